@@ -0,0 +1,245 @@
+/**
+ * @file        adjbuilder.hpp
+ * 
+ * @brief       Streaming construction of adjacency lists.
+ * 
+ * @details     This file contains the class cut::AdjacencyListBuilder, which
+ *              builds a cut::CompatAdjacencyList from a stream of connections
+ *              without ever materializing the whole list of connections in memory.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-24
+ */
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <functional>
+#include <cstdio>
+#include <cstddef>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/csrbuild.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A streaming builder of adjacency lists.
+ * 
+ * @details     The class cut::AdjacencyListBuilder accepts connections in chunks,
+ *              from arrays, from a callback or from a text edge list, and produces
+ *              a cut::CompatAdjacencyList.\n 
+ *              The builder keeps in memory only the degree of each node and a buffer
+ *              of at most <code>ChunkSize</code> connections. When the buffer is full,
+ *              it is spilled to a temporary file. The list is finally produced by a
+ *              counting sort that scatters the spilled chunks directly in the final
+ *              arrays, so the memory overhead over the output list is bounded by the
+ *              size of the buffer, independently of the number of connections.\n 
+ *              If no chunk has been spilled, no file is ever created.
+ */
+class AdjacencyListBuilder
+{
+private:
+    /**
+     * @brief       The maximum number of connections kept in memory.
+     * @details     The maximum number of connections kept in memory.
+     */
+    size_t m_ChunkSize;
+
+    /**
+     * @brief       The connections not spilled yet.
+     * @details     The connections not spilled yet.
+     */
+    std::vector<std::pair<int, int>> m_Buffer;
+
+    /**
+     * @brief       The number of connections of each node.
+     * @details     The number of connections of each node.
+     */
+    std::vector<int> m_Degree;
+
+    /**
+     * @brief       The total number of connections.
+     * @details     The total number of connections.
+     */
+    size_t m_NConns;
+
+    /**
+     * @brief       The temporary file holding the spilled chunks.
+     * @details     The temporary file holding the spilled chunks, or null if
+     *              nothing has been spilled.
+     */
+    std::FILE* m_Spill;
+
+    /**
+     * @brief       The number of spilled chunks.
+     * @details     The number of spilled chunks.
+     */
+    size_t m_NSpills;
+
+    /**
+     * @brief       Write the buffer to the temporary file.
+     * @details     Write the buffer to the temporary file, creating it if needed,
+     *              and clear the buffer.
+     * 
+     * @throws cut::AssertionError if the temporary file cannot be written.
+     */
+    void Spill();
+
+    /**
+     * @brief       Discard all the connections.
+     * @details     Discard all the connections and close the temporary file.
+     */
+    void Reset();
+
+public:
+    /**
+     * @brief       The default number of connections kept in memory.
+     * @details     The default number of connections kept in memory.
+     */
+    static const size_t DefaultChunkSize = 1 << 22;
+
+    /**
+     * @brief       Construct a new empty builder.
+     * 
+     * @details     This constructor initializes a builder that keeps in memory
+     *              at most <code>ChunkSize</code> connections.
+     * 
+     * @param ChunkSize The maximum number of buffered connections.
+     * 
+     * @throws cut::OutOfBoundError if <code>ChunkSize == 0</code>.
+     */
+    AdjacencyListBuilder(size_t ChunkSize = DefaultChunkSize);
+
+    AdjacencyListBuilder(const cut::AdjacencyListBuilder& B) = delete;
+    cut::AdjacencyListBuilder& operator=(const cut::AdjacencyListBuilder& B) = delete;
+
+    /**
+     * @brief       Destroy the builder.
+     * @details     Destroy the builder, removing the temporary file.
+     */
+    ~AdjacencyListBuilder();
+
+    /**
+     * @brief       Add a connection.
+     * 
+     * @details     This method adds a connection from <code>Node</code> to
+     *              <code>Adjacent</code>.
+     * 
+     * @param Node The index of the node.
+     * @param Adjacent The index of the adjacent.
+     * 
+     * @throws cut::OutOfBoundError if any of the indices is negative.
+     */
+    void AddEdge(int Node, int Adjacent);
+
+    /**
+     * @brief       Add a chunk of connections.
+     * 
+     * @details     This method adds all the connections in the given array.
+     *              For each connection, the first value identifies the node, while
+     *              the second value identifies the adjacent.
+     * 
+     * @param Edges The array of connections.
+     * @param NEdges The number of connections in the array.
+     * 
+     * @throws cut::OutOfBoundError if any of the indices is negative.
+     */
+    void AddEdges(const std::pair<int, int>* Edges, size_t NEdges);
+
+    /**
+     * @brief       Add the connections produced by a callback.
+     * 
+     * @details     This method repeatedly calls <code>Source(Chunk, Capacity)</code>,
+     *              which must write at most <code>Capacity</code> connections in
+     *              <code>Chunk</code> and return their number. The process stops
+     *              when the callback returns 0.
+     * 
+     * @param Source The callback producing the connections.
+     * @return size_t The number of connections added.
+     * 
+     * @throws cut::OutOfBoundError if any of the indices is negative.
+     */
+    size_t AddEdges(const std::function<size_t(std::pair<int, int>*, size_t)>& Source);
+
+    /**
+     * @brief       Add the connections from a text edge list.
+     * 
+     * @details     This method reads a text edge list, with a connection per line
+     *              given by two whitespace separated indices. Empty lines and lines
+     *              starting with <code>'#'</code> or <code>'%'</code> are ignored.
+     * 
+     * @param Stream The input stream.
+     * @return size_t The number of connections added.
+     * 
+     * @throws cut::AssertionError if a line is malformed or contains negative indices.
+     */
+    size_t ReadEdgeList(std::istream& Stream);
+
+    /**
+     * @brief       Add the connections from a text edge list file.
+     * 
+     * @details     This method opens the given file and reads it with
+     *              <code>ReadEdgeList(std::istream&)</code>.
+     * 
+     * @param Filename The path to the edge list.
+     * @return size_t The number of connections added.
+     * 
+     * @throws cut::AssertionError if the file cannot be opened or is malformed.
+     */
+    size_t ReadEdgeList(const std::string& Filename);
+
+    /**
+     * @brief       The number of nodes added so far.
+     * @details     The number of nodes added so far, that is the largest node
+     *              index plus one.
+     * 
+     * @return int The number of nodes.
+     */
+    int NumNodes() const;
+
+    /**
+     * @brief       The number of connections added so far.
+     * @details     The number of connections added so far, including duplicates.
+     * 
+     * @return size_t The number of connections.
+     */
+    size_t NumConnections() const;
+
+    /**
+     * @brief       The number of chunks spilled to the temporary file.
+     * @details     The number of chunks spilled to the temporary file.
+     * 
+     * @return size_t The number of spilled chunks.
+     */
+    size_t NumSpills() const;
+
+    /**
+     * @brief       Build the adjacency list.
+     * 
+     * @details     This method produces a cut::CompatAdjacencyList with all the
+     *              connections added so far, and leaves the builder empty, ready
+     *              to be reused.\n 
+     *              If <code>SortAndUnique</code> is true, duplicated connections are
+     *              discarded and the adjacents of each node are sorted. Otherwise,
+     *              the adjacents keep the order in which they have been added.\n 
+     *              The peak memory reported in <code>Stats</code> includes the buffer,
+     *              the degrees and the output arrays.
+     * 
+     * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+     * @param Stats If not null, receives the statistics about the construction.
+     * @return cut::CompatAdjacencyList The adjacency list.
+     * 
+     * @throws cut::AssertionError if the temporary file cannot be read.
+     * @throws cut::AssertionError if the connections do not fit a cut::CompatAdjacencyList.
+     */
+    cut::CompatAdjacencyList Build(bool SortAndUnique = true,
+                                   cut::CSRBuildStats* Stats = nullptr);
+};
+
+} // namespace cut
\ No newline at end of file
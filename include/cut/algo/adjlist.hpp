@@ -21,6 +21,11 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <cut/algo/span.hpp>
+#include <cut/memory/arena.hpp>
+#include <cut/memory/aligned.hpp>
+#include <cut/algo/csrbuild.hpp>
 
 
 namespace cut
@@ -149,6 +154,27 @@ public:
      */
     virtual int GetAdjacent(int i, int idx) const  = 0;
 
+    /**
+     * @brief       Return the adjacents of node i.
+     * 
+     * @details     This method returns a read-only view over the list of
+     *              adjacents of node <code>i</code>.\n 
+     *              The view refers to the internal memory of the list, hence
+     *              iterating over it requires no copies and no virtual calls.
+     *              The view is invalidated by any operation that modifies the list.\n 
+     *              The default implementation is meant for lists that do not store
+     *              their adjacents as contiguous integers: it gathers the adjacents
+     *              with <code>GetAdjacent()</code> into a per-thread buffer, and the
+     *              view is also invalidated by the next call to this method from the
+     *              same thread.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<int> The adjacents of the given node.
+     */
+    virtual cut::Span<int> Neighbors(int i) const;
+
     /**
      * @brief       Syntactic sugar for <code>GetAdjacent()</code>.
      * 
@@ -165,22 +191,44 @@ public:
 
 
 
+class CompatAdjacencyList;
+
 /**
  * @brief       A flexible implementation of the cut::BaseAdjacencyList interface.
  * 
  * @details     The class cut::AdjacencyList provides a flexible implementation
  *              of the abstract interface cut::BaseAdjacencyList.\n 
  *              This class provides operations for modifying and updating the list,
- *              but it is not the most efficient for read-only accesses.
+ *              but it is not the most efficient for read-only accesses.\n 
+ *              The rows of the list are allocated from a cut::Arena owned by the list,
+ *              instead of being separate allocations of the heap. Since the arena is not
+ *              thread-safe, the list must not be modified by concurrent threads, not even
+ *              on different rows: any method that may grow a row, such as AddAdjacent()
+ *              or InsertAdjacent(), allocates from the shared arena. Concurrent reads
+ *              are safe.
  */
 class AdjacencyList : public cut::BaseAdjacencyList
 {
+public:
+    /**
+     * @brief       The type of the rows of the list.
+     * @details     The type of the rows of the list, allocated from the arena of the list.
+     */
+    typedef std::vector<int, cut::ArenaAllocator<int>> RowType;
+
 protected:
+    /**
+     * @brief       The arena of the rows.
+     * @details     The arena of the rows. It is declared before the rows, so that
+     *              the rows are destroyed first.
+     */
+    std::unique_ptr<cut::Arena> m_Arena;
+
     /**
      * @brief       The list of lists implementing the adjacency list.
      * @details     The list of lists implementing the adjacency list.
      */
-    std::vector<std::vector<int>> m_Adj;
+    std::vector<RowType> m_Adj;
 
     /**
      * @brief       The total number of connections.
@@ -188,6 +236,93 @@ protected:
      */
     int m_NConnections;
 
+    /**
+     * @brief       The tombstones of the deleted nodes.
+     * @details     The tombstones of the deleted nodes. It is empty if no node
+     *              has ever been deleted with <code>DeleteNode()</code>.
+     */
+    std::vector<char> m_Deleted;
+
+    /**
+     * @brief       The deleted nodes available for reuse.
+     * @details     The deleted nodes available for reuse by <code>NewNode()</code>,
+     *              that is the ones no connection points to, after <code>PurgeDeleted()</code>.
+     */
+    std::vector<int> m_FreeNodes;
+
+    /**
+     * @brief       Forget the deleted nodes available for reuse.
+     * @details     Forget the deleted nodes available for reuse, after an operation
+     *              that shifted the indices of the nodes, since the connections of
+     *              the other nodes may now point to them.
+     */
+    void ResetFreeNodes();
+
+    /**
+     * @brief       Remove all the rows.
+     * @details     Remove all the rows, and reset the arena so that its memory is
+     *              reused by the next rows.
+     */
+    void ClearRows();
+
+    /**
+     * @brief       Create an empty row.
+     * @details     Create an empty row allocated from the arena of the list.
+     */
+    RowType EmptyRow() const;
+
+    /**
+     * @brief       Copy the rows of another list.
+     * @details     Copy the rows of another list, allocating them from the arena of this list.
+     */
+    void CopyRows(const cut::AdjacencyList& FAL);
+
+    /**
+     * @brief       Copy a compact list.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given compact list. Each row is copied from the arrays of the
+     *              compact list in a single operation, without virtual calls.
+     * 
+     * @param CAL The list to copy.
+     */
+    void CopyFromCompat(const cut::CompatAdjacencyList& CAL);
+
+    /**
+     * @brief       Copy any list.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given one, with the fastest path available for its class.
+     * 
+     * @param AL The list to copy.
+     */
+    void AssignFrom(const cut::BaseAdjacencyList& AL);
+
+    /**
+     * @brief       Move any list.
+     * 
+     * @details     This method moves the rows of the given list if it is a
+     *              cut::AdjacencyList. Otherwise, it copies the given list with
+     *              AssignFrom(). The input is left empty, unless it is of a class other
+     *              than cut::AdjacencyList and cut::CompatAdjacencyList, in which case it is
+     *              left unchanged.
+     * 
+     * @param AL The list to move.
+     */
+    void MoveFrom(cut::BaseAdjacencyList&& AL);
+
+    /**
+     * @brief       Copy the given list through the abstract interface.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given one, reading it row by row with <code>Neighbors()</code>.\n 
+     *              The rows are copied in parallel, with the number of threads
+     *              given by cut::GetNumThreads().
+     * 
+     * @param AL The list to copy.
+     */
+    void CopyFrom(const cut::BaseAdjacencyList& AL);
+
 public:
     /**
      * @brief       Construct a new AdjacencyList with N nodes.
@@ -206,7 +341,9 @@ public:
      * @details     This constructor initializes an adjacency list from the
      *              given list of connections.\n 
      *              For each connection in the list, the first value identifies
-     *              the node, while the second value identifies the adjacent.
+     *              the node, while the second value identifies the adjacent.\n 
+     *              Duplicated connections are discarded, and the adjacents of each
+     *              node keep the order of their first occurrence (see <code>BuildFrom()</code>).
      * 
      * @param Connections A list of connections.
      */
@@ -221,26 +358,100 @@ public:
      * @param AL The list to copy.
      */
     AdjacencyList(const cut::BaseAdjacencyList& AL);
+    AdjacencyList(const cut::AdjacencyList& AL);
 
     /**
      * @brief       Move constructor.
      * 
      * @details     This constructor initializes an adjacency list by moving
      *              the memory from the given adjacency list.\n 
-     *              This constructor invalidates the input.
+     *              This constructor invalidates the input.\n 
+     *              A cut::CompatAdjacencyList is converted copying each row in a single
+     *              operation, and its memory is released. Any other class is copied
+     *              through the abstract interface.
      * 
      * @param AL The adjacency list to move.
      */
     AdjacencyList(cut::BaseAdjacencyList&& AL);
+    AdjacencyList(cut::AdjacencyList&& AL);
 
     virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override;
     virtual cut::AdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override;
+    cut::AdjacencyList& operator=(const cut::AdjacencyList& AL);
+    cut::AdjacencyList& operator=(cut::AdjacencyList&& AL);
     virtual ~AdjacencyList();
 
     virtual int NumNodes() const override;
     virtual int NumConnections() const override;
     virtual int NumAdjacents(int i) const override;
     virtual int GetAdjacent(int i, int idx) const override;
+    virtual cut::Span<int> Neighbors(int i) const override;
+
+    /**
+     * @brief       Determine whether or not a connection exists.
+     * 
+     * @details     Determine whether or not <code>j</code> is an adjacent of <code>i</code>.
+     *              The row is scanned with the vectorized kernel of cut::Contains().
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If <code>j</code> is an adjacent of <code>i</code>.
+     * @return false Otherwise, or if <code>i</code> is not a node.
+     */
+    bool HasConnection(int i, int j) const;
+
+    /**
+     * @brief       Number of adjacents of node i, without bound checks.
+     * 
+     * @details     This method returns the number of connections going
+     *              out from node i.\n 
+     *              Differently from <code>NumAdjacents()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> is
+     *              undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @return int The number of connections in the node.
+     */
+    int NumAdjacentsUnchecked(int i) const;
+
+    /**
+     * @brief       Return an adjacent to node i, without bound checks.
+     * 
+     * @details     This method returns the adjacent in position
+     *              <code>idx</code> in the list of adjacents of node
+     *              <code>i</code>.\n 
+     *              Differently from <code>GetAdjacent()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> or
+     *              <code>idx >= NumAdjacents(i)</code> is undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @param idx The index of an adjancent.
+     * @return int The adjacent of the given node in the given position.
+     */
+    int GetAdjacentUnchecked(int i, int idx) const;
+
+    /**
+     * @brief       Return the adjacents of node i, without bound checks.
+     * 
+     * @details     This method returns a read-only view over the list of
+     *              adjacents of node <code>i</code>.\n 
+     *              Differently from <code>Neighbors()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> is
+     *              undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<int> The adjacents of the given node.
+     */
+    cut::Span<int> NeighborsUnchecked(int i) const;
 
     /**
      * @brief       Add a new node to the list.
@@ -293,11 +504,93 @@ public:
      */
     virtual void RemoveNode(int i);
 
+    /**
+     * @brief       Delete the given node, without shifting the others.
+     * 
+     * @details     This method deletes the node with index <code>i</code>, deleting
+     *              also all its connections, in <code>O(NumAdjacents(i))</code> time.\n 
+     *              Differently from <code>RemoveNode()</code>, the node is only marked
+     *              with a tombstone: the indices of all the other nodes stay valid, and
+     *              <code>NumNodes()</code> does not change. The row of a deleted node is empty.\n 
+     *              The connections of other nodes towards <code>i</code> are not removed,
+     *              they are dropped by <code>PurgeDeleted()</code> or <code>Compact()</code>.
+     *              Hence the index <code>i</code> is not reused by <code>NewNode()</code>
+     *              until <code>PurgeDeleted()</code> has run.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     * @throws cut::AssertionError if <code>i</code> is already deleted.
+     * 
+     * @param i The node to delete.
+     */
+    virtual void DeleteNode(int i);
+
+    /**
+     * @brief       Create a new node, reusing a deleted one if possible.
+     * 
+     * @details     This method returns the index of a node deleted with
+     *              <code>DeleteNode()</code> and released by <code>PurgeDeleted()</code>,
+     *              which is revived with no connections from or towards it, or adds a new
+     *              node as <code>AddNode()</code> if there is none.\n 
+     *              The operation takes constant time.
+     * 
+     * @return int The index of the new node.
+     */
+    virtual int NewNode();
+
+    /**
+     * @brief       Check whether the given node has been deleted.
+     * 
+     * @details     This method returns true if node <code>i</code> has been deleted
+     *              with <code>DeleteNode()</code>, and not reused yet.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     * 
+     * @param i The index of a node.
+     * @return bool Whether or not the node is deleted.
+     */
+    bool IsDeleted(int i) const;
+
+    /**
+     * @brief       The number of deleted nodes.
+     * 
+     * @details     This method returns the number of nodes deleted with
+     *              <code>DeleteNode()</code> and not reused yet.
+     * 
+     * @return int The number of deleted nodes.
+     */
+    int NumDeletedNodes() const;
+
+    /**
+     * @brief       Drop the connections towards the deleted nodes.
+     * 
+     * @details     This method removes the connections of all the nodes towards the
+     *              nodes deleted with <code>DeleteNode()</code>, in a single linear pass
+     *              over the list, without renumbering any node. Afterwards, the indices
+     *              of the deleted nodes are reused by <code>NewNode()</code>.
+     */
+    void PurgeDeleted();
+
+    /**
+     * @brief       Remove the deleted nodes and renumber the others.
+     * 
+     * @details     This method removes all the nodes deleted with <code>DeleteNode()</code>,
+     *              in a single linear pass over the list. The remaining nodes keep their
+     *              relative order and are renumbered contiguously, and their adjacents are
+     *              renumbered accordingly. The connections towards deleted nodes are dropped.\n 
+     *              Adjacents that are not nodes of the list are left unchanged.
+     * 
+     * @return std::vector<int> The new index of each old node, or -1 for the deleted ones.
+     */
+    std::vector<int> Compact();
+
     /**
      * @brief       Add the given adjancent to the given node.
      * 
      * @details     This method adds the value <code>j</code> as an adjacent
-     *              of the node <code>i</code>.
+     *              of the node <code>i</code>.\n 
+     *              The duplicate check is a linear scan of the row, hence
+     *              <code>AddAdjacents()</code> should be preferred for adding many
+     *              adjacents to the same node.
      * 
      * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
      * @throws cut::AssertionError if <code>j</code> is already an adjacent of <code>i</code>.
@@ -307,6 +600,47 @@ public:
      */
     virtual void AddAdjacent(int i, int j);
 
+    /**
+     * @brief       Add a range of adjacents to the given node.
+     * 
+     * @details     This method appends the values in <code>[Begin, End)</code> to the
+     *              adjacents of node <code>i</code>, in the given order.\n 
+     *              If <code>CheckDuplicates</code> is true, the values that are already
+     *              adjacents of <code>i</code>, or that are repeated in the range, are
+     *              skipped. The duplicates are found by sorting a scratch copy of the row,
+     *              so the cost is <code>O(d log d)</code> for the resulting degree
+     *              <code>d</code>, instead of the <code>O(d^2)</code> of repeated calls to
+     *              <code>AddAdjacent()</code>.\n 
+     *              If <code>CheckDuplicates</code> is false, the caller guarantees that the
+     *              range does not introduce duplicates, and the values are appended as is.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     * 
+     * @param i The index of a node.
+     * @param Begin The first of the new adjacents.
+     * @param End The end of the new adjacents.
+     * @param CheckDuplicates Whether or not the duplicates must be skipped.
+     * @return int The number of adjacents actually added.
+     */
+    virtual int AddAdjacents(int i, const int* Begin, const int* End, bool CheckDuplicates = true);
+
+    /**
+     * @brief       Replace the content of the list with the given connections.
+     * 
+     * @details     This method replaces the whole list with the given connections.
+     *              For each connection in the list, the first value identifies
+     *              the node, while the second value identifies the adjacent.\n 
+     *              The rows are filled with a counting sort, preserving the input order.
+     *              If <code>CheckDuplicates</code> is true, the duplicated connections
+     *              are then discarded as in <code>AddAdjacents()</code>, keeping the first
+     *              occurrence. The rows are deduplicated in parallel, with the number of
+     *              threads given by cut::GetNumThreads().
+     * 
+     * @param Connections A list of connections.
+     * @param CheckDuplicates Whether or not the duplicates must be discarded.
+     */
+    virtual void BuildFrom(const std::vector<std::pair<int, int>>& Connections, bool CheckDuplicates = true);
+
     /**
      * @brief       Add the given adjancent to the given node.
      * 
@@ -382,22 +716,70 @@ public:
  * @details     This class provides an efficient read-only implementation of
  *              an adjacency list.\n 
  *              The memory is compactly stored, enhancing memory locality
- *              and fast accesses.
+ *              and fast accesses.\n 
+ *              The arrays are allocated with cut::AlignedAllocator, following the
+ *              policy returned by cut::GetDefaultMemoryPolicy() when the list is
+ *              created: by default they are only aligned to the cache lines. A policy
+ *              with huge pages and first-touch placement makes the threads of the
+ *              library touch the pages first, so that on NUMA systems each thread reads
+ *              its rows from its own node.
  */
 class CompatAdjacencyList : public cut::BaseAdjacencyList
 {
+public:
+    /**
+     * @brief       The type of the arrays of the list.
+     * @details     The type of the arrays of the list, allocated with the placement policy of the list.
+     */
+    typedef std::vector<int, cut::AlignedAllocator<int>> ArrayType;
+
 protected:
     /**
      * @brief       The list of connections.
      * @details     The list of connections.
      */
-    std::vector<int> m_Adj;
+    ArrayType m_Adj;
 
     /**
      * @brief       The starting index of each node.
      * @details     The starting index of each node.
      */
-    std::vector<int> m_Idx;
+    ArrayType m_Idx;
+
+    /**
+     * @brief       Copy the given list through the abstract interface.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given one, reading it row by row with <code>Neighbors()</code>.\n 
+     *              Both the degrees and the rows are read in parallel, with the number
+     *              of threads given by cut::GetNumThreads(), and the offsets are
+     *              computed with cut::ParallelPrefixSum().
+     * 
+     * @param AL The list to copy.
+     */
+    void CopyFrom(const cut::BaseAdjacencyList& AL);
+
+    /**
+     * @brief       Copy a flexible list.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given cut::AdjacencyList. The connections are allocated at once, and
+     *              the rows are copied in parallel, each in a single operation and
+     *              without virtual calls.
+     * 
+     * @param FAL The list to copy.
+     */
+    void CopyFromList(const cut::AdjacencyList& FAL);
+
+    /**
+     * @brief       Copy any list.
+     * 
+     * @details     This method replaces the content of this list with a copy of the
+     *              given one, with the fastest path available for its class.
+     * 
+     * @param AL The list to copy.
+     */
+    void AssignFrom(const cut::BaseAdjacencyList& AL);
 
 
 public:
@@ -407,12 +789,72 @@ public:
      * @details     This constructor initializes an adjacency list from the
      *              given list of connections.\n 
      *              For each connection in the list, the first value identifies
-     *              the node, while the second value identifies the adjacent.
+     *              the node, while the second value identifies the adjacent.\n 
+     *              Duplicated connections are discarded and the adjacents of each
+     *              node are sorted.\n 
+     *              The construction takes linear time in the number of nodes and
+     *              connections, plus the time for sorting the unsorted rows
+     *              (see cut::BuildCSR()).
      * 
      * @param Connections A list of connections.
      */
     CompatAdjacencyList(const std::vector<std::pair<int, int>>& Connections);
 
+    /**
+     * @brief       Construct a new CompatAdjacencyList from a list of connections.
+     * 
+     * @details     This constructor initializes an adjacency list from the
+     *              given list of connections.\n 
+     *              For each connection in the list, the first value identifies
+     *              the node, while the second value identifies the adjacent.\n 
+     *              If <code>SortAndUnique</code> is true, duplicated connections are
+     *              discarded and the adjacents of each node are sorted. Otherwise,
+     *              the adjacents keep the input order, and the construction is a
+     *              plain counting sort.\n 
+     *              The statistics about the construction, including its peak memory,
+     *              are reported in <code>Stats</code>, if not null.\n 
+     *              If <code>SortAndUnique</code> is true and cut::GetNumThreads() is larger
+     *              than one, the list is built with cut::BuildCSRParallel().
+     * 
+     * @param Connections A list of connections.
+     * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+     * @param Stats If not null, receives the statistics about the construction.
+     */
+    CompatAdjacencyList(const std::vector<std::pair<int, int>>& Connections,
+                        bool SortAndUnique,
+                        cut::CSRBuildStats* Stats = nullptr);
+
+    /**
+     * @brief       Construct a new CompatAdjacencyList from its raw arrays.
+     * 
+     * @details     This constructor initializes an adjacency list by moving the
+     *              given arrays of offsets and connections.\n 
+     *              The adjacents of node <code>i</code> are the connections in the
+     *              range <code>[Offsets[i], Offsets[i + 1])</code>.
+     * 
+     * @param Offsets The offsets of the rows. It must contain one element more than the nodes.
+     * @param Adjacents The connections of all the rows.
+     * 
+     * @throws cut::AssertionError if the offsets are empty or do not cover the connections.
+     */
+    CompatAdjacencyList(ArrayType&& Offsets,
+                        ArrayType&& Adjacents);
+
+    /**
+     * @brief       Construct a new CompatAdjacencyList from its raw arrays.
+     * 
+     * @details     This constructor initializes an adjacency list by copying the
+     *              given arrays of offsets and connections in arrays allocated with
+     *              the default memory policy.
+     * 
+     * @param Offsets The offsets of the rows. It must contain one element more than the nodes.
+     * @param Adjacents The connections of all the rows.
+     * 
+     * @throws cut::AssertionError if the offsets are empty or do not cover the connections.
+     */
+    CompatAdjacencyList(const std::vector<int>& Offsets,
+                        const std::vector<int>& Adjacents);
+
     /**
      * @brief       Copy constructor.
      * 
@@ -428,20 +870,153 @@ public:
      * 
      * @details     This constructor initializes an adjacency list by moving
      *              the memory from the given adjacency list.\n 
-     *              This constructor invalidates the input.
+     *              This constructor invalidates the input.\n 
+     *              A cut::AdjacencyList is converted with a single allocation of the
+     *              connections, copying each row in a single operation, and its memory
+     *              is released. Any other class is copied through the abstract interface.
      * 
      * @param AL The adjacency list to move.
      */
     CompatAdjacencyList(cut::BaseAdjacencyList&& AL);
+    CompatAdjacencyList(const cut::CompatAdjacencyList& AL);
+    CompatAdjacencyList(cut::CompatAdjacencyList&& AL);
 
     virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override;
     virtual cut::CompatAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override;
+    cut::CompatAdjacencyList& operator=(const cut::CompatAdjacencyList& AL);
+    cut::CompatAdjacencyList& operator=(cut::CompatAdjacencyList&& AL);
     virtual ~CompatAdjacencyList();
 
     virtual int NumNodes() const override;
     virtual int NumConnections() const override;
     virtual int NumAdjacents(int i) const override;
     virtual int GetAdjacent(int i, int idx) const override;
+    virtual cut::Span<int> Neighbors(int i) const override;
+
+    /**
+     * @brief       Determine whether or not a connection exists.
+     * 
+     * @details     Determine whether or not <code>j</code> is an adjacent of <code>i</code>.
+     *              The row is scanned with the vectorized kernel of cut::Contains(),
+     *              hence the rows need not be sorted.
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If <code>j</code> is an adjacent of <code>i</code>.
+     * @return false Otherwise, or if <code>i</code> is not a node.
+     */
+    bool HasConnection(int i, int j) const;
+
+    /**
+     * @brief       Determine whether or not a connection exists, in sorted rows.
+     * 
+     * @details     Determine whether or not <code>j</code> is an adjacent of <code>i</code>,
+     *              with the search of cut::SortedContains(), which is logarithmic in the
+     *              size of the row.
+     * 
+     * @warning     The result is unspecified if the row of <code>i</code> is not sorted,
+     *              as when the list is built without sorting and deduplication.
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If <code>j</code> is an adjacent of <code>i</code>.
+     * @return false Otherwise, or if <code>i</code> is not a node.
+     */
+    bool HasSortedConnection(int i, int j) const;
+
+    /**
+     * @brief       The degrees of the nodes.
+     * 
+     * @details     This method returns the number of adjacents of each node, computed
+     *              from the offsets of the rows with cut::RowDegrees().
+     * 
+     * @return std::vector<int> The degree of each node.
+     */
+    std::vector<int> Degrees() const;
+
+    /**
+     * @brief       Number of adjacents of node i, without bound checks.
+     * 
+     * @details     This method returns the number of connections going
+     *              out from node i.\n 
+     *              Differently from <code>NumAdjacents()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> is
+     *              undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @return int The number of connections in the node.
+     */
+    int NumAdjacentsUnchecked(int i) const;
+
+    /**
+     * @brief       Return an adjacent to node i, without bound checks.
+     * 
+     * @details     This method returns the adjacent in position
+     *              <code>idx</code> in the list of adjacents of node
+     *              <code>i</code>.\n 
+     *              Differently from <code>GetAdjacent()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> or
+     *              <code>idx >= NumAdjacents(i)</code> is undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @param idx The index of an adjancent.
+     * @return int The adjacent of the given node in the given position.
+     */
+    int GetAdjacentUnchecked(int i, int idx) const;
+
+    /**
+     * @brief       Return the adjacents of node i, without bound checks.
+     * 
+     * @details     This method returns a read-only view over the list of
+     *              adjacents of node <code>i</code>.\n 
+     *              Differently from <code>Neighbors()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> is
+     *              undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<int> The adjacents of the given node.
+     */
+    cut::Span<int> NeighborsUnchecked(int i) const;
 };
 
-} // namespace cut
+
+inline int AdjacencyList::NumAdjacentsUnchecked(int i) const
+{
+    return m_Adj[i].size();
+}
+
+inline int AdjacencyList::GetAdjacentUnchecked(int i, int idx) const
+{
+    return m_Adj[i][idx];
+}
+
+inline cut::Span<int> AdjacencyList::NeighborsUnchecked(int i) const
+{
+    return cut::Span<int>(m_Adj[i].data(), m_Adj[i].size());
+}
+
+inline int CompatAdjacencyList::NumAdjacentsUnchecked(int i) const
+{
+    return m_Idx[i + 1] - m_Idx[i];
+}
+
+inline int CompatAdjacencyList::GetAdjacentUnchecked(int i, int idx) const
+{
+    return m_Adj[m_Idx[i] + idx];
+}
+
+inline cut::Span<int> CompatAdjacencyList::NeighborsUnchecked(int i) const
+{
+    return cut::Span<int>(m_Adj.data() + m_Idx[i], m_Idx[i + 1] - m_Idx[i]);
+}
+
+} // namespace cut
\ No newline at end of file
@@ -12,5 +12,19 @@
  */
 #pragma once
 
+#include <cut/algo/span.hpp>
+#include <cut/algo/intersect.hpp>
 #include <cut/algo/minheap.hpp>
-#include <cut/algo/adjlist.hpp>
\ No newline at end of file
+#include <cut/algo/dheap.hpp>
+#include <cut/algo/radixheap.hpp>
+#include <cut/algo/csrbuild.hpp>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/csr.hpp>
+#include <cut/algo/wadjlist.hpp>
+#include <cut/algo/madjlist.hpp>
+#include <cut/algo/adjbuilder.hpp>
+#include <cut/algo/zadjlist.hpp>
+#include <cut/algo/dadjlist.hpp>
+#include <cut/algo/graph.hpp>
+#include <cut/algo/reorder.hpp>
+#include <cut/algo/partition.hpp>
\ No newline at end of file
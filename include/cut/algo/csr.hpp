@@ -0,0 +1,425 @@
+/**
+ * @file        csr.hpp
+ * 
+ * @brief       A templated compressed sparse row adjacency list.
+ * 
+ * @details     This file contains the declaration and the implementation of the
+ *              class template cut::CSRAdjacencyList, a read-only adjacency list in
+ *              compressed sparse row format whose node and offset types are
+ *              chosen at compile time.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-20
+ */
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/span.hpp>
+#include <cut/algo/csrbuild.hpp>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       An efficient read-only adjacency list with configurable types.
+ * 
+ * @details     The class cut::CSRAdjacencyList stores an adjacency list in
+ *              compressed sparse row format, like cut::CompatAdjacencyList, but
+ *              the type of the node indices and the type of the offsets are
+ *              template parameters.\n 
+ *              Using small node types halves the memory bandwidth of the traversals,
+ *              while using 64 bits offsets allows for lists with more than 2^31
+ *              connections.\n 
+ *              The class is final, hence all the accesses through an object of this
+ *              type are devirtualized by the compiler.\n 
+ *              The class implements the interface cut::BaseAdjacencyList, which
+ *              returns integers. That interface is only meaningful as long as
+ *              nodes and connections fit an integer; for larger lists the typed
+ *              interface (cut::CSRAdjacencyList::NodeCount(), cut::CSRAdjacencyList::Degree(),
+ *              cut::CSRAdjacencyList::Adjacent(), cut::CSRAdjacencyList::Row()) must
+ *              be used instead.
+ * 
+ * @tparam IndexT The unsigned or signed integer type of the node indices.
+ * @tparam OffsetT The integer type of the row offsets.
+ */
+template<typename IndexT = uint32_t, typename OffsetT = uint64_t>
+class CSRAdjacencyList final : public cut::BaseAdjacencyList
+{
+public:
+    /**
+     * @brief       The type of the node indices.
+     * @details     The type of the node indices.
+     */
+    typedef IndexT IndexType;
+
+    /**
+     * @brief       The type of the row offsets.
+     * @details     The type of the row offsets.
+     */
+    typedef OffsetT OffsetType;
+
+private:
+    /**
+     * @brief       The list of connections.
+     * @details     The list of connections.
+     */
+    std::vector<IndexT> m_Adj;
+
+    /**
+     * @brief       The starting index of each node.
+     * @details     The starting index of each node.
+     */
+    std::vector<OffsetT> m_Idx;
+
+    /**
+     * @brief       Copy the given list through the abstract interface.
+     * @details     Copy the given list through the abstract interface, reading
+     *              the degrees and the rows in parallel.
+     */
+    void CopyFrom(const cut::BaseAdjacencyList& AL)
+    {
+        const cut::CSRAdjacencyList<IndexT, OffsetT>* CSR;
+        CSR = dynamic_cast<const cut::CSRAdjacencyList<IndexT, OffsetT>*>(&AL);
+        if (CSR != nullptr)
+        {
+            m_Adj = CSR->m_Adj;
+            m_Idx = CSR->m_Idx;
+            return;
+        }
+
+        // Count the adjacents of each node and accumulate the offsets
+        int NNodes = AL.NumNodes();
+        m_Idx.assign(NNodes + 1, 0);
+        cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+                m_Idx[i + 1] = (OffsetT)AL.NumAdjacents(i);
+        });
+        cut::ParallelPrefixSum(m_Idx.data() + 1, NNodes);
+
+        // Fill the data, each row has its own range
+        m_Adj.resize(m_Idx[NNodes]);
+        cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+            {
+                cut::Span<int> Adjs = AL.Neighbors(i);
+                IndexT* Dst = m_Adj.data() + m_Idx[i];
+                for (int a : Adjs)
+                    *(Dst++) = (IndexT)a;
+            }
+        }, -1, 1024);
+    }
+
+public:
+    /**
+     * @brief       Construct an empty list.
+     * 
+     * @details     This constructor initializes a list with no nodes.
+     */
+    CSRAdjacencyList()
+        : cut::BaseAdjacencyList(), m_Idx(1, 0)
+    { }
+
+    /**
+     * @brief       Construct a new CSRAdjacencyList from a list of connections.
+     * 
+     * @details     This constructor initializes an adjacency list from the
+     *              given list of connections.\n 
+     *              For each connection in the list, the first value identifies
+     *              the node, while the second value identifies the adjacent.\n 
+     *              If <code>SortAndUnique</code> is true (default), duplicated
+     *              connections are discarded and the adjacents of each node are
+     *              sorted. Otherwise, the adjacents keep the input order.\n 
+     *              The construction takes linear time in the number of nodes
+     *              and connections, plus the time for sorting the unsorted rows
+     *              (see cut::BuildCSR()).
+     * 
+     * @param Connections A list of connections.
+     * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+     * @param Stats If not null, receives the statistics about the construction.
+     */
+    CSRAdjacencyList(const std::vector<std::pair<IndexT, IndexT>>& Connections,
+                     bool SortAndUnique = true,
+                     cut::CSRBuildStats* Stats = nullptr)
+        : cut::BaseAdjacencyList()
+    {
+        if (SortAndUnique && cut::GetNumThreads() > 1)
+            cut::BuildCSRParallel(Connections.data(), Connections.size(), m_Idx, m_Adj, Stats);
+        else
+            cut::BuildCSR(Connections.data(), Connections.size(), m_Idx, m_Adj, SortAndUnique, Stats);
+    }
+
+    /**
+     * @brief       Construct a new CSRAdjacencyList from its raw arrays.
+     * 
+     * @details     This constructor initializes an adjacency list by moving the
+     *              given arrays of offsets and connections.\n 
+     *              The adjacents of node <code>i</code> are the connections in the
+     *              range <code>[Offsets[i], Offsets[i + 1])</code>.
+     * 
+     * @param Offsets The offsets of the rows. It must contain one element more than the nodes.
+     * @param Adjacents The connections of all the rows.
+     * 
+     * @throws cut::AssertionError if the offsets are empty or do not cover the connections.
+     */
+    CSRAdjacencyList(std::vector<OffsetT>&& Offsets,
+                     std::vector<IndexT>&& Adjacents)
+        : cut::BaseAdjacencyList(), m_Adj(std::move(Adjacents)), m_Idx(std::move(Offsets))
+    {
+        CUTAssert(!m_Idx.empty());
+        CUTAssert(m_Idx.front() == 0);
+        CUTAssert((size_t)m_Idx.back() == m_Adj.size());
+    }
+
+    /**
+     * @brief       Copy constructor.
+     * 
+     * @details     This constructor initializes an adjacency list as a
+     *              copy of the given one.
+     * 
+     * @param AL The list to copy.
+     */
+    CSRAdjacencyList(const cut::CSRAdjacencyList<IndexT, OffsetT>& AL)
+        : cut::BaseAdjacencyList(), m_Adj(AL.m_Adj), m_Idx(AL.m_Idx)
+    { }
+
+    /**
+     * @brief       Conversion constructor.
+     * 
+     * @details     This constructor initializes an adjacency list as a
+     *              copy of the given one, whatever its implementation.
+     * 
+     * @param AL The list to copy.
+     */
+    CSRAdjacencyList(const cut::BaseAdjacencyList& AL)
+        : cut::BaseAdjacencyList()
+    {
+        CopyFrom(AL);
+    }
+
+    /**
+     * @brief       Move constructor.
+     * 
+     * @details     This constructor initializes an adjacency list by moving
+     *              the memory from the given adjacency list.\n 
+     *              This constructor invalidates the input.
+     * 
+     * @param AL The adjacency list to move.
+     */
+    CSRAdjacencyList(cut::CSRAdjacencyList<IndexT, OffsetT>&& AL)
+        : cut::BaseAdjacencyList(), m_Adj(std::move(AL.m_Adj)), m_Idx(std::move(AL.m_Idx))
+    {
+        AL.m_Idx.assign(1, 0);
+    }
+
+    cut::CSRAdjacencyList<IndexT, OffsetT>& operator=(const cut::CSRAdjacencyList<IndexT, OffsetT>& AL)
+    {
+        m_Adj = AL.m_Adj;
+        m_Idx = AL.m_Idx;
+        return *this;
+    }
+
+    cut::CSRAdjacencyList<IndexT, OffsetT>& operator=(cut::CSRAdjacencyList<IndexT, OffsetT>&& AL)
+    {
+        m_Adj = std::move(AL.m_Adj);
+        m_Idx = std::move(AL.m_Idx);
+        AL.m_Idx.assign(1, 0);
+        return *this;
+    }
+
+    virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override
+    {
+        if (&AL != this)
+            CopyFrom(AL);
+        return *this;
+    }
+
+    virtual cut::BaseAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override
+    {
+        cut::CSRAdjacencyList<IndexT, OffsetT>* CSR;
+        CSR = dynamic_cast<cut::CSRAdjacencyList<IndexT, OffsetT>*>(&AL);
+        if (CSR != nullptr)
+            return *this = std::move(*CSR);
+        CopyFrom(AL);
+        return *this;
+    }
+
+    virtual ~CSRAdjacencyList() { }
+
+    virtual int NumNodes() const override { return (int)NodeCount(); }
+    virtual int NumConnections() const override { return (int)ConnectionCount(); }
+    virtual int NumAdjacents(int i) const override
+    {
+        CUTCheckGEQ(i, 0);
+        CUTCheckLess(i, NumNodes());
+
+        return (int)DegreeUnchecked((IndexT)i);
+    }
+    virtual int GetAdjacent(int i, int idx) const override
+    {
+        CUTCheckGEQ(i, 0);
+        CUTCheckLess(i, NumNodes());
+        CUTCheckGEQ(idx, 0);
+        CUTCheckLess((OffsetT)idx, DegreeUnchecked((IndexT)i));
+
+        return (int)m_Adj[m_Idx[i] + idx];
+    }
+    virtual cut::Span<int> Neighbors(int i) const override
+    {
+        // Adjacents stored as integers can be exposed directly
+        if (sizeof(IndexT) == sizeof(int))
+        {
+            CUTCheckGEQ(i, 0);
+            CUTCheckLess(i, NumNodes());
+
+            cut::Span<IndexT> R = RowUnchecked((IndexT)i);
+            return cut::Span<int>(reinterpret_cast<const int*>(R.Data()), R.Size());
+        }
+        return cut::BaseAdjacencyList::Neighbors(i);
+    }
+
+
+
+    /**
+     * @brief       Number of nodes of the list.
+     * 
+     * @details     This method returns the number of nodes composing
+     *              this adjacency list, without narrowing it to an integer.
+     * 
+     * @return size_t The number of nodes in the list.
+     */
+    size_t NodeCount() const { return m_Idx.size() - 1; }
+
+    /**
+     * @brief       Number of connections in the list.
+     * 
+     * @details     This method returns the total number of connections that
+     *              compose this adjacency list, without narrowing it to an integer.
+     * 
+     * @return size_t The number of connections in the list.
+     */
+    size_t ConnectionCount() const { return m_Adj.size(); }
+
+    /**
+     * @brief       Number of adjacents of node i.
+     * 
+     * @details     This method returns the number of connections going
+     *              out from node i.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NodeCount()</code>.
+     * 
+     * @param i The index of a node.
+     * @return OffsetT The number of connections in the node.
+     */
+    OffsetT Degree(IndexT i) const
+    {
+        CUTCheckLess((size_t)i, NodeCount());
+
+        return DegreeUnchecked(i);
+    }
+
+    /**
+     * @brief       Return an adjacent to node i.
+     * 
+     * @details     This method returns the adjacent in position
+     *              <code>idx</code> in the list of adjacents of node
+     *              <code>i</code>.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NodeCount()</code>.
+     * @throws cut::OutOfBoundError if <code>idx >= Degree(i)</code>.
+     * 
+     * @param i The index of a node.
+     * @param idx The index of an adjancent.
+     * @return IndexT The adjacent of the given node in the given position.
+     */
+    IndexT Adjacent(IndexT i, OffsetT idx) const
+    {
+        CUTCheckLess((size_t)i, NodeCount());
+        CUTCheckLess(idx, DegreeUnchecked(i));
+
+        return m_Adj[m_Idx[i] + idx];
+    }
+
+    /**
+     * @brief       Return the adjacents of node i.
+     * 
+     * @details     This method returns a read-only view over the list of
+     *              adjacents of node <code>i</code>, with their native type.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NodeCount()</code>.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<IndexT> The adjacents of the given node.
+     */
+    cut::Span<IndexT> Row(IndexT i) const
+    {
+        CUTCheckLess((size_t)i, NodeCount());
+
+        return RowUnchecked(i);
+    }
+
+    /**
+     * @brief       Number of adjacents of node i, without bound checks.
+     * 
+     * @details     Same as cut::CSRAdjacencyList::Degree(), but the input is never checked.
+     * 
+     * @param i The index of a node.
+     * @return OffsetT The number of connections in the node.
+     */
+    OffsetT DegreeUnchecked(IndexT i) const { return m_Idx[i + 1] - m_Idx[i]; }
+
+    /**
+     * @brief       Return an adjacent to node i, without bound checks.
+     * 
+     * @details     Same as cut::CSRAdjacencyList::Adjacent(), but the input is never checked.
+     * 
+     * @param i The index of a node.
+     * @param idx The index of an adjancent.
+     * @return IndexT The adjacent of the given node in the given position.
+     */
+    IndexT AdjacentUnchecked(IndexT i, OffsetT idx) const { return m_Adj[m_Idx[i] + idx]; }
+
+    /**
+     * @brief       Return the adjacents of node i, without bound checks.
+     * 
+     * @details     Same as cut::CSRAdjacencyList::Row(), but the input is never checked.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<IndexT> The adjacents of the given node.
+     */
+    cut::Span<IndexT> RowUnchecked(IndexT i) const
+    {
+        return cut::Span<IndexT>(m_Adj.data() + m_Idx[i], m_Idx[i + 1] - m_Idx[i]);
+    }
+
+    /**
+     * @brief       The raw array of the row offsets.
+     * 
+     * @details     This method returns the array of <code>NodeCount() + 1</code>
+     *              offsets delimiting the rows.
+     * 
+     * @return const OffsetT* The array of offsets.
+     */
+    const OffsetT* Offsets() const { return m_Idx.data(); }
+
+    /**
+     * @brief       The raw array of the connections.
+     * 
+     * @details     This method returns the array of <code>ConnectionCount()</code>
+     *              connections of all the rows.
+     * 
+     * @return const IndexT* The array of connections.
+     */
+    const IndexT* Adjacents() const { return m_Adj.data(); }
+};
+
+} // namespace cut
\ No newline at end of file
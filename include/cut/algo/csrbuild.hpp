@@ -0,0 +1,487 @@
+/**
+ * @file        csrbuild.hpp
+ * 
+ * @brief       Linear time construction of compressed sparse row arrays.
+ * 
+ * @details     This file contains the function template cut::BuildCSR(), which
+ *              builds the arrays of a compressed sparse row adjacency list from a
+ *              list of connections by means of a counting sort.\n 
+ *              The file also contains cut::BuildCSRParallel(), its multithreaded
+ *              counterpart.\n 
+ *              The functions are shared by cut::CompatAdjacencyList,
+ *              cut::CSRAdjacencyList and cut::WeightedAdjacencyList, hence all the
+ *              lists reject the same inputs in the same way.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-21
+ */
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <cut/excepts/status.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       Statistics about the construction of a compressed sparse row list.
+ * 
+ * @details     This structure reports the cost of a call to cut::BuildCSR().
+ */
+struct CSRBuildStats
+{
+    /**
+     * @brief       Peak memory allocated by the construction, in bytes.
+     * @details     Peak memory allocated by the construction, in bytes.
+     *              The input connections are not accounted.
+     */
+    size_t PeakMemory;
+
+    /**
+     * @brief       Number of duplicated connections that have been discarded.
+     * @details     Number of duplicated connections that have been discarded.
+     */
+    size_t NumDuplicates;
+
+    /**
+     * @brief       Number of rows that required sorting.
+     * @details     Number of rows that required sorting.
+     */
+    size_t NumSortedRows;
+};
+
+
+/**
+ * @brief       Sort and deduplicate the rows of a compressed sparse row list.
+ * 
+ * @details     This function sorts the adjacents of each row and removes the
+ *              duplicates, compacting the rows in place and updating the offsets.\n 
+ *              Rows that are already sorted are not sorted again.
+ * 
+ * @param Idx The array of offsets, with one element more than the nodes.
+ * @param Adj The array of adjacents.
+ * @return size_t The number of rows that required sorting.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam IdxAllocT The allocator of the offsets.
+ * @tparam AdjAllocT The allocator of the adjacents.
+ */
+template<typename IndexT, typename OffsetT, typename IdxAllocT, typename AdjAllocT>
+size_t SortAndUniqueRows(std::vector<OffsetT, IdxAllocT>& Idx,
+                         std::vector<IndexT, AdjAllocT>& Adj)
+{
+    size_t NNodes = Idx.size() - 1;
+    size_t NSorted = 0;
+    OffsetT Out = 0;
+    for (size_t i = 0; i < NNodes; ++i)
+    {
+        IndexT* Begin = Adj.data() + Idx[i];
+        IndexT* End = Adj.data() + Idx[i + 1];
+        if (!std::is_sorted(Begin, End))
+        {
+            std::sort(Begin, End);
+            NSorted++;
+        }
+        End = std::unique(Begin, End);
+        IndexT* Dst = Adj.data() + Out;
+        Idx[i] = Out;
+        Out += (OffsetT)(std::copy(Begin, End, Dst) - Dst);
+    }
+    Idx[NNodes] = Out;
+    Adj.resize((size_t)Out);
+    return NSorted;
+}
+
+/**
+ * @brief       Sort and deduplicate the rows, moving a value along with each adjacent.
+ * 
+ * @details     This function behaves as the overload without values, but the rows are
+ *              sorted by adjacent and then by value, and <code>Val</code> is permuted and
+ *              compacted along with <code>Adj</code>. Hence, among duplicated adjacents
+ *              the one with the smallest value is kept.\n 
+ *              Rows that are already sorted are not sorted again.
+ * 
+ * @param Idx The array of offsets, with one element more than the nodes.
+ * @param Adj The array of adjacents.
+ * @param Val The array of values, aligned with <code>Adj</code>.
+ * @return size_t The number of rows that required sorting.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam ValueT The type of the values, that must be less-than comparable.
+ * @tparam IdxAllocT The allocator of the offsets.
+ * @tparam AdjAllocT The allocator of the adjacents.
+ * @tparam ValAllocT The allocator of the values.
+ */
+template<typename IndexT, typename OffsetT, typename ValueT, typename IdxAllocT, typename AdjAllocT, typename ValAllocT>
+size_t SortAndUniqueRows(std::vector<OffsetT, IdxAllocT>& Idx,
+                         std::vector<IndexT, AdjAllocT>& Adj,
+                         std::vector<ValueT, ValAllocT>& Val)
+{
+    size_t NNodes = Idx.size() - 1;
+    size_t NSorted = 0;
+    OffsetT Out = 0;
+    std::vector<std::pair<IndexT, ValueT>> Row;
+    for (size_t i = 0; i < NNodes; ++i)
+    {
+        OffsetT Begin = Idx[i];
+        OffsetT End = Idx[i + 1];
+        bool Sorted = true;
+        for (OffsetT k = Begin + 1; Sorted && k < End; ++k)
+            Sorted = Adj[k - 1] < Adj[k] || (Adj[k - 1] == Adj[k] && !(Val[k] < Val[k - 1]));
+        if (!Sorted)
+        {
+            Row.clear();
+            for (OffsetT k = Begin; k < End; ++k)
+                Row.emplace_back(Adj[k], Val[k]);
+            std::sort(Row.begin(), Row.end());
+            for (OffsetT k = Begin; k < End; ++k)
+            {
+                Adj[k] = Row[k - Begin].first;
+                Val[k] = Row[k - Begin].second;
+            }
+            NSorted++;
+        }
+        Idx[i] = Out;
+        for (OffsetT k = Begin; k < End; ++k)
+        {
+            if (k > Begin && Adj[k] == Adj[Out - 1])
+                continue;
+            Adj[Out] = Adj[k];
+            Val[Out] = Val[k];
+            Out++;
+        }
+    }
+    Idx[NNodes] = Out;
+    Adj.resize((size_t)Out);
+    Val.resize((size_t)Out);
+    return NSorted;
+}
+
+
+/**
+ * @brief       Compute the offsets of a compressed sparse row list.
+ * 
+ * @details     This function validates the given connections and fills the offsets
+ *              of a compressed sparse row list, as the first phase of cut::BuildCSR().
+ *              The offsets are shifted two positions ahead: after the call,
+ *              <code>Idx[i + 1]</code> is the first position of row <code>i</code>, and
+ *              the scatter of the adjacents advances it to the end of the row.
+ * 
+ * @param Conns The array of connections.
+ * @param NConns The number of connections.
+ * @param Idx The output array of offsets, with two elements more than the nodes.
+ * @return size_t The number of nodes.
+ * 
+ * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam IdxAllocT The allocator of the offsets.
+ */
+template<typename IndexT, typename OffsetT, typename IdxAllocT>
+size_t CountCSROffsets(const std::pair<IndexT, IndexT>* Conns,
+                       size_t NConns,
+                       std::vector<OffsetT, IdxAllocT>& Idx)
+{
+    // Get the number of nodes. The indices are validated without branching out of the loop
+    size_t NNodes = 0;
+    cut::CheckStatus Status;
+    for (size_t i = 0; i < NConns; ++i)
+    {
+        CUTCheckGEQStatus(Conns[i].first, 0, Status);
+        CUTCheckGEQStatus(Conns[i].second, 0, Status);
+        NNodes = std::max(NNodes, (size_t)Conns[i].first + 1);
+    }
+    Status.Raise();
+
+    // Count the connections of each node two positions ahead, so that the
+    // prefix sum leaves in Idx[i + 1] the first free slot of row i
+    Idx.assign(NNodes + 2, 0);
+    for (size_t i = 0; i < NConns; ++i)
+        Idx[(size_t)Conns[i].first + 2]++;
+    for (size_t i = 2; i < NNodes + 2; ++i)
+        Idx[i] += Idx[i - 1];
+    return NNodes;
+}
+
+
+/**
+ * @brief       Build the arrays of a compressed sparse row list.
+ * 
+ * @details     This function fills the arrays of offsets and adjacents of a
+ *              compressed sparse row list from the given connections.\n 
+ *              For each connection, the first value identifies the node, while
+ *              the second value identifies the adjacent. The number of nodes is
+ *              the largest node index plus one.\n 
+ *              The construction is a counting sort: a pass counts the connections
+ *              of each node, a prefix sum produces the offsets, and a second pass
+ *              scatters the adjacents in their rows, preserving the input order.
+ *              No copy of the connections is ever made.\n 
+ *              If <code>SortAndUnique</code> is true, each row is sorted and its
+ *              duplicates are removed. Rows that are already sorted are not sorted
+ *              again, so presorted inputs are handled in linear time.
+ * 
+ * @param Conns The array of connections.
+ * @param NConns The number of connections.
+ * @param Idx The output array of offsets, with one element more than the nodes.
+ * @param Adj The output array of adjacents.
+ * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+ * @param Stats If not null, receives the statistics about the construction.
+ * 
+ * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam IdxAllocT The allocator of the offsets.
+ * @tparam AdjAllocT The allocator of the adjacents.
+ */
+template<typename IndexT, typename OffsetT, typename IdxAllocT, typename AdjAllocT>
+void BuildCSR(const std::pair<IndexT, IndexT>* Conns,
+              size_t NConns,
+              std::vector<OffsetT, IdxAllocT>& Idx,
+              std::vector<IndexT, AdjAllocT>& Adj,
+              bool SortAndUnique = true,
+              cut::CSRBuildStats* Stats = nullptr)
+{
+    size_t NNodes = cut::CountCSROffsets(Conns, NConns, Idx);
+
+    // Scatter. After this loop Idx[i + 1] is the end of row i
+    Adj.resize(NConns);
+    for (size_t i = 0; i < NConns; ++i)
+        Adj[Idx[(size_t)Conns[i].first + 1]++] = Conns[i].second;
+    Idx.pop_back();
+
+    size_t NSorted = 0;
+    if (SortAndUnique)
+        NSorted = cut::SortAndUniqueRows(Idx, Adj);
+
+    if (Stats != nullptr)
+    {
+        Stats->PeakMemory = (NNodes + 2) * sizeof(OffsetT) + NConns * sizeof(IndexT);
+        Stats->NumDuplicates = NConns - Adj.size();
+        Stats->NumSortedRows = NSorted;
+    }
+}
+
+/**
+ * @brief       Build the arrays of a compressed sparse row list with a value per connection.
+ * 
+ * @details     This function behaves as the overload without values, but it also
+ *              scatters <code>Values[k]</code> along with the adjacent of
+ *              <code>Conns[k]</code>, so that <code>Val</code> is aligned with
+ *              <code>Adj</code>. If <code>SortAndUnique</code> is true, among duplicated
+ *              connections the one with the smallest value is kept (see
+ *              cut::SortAndUniqueRows()).
+ * 
+ * @param Conns The array of connections.
+ * @param Values The value of each connection.
+ * @param NConns The number of connections.
+ * @param Idx The output array of offsets, with one element more than the nodes.
+ * @param Adj The output array of adjacents.
+ * @param Val The output array of values.
+ * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+ * @param Stats If not null, receives the statistics about the construction.
+ * 
+ * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam ValueT The type of the values.
+ * @tparam IdxAllocT The allocator of the offsets.
+ * @tparam AdjAllocT The allocator of the adjacents.
+ * @tparam ValAllocT The allocator of the values.
+ */
+template<typename IndexT, typename OffsetT, typename ValueT, typename IdxAllocT, typename AdjAllocT, typename ValAllocT>
+void BuildCSR(const std::pair<IndexT, IndexT>* Conns,
+              const ValueT* Values,
+              size_t NConns,
+              std::vector<OffsetT, IdxAllocT>& Idx,
+              std::vector<IndexT, AdjAllocT>& Adj,
+              std::vector<ValueT, ValAllocT>& Val,
+              bool SortAndUnique = true,
+              cut::CSRBuildStats* Stats = nullptr)
+{
+    size_t NNodes = cut::CountCSROffsets(Conns, NConns, Idx);
+
+    // Scatter the values through the same cursors as the adjacents
+    Adj.resize(NConns);
+    Val.resize(NConns);
+    for (size_t i = 0; i < NConns; ++i)
+    {
+        OffsetT Pos = Idx[(size_t)Conns[i].first + 1]++;
+        Adj[Pos] = Conns[i].second;
+        Val[Pos] = Values[i];
+    }
+    Idx.pop_back();
+
+    size_t NSorted = 0;
+    if (SortAndUnique)
+        NSorted = cut::SortAndUniqueRows(Idx, Adj, Val);
+
+    if (Stats != nullptr)
+    {
+        Stats->PeakMemory = (NNodes + 2) * sizeof(OffsetT) + NConns * (sizeof(IndexT) + sizeof(ValueT));
+        Stats->NumDuplicates = NConns - Adj.size();
+        Stats->NumSortedRows = NSorted;
+    }
+}
+
+/**
+ * @brief       Build the arrays of a compressed sparse row list in parallel.
+ * 
+ * @details     This function produces the same arrays as cut::BuildCSR() with
+ *              <code>SortAndUnique</code> set to true, but every phase is split
+ *              across <code>NumThreads</code> threads:
+ *              - the degrees are counted with relaxed atomic increments;
+ *              - the offsets are computed with cut::ParallelPrefixSum();
+ *              - the adjacents are scattered through per-row atomic cursors;
+ *              - the unsorted rows are sorted and all the rows are deduplicated, in
+ *                dynamically scheduled blocks;
+ *              - if duplicates were found, the rows are compacted in a new array.
+ * 
+ *              Since the scatter order is not deterministic, the rows are always
+ *              sorted, that makes the result independent of the schedule.
+ * 
+ * @param Conns The array of connections.
+ * @param NConns The number of connections.
+ * @param Idx The output array of offsets, with one element more than the nodes.
+ * @param Adj The output array of adjacents.
+ * @param Stats If not null, receives the statistics about the construction.
+ * @param NumThreads The number of threads (see cut::ResolveNumThreads()).
+ * 
+ * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+ * 
+ * @tparam IndexT The type of the node indices.
+ * @tparam OffsetT The type of the row offsets.
+ * @tparam IdxAllocT The allocator of the offsets.
+ * @tparam AdjAllocT The allocator of the adjacents.
+ */
+template<typename IndexT, typename OffsetT, typename IdxAllocT, typename AdjAllocT>
+void BuildCSRParallel(const std::pair<IndexT, IndexT>* Conns,
+                      size_t NConns,
+                      std::vector<OffsetT, IdxAllocT>& Idx,
+                      std::vector<IndexT, AdjAllocT>& Adj,
+                      cut::CSRBuildStats* Stats = nullptr,
+                      int NumThreads = -1)
+{
+    // Get the number of nodes
+    std::atomic<size_t> MaxNode(0);
+    cut::ParallelFor(0, NConns, [&](size_t b, size_t e)
+    {
+        size_t LocMax = 0;
+        cut::CheckStatus Status;
+        for (size_t i = b; i < e; ++i)
+        {
+            CUTCheckGEQStatus(Conns[i].first, 0, Status);
+            CUTCheckGEQStatus(Conns[i].second, 0, Status);
+            LocMax = std::max(LocMax, (size_t)Conns[i].first + 1);
+        }
+        Status.Raise();
+        size_t Cur = MaxNode.load();
+        while (Cur < LocMax && !MaxNode.compare_exchange_weak(Cur, LocMax)) { }
+    }, NumThreads);
+    size_t NNodes = MaxNode.load();
+
+    // Degree histogram
+    std::unique_ptr<std::atomic<OffsetT>[]> Cursor(new std::atomic<OffsetT>[NNodes + 1]);
+    cut::ParallelFor(0, NNodes + 1, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Cursor[i].store(0, std::memory_order_relaxed);
+    }, NumThreads);
+    cut::ParallelFor(0, NConns, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Cursor[(size_t)Conns[i].first].fetch_add(1, std::memory_order_relaxed);
+    }, NumThreads);
+
+    // Offsets
+    Idx.resize(NNodes + 1);
+    Idx[0] = 0;
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Idx[i + 1] = Cursor[i].load(std::memory_order_relaxed);
+    }, NumThreads);
+    cut::ParallelPrefixSum(Idx.data() + 1, NNodes, NumThreads);
+
+    // Scatter
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Cursor[i].store(Idx[i], std::memory_order_relaxed);
+    }, NumThreads);
+    Adj.resize(NConns);
+    cut::ParallelFor(0, NConns, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+        {
+            OffsetT Pos = Cursor[(size_t)Conns[i].first].fetch_add(1, std::memory_order_relaxed);
+            Adj[Pos] = Conns[i].second;
+        }
+    }, NumThreads);
+
+    // Sort and deduplicate the rows, saving the new lengths in the cursors
+    std::atomic<size_t> NSorted(0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        size_t LocSorted = 0;
+        for (size_t i = b; i < e; ++i)
+        {
+            IndexT* Begin = Adj.data() + Idx[i];
+            IndexT* End = Adj.data() + Idx[i + 1];
+            if (!std::is_sorted(Begin, End))
+            {
+                std::sort(Begin, End);
+                LocSorted++;
+            }
+            Cursor[i].store((OffsetT)(std::unique(Begin, End) - Begin), std::memory_order_relaxed);
+        }
+        NSorted.fetch_add(LocSorted);
+    }, NumThreads, 1024);
+
+    // Compact the rows only if some duplicate was found
+    size_t Peak = (NNodes + 1) * (2 * sizeof(OffsetT) + sizeof(std::atomic<OffsetT>)) + NConns * sizeof(IndexT);
+    std::vector<OffsetT, IdxAllocT> NewIdx(NNodes + 1, OffsetT(0), Idx.get_allocator());
+    NewIdx[0] = 0;
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            NewIdx[i + 1] = Cursor[i].load(std::memory_order_relaxed);
+    }, NumThreads);
+    cut::ParallelPrefixSum(NewIdx.data() + 1, NNodes, NumThreads);
+    Cursor.reset();
+    if ((size_t)NewIdx[NNodes] != NConns)
+    {
+        std::vector<IndexT, AdjAllocT> NewAdj(NewIdx[NNodes], IndexT(0), Adj.get_allocator());
+        Peak = std::max(Peak, 2 * (NNodes + 1) * sizeof(OffsetT) + (NConns + NewAdj.size()) * sizeof(IndexT));
+        cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+                std::copy(Adj.data() + Idx[i], Adj.data() + Idx[i] + (NewIdx[i + 1] - NewIdx[i]), NewAdj.data() + NewIdx[i]);
+        }, NumThreads);
+        Adj.swap(NewAdj);
+    }
+    Idx.swap(NewIdx);
+
+    if (Stats != nullptr)
+    {
+        Stats->PeakMemory = Peak;
+        Stats->NumDuplicates = NConns - Adj.size();
+        Stats->NumSortedRows = NSorted.load();
+    }
+}
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,354 @@
+/**
+ * @file        dadjlist.hpp
+ * 
+ * @brief       A compact adjacency list supporting incremental updates.
+ * 
+ * @details     This file contains the declaration of the class cut::DynamicAdjacencyList,
+ *              which layers per-node buffers of insertions and deletions over a compressed
+ *              sparse row list, and merges them in batches.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-10
+ */
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/span.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A compact adjacency list supporting incremental updates.
+ * 
+ * @details     The class cut::DynamicAdjacencyList stores an adjacency list as the arrays
+ *              of a cut::CompatAdjacencyList, with sorted rows and no duplicates, plus a
+ *              delta for each modified node: the sorted adjacents added to its row and the
+ *              sorted adjacents removed from it.\n 
+ *              The insertions and the deletions only touch the deltas, and cost time linear
+ *              in the size of the delta of the node plus logarithmic in the size of its row.
+ *              The readers see the merged rows: <code>Neighbors()</code> returns the row of
+ *              the compact arrays directly if the node has no delta, and merges it into a
+ *              per-thread buffer otherwise, while ForEachAdjacent() visits the merged row
+ *              without copying it. <code>GetAdjacent()</code> never builds the merged row:
+ *              on a modified node it costs time logarithmic in the sizes of the row and of
+ *              the delta, so a loop over the row stays cheap.\n 
+ *              When the size of all the deltas reaches the merge threshold, or when Merge()
+ *              is called, the deltas are compacted into fresh arrays in a single parallel
+ *              pass, with the number of threads given by cut::GetNumThreads().\n 
+ *              The rows keep the semantic of a set: adding an adjacent already in the row,
+ *              or removing one that is not, has no effect. The number of nodes grows to
+ *              include the largest node that received an adjacent.\n 
+ *              Concurrent reads are safe, but the list must not be modified concurrently.
+ */
+class DynamicAdjacencyList : public cut::BaseAdjacencyList
+{
+private:
+    /**
+     * @brief       The pending changes to a row.
+     * @details     The adjacents added to a row and the adjacents removed from it,
+     *              both sorted. The added ones are not in the compact row, the removed
+     *              ones are.
+     */
+    struct Delta
+    {
+        std::vector<int> Added;
+        std::vector<int> Removed;
+    };
+
+    /**
+     * @brief       The compact rows.
+     * @details     The compact rows, sorted and without duplicates.
+     */
+    cut::CompatAdjacencyList::ArrayType m_Adj;
+
+    /**
+     * @brief       The starting index of each compact row.
+     * @details     The starting index of each compact row.
+     */
+    cut::CompatAdjacencyList::ArrayType m_Idx;
+
+    /**
+     * @brief       The pending changes of the modified nodes.
+     * @details     The pending changes of the modified nodes.
+     */
+    std::unordered_map<int, Delta> m_Deltas;
+
+    int m_NNodes;
+    int m_NConnections;
+    size_t m_NPending;
+    size_t m_MergeThreshold;
+    size_t m_NMerges;
+
+    /**
+     * @brief       Replace the content of this list.
+     * 
+     * @details     This method replaces the content of this list with the compact
+     *              rows of the given one, sorted and without duplicates.
+     * 
+     * @param AL The list to copy.
+     */
+    void Load(const cut::BaseAdjacencyList& AL);
+
+    /**
+     * @brief       The pending changes of node i.
+     * @details     The pending changes of node i, or null if it has none.
+     */
+    const Delta* DeltaOf(int i) const;
+
+    /**
+     * @brief       The compact row of node i.
+     * @details     The compact row of node i, empty if the node was added after the last merge.
+     */
+    cut::Span<int> CompactRow(int i) const;
+
+    bool Insert(int i, int j);
+    bool Erase(int i, int j);
+
+    /**
+     * @brief       Merge the deltas if they are too large.
+     * @details     Call Merge() if the size of the deltas reached the merge threshold.
+     */
+    void MergeIfNeeded();
+
+public:
+    /**
+     * @brief       The smallest automatic merge threshold.
+     * 
+     * @details     If no merge threshold is given, the deltas are merged when their
+     *              size reaches one eighth of the compact connections, but not before
+     *              they reach this size.
+     */
+    static const size_t MinMergeThreshold = 1024;
+
+    /**
+     * @brief       Construct an empty list.
+     * 
+     * @details     This constructor initializes a list with no nodes.
+     * 
+     * @param MergeThreshold The size of the deltas that triggers a merge, 0 for automatic.
+     */
+    explicit DynamicAdjacencyList(size_t MergeThreshold = 0);
+
+    /**
+     * @brief       Construct a new DynamicAdjacencyList from a list of connections.
+     * 
+     * @details     This constructor builds the compact rows of the given connections,
+     *              sorted and without duplicates (see cut::BuildCSR()).
+     * 
+     * @param Connections A list of connections.
+     * @param MergeThreshold The size of the deltas that triggers a merge, 0 for automatic.
+     */
+    DynamicAdjacencyList(const std::vector<std::pair<int, int>>& Connections,
+                         size_t MergeThreshold = 0);
+
+    /**
+     * @brief       Copy constructor.
+     * 
+     * @details     This constructor initializes a copy of the given list. If the given
+     *              list is dynamic, its deltas are copied, otherwise its rows are read
+     *              through the abstract interface, sorted and deduplicated.
+     * 
+     * @param AL The list to copy.
+     */
+    DynamicAdjacencyList(const cut::BaseAdjacencyList& AL);
+
+    DynamicAdjacencyList(const cut::DynamicAdjacencyList& AL);
+
+    /**
+     * @brief       Move constructor.
+     * 
+     * @details     This constructor initializes a list by moving the memory
+     *              of the given one. The input is left empty.
+     * 
+     * @param AL The list to move.
+     */
+    DynamicAdjacencyList(cut::DynamicAdjacencyList&& AL);
+
+    virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override;
+    virtual cut::DynamicAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override;
+    cut::DynamicAdjacencyList& operator=(const cut::DynamicAdjacencyList& AL);
+    cut::DynamicAdjacencyList& operator=(cut::DynamicAdjacencyList&& AL);
+    virtual ~DynamicAdjacencyList();
+
+    virtual int NumNodes() const override;
+    virtual int NumConnections() const override;
+    virtual int NumAdjacents(int i) const override;
+    virtual int GetAdjacent(int i, int idx) const override;
+    virtual cut::Span<int> Neighbors(int i) const override;
+
+    /**
+     * @brief       Visit the adjacents of node i.
+     * 
+     * @details     This method calls <code>Body(j)</code> for each adjacent <code>j</code>
+     *              of node <code>i</code>, in increasing order, merging the compact row
+     *              with the delta of the node while visiting it.\n 
+     *              Differently from <code>Neighbors()</code>, the row is never copied.
+     * 
+     * @param i The index of a node.
+     * @param Body The function to call on each adjacent.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     */
+    template<typename FuncT>
+    void ForEachAdjacent(int i, FuncT&& Body) const;
+
+    /**
+     * @brief       Determine whether or not a connection exists.
+     * 
+     * @details     Determine whether or not <code>j</code> is an adjacent of <code>i</code>.
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If <code>j</code> is an adjacent of <code>i</code>.
+     * @return false Otherwise.
+     */
+    bool HasConnection(int i, int j) const;
+
+    /**
+     * @brief       Add a connection.
+     * 
+     * @details     This method adds <code>j</code> to the adjacents of <code>i</code>, and
+     *              merges the deltas if they reached the merge threshold.
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If the connection was added.
+     * @return false If the connection already existed.
+     * 
+     * @throws cut::OutOfBoundError if <code>i < 0</code> or <code>j < 0</code>.
+     */
+    bool AddConnection(int i, int j);
+
+    /**
+     * @brief       Remove a connection.
+     * 
+     * @details     This method removes <code>j</code> from the adjacents of <code>i</code>,
+     *              and merges the deltas if they reached the merge threshold.
+     * 
+     * @param i The index of a node.
+     * @param j The index of the adjacent.
+     * @return true If the connection was removed.
+     * @return false If the connection did not exist.
+     * 
+     * @throws cut::OutOfBoundError if <code>i < 0</code> or <code>j < 0</code>.
+     */
+    bool RemoveConnection(int i, int j);
+
+    /**
+     * @brief       Add a batch of connections.
+     * 
+     * @details     This method adds all the given connections, and then merges the
+     *              deltas once if they reached the merge threshold.\n 
+     *              The batch is sorted, and the connections of each node are merged with
+     *              its delta in a single linear pass, so that many edits of the same node
+     *              do not cost one shift of the delta each.
+     * 
+     * @param Connections A list of connections.
+     * @return size_t The number of connections that were added.
+     * 
+     * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+     */
+    size_t AddConnections(const std::vector<std::pair<int, int>>& Connections);
+
+    /**
+     * @brief       Remove a batch of connections.
+     * 
+     * @details     This method removes all the given connections, and then merges the
+     *              deltas once if they reached the merge threshold.\n 
+     *              As in AddConnections(), the connections of each node are merged with
+     *              its delta in a single linear pass.
+     * 
+     * @param Connections A list of connections.
+     * @return size_t The number of connections that were removed.
+     * 
+     * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+     */
+    size_t RemoveConnections(const std::vector<std::pair<int, int>>& Connections);
+
+    /**
+     * @brief       Merge the deltas into the compact rows.
+     * 
+     * @details     This method builds new compact arrays from the merged rows, and
+     *              clears the deltas. The rows are merged in parallel.
+     */
+    void Merge();
+
+    /**
+     * @brief       The size of the deltas.
+     * @details     The number of added and removed adjacents waiting for a merge.
+     * 
+     * @return size_t The size of the deltas.
+     */
+    size_t NumPendingEdits() const;
+
+    /**
+     * @brief       The merge threshold.
+     * @details     The size of the deltas that triggers a merge, 0 for automatic.
+     * 
+     * @return size_t The merge threshold.
+     */
+    size_t MergeThreshold() const;
+
+    /**
+     * @brief       Set the merge threshold.
+     * 
+     * @details     Set the size of the deltas that triggers a merge, 0 for automatic
+     *              (see cut::DynamicAdjacencyList::MinMergeThreshold).
+     * 
+     * @param Threshold The merge threshold.
+     */
+    void SetMergeThreshold(size_t Threshold);
+
+    /**
+     * @brief       The number of merges.
+     * @details     The number of merges since the list was built.
+     * 
+     * @return size_t The number of merges.
+     */
+    size_t NumMerges() const;
+};
+
+
+template<typename FuncT>
+void DynamicAdjacencyList::ForEachAdjacent(int i, FuncT&& Body) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    cut::Span<int> Row = CompactRow(i);
+    const Delta* D = DeltaOf(i);
+    if (D == nullptr)
+    {
+        for (int j : Row)
+            Body(j);
+        return;
+    }
+
+    // Merge the sorted row skipping the removed adjacents with the sorted added ones
+    const int* Add = D->Added.data();
+    const int* AddEnd = Add + D->Added.size();
+    const int* Rem = D->Removed.data();
+    const int* RemEnd = Rem + D->Removed.size();
+    for (int j : Row)
+    {
+        while (Add != AddEnd && *Add < j)
+            Body(*Add++);
+        if (Rem != RemEnd && *Rem == j)
+        {
+            ++Rem;
+            continue;
+        }
+        Body(j);
+    }
+    while (Add != AddEnd)
+        Body(*Add++);
+}
+
+} // namespace cut
\ No newline at end of file
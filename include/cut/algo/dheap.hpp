@@ -0,0 +1,488 @@
+/**
+ * @file        dheap.hpp
+ * 
+ * @brief       A templated d-ary indexed heap.
+ * 
+ * @details     This file contains the declaration and the implementation of the
+ *              class template cut::IndexedHeap, an indexed priority queue whose
+ *              arity, ordering, key type and element type are chosen at compile time.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-27
+ */
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cut/excepts/excepts.hpp>
+#include <cut/memory/aligned.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A d-ary indexed heap with compile-time parameters.
+ * 
+ * @details     The class cut::IndexedHeap provides the same interface of cut::MinHeap,
+ *              mapping integer elements to keys, but all its parameters are fixed at
+ *              compile time:
+ *              - <code>Arity</code> is the number of children of each node. With arity
+ *                4 or 8 the tree is shallower and the children of a node are contiguous.
+ *                The nodes are aligned to the cache lines and the root is padded, so that
+ *                the children of each node start at a multiple of <code>Arity</code>:
+ *                when <code>Arity * sizeof(Node)</code> divides the cache line, a sift
+ *                down touches one cache line per level;
+ *              - <code>Compare</code> is the ordering, a min-heap with <code>std::less</code>
+ *                (default) or a max-heap with <code>std::greater</code>, resolved without
+ *                any runtime sign;
+ *              - <code>KeyT</code> and <code>IndexT</code> are the types of keys and
+ *                elements, stored interleaved. With <code>float</code> and <code>uint32_t</code>
+ *                a node takes 8 bytes, against the 16 bytes of cut::MinHeap.
+ * 
+ *              Elements are in the range <code>[0, std::numeric_limits<IndexT>::max())</code>.
+ * 
+ * @tparam KeyT The type of the keys.
+ * @tparam IndexT The unsigned integer type of the elements.
+ * @tparam Arity The number of children of each node, at least 2.
+ * @tparam Compare The ordering of the keys: the top of the heap is the element whose
+ *                 key compares before all the others.
+ */
+template<typename KeyT = double,
+         typename IndexT = uint32_t,
+         size_t Arity = 4,
+         typename Compare = std::less<KeyT>>
+class IndexedHeap
+{
+    static_assert(Arity >= 2, "The arity of a heap must be at least 2.");
+    static_assert(std::numeric_limits<IndexT>::is_integer && !std::numeric_limits<IndexT>::is_signed,
+                  "The elements of a heap must be of an unsigned integer type.");
+
+public:
+    /**
+     * @brief       The type of the keys.
+     * @details     The type of the keys.
+     */
+    typedef KeyT KeyType;
+
+    /**
+     * @brief       The type of the elements.
+     * @details     The type of the elements.
+     */
+    typedef IndexT IndexType;
+
+    /**
+     * @brief       A node of the heap.
+     * @details     A node of the heap, storing an element and its key side by side.
+     */
+    struct Node
+    {
+        KeyT Key;
+        IndexT Element;
+    };
+
+private:
+    /**
+     * @brief       The number of unused nodes before the root.
+     * @details     The number of unused nodes before the root, so that the children
+     *              of each node start at a multiple of <code>Arity</code>.
+     */
+    static constexpr size_t Pad = Arity - 1;
+
+    /**
+     * @brief       Heap nodes, in the order of the heap tree.
+     * @details     Heap nodes, in the order of the heap tree, after <code>Pad</code>
+     *              unused nodes. The root is in position <code>Pad</code>, and the
+     *              children of the node in position <code>v</code> are in the
+     *              positions from <code>Arity * (v - Pad + 1)</code> to
+     *              <code>Arity * (v - Pad + 1) + Arity - 1</code>.
+     */
+    std::vector<Node, cut::AlignedAllocator<Node>> m_Nodes;
+
+    /**
+     * @brief       The position of each element in the heap tree.
+     * @details     The position of each element in the heap tree, or
+     *              <code>NotInHeap</code> for the elements that are not in the heap.
+     */
+    std::vector<IndexT> m_Perm;
+
+    /**
+     * @brief       The ordering of the keys.
+     * @details     The ordering of the keys.
+     */
+    Compare m_Less;
+
+    /**
+     * @brief       Position of the elements that are not in the heap.
+     * @details     Position of the elements that are not in the heap.
+     */
+    static constexpr IndexT NotInHeap = std::numeric_limits<IndexT>::max();
+
+
+    void MoveUp(size_t v)
+    {
+        Node N = m_Nodes[v];
+        while (v != Pad)
+        {
+            size_t p = v / Arity + Pad - 1;
+            if (!m_Less(N.Key, m_Nodes[p].Key))
+                break;
+            // Move the parent down, the node is written once at the end
+            m_Nodes[v] = m_Nodes[p];
+            m_Perm[m_Nodes[v].Element] = (IndexT)v;
+            v = p;
+        }
+        m_Nodes[v] = N;
+        m_Perm[N.Element] = (IndexT)v;
+    }
+
+    void MoveDown(size_t v)
+    {
+        Node N = m_Nodes[v];
+        size_t Size = m_Nodes.size();
+        while (true)
+        {
+            size_t First = Arity * (v - Pad + 1);
+            if (First >= Size)
+                break;
+            // Pick the best child, the children are contiguous
+            size_t Last = std::min(First + Arity, Size);
+            size_t u = First;
+            for (size_t c = First + 1; c < Last; ++c)
+            {
+                if (m_Less(m_Nodes[c].Key, m_Nodes[u].Key))
+                    u = c;
+            }
+            if (!m_Less(m_Nodes[u].Key, N.Key))
+                break;
+            m_Nodes[v] = m_Nodes[u];
+            m_Perm[m_Nodes[v].Element] = (IndexT)v;
+            v = u;
+        }
+        m_Nodes[v] = N;
+        m_Perm[N.Element] = (IndexT)v;
+    }
+
+    void Heapify(const KeyT* Keys, size_t NumKeys)
+    {
+        CUTCheckLEQ(NumKeys, (size_t)NotInHeap);
+        m_Nodes.resize(Pad + NumKeys);
+        m_Perm.resize(NumKeys);
+        for (size_t i = 0; i < NumKeys; ++i)
+        {
+            m_Nodes[Pad + i].Key = Keys[i];
+            m_Nodes[Pad + i].Element = (IndexT)i;
+            m_Perm[i] = (IndexT)(Pad + i);
+        }
+        // Floyd's construction, from the last internal node to the root
+        if (NumKeys > 1)
+        {
+            for (size_t v = (NumKeys - 2) / Arity + 1; v > 0; --v)
+                MoveDown(Pad + v - 1);
+        }
+    }
+
+public:
+    /**
+     * @brief       Create a new empty heap.
+     * 
+     * @details     This constructor creates a new empty heap, to be filled
+     *              with cut::IndexedHeap::Push().
+     * 
+     * @param Less The ordering of the keys.
+     */
+    explicit IndexedHeap(const Compare& Less = Compare())
+        : m_Nodes(Pad), m_Less(Less)
+    { }
+
+    /**
+     * @brief       Create a new heap from the vector of keys.
+     * 
+     * @details     This constructor creates a new heap, associating the key
+     *              <code>Keys[i]</code> to the element <code>i</code>, in linear time.
+     * 
+     * @param Keys The vector of keys.
+     * @param Less The ordering of the keys.
+     */
+    explicit IndexedHeap(const std::vector<KeyT>& Keys,
+                         const Compare& Less = Compare())
+        : m_Nodes(Pad), m_Less(Less)
+    {
+        Heapify(Keys.data(), Keys.size());
+    }
+
+    /**
+     * @brief       Create a new heap from the array of keys.
+     * 
+     * @details     This constructor creates a new heap, associating the key
+     *              <code>Keys[i]</code> to the element <code>i</code>, in linear time.
+     * 
+     * @param Keys The array of keys.
+     * @param NumKeys The number of keys in the array.
+     * @param Less The ordering of the keys.
+     */
+    IndexedHeap(const KeyT* const Keys,
+                size_t NumKeys,
+                const Compare& Less = Compare())
+        : m_Nodes(Pad), m_Less(Less)
+    {
+        CUTCheckNull(Keys);
+        Heapify(Keys, NumKeys);
+    }
+
+
+    /**
+     * @brief       Returns the number of elements in the heap.
+     * @details     Returns the number of elements in the heap.
+     * 
+     * @return size_t The heap's size.
+     */
+    size_t Size() const { return m_Nodes.size() - Pad; }
+
+    /**
+     * @brief       Checks whether the heap is empty.
+     * @details     Checks whether the heap is empty.
+     * 
+     * @return bool Whether or not the heap is empty.
+     */
+    bool Empty() const { return Size() == 0; }
+
+    /**
+     * @brief       Checks whether an element is in the heap.
+     * @details     Checks whether an element is in the heap.
+     * 
+     * @param Element An element.
+     * @return bool Whether or not the element is in the heap.
+     */
+    bool Contains(size_t Element) const
+    {
+        return Element < m_Perm.size() && m_Perm[Element] != NotInHeap;
+    }
+
+    /**
+     * @brief       Returns the top element.
+     * 
+     * @details     This method returns the element whose key compares before
+     *              all the others, with its key.
+     * 
+     * @return std::pair<KeyT, IndexT> The key-value pair on top of the heap.
+     * 
+     * @throws cut::OutOfBoundError if the heap is empty.
+     */
+    std::pair<KeyT, IndexT> FindMin() const
+    {
+        CUTCheckGreater(Size(), (size_t)0);
+
+        return FindMinUnchecked();
+    }
+
+    /**
+     * @brief       Returns the top element, without bound checks.
+     * 
+     * @details     This method returns the top element as cut::IndexedHeap::FindMin(),
+     *              but it never checks that the heap is not empty.
+     * 
+     * @warning     Calling this method on an empty heap is undefined behavior.
+     * 
+     * @return std::pair<KeyT, IndexT> The key-value pair on top of the heap.
+     */
+    std::pair<KeyT, IndexT> FindMinUnchecked() const
+    {
+        return { m_Nodes[Pad].Key, m_Nodes[Pad].Element };
+    }
+
+    /**
+     * @brief       Returns the key of the element.
+     * 
+     * @details     This method returns the key associated to the given element.
+     * 
+     * @param Element An element of the heap.
+     * @return KeyT The key of the element.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    KeyT GetKey(size_t Element) const
+    {
+        CUTCheckLess(Element, m_Perm.size());
+        CUTAssert(Contains(Element));
+
+        return GetKeyUnchecked(Element);
+    }
+
+    /**
+     * @brief       Returns the key of the element, without bound checks.
+     * 
+     * @details     This method returns the key associated to the given element,
+     *              as cut::IndexedHeap::GetKey(), but it never checks its input.
+     * 
+     * @warning     Calling this method with an element that is not in the heap
+     *              is undefined behavior.
+     * 
+     * @param Element An element of the heap.
+     * @return KeyT The key of the element.
+     */
+    KeyT GetKeyUnchecked(size_t Element) const
+    {
+        return m_Nodes[m_Perm[Element]].Key;
+    }
+
+    /**
+     * @brief       Set the key of the element to a given value.
+     * 
+     * @details     This method updates the key associated to the given element
+     *              with the given value, and then restores the heap.
+     * 
+     * @param Element The element whose key must be modified.
+     * @param NewKey The new value of the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    void SetKey(size_t Element,
+                KeyT NewKey)
+    {
+        CUTCheckLess(Element, m_Perm.size());
+        CUTAssert(Contains(Element));
+
+        size_t v = m_Perm[Element];
+        KeyT OldKey = m_Nodes[v].Key;
+        m_Nodes[v].Key = NewKey;
+        if (m_Less(NewKey, OldKey))
+            MoveUp(v);
+        else if (m_Less(OldKey, NewKey))
+            MoveDown(v);
+    }
+
+    /**
+     * @brief       Decreases the key of the element by the given value.
+     * 
+     * @details     This method subtracts the given value from the key associated
+     *              with the given element, and then restores the heap.\n 
+     *              This operation is a decrement independently of the ordering.
+     * 
+     * @param Element The element whose key must be decremented.
+     * @param Decrement The decrement to operate on the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    void DecreaseKey(size_t Element,
+                     KeyT Decrement)
+    {
+        SetKey(Element, GetKey(Element) - Decrement);
+    }
+
+    /**
+     * @brief       Increases the key of the element by the given value.
+     * 
+     * @details     This method adds the given value to the key associated
+     *              with the given element, and then restores the heap.\n 
+     *              This operation is an increment independently of the ordering.
+     * 
+     * @param Element The element whose key must be incremented.
+     * @param Increment The increment to operate on the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    void IncreaseKey(size_t Element,
+                     KeyT Increment)
+    {
+        SetKey(Element, GetKey(Element) + Increment);
+    }
+
+    /**
+     * @brief       Removes and returns the top element.
+     * 
+     * @details     This method removes from the heap the element whose key
+     *              compares before all the others, and returns it with its key.
+     * 
+     * @return std::pair<KeyT, IndexT> The key-value pair removed from the heap.
+     * 
+     * @throws cut::OutOfBoundError if the heap is empty.
+     */
+    std::pair<KeyT, IndexT> ExtractMin()
+    {
+        CUTCheckGreater(Size(), (size_t)0);
+
+        std::pair<KeyT, IndexT> Min = FindMinUnchecked();
+        m_Perm[Min.second] = NotInHeap;
+        Node Back = m_Nodes.back();
+        m_Nodes.pop_back();
+        if (!Empty())
+        {
+            m_Nodes[Pad] = Back;
+            MoveDown(Pad);
+        }
+        return Min;
+    }
+
+    /**
+     * @brief       Adds an element to the heap.
+     * 
+     * @details     This method adds the given element to the heap, associating
+     *              it to the given key, and then restores the heap.
+     * 
+     * @param Element The element to add.
+     * @param Key The key of the element.
+     * 
+     * @throws cut::OutOfBoundError if Element does not fit IndexT.
+     * @throws cut::AssertionError if Element is already in the heap.
+     */
+    void Push(size_t Element,
+              KeyT Key)
+    {
+        CUTCheckLess(Element, (size_t)NotInHeap);
+        if (Element >= m_Perm.size())
+            m_Perm.resize(Element + 1, NotInHeap);
+        CUTAssert(!Contains(Element));
+
+        m_Nodes.push_back({ Key, (IndexT)Element });
+        MoveUp(m_Nodes.size() - 1);
+    }
+
+    /**
+     * @brief       Removes all the elements from the heap.
+     * 
+     * @details     This method empties the heap, in time proportional to the
+     *              number of elements it contains, keeping the memory.
+     */
+    void Clear()
+    {
+        for (size_t v = Pad; v < m_Nodes.size(); ++v)
+            m_Perm[m_Nodes[v].Element] = NotInHeap;
+        m_Nodes.resize(Pad);
+    }
+
+    /**
+     * @brief       Reserves the memory for the given number of elements.
+     * 
+     * @details     This method allocates the memory for the elements from
+     *              0 to <code>NumElements - 1</code>, so that pushing them
+     *              does not allocate.
+     * 
+     * @param NumElements The number of elements.
+     */
+    void Reserve(size_t NumElements)
+    {
+        m_Nodes.reserve(Pad + NumElements);
+        if (NumElements > m_Perm.size())
+            m_Perm.resize(NumElements, NotInHeap);
+    }
+};
+
+template<typename KeyT, typename IndexT, size_t Arity, typename Compare>
+constexpr size_t IndexedHeap<KeyT, IndexT, Arity, Compare>::Pad;
+
+template<typename KeyT, typename IndexT, size_t Arity, typename Compare>
+constexpr IndexT IndexedHeap<KeyT, IndexT, Arity, Compare>::NotInHeap;
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,532 @@
+/**
+ * @file        graph.hpp
+ * 
+ * @brief       Traversal and shortest path algorithms on adjacency lists.
+ * 
+ * @details     This file contains the class cut::GraphSearch, which implements
+ *              breadth-first search and single source shortest paths on top of
+ *              the interface cut::BaseAdjacencyList, and the weight functors
+ *              used by the shortest path algorithms.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-29
+ */
+#pragma once
+
+#include <vector>
+#include <map>
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/minheap.hpp>
+#include <cut/algo/span.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/parallel/multiqueue.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <cut/excepts/status.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       Unit weights for the shortest path algorithms.
+ * 
+ * @details     This functor assigns weight 1 to every connection.\n 
+ *              A weight functor is called as <code>W(i, idx)</code> and returns the
+ *              weight of the connection in position <code>idx</code> of the adjacents
+ *              of node <code>i</code>.
+ */
+struct UnitWeight
+{
+    double operator()(int, int) const { return 1.0; }
+};
+
+
+/**
+ * @brief       Traversal and shortest path algorithms.
+ * 
+ * @details     The class cut::GraphSearch implements:
+ *              - a parallel direction-optimizing breadth-first search;
+ *              - a sequential Dijkstra's algorithm on cut::MinHeap;
+ *              - a parallel delta-stepping single source shortest path;
+ *              - a parallel label-correcting Dijkstra's algorithm on cut::MultiQueue.
+ * 
+ *              All the algorithms read the graph through <code>Neighbors()</code>,
+ *              hence they work on any cut::BaseAdjacencyList, and they are fastest
+ *              on the compressed ones.\n 
+ *              The object owns all the scratch memory used by the algorithms,
+ *              including the per-block buffers of the parallel ones. Reusing the same
+ *              object for many queries on graphs of similar size avoids any allocation
+ *              after the first query.\n 
+ *              The number of threads of the parallel algorithms is given by
+ *              cut::GetNumThreads(). A single object must not run two queries at the
+ *              same time.
+ * 
+ * @warning     All the adjacents must be nodes of the graph, that is in the range
+ *              <code>[0, NumNodes())</code>.
+ */
+class GraphSearch
+{
+private:
+    /**
+     * @brief       The visited depths of the current breadth-first search.
+     * @details     The visited depths of the current breadth-first search.
+     */
+    std::unique_ptr<std::atomic<int>[]> m_Depth;
+
+    /**
+     * @brief       The tentative distances of the current delta-stepping query.
+     * @details     The tentative distances of the current delta-stepping query.
+     */
+    std::unique_ptr<std::atomic<double>[]> m_Dist;
+
+    /**
+     * @brief       The capacity of the per-node scratch arrays.
+     * @details     The capacity of the per-node scratch arrays.
+     */
+    size_t m_DepthCap;
+
+    /**
+     * @brief       The capacity of the tentative distances.
+     * @details     The capacity of the tentative distances.
+     */
+    size_t m_DistCap;
+
+    /**
+     * @brief       The current and next frontier.
+     * @details     The current and next frontier.
+     */
+    std::vector<int> m_Frontier, m_Next;
+
+    /**
+     * @brief       Per-block output buffers of the parallel loops.
+     * @details     Per-block output buffers of the parallel loops.
+     */
+    std::vector<std::vector<int>> m_Blocks;
+
+    /**
+     * @brief       Per-node marks of the delta-stepping.
+     * @details     Per-node marks of the delta-stepping.
+     */
+    std::vector<char> m_Mark;
+
+    /**
+     * @brief       The buckets of the delta-stepping.
+     * 
+     * @details     The non-empty buckets of the delta-stepping, by their index. Only
+     *              the buckets holding some node are stored, hence the memory does not
+     *              depend on the largest distance over <code>Delta</code>.
+     */
+    std::map<uint64_t, std::vector<int>> m_Buckets;
+
+    /**
+     * @brief       The memory of the buckets already processed.
+     * @details     The memory of the buckets already processed, reused by the next ones.
+     */
+    std::vector<std::vector<int>> m_SpareBuckets;
+
+    /**
+     * @brief       The heap of Dijkstra's algorithm.
+     * @details     The heap of Dijkstra's algorithm.
+     */
+    cut::MinHeap m_Heap;
+
+    /**
+     * @brief       The relaxed queue of the parallel Dijkstra's algorithm.
+     * @details     The relaxed queue of the parallel Dijkstra's algorithm.
+     */
+    std::unique_ptr<cut::MultiQueue> m_Queue;
+
+    /**
+     * @brief       The number of nodes processed by each block of the parallel loops.
+     * @details     The number of nodes processed by each block of the parallel loops.
+     */
+    static const size_t BlockSize = 1024;
+
+    /**
+     * @brief       The number of heaps of the relaxed queue for each thread.
+     * @details     The number of heaps of the relaxed queue for each thread.
+     */
+    static const int QueuesPerThread = 2;
+
+    void PrepareBlocks(size_t N);
+    void GatherBlocks(std::vector<int>& Out);
+
+    // Lower the tentative distance of v, return true if it decreased
+    static bool RelaxTo(std::atomic<double>& Dist, double NewDist)
+    {
+        double Cur = Dist.load(std::memory_order_relaxed);
+        while (NewDist < Cur)
+        {
+            if (Dist.compare_exchange_weak(Cur, NewDist, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    template<typename WeightFn>
+    void RelaxBlocks(const cut::BaseAdjacencyList& G, const std::vector<int>& Nodes,
+                     WeightFn& W, double Delta, bool Light);
+
+    void PushBucket(int v, double Delta);
+    void ReleaseBuckets();
+    static uint64_t BucketOf(double Dist, double Delta);
+    void ResetDistances(size_t NNodes);
+    void GatherDistances(std::vector<double>& Dist, size_t NNodes);
+
+public:
+    /**
+     * @brief       The depth of the unreachable nodes.
+     * @details     The depth of the nodes not reached by a breadth-first search.
+     */
+    static const int Unreached = -1;
+
+    /**
+     * @brief       Construct a new search object.
+     * @details     Construct a new search object, with no scratch memory.
+     */
+    GraphSearch();
+
+    GraphSearch(const cut::GraphSearch& GS) = delete;
+    cut::GraphSearch& operator=(const cut::GraphSearch& GS) = delete;
+
+    /**
+     * @brief       Parallel direction-optimizing breadth-first search.
+     * 
+     * @details     This method computes the depth of each node from <code>Source</code>,
+     *              that is the minimum number of connections to reach it, storing
+     *              cut::GraphSearch::Unreached for the unreachable nodes.\n 
+     *              The search proceeds level by level. Small frontiers are expanded
+     *              top-down, scanning their adjacents. When the adjacents of the frontier
+     *              exceed a fraction of the unexplored connections, the search switches to
+     *              bottom-up, where each unvisited node scans its incoming neighbors in
+     *              <code>Incoming</code> looking for a parent in the frontier.\n 
+     *              For symmetric graphs, <code>Incoming</code> is <code>&G</code> itself.
+     *              If <code>Incoming</code> is null, the search is always top-down.
+     * 
+     * @param G The graph.
+     * @param Source The source node.
+     * @param Depth The output depths, resized to <code>G.NumNodes()</code>.
+     * @param Incoming The incoming neighbors of each node, or null.
+     * @return int The number of reached nodes, including the source.
+     * 
+     * @throws cut::OutOfBoundError if <code>Source</code> is not a node of the graph.
+     */
+    int BFS(const cut::BaseAdjacencyList& G,
+            int Source,
+            std::vector<int>& Depth,
+            const cut::BaseAdjacencyList* Incoming = nullptr);
+
+    /**
+     * @brief       Sequential Dijkstra's algorithm.
+     * 
+     * @details     This method computes the distance of each node from <code>Source</code>,
+     *              with the weights given by the functor <code>W</code> (see cut::UnitWeight),
+     *              which must be non-negative. Unreachable nodes get an infinite distance.\n 
+     *              The queue is a cut::MinHeap owned by this object, which is cleared and
+     *              reused by the next queries.
+     * 
+     * @param G The graph.
+     * @param Source The source node.
+     * @param W The weight functor.
+     * @param Dist The output distances, resized to <code>G.NumNodes()</code>.
+     * @param Pred If not null, receives the predecessor of each node in a shortest path,
+     *             or -1 for the source and the unreachable nodes.
+     * 
+     * @throws cut::OutOfBoundError if <code>Source</code> is not a node of the graph.
+     * 
+     * @tparam WeightFn The type of the weight functor.
+     */
+    template<typename WeightFn>
+    void Dijkstra(const cut::BaseAdjacencyList& G,
+                  int Source,
+                  WeightFn W,
+                  std::vector<double>& Dist,
+                  std::vector<int>* Pred = nullptr);
+
+    /**
+     * @brief       Parallel delta-stepping shortest paths.
+     * 
+     * @details     This method computes the same distances of cut::GraphSearch::Dijkstra(),
+     *              in parallel.\n 
+     *              The nodes are kept in buckets of width <code>Delta</code> by their tentative
+     *              distance. The buckets are processed in order: the light connections
+     *              (<code>W <= Delta</code>) of the nodes in a bucket are relaxed in parallel,
+     *              until the bucket is empty, and finally the heavy connections of all the
+     *              nodes removed from the bucket are relaxed in parallel.\n 
+     *              Small values of <code>Delta</code> approach Dijkstra's algorithm, large
+     *              values approach Bellman-Ford. A good value is of the order of the
+     *              average weight.\n 
+     *              The weights must be non-negative.
+     * 
+     * @param G The graph.
+     * @param Source The source node.
+     * @param W The weight functor, which must be thread-safe.
+     * @param Delta The width of the buckets.
+     * @param Dist The output distances, resized to <code>G.NumNodes()</code>.
+     * 
+     * @throws cut::OutOfBoundError if <code>Source</code> is not a node of the graph.
+     * @throws cut::OutOfBoundError if <code>Delta <= 0</code>.
+     * @throws cut::OutOfBoundError if a relaxed connection has a negative weight.
+     * @throws cut::OutOfBoundError if a distance over <code>Delta</code> is negative or
+     *         does not fit a 64 bits integer, independently of CUT_CHECKS.
+     * 
+     * @tparam WeightFn The type of the weight functor.
+     */
+    template<typename WeightFn>
+    void DeltaStepping(const cut::BaseAdjacencyList& G,
+                       int Source,
+                       WeightFn W,
+                       double Delta,
+                       std::vector<double>& Dist);
+
+    /**
+     * @brief       Parallel label-correcting Dijkstra's algorithm.
+     * 
+     * @details     This method computes the same distances of cut::GraphSearch::Dijkstra(),
+     *              in parallel.\n 
+     *              The sequential cut::MinHeap is replaced by a cut::MultiQueue shared by
+     *              all the threads. Each thread extracts a node with a small tentative
+     *              distance, skips it if its distance has been lowered since it was pushed,
+     *              and relaxes its connections, pushing again the improved adjacents. Since
+     *              the queue is relaxed, a node may be expanded more than once, and the
+     *              search ends when no node is left to expand.\n 
+     *              Differently from cut::GraphSearch::DeltaStepping(), there is no barrier
+     *              between the phases, hence this method is fastest when many threads
+     *              would stall on small buckets.
+     * 
+     * @param G The graph.
+     * @param Source The source node.
+     * @param W The weight functor, which must be thread-safe.
+     * @param Dist The output distances, resized to <code>G.NumNodes()</code>.
+     * 
+     * @throws cut::OutOfBoundError if <code>Source</code> is not a node of the graph.
+     * 
+     * @tparam WeightFn The type of the weight functor.
+     */
+    template<typename WeightFn>
+    void ParallelDijkstra(const cut::BaseAdjacencyList& G,
+                          int Source,
+                          WeightFn W,
+                          std::vector<double>& Dist);
+};
+
+
+template<typename WeightFn>
+void GraphSearch::Dijkstra(const cut::BaseAdjacencyList& G,
+                           int Source,
+                           WeightFn W,
+                           std::vector<double>& Dist,
+                           std::vector<int>* Pred)
+{
+    CUTCheckGEQ(Source, 0);
+    CUTCheckLess(Source, G.NumNodes());
+
+    int NNodes = G.NumNodes();
+    Dist.assign(NNodes, std::numeric_limits<double>::infinity());
+    if (Pred != nullptr)
+        Pred->assign(NNodes, -1);
+    m_Heap.Clear();
+    m_Heap.Reserve(NNodes);
+
+    Dist[Source] = 0;
+    m_Heap.Push(Source, 0);
+    while (!m_Heap.Empty())
+    {
+        std::pair<double, size_t> Min = m_Heap.ExtractMin();
+        int u = (int)Min.second;
+        cut::Span<int> Adjs = G.Neighbors(u);
+        for (size_t k = 0; k < Adjs.Size(); ++k)
+        {
+            int v = Adjs[k];
+            double NewDist = Min.first + W(u, (int)k);
+            if (NewDist >= Dist[v])
+                continue;
+            Dist[v] = NewDist;
+            if (Pred != nullptr)
+                (*Pred)[v] = u;
+            if (m_Heap.Contains(v))
+                m_Heap.SetKey(v, NewDist);
+            else
+                m_Heap.Push(v, NewDist);
+        }
+    }
+}
+
+template<typename WeightFn>
+void GraphSearch::RelaxBlocks(const cut::BaseAdjacencyList& G,
+                              const std::vector<int>& Nodes,
+                              WeightFn& W,
+                              double Delta,
+                              bool Light)
+{
+    PrepareBlocks(Nodes.size());
+    cut::ParallelFor(0, Nodes.size(), [&](size_t b, size_t e)
+    {
+        std::vector<int>& Out = m_Blocks[b / BlockSize];
+        cut::CheckStatus Status;
+        for (size_t i = b; i < e; ++i)
+        {
+            int u = Nodes[i];
+            double DU = m_Dist[u].load(std::memory_order_relaxed);
+            cut::Span<int> Adjs = G.Neighbors(u);
+            for (size_t k = 0; k < Adjs.Size(); ++k)
+            {
+                double w = W(u, (int)k);
+                CUTCheckGEQStatus(w, 0.0, Status);
+                if ((w <= Delta) != Light)
+                    continue;
+                int v = Adjs[k];
+                if (RelaxTo(m_Dist[v], DU + w))
+                    Out.push_back(v);
+            }
+        }
+        Status.Raise();
+    }, -1, BlockSize);
+}
+
+template<typename WeightFn>
+void GraphSearch::DeltaStepping(const cut::BaseAdjacencyList& G,
+                                int Source,
+                                WeightFn W,
+                                double Delta,
+                                std::vector<double>& Dist)
+{
+    CUTCheckGEQ(Source, 0);
+    CUTCheckLess(Source, G.NumNodes());
+    CUTCheckGreater(Delta, 0.0);
+
+    size_t NNodes = G.NumNodes();
+    ResetDistances(NNodes);
+    m_Mark.assign(NNodes, 0);
+    ReleaseBuckets();
+
+    m_Dist[Source].store(0);
+    PushBucket(Source, Delta);
+    std::vector<int>& Settled = m_Next;
+    while (!m_Buckets.empty())
+    {
+        // The smallest non-empty bucket, which stays in place while nodes are pushed
+        uint64_t i = m_Buckets.begin()->first;
+        std::vector<int>& Bucket = m_Buckets.begin()->second;
+        Settled.clear();
+        while (!Bucket.empty())
+        {
+            // Take the nodes that still belong to this bucket
+            m_Frontier.clear();
+            for (int v : Bucket)
+            {
+                double d = m_Dist[v].load(std::memory_order_relaxed);
+                if (BucketOf(d, Delta) != i || (m_Mark[v] & 1))
+                    continue;
+                m_Mark[v] |= 1;
+                m_Frontier.push_back(v);
+            }
+            Bucket.clear();
+            for (int v : m_Frontier)
+            {
+                m_Mark[v] &= ~1;
+                if (!(m_Mark[v] & 2))
+                {
+                    m_Mark[v] |= 2;
+                    Settled.push_back(v);
+                }
+            }
+            // Light connections may reinsert nodes in this bucket
+            RelaxBlocks(G, m_Frontier, W, Delta, true);
+            for (const std::vector<int>& Out : m_Blocks)
+            {
+                for (int v : Out)
+                    PushBucket(v, Delta);
+            }
+        }
+        // Heavy connections always go to later buckets
+        RelaxBlocks(G, Settled, W, Delta, false);
+        for (const std::vector<int>& Out : m_Blocks)
+        {
+            for (int v : Out)
+                PushBucket(v, Delta);
+        }
+        for (int v : Settled)
+            m_Mark[v] = 0;
+        m_SpareBuckets.push_back(std::move(Bucket));
+        m_Buckets.erase(m_Buckets.begin());
+    }
+
+    GatherDistances(Dist, NNodes);
+}
+
+template<typename WeightFn>
+void GraphSearch::ParallelDijkstra(const cut::BaseAdjacencyList& G,
+                                   int Source,
+                                   WeightFn W,
+                                   std::vector<double>& Dist)
+{
+    CUTCheckGEQ(Source, 0);
+    CUTCheckLess(Source, G.NumNodes());
+
+    size_t NNodes = G.NumNodes();
+    ResetDistances(NNodes);
+    int NThreads = cut::GetNumThreads();
+    if (m_Queue == nullptr || m_Queue->NumQueues() != (size_t)NThreads * QueuesPerThread)
+        m_Queue.reset(new cut::MultiQueue(NThreads, QueuesPerThread));
+    m_Queue->Clear();
+
+    // Nodes pushed and not expanded yet, counted before each push
+    std::atomic<size_t> Pending(1);
+    std::atomic<bool> Abort(false);
+    m_Dist[Source].store(0);
+    m_Queue->Push(Source, 0);
+    cut::ParallelFor(0, NThreads, [&](size_t, size_t)
+    {
+        std::pair<double, size_t> Min;
+        while (!Abort.load(std::memory_order_relaxed) && Pending.load(std::memory_order_acquire) > 0)
+        {
+            if (!m_Queue->TryExtractApproxMin(Min))
+            {
+                // Other threads are still expanding nodes
+                std::this_thread::yield();
+                continue;
+            }
+            int u = (int)Min.second;
+            double DU = m_Dist[u].load(std::memory_order_relaxed);
+            // Skip the entries left behind by a later decrease
+            if (Min.first <= DU)
+            {
+                try
+                {
+                    cut::Span<int> Adjs = G.Neighbors(u);
+                    for (size_t k = 0; k < Adjs.Size(); ++k)
+                    {
+                        int v = Adjs[k];
+                        double NewDist = DU + W(u, (int)k);
+                        if (RelaxTo(m_Dist[v], NewDist))
+                        {
+                            Pending.fetch_add(1, std::memory_order_relaxed);
+                            m_Queue->DecreaseKey(v, NewDist);
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    // Let the other threads leave, the loop rethrows
+                    Abort.store(true);
+                    throw;
+                }
+            }
+            Pending.fetch_sub(1, std::memory_order_release);
+        }
+    }, NThreads, 1);
+
+    GatherDistances(Dist, NNodes);
+}
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,171 @@
+/**
+ * @file        intersect.hpp
+ * 
+ * @brief       Vectorized kernels over the rows of adjacency lists.
+ * 
+ * @details     This file contains the kernels for intersecting sorted rows, counting
+ *              their intersection, searching an adjacent in a row and computing the
+ *              degrees of a compressed sparse row list.\n 
+ *              Each kernel has a scalar implementation and a SIMD one for SSE2, AVX2
+ *              and NEON. The implementation is selected at runtime, according to the
+ *              features of the processor (see cut::GetSimdLevel()).
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-11
+ */
+#pragma once
+
+#include <cstddef>
+#include <cut/algo/span.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       The instruction sets of the kernels.
+ * 
+ * @details     The instruction sets the kernels can use, from the least to the most
+ *              capable on each architecture. NEON is only used on AArch64.
+ */
+enum class SimdLevel
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+/**
+ * @brief       The instruction set supported by the processor.
+ * 
+ * @details     This function returns the most capable instruction set that both the
+ *              processor and the compiler of the library support.
+ * 
+ * @return cut::SimdLevel The supported instruction set.
+ */
+cut::SimdLevel DetectSimdLevel();
+
+/**
+ * @brief       The instruction set used by the kernels.
+ * 
+ * @details     This function returns the instruction set used by the kernels, which by
+ *              default is the one returned by cut::DetectSimdLevel().
+ * 
+ * @return cut::SimdLevel The instruction set of the kernels.
+ */
+cut::SimdLevel GetSimdLevel();
+
+/**
+ * @brief       Set the instruction set used by the kernels.
+ * 
+ * @details     This function selects the implementation of the kernels. If the processor
+ *              does not support the requested instruction set, the kernels fall back to
+ *              the scalar implementation.\n 
+ *              This is meant for testing and benchmarking the kernels against each other.
+ * 
+ * @param Level The requested instruction set.
+ * @return cut::SimdLevel The instruction set actually selected.
+ */
+cut::SimdLevel SetSimdLevel(cut::SimdLevel Level);
+
+
+/**
+ * @brief       Intersect two sorted rows.
+ * 
+ * @details     This function writes to <code>Out</code> the elements that appear in both
+ *              the given rows, in increasing order. Both rows must be sorted and must not
+ *              contain duplicates, as the rows of cut::CompatAdjacencyList built with
+ *              sorting and deduplication.\n 
+ *              The intersection takes linear time in the size of the rows, and compares
+ *              blocks of 4 (SSE2, NEON) or 8 (AVX2) elements at once.
+ * 
+ * @param A The first row.
+ * @param NA The size of the first row.
+ * @param B The second row.
+ * @param NB The size of the second row.
+ * @param Out The output, with room for at least <code>min(NA, NB)</code> elements.
+ * @return size_t The size of the intersection.
+ */
+size_t IntersectSorted(const int* A, size_t NA, const int* B, size_t NB, int* Out);
+
+/**
+ * @brief       Count the intersection of two sorted rows.
+ * 
+ * @details     This function returns the number of elements that appear in both the
+ *              given rows, as cut::IntersectSorted() without writing them.
+ * 
+ * @param A The first row.
+ * @param NA The size of the first row.
+ * @param B The second row.
+ * @param NB The size of the second row.
+ * @return size_t The size of the intersection.
+ */
+size_t IntersectSortedCount(const int* A, size_t NA, const int* B, size_t NB);
+
+/**
+ * @brief       Search an element in a row.
+ * 
+ * @details     This function determines whether or not <code>x</code> appears in the
+ *              given row, in any order, comparing blocks of elements at once.
+ * 
+ * @param A The row.
+ * @param N The size of the row.
+ * @param x The element to search.
+ * @return true If <code>x</code> is in the row.
+ * @return false Otherwise.
+ */
+bool Contains(const int* A, size_t N, int x);
+
+/**
+ * @brief       Search an element in a sorted row.
+ * 
+ * @details     This function determines whether or not <code>x</code> appears in the
+ *              given sorted row. The search is binary until few elements are left, and
+ *              then scans them with cut::Contains().
+ * 
+ * @param A The sorted row.
+ * @param N The size of the row.
+ * @param x The element to search.
+ * @return true If <code>x</code> is in the row.
+ * @return false Otherwise.
+ */
+bool SortedContains(const int* A, size_t N, int x);
+
+/**
+ * @brief       Compute the degrees of a compressed sparse row list.
+ * 
+ * @details     This function writes <code>Offsets[i + 1] - Offsets[i]</code> to
+ *              <code>Out[i]</code>, for each row <code>i</code>.
+ * 
+ * @param Offsets The offsets of the rows, with <code>NRows + 1</code> elements.
+ * @param NRows The number of rows.
+ * @param Out The degrees, with room for <code>NRows</code> elements.
+ */
+void RowDegrees(const int* Offsets, size_t NRows, int* Out);
+
+
+inline size_t IntersectSorted(cut::Span<int> A, cut::Span<int> B, int* Out)
+{
+    return cut::IntersectSorted(A.Data(), A.Size(), B.Data(), B.Size(), Out);
+}
+
+inline size_t IntersectSortedCount(cut::Span<int> A, cut::Span<int> B)
+{
+    return cut::IntersectSortedCount(A.Data(), A.Size(), B.Data(), B.Size());
+}
+
+inline bool Contains(cut::Span<int> A, int x)
+{
+    return cut::Contains(A.Data(), A.Size(), x);
+}
+
+inline bool SortedContains(cut::Span<int> A, int x)
+{
+    return cut::SortedContains(A.Data(), A.Size(), x);
+}
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,337 @@
+/**
+ * @file        madjlist.hpp
+ * 
+ * @brief       A read-only adjacency list mapped from a binary file.
+ * 
+ * @details     This file contains the declaration of the binary on-disk format
+ *              for adjacency lists, and of the class cut::MappedAdjacencyList,
+ *              which serves an adjacency list directly from a memory mapping
+ *              of a file in that format.\n 
+ *              The format is little-endian and versioned. A file is composed of a
+ *              64 bytes header (cut::BinaryAdjacencyHeader), followed by the array of
+ *              the <code>NumNodes + 1</code> row offsets as 64 bits unsigned integers,
+ *              followed by the array of the <code>NumConnections</code> adjacents as
+ *              32 bits signed integers. Both arrays start at 64 bytes aligned positions,
+ *              hence they can be used directly from the mapping.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-23
+ */
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/span.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       Header of the binary adjacency list format.
+ * 
+ * @details     This structure is the 64 bytes header that opens a binary
+ *              adjacency list file. All the fields are stored little-endian.
+ */
+struct BinaryAdjacencyHeader
+{
+    /**
+     * @brief       Magic string identifying the format.
+     * @details     Magic string identifying the format. Always <code>"CUTADJL"</code>,
+     *              null terminated.
+     */
+    char Magic[8];
+
+    /**
+     * @brief       Version of the format.
+     * @details     Version of the format.
+     */
+    uint32_t Version;
+
+    /**
+     * @brief       Reserved flags.
+     * @details     Reserved flags. Must be zero in the current version.
+     */
+    uint32_t Flags;
+
+    /**
+     * @brief       Number of nodes.
+     * @details     Number of nodes.
+     */
+    uint64_t NumNodes;
+
+    /**
+     * @brief       Number of connections.
+     * @details     Number of connections.
+     */
+    uint64_t NumConnections;
+
+    /**
+     * @brief       Position in the file of the array of offsets, in bytes.
+     * @details     Position in the file of the array of offsets, in bytes.
+     */
+    uint64_t OffsetsPos;
+
+    /**
+     * @brief       Position in the file of the array of adjacents, in bytes.
+     * @details     Position in the file of the array of adjacents, in bytes.
+     */
+    uint64_t AdjacentsPos;
+
+    /**
+     * @brief       Size of an offset in bytes.
+     * @details     Size of an offset in bytes. Always 8 in the current version.
+     */
+    uint32_t OffsetBytes;
+
+    /**
+     * @brief       Size of an adjacent in bytes.
+     * @details     Size of an adjacent in bytes. Always 4 in the current version.
+     */
+    uint32_t IndexBytes;
+
+    /**
+     * @brief       Reserved for future use.
+     * @details     Reserved for future use. Must be zero in the current version.
+     */
+    uint64_t Reserved;
+};
+
+
+/**
+ * @brief       A read-only adjacency list served from a memory mapped file.
+ * 
+ * @details     The class cut::MappedAdjacencyList maps a file in the binary
+ *              adjacency list format (see cut::BinaryAdjacencyHeader) and serves
+ *              all the accesses straight out of the mapping, without copying the
+ *              data.\n 
+ *              Opening a list only reads the header and the row offsets, which are
+ *              validated once, in linear time in the number of nodes, while the pages
+ *              of the adjacents are loaded lazily by the operating system. Since
+ *              the mapping is shared and read-only, multiple processes mapping the
+ *              same file share the same page cache.\n 
+ *              Files are produced with cut::MappedAdjacencyList::Save(), and
+ *              a mapped list can be converted to any other adjacency list with
+ *              their converting constructors.
+ */
+class MappedAdjacencyList final : public cut::BaseAdjacencyList
+{
+private:
+    /**
+     * @brief       The memory mapping.
+     * @details     The memory mapping.
+     */
+    void* m_Map;
+
+    /**
+     * @brief       The size of the memory mapping, in bytes.
+     * @details     The size of the memory mapping, in bytes.
+     */
+    size_t m_MapSize;
+
+    /**
+     * @brief       Handle of the mapping object (only used on Windows).
+     * @details     Handle of the mapping object (only used on Windows).
+     */
+    void* m_Handle;
+
+    /**
+     * @brief       The number of nodes.
+     * @details     The number of nodes.
+     */
+    size_t m_NNodes;
+
+    /**
+     * @brief       The number of connections.
+     * @details     The number of connections.
+     */
+    size_t m_NConns;
+
+    /**
+     * @brief       The starting index of each node, inside the mapping.
+     * @details     The starting index of each node, inside the mapping.
+     */
+    const uint64_t* m_Idx;
+
+    /**
+     * @brief       The list of connections, inside the mapping.
+     * @details     The list of connections, inside the mapping.
+     */
+    const int* m_Adj;
+
+    /**
+     * @brief       Release the mapping.
+     * @details     Release the mapping.
+     */
+    void Unmap();
+
+public:
+    /**
+     * @brief       Current version of the binary format.
+     * @details     Current version of the binary format.
+     */
+    static const uint32_t Version = 1;
+
+    /**
+     * @brief       Map an adjacency list from a binary file.
+     * 
+     * @details     This constructor maps the given file, validates its header and
+     *              its row offsets, and makes the list serve its content.\n 
+     *              The offsets must be non-decreasing and delimit the adjacents, and
+     *              the number of nodes and of adjacents of each node must fit an int.
+     *              The total number of connections can exceed it (see
+     *              cut::MappedAdjacencyList::NumConnections64()).
+     * 
+     * @param Filename The path to a file in the binary adjacency list format.
+     * 
+     * @throws cut::AssertionError if the file cannot be opened or mapped.
+     * @throws cut::AssertionError if the file is not a valid binary adjacency list.
+     * @throws cut::AssertionError if the host is not little-endian.
+     */
+    MappedAdjacencyList(const std::string& Filename);
+
+    /**
+     * @brief       Move constructor.
+     * 
+     * @details     This constructor takes the ownership of the mapping of the
+     *              given list. The input is left empty.
+     * 
+     * @param AL The list to move.
+     */
+    MappedAdjacencyList(cut::MappedAdjacencyList&& AL);
+
+    MappedAdjacencyList(const cut::MappedAdjacencyList& AL) = delete;
+
+    /**
+     * @brief       Assignment-copy operator.
+     * 
+     * @details     A mapped list is read-only, hence this operator always throws.
+     * 
+     * @throws cut::AssertionError always.
+     */
+    virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override;
+
+    /**
+     * @brief       Assignment-move operator.
+     * 
+     * @details     This operator takes the ownership of the mapping of the given
+     *              list, which must be a cut::MappedAdjacencyList.
+     * 
+     * @throws cut::AssertionError if the given list is not a cut::MappedAdjacencyList.
+     */
+    virtual cut::BaseAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override;
+
+    /**
+     * @brief       Unmap the file.
+     * 
+     * @details     Unmap the file.
+     */
+    virtual ~MappedAdjacencyList();
+
+    virtual int NumNodes() const override;
+
+    /**
+     * @brief       The number of connections.
+     * 
+     * @details     This method returns the number of connections of the list.
+     * 
+     * @return int The number of connections.
+     * 
+     * @throws cut::OutOfBoundError if the number of connections does not fit an int,
+     *         independently of CUT_CHECKS.
+     */
+    virtual int NumConnections() const override;
+
+    /**
+     * @brief       The number of connections, as a 64 bits integer.
+     * 
+     * @details     This method returns the number of connections of the list, also
+     *              when it exceeds the range of cut::MappedAdjacencyList::NumConnections().
+     * 
+     * @return uint64_t The number of connections.
+     */
+    uint64_t NumConnections64() const { return m_NConns; }
+
+    virtual int NumAdjacents(int i) const override;
+    virtual int GetAdjacent(int i, int idx) const override;
+    virtual cut::Span<int> Neighbors(int i) const override;
+
+    /**
+     * @brief       Return the adjacents of node i, without bound checks.
+     * 
+     * @details     This method returns a read-only view over the list of
+     *              adjacents of node <code>i</code>, inside the mapping.\n 
+     *              Differently from <code>Neighbors()</code>, this method is
+     *              not virtual, it is inlined and it never checks its input,
+     *              independently of CUT_CHECKS.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<int> The adjacents of the given node.
+     */
+    cut::Span<int> NeighborsUnchecked(int i) const
+    {
+        return cut::Span<int>(m_Adj + m_Idx[i], (size_t)(m_Idx[i + 1] - m_Idx[i]));
+    }
+
+    /**
+     * @brief       The raw array of the row offsets.
+     * 
+     * @details     This method returns the array of <code>NumNodes() + 1</code>
+     *              offsets delimiting the rows, inside the mapping.
+     * 
+     * @return const uint64_t* The array of offsets.
+     */
+    const uint64_t* Offsets() const { return m_Idx; }
+
+    /**
+     * @brief       The raw array of the connections.
+     * 
+     * @details     This method returns the array of <code>NumConnections()</code>
+     *              connections of all the rows, inside the mapping.
+     * 
+     * @return const int* The array of connections.
+     */
+    const int* Adjacents() const { return m_Adj; }
+
+    /**
+     * @brief       The memory mapping.
+     * 
+     * @details     This method returns the whole mapping of the file, header included,
+     *              for the formats that append their own data to the adjacency list
+     *              (see cut::GraphShard).
+     * 
+     * @return const char* The first byte of the file.
+     */
+    const char* MappedData() const { return static_cast<const char*>(m_Map); }
+
+    /**
+     * @brief       The size of the memory mapping.
+     * @details     The size of the mapped file, in bytes.
+     * 
+     * @return size_t The size of the file.
+     */
+    size_t MappedSize() const { return m_MapSize; }
+
+
+    /**
+     * @brief       Write an adjacency list in the binary format.
+     * 
+     * @details     This method writes the given adjacency list to the given file,
+     *              using the binary adjacency list format, so that it can be later
+     *              mapped with cut::MappedAdjacencyList::MappedAdjacencyList().
+     * 
+     * @param AL The list to write.
+     * @param Filename The path of the output file.
+     * 
+     * @throws cut::AssertionError if the file cannot be written.
+     * @throws cut::AssertionError if the host is not little-endian.
+     */
+    static void Save(const cut::BaseAdjacencyList& AL,
+                     const std::string& Filename);
+};
+
+} // namespace cut
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <cut/algo/span.hpp>
 
 namespace cut
 {
@@ -32,12 +33,12 @@ namespace cut
  *              of this class, and integer values can be used to map array
  *              positions.\n 
  *              This class can also be used to realize max-heap structures
- *              (see constructor's documentation). 
- * 
- * @warning     This interface does not support deletions or insertions,
- *              but only increasing and decreasing of keys.\n 
- *              This limitation is intentional, as it allows for an efficient
- *              implementation.
+ *              (see constructor's documentation).\n 
+ *              Elements can be removed with cut::MinHeap::ExtractMin() and added
+ *              with cut::MinHeap::Push(), so that the cost of each operation depends
+ *              on the number of elements currently in the heap. A heap emptied with
+ *              cut::MinHeap::Clear() keeps its memory, so it can be reused across
+ *              many queries without allocations.
  */
 class MinHeap
 {
@@ -70,13 +71,64 @@ private:
      */
     int m_Sign;
 
+    /**
+     * @brief       Position of the elements that are not in the heap.
+     * @details     Position of the elements that are not in the heap.
+     */
+    static const size_t NotInHeap = (size_t)-1;
+
 
     void MoveUp(size_t Element);
     void MoveDown(size_t Element);
-    void Insert(double Key);
+
+    /**
+     * @brief       Replace the stored key of an element and restore the heap.
+     * 
+     * @details     This method replaces the key of the element with the given one,
+     *              already multiplied by the sign, and moves the element up or down
+     *              accordingly. Equal keys leave the heap untouched.
+     * 
+     * @param Element An element of the heap.
+     * @param StoredKey The new key, multiplied by the sign.
+     */
+    void UpdateKey(size_t Element, double StoredKey);
+
+    /**
+     * @brief       Restore the heap after any change of the keys.
+     * 
+     * @details     This method sifts down every internal node, from the last one
+     *              to the root, in linear time in the size of the heap.
+     */
+    void Rebuild();
+
+    /**
+     * @brief       Build the heap from an array of keys.
+     * 
+     * @details     This method replaces the content of the heap with the given
+     *              keys, associating \code Keys[i] \endcode to the element
+     *              \code i \endcode, and restores the heap with Floyd's bottom-up
+     *              construction, in linear time.
+     * 
+     * @param Keys The array of keys.
+     * @param NumKeys The number of keys in the array.
+     */
+    void Heapify(const double* const Keys, size_t NumKeys);
 
 
 public:
+    /**
+     * @brief       Create a new empty cut::MinHeap.
+     * 
+     * @details     This constructor creates a new empty cut::MinHeap, to be
+     *              filled with cut::MinHeap::Push().\n 
+     *              If the optional parameter \code AsMaxHeap \endcode is set to
+     *              true (default is false), the cut::MinHeap is modified to
+     *              implement a max-heap data structure.
+     * 
+     * @param AsMaxHeap Decide whether or not the heap must implement a min- or max- heap.
+     */
+    explicit MinHeap(bool AsMaxHeap = false);
+
     /**
      * @brief       Create a new cut::MinHeap from the vector of keys.
      * 
@@ -84,7 +136,7 @@ public:
      *              given vector of keys.\n 
      *              The key \code Keys[i] \endcode from the provided vector of keys
      *              is associated to the integer value \code i \endcode before
-     *              the heapifying of the structure.\n 
+     *              the heapifying of the structure, which takes linear time.\n 
      *              If the optional parameter \code AsMaxHeap \endcode is set to
      *              true (default is false), the cut::MinHeap is modified to
      *              implement a max-heap data structure.
@@ -102,7 +154,7 @@ public:
      *              given array of keys.\n 
      *              The key \code Keys[i] \endcode from the provided array of keys
      *              is associated to the integer value \code i \endcode before
-     *              the heapifying of the structure.\n 
+     *              the heapifying of the structure, which takes linear time.\n 
      *              If the optional parameter \code AsMaxHeap \endcode is set to
      *              true (default is false), the cut::MinHeap is modified to
      *              implement a max-heap data structure.
@@ -133,6 +185,15 @@ public:
      */
     size_t Size() const;
 
+    /**
+     * @brief       Checks whether the min-heap is empty.
+     * 
+     * @details     This method returns true if the heap contains no elements.
+     * 
+     * @return bool Whether or not the heap is empty.
+     */
+    bool Empty() const;
+
 
     /**
      * @brief       Returns the minimum (or maximum) element.
@@ -157,10 +218,42 @@ public:
      * @param Element An element of the heap.
      * @return double The key of the element.
      * 
-     * @throws cut::OutOfBoundError if Element is larger than the heap size.
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
      */
     double GetKey(size_t Element) const;
 
+    /**
+     * @brief       Returns the minimum (or maximum) element, without bound checks.
+     * 
+     * @details     This method returns the element of the heap with the
+     *              minimum key, as cut::MinHeap::FindMin().\n 
+     *              Differently from cut::MinHeap::FindMin(), this method is inlined
+     *              and it never checks that the heap is not empty, independently
+     *              of CUT_CHECKS.
+     * 
+     * @warning     Calling this method on an empty heap is undefined behavior.
+     * 
+     * @return std::pair<double, size_t> The kay-value pair in the heap with minimum key.
+     */
+    std::pair<double, size_t> FindMinUnchecked() const;
+
+    /**
+     * @brief       Returns the key of the element, without bound checks.
+     * 
+     * @details     This method returns the key associated to the given
+     *              element, as cut::MinHeap::GetKey().\n 
+     *              Differently from cut::MinHeap::GetKey(), this method is inlined
+     *              and it never checks its input, independently of CUT_CHECKS.
+     * 
+     * @warning     Calling this method with an element that is not in the heap
+     *              is undefined behavior.
+     * 
+     * @param Element An element of the heap.
+     * @return double The key of the element.
+     */
+    double GetKeyUnchecked(size_t Element) const;
+
     /**
      * @brief       Decreases the key of the element by the given value.
      * 
@@ -172,7 +265,8 @@ public:
      * @param Element The element whose key must be decremented.
      * @param Decrement The decrement to operate on the key.
      * 
-     * @throws cut::OutOfBoundError if Element is larger than the heap size.
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
      */
     void DecreaseKey(size_t Element,
                      double Decrement);
@@ -188,7 +282,8 @@ public:
      * @param Element The element whose key must be incremented.
      * @param Increment The increment to operate on the key.
      * 
-     * @throws cut::OutOfBoundError if Element is larger than the heap size.
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
      */
     void IncreaseKey(size_t Element,
                      double Increment);
@@ -201,9 +296,124 @@ public:
      * 
      * @param Element The element whose key must be modified.
      * @param NewKey The new value of the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
      */
     void SetKey(size_t Element,
                 double NewKey);
+
+    /**
+     * @brief       Set the keys of many elements at once.
+     * 
+     * @details     This method applies the given (element, new key) pairs, as many
+     *              calls to cut::MinHeap::SetKey() in the same order, so the last
+     *              update of an element wins. Updates leaving a key unchanged are
+     *              skipped.\n 
+     *              If the changed keys are few with respect to the size of the heap,
+     *              each element is moved up or down on its own, in logarithmic time.
+     *              If they are a large fraction of the heap, all the keys are written
+     *              first and the heap is rebuilt once, in linear time. The cost of the
+     *              batch is then roughly <code>min(k log(n), n)</code>.
+     * 
+     * @param Updates The array of pairs (element, new key).
+     * @param NumUpdates The number of pairs in the array.
+     * 
+     * @throws cut::NullPointerError if Updates is null and NumUpdates is not zero.
+     * @throws cut::OutOfBoundError if an element has never been in the heap.
+     * @throws cut::AssertionError if an element is not in the heap.
+     */
+    void SetKeys(const std::pair<size_t, double>* const Updates,
+                 size_t NumUpdates);
+
+    /**
+     * @brief       Set the keys of many elements at once.
+     * 
+     * @details     This method applies the given (element, new key) pairs, as
+     *              cut::MinHeap::SetKeys(const std::pair<size_t, double>* const, size_t).
+     * 
+     * @param Updates The span of pairs (element, new key).
+     */
+    void SetKeys(cut::Span<std::pair<size_t, double>> Updates);
+
+
+    /**
+     * @brief       Removes and returns the minimum (or maximum) element.
+     * 
+     * @details     This method removes from the heap the element with the
+     *              minimum key, and returns it with its key.\n 
+     *              If the heap is a max-heap, this method removes the element
+     *              with maximum key.\n 
+     *              The removed element can be added again with cut::MinHeap::Push().
+     * 
+     * @return std::pair<double, size_t> The kay-value pair removed from the heap.
+     * 
+     * @throws cut::OutOfBoundError if the heap is empty.
+     */
+    std::pair<double, size_t> ExtractMin();
+
+    /**
+     * @brief       Adds an element to the heap.
+     * 
+     * @details     This method adds the given element to the heap, associating
+     *              it to the given key, and then restores the heap.\n 
+     *              Elements do not need to be contiguous, but the memory used by
+     *              the heap is proportional to the largest element ever pushed.
+     * 
+     * @param Element The element to add.
+     * @param Key The key of the element.
+     * 
+     * @throws cut::AssertionError if Element is already in the heap.
+     */
+    void Push(size_t Element,
+              double Key);
+
+    /**
+     * @brief       Checks whether an element is in the heap.
+     * 
+     * @details     This method returns true if the given element has been
+     *              added to the heap and not removed yet.
+     * 
+     * @param Element An element.
+     * @return bool Whether or not the element is in the heap.
+     */
+    bool Contains(size_t Element) const;
+
+    /**
+     * @brief       Removes all the elements from the heap.
+     * 
+     * @details     This method empties the heap, in time proportional to the
+     *              number of elements it contains. The memory is kept, so
+     *              the heap can be refilled without allocations.
+     */
+    void Clear();
+
+    /**
+     * @brief       Reserves the memory for the given number of elements.
+     * 
+     * @details     This method allocates the memory for the elements from
+     *              0 to \code NumElements - 1 \endcode, so that pushing them
+     *              does not allocate.
+     * 
+     * @param NumElements The number of elements.
+     */
+    void Reserve(size_t NumElements);
 };
 
-} // namespace cut
+
+inline std::pair<double, size_t> MinHeap::FindMinUnchecked() const
+{
+    return { m_Sign * m_Nodes[0].first, m_Nodes[0].second };
+}
+
+inline double MinHeap::GetKeyUnchecked(size_t Element) const
+{
+    return m_Sign * m_Nodes[m_Perm[Element]].first;
+}
+
+inline void MinHeap::SetKeys(cut::Span<std::pair<size_t, double>> Updates)
+{
+    SetKeys(Updates.Data(), Updates.Size());
+}
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,526 @@
+/**
+ * @file        partition.hpp
+ * 
+ * @brief       Partitioning of adjacency lists in shards with halos.
+ * 
+ * @details     This file contains the partitioners of the nodes of an adjacency list,
+ *              and the classes cut::GraphShard and cut::PartitionedGraph, which split a
+ *              list in shards with local numbering, each one with the ghost nodes it
+ *              reads from the other shards and the lists for exchanging their values.\n 
+ *              The shards are stored in the binary adjacency list format (see
+ *              cut::BinaryAdjacencyHeader) followed by their maps, so that each worker
+ *              maps only the file of its own shard.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-12
+ */
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/span.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       Enumeration of node partitioners.
+ * 
+ * @details     This enumeration provides the partitioners of cut::ComputePartition():
+ *              - <code>RANGE_PARTITION</code> splits the nodes in contiguous ranges with
+ *                the same load, where the load of a node is its degree plus one;
+ *              - <code>LABEL_PROPAGATION</code> splits the breadth-first order of the
+ *                nodes (see cut::ComputeOrdering()) in ranges with the same load, and
+ *                then moves each node to the part of most of its adjacents, as long as
+ *                the part does not exceed the allowed imbalance.
+ */
+enum PartitionMethod
+{
+    RANGE_PARTITION,
+    LABEL_PROPAGATION
+};
+
+/**
+ * @brief       Compute a partition of the nodes.
+ * 
+ * @details     This function assigns each node of the given list to one of
+ *              <code>NParts</code> parts, with the given method (see cut::PartitionMethod).
+ *              The traversals follow the connections as they are, hence the partitions
+ *              based on them are meaningful for symmetric lists. Adjacents that are not
+ *              nodes of the list are ignored.\n 
+ *              The label propagation is sequential, hence its result only depends on
+ *              the list.
+ * 
+ * @param G The adjacency list.
+ * @param NParts The number of parts.
+ * @param Method The partitioner.
+ * @param NIterations The maximum number of rounds of label propagation.
+ * @param MaxImbalance The largest allowed ratio between the load of a part and the average load.
+ * @return std::vector<int> The part of each node.
+ * 
+ * @throws cut::OutOfBoundError if <code>NParts</code> is not positive.
+ */
+std::vector<int> ComputePartition(const cut::BaseAdjacencyList& G,
+                                  int NParts,
+                                  cut::PartitionMethod Method = LABEL_PROPAGATION,
+                                  int NIterations = 10,
+                                  double MaxImbalance = 1.05);
+
+/**
+ * @brief       The number of connections across parts.
+ * 
+ * @details     This function returns the number of connections whose node and
+ *              adjacent belong to different parts.
+ * 
+ * @param G The adjacency list.
+ * @param Owner The part of each node.
+ * @return size_t The number of cut connections.
+ * 
+ * @throws cut::AssertionError if <code>Owner</code> does not match the number of nodes.
+ */
+size_t EdgeCut(const cut::BaseAdjacencyList& G, const std::vector<int>& Owner);
+
+
+/**
+ * @brief       Header of the shard section of a shard file.
+ * 
+ * @details     A shard file is a binary adjacency list (see cut::BinaryAdjacencyHeader)
+ *              whose rows are the local rows of the shard, followed by this 64 bytes header
+ *              at the first 64 bytes aligned position after the adjacents. The header is
+ *              followed by the arrays of 32 bits signed integers of the local to global
+ *              map, the offsets of the send lists, the send lists, the offsets of the
+ *              receive lists and the receive lists, each one at a 64 bytes aligned position.
+ */
+struct BinaryShardHeader
+{
+    /**
+     * @brief       Magic string identifying the format.
+     * @details     Magic string identifying the format. Always <code>"CUTSHRD"</code>,
+     *              null terminated.
+     */
+    char Magic[8];
+
+    /**
+     * @brief       Version of the format.
+     * @details     Version of the format.
+     */
+    uint32_t Version;
+
+    /**
+     * @brief       The index of the shard.
+     * @details     The index of the shard.
+     */
+    uint32_t Part;
+
+    /**
+     * @brief       The number of shards.
+     * @details     The number of shards of the partitioned list.
+     */
+    uint32_t NumParts;
+
+    /**
+     * @brief       The number of owned nodes.
+     * @details     The number of nodes owned by the shard.
+     */
+    uint32_t NumOwned;
+
+    /**
+     * @brief       The number of local nodes.
+     * @details     The number of owned nodes plus the number of ghost nodes.
+     */
+    uint64_t NumLocal;
+
+    /**
+     * @brief       The size of the send lists.
+     * @details     The size of the send lists.
+     */
+    uint64_t NumSend;
+
+    /**
+     * @brief       The size of the receive lists.
+     * @details     The size of the receive lists, i.e. the number of ghosts.
+     */
+    uint64_t NumRecv;
+
+    /**
+     * @brief       Reserved for future use.
+     * @details     Reserved for future use. Must be zero in the current version.
+     */
+    uint64_t Reserved[2];
+};
+
+
+/**
+ * @brief       A shard of a partitioned adjacency list.
+ * 
+ * @details     The class cut::GraphShard stores the rows of the nodes owned by a part,
+ *              with local numbering: the owned nodes come first, in increasing global
+ *              order, and they are followed by the ghost nodes, i.e. the adjacents owned
+ *              by other parts, in increasing global order. The ghost nodes have empty
+ *              rows, hence <code>Local()</code> is an adjacency list on its own.\n 
+ *              For each other part, the shard stores the owned nodes that part reads
+ *              (the send list) and the ghosts the part owns (the receive list). The send
+ *              list of part <code>p</code> to part <code>q</code> and the receive list of
+ *              <code>q</code> from <code>p</code> refer to the same global nodes, in the
+ *              same order, hence a halo exchange packs the values of a send list, ships
+ *              them, and unpacks them with the matching receive list.\n 
+ *              Shards are built by cut::PartitionedGraph, or mapped from the files written
+ *              with cut::GraphShard::Save(). A mapped shard serves its rows from the mapping,
+ *              and copies the maps in memory.
+ */
+class GraphShard
+{
+private:
+    friend class PartitionedGraph;
+
+    int m_Part;
+    int m_NParts;
+    int m_NOwned;
+
+    /**
+     * @brief       The local rows.
+     * @details     The local rows, either a cut::CompatAdjacencyList or a cut::MappedAdjacencyList.
+     */
+    std::unique_ptr<cut::BaseAdjacencyList> m_Local;
+
+    /**
+     * @brief       The global index of each local node.
+     * @details     The global index of each local node, owned nodes first.
+     */
+    std::vector<int> m_Global;
+
+    /**
+     * @brief       The part owning each ghost.
+     * @details     The part owning each ghost, the first ghost being local node <code>NumOwned()</code>.
+     */
+    std::vector<int> m_GhostOwner;
+
+    std::vector<int> m_SendOffsets;
+    std::vector<int> m_SendNodes;
+    std::vector<int> m_RecvOffsets;
+    std::vector<int> m_RecvNodes;
+
+    GraphShard();
+
+public:
+    /**
+     * @brief       Current version of the shard section of the format.
+     * @details     Current version of the shard section of the format.
+     */
+    static const uint32_t Version = 1;
+
+    /**
+     * @brief       Map a shard from a file.
+     * 
+     * @details     This constructor maps the given file, written by cut::GraphShard::Save(),
+     *              and validates it.
+     * 
+     * @param Filename The path to a shard file.
+     * 
+     * @throws cut::AssertionError if the file cannot be opened or mapped.
+     * @throws cut::AssertionError if the file is not a valid shard file.
+     */
+    GraphShard(const std::string& Filename);
+
+    GraphShard(cut::GraphShard&& S);
+    cut::GraphShard& operator=(cut::GraphShard&& S);
+    GraphShard(const cut::GraphShard&) = delete;
+    cut::GraphShard& operator=(const cut::GraphShard&) = delete;
+    ~GraphShard();
+
+    /**
+     * @brief       The index of the shard.
+     * @details     The index of the shard.
+     * 
+     * @return int The index of the shard.
+     */
+    int Part() const;
+
+    /**
+     * @brief       The number of shards.
+     * @details     The number of shards of the partitioned list.
+     * 
+     * @return int The number of shards.
+     */
+    int NumParts() const;
+
+    /**
+     * @brief       The number of owned nodes.
+     * @details     The number of nodes owned by the shard, whose local indices are
+     *              <code>[0, NumOwned())</code>.
+     * 
+     * @return int The number of owned nodes.
+     */
+    int NumOwned() const;
+
+    /**
+     * @brief       The number of ghost nodes.
+     * @details     The number of ghost nodes, whose local indices are
+     *              <code>[NumOwned(), NumLocal())</code>.
+     * 
+     * @return int The number of ghost nodes.
+     */
+    int NumGhosts() const;
+
+    /**
+     * @brief       The number of local nodes.
+     * @details     The number of owned nodes plus the number of ghost nodes.
+     * 
+     * @return int The number of local nodes.
+     */
+    int NumLocal() const;
+
+    /**
+     * @brief       The local rows.
+     * 
+     * @details     This method returns the adjacency list of the shard, with
+     *              <code>NumLocal()</code> nodes in local numbering. The rows of
+     *              the ghosts are empty.
+     * 
+     * @return const cut::BaseAdjacencyList& The local rows.
+     */
+    const cut::BaseAdjacencyList& Local() const;
+
+    /**
+     * @brief       The global index of a local node.
+     * @details     The global index of a local node.
+     * 
+     * @param l The local index.
+     * @return int The global index.
+     * 
+     * @throws cut::OutOfBoundError if <code>l</code> is not a local node.
+     */
+    int ToGlobal(int l) const;
+
+    /**
+     * @brief       The local index of a global node.
+     * 
+     * @details     The local index of a global node, found with a binary search
+     *              over the owned nodes and then over the ghosts.
+     * 
+     * @param g The global index.
+     * @return int The local index, or -1 if the node is neither owned nor a ghost.
+     */
+    int ToLocal(int g) const;
+
+    /**
+     * @brief       Whether or not a local node is a ghost.
+     * @details     Whether or not a local node is a ghost.
+     * 
+     * @param l The local index.
+     * @return true If <code>NumOwned() <= l < NumLocal()</code>.
+     * @return false Otherwise.
+     */
+    bool IsGhost(int l) const;
+
+    /**
+     * @brief       The part owning a ghost.
+     * @details     The part owning a ghost.
+     * 
+     * @param l The local index of a ghost.
+     * @return int The owner of the ghost.
+     * 
+     * @throws cut::OutOfBoundError if <code>l</code> is not a ghost.
+     */
+    int GhostOwner(int l) const;
+
+    /**
+     * @brief       The owned nodes read by a part.
+     * @details     The local indices of the owned nodes that are ghosts of part <code>p</code>,
+     *              in increasing global order.
+     * 
+     * @param p The index of a part.
+     * @return cut::Span<int> The send list to part <code>p</code>.
+     * 
+     * @throws cut::OutOfBoundError if <code>p</code> is not a part.
+     */
+    cut::Span<int> SendList(int p) const;
+
+    /**
+     * @brief       The ghosts owned by a part.
+     * @details     The local indices of the ghosts owned by part <code>p</code>,
+     *              in increasing global order.
+     * 
+     * @param p The index of a part.
+     * @return cut::Span<int> The receive list from part <code>p</code>.
+     * 
+     * @throws cut::OutOfBoundError if <code>p</code> is not a part.
+     */
+    cut::Span<int> RecvList(int p) const;
+
+    /**
+     * @brief       Pack the values sent to a part.
+     * 
+     * @details     This method copies to <code>Buffer</code> the values of the nodes
+     *              in the send list to part <code>p</code>.
+     * 
+     * @param p The index of a part.
+     * @param Values The values of the local nodes.
+     * @param Buffer The output, with room for <code>SendList(p).Size()</code> values.
+     */
+    template<typename T>
+    void PackHalo(int p, const T* Values, T* Buffer) const;
+
+    /**
+     * @brief       Unpack the values received from a part.
+     * 
+     * @details     This method copies the values in <code>Buffer</code>, packed by part
+     *              <code>p</code> with cut::GraphShard::PackHalo(), to the ghosts in the
+     *              receive list from part <code>p</code>.
+     * 
+     * @param p The index of a part.
+     * @param Buffer The values received from part <code>p</code>.
+     * @param Values The values of the local nodes.
+     */
+    template<typename T>
+    void UnpackHalo(int p, const T* Buffer, T* Values) const;
+
+    /**
+     * @brief       Write the shard to a file.
+     * 
+     * @details     This method writes the local rows in the binary adjacency list format,
+     *              followed by the shard section (see cut::BinaryShardHeader). The file can
+     *              be mapped both as a cut::GraphShard and as a cut::MappedAdjacencyList.
+     * 
+     * @param Filename The path of the output file.
+     * 
+     * @throws cut::AssertionError if the file cannot be written.
+     */
+    void Save(const std::string& Filename) const;
+};
+
+
+/**
+ * @brief       An adjacency list split in shards.
+ * 
+ * @details     The class cut::PartitionedGraph splits an adjacency list in shards,
+ *              according to the part of each node: shard <code>p</code> owns the rows
+ *              of the nodes of part <code>p</code>, in local numbering, and has a ghost
+ *              for each adjacent owned by another part (see cut::GraphShard).\n 
+ *              The shards are built in parallel, with the number of threads given by
+ *              cut::GetNumThreads(). Adjacents that are not nodes of the list are dropped.
+ */
+class PartitionedGraph
+{
+private:
+    std::vector<int> m_Owner;
+    std::vector<cut::GraphShard> m_Shards;
+
+public:
+    /**
+     * @brief       Split an adjacency list in shards.
+     * 
+     * @details     This constructor builds a shard for each part of the given partition.
+     * 
+     * @param G The adjacency list.
+     * @param Owner The part of each node, as computed by cut::ComputePartition().
+     * @param NParts The number of parts, larger than any element of <code>Owner</code>.
+     * 
+     * @throws cut::AssertionError if <code>Owner</code> does not match the number of nodes.
+     * @throws cut::OutOfBoundError if a part is negative or not less than <code>NParts</code>.
+     */
+    PartitionedGraph(const cut::BaseAdjacencyList& G,
+                     const std::vector<int>& Owner,
+                     int NParts);
+
+    /**
+     * @brief       Partition and split an adjacency list.
+     * 
+     * @details     This constructor computes a partition of the list with cut::ComputePartition()
+     *              and builds a shard for each part.
+     * 
+     * @param G The adjacency list.
+     * @param NParts The number of parts.
+     * @param Method The partitioner.
+     */
+    PartitionedGraph(const cut::BaseAdjacencyList& G,
+                     int NParts,
+                     cut::PartitionMethod Method = LABEL_PROPAGATION);
+
+    /**
+     * @brief       The number of shards.
+     * @details     The number of shards.
+     * 
+     * @return int The number of shards.
+     */
+    int NumParts() const;
+
+    /**
+     * @brief       The number of nodes.
+     * @details     The number of nodes of the partitioned list.
+     * 
+     * @return int The number of nodes.
+     */
+    int NumNodes() const;
+
+    /**
+     * @brief       The part owning a node.
+     * @details     The part owning a node.
+     * 
+     * @param g The global index of a node.
+     * @return int The part owning the node.
+     * 
+     * @throws cut::OutOfBoundError if <code>g</code> is not a node.
+     */
+    int Owner(int g) const;
+
+    /**
+     * @brief       A shard.
+     * @details     The shard of part <code>p</code>.
+     * 
+     * @param p The index of a part.
+     * @return const cut::GraphShard& The shard.
+     * 
+     * @throws cut::OutOfBoundError if <code>p</code> is not a part.
+     */
+    const cut::GraphShard& Shard(int p) const;
+
+    /**
+     * @brief       Write all the shards.
+     * 
+     * @details     This method writes each shard to the file returned by
+     *              cut::PartitionedGraph::ShardFilename().
+     * 
+     * @param Prefix The prefix of the paths of the files.
+     * 
+     * @throws cut::AssertionError if a file cannot be written.
+     */
+    void Save(const std::string& Prefix) const;
+
+    /**
+     * @brief       The file of a shard.
+     * @details     The path <code>Prefix.p.shard</code> of the file of shard <code>p</code>.
+     * 
+     * @param Prefix The prefix of the paths of the files.
+     * @param p The index of a part.
+     * @return std::string The path of the file of the shard.
+     */
+    static std::string ShardFilename(const std::string& Prefix, int p);
+};
+
+
+
+template<typename T>
+void GraphShard::PackHalo(int p, const T* Values, T* Buffer) const
+{
+    cut::Span<int> Send = SendList(p);
+    for (size_t k = 0; k < Send.Size(); ++k)
+        Buffer[k] = Values[Send[k]];
+}
+
+template<typename T>
+void GraphShard::UnpackHalo(int p, const T* Buffer, T* Values) const
+{
+    cut::Span<int> Recv = RecvList(p);
+    for (size_t k = 0; k < Recv.Size(); ++k)
+        Values[Recv[k]] = Buffer[k];
+}
+
+} // namespace cut
\ No newline at end of file
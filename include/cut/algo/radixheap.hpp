@@ -0,0 +1,431 @@
+/**
+ * @file        radixheap.hpp
+ * 
+ * @brief       A monotone priority queue for integer keys.
+ * 
+ * @details     This file contains the declaration and the implementation of the
+ *              class template cut::RadixHeap, an indexed radix heap for unsigned
+ *              integer keys that are extracted in non-decreasing order.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-28
+ */
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       An indexed radix heap.
+ * 
+ * @details     The class cut::RadixHeap is a monotone priority queue, with the same
+ *              element-id interface of cut::MinHeap and cut::IndexedHeap, so that it
+ *              can replace them as a template parameter of an algorithm.\n 
+ *              The queue is monotone: the keys must never be smaller than the last
+ *              extracted key. This is the case, for instance, of the distances
+ *              extracted by Dijkstra's algorithm on non-negative weights.\n 
+ *              The elements are kept in one bucket for each bit of the keys, according
+ *              to the highest bit in which their key differs from the last extracted key.
+ *              All the operations but the extraction take constant time, while the
+ *              extraction takes <code>O(log C)</code> amortized time, with <code>C</code>
+ *              the largest difference between a key and the last extracted key.
+ * 
+ * @tparam KeyT The unsigned integer type of the keys.
+ * @tparam IndexT The unsigned integer type of the elements.
+ */
+template<typename KeyT = uint32_t,
+         typename IndexT = uint32_t>
+class RadixHeap
+{
+    static_assert(std::numeric_limits<KeyT>::is_integer && !std::numeric_limits<KeyT>::is_signed,
+                  "The keys of a radix heap must be of an unsigned integer type.");
+    static_assert(std::numeric_limits<IndexT>::is_integer && !std::numeric_limits<IndexT>::is_signed,
+                  "The elements of a radix heap must be of an unsigned integer type.");
+
+public:
+    /**
+     * @brief       The type of the keys.
+     * @details     The type of the keys.
+     */
+    typedef KeyT KeyType;
+
+    /**
+     * @brief       The type of the elements.
+     * @details     The type of the elements.
+     */
+    typedef IndexT IndexType;
+
+private:
+    /**
+     * @brief       The number of buckets.
+     * @details     The number of buckets, one for each bit of the keys plus
+     *              the bucket of the keys equal to the last extracted key.
+     */
+    static constexpr size_t NBuckets = std::numeric_limits<KeyT>::digits + 1;
+
+    /**
+     * @brief       Bucket of the elements that are not in the heap.
+     * @details     Bucket of the elements that are not in the heap.
+     */
+    static constexpr uint8_t NotInHeap = 0xFF;
+
+    /**
+     * @brief       The elements in each bucket.
+     * @details     The elements in each bucket.
+     */
+    std::vector<IndexT> m_Buckets[NBuckets];
+
+    /**
+     * @brief       The key of each element.
+     * @details     The key of each element.
+     */
+    std::vector<KeyT> m_Keys;
+
+    /**
+     * @brief       The bucket of each element.
+     * @details     The bucket of each element, or <code>NotInHeap</code>.
+     */
+    std::vector<uint8_t> m_Bucket;
+
+    /**
+     * @brief       The position of each element inside its bucket.
+     * @details     The position of each element inside its bucket.
+     */
+    std::vector<IndexT> m_Pos;
+
+    /**
+     * @brief       The last extracted key.
+     * @details     The last extracted key, the lower bound for all the keys.
+     */
+    KeyT m_Last;
+
+    /**
+     * @brief       The number of elements in the heap.
+     * @details     The number of elements in the heap.
+     */
+    size_t m_Size;
+
+
+    static size_t BucketOf(KeyT Key, KeyT Last)
+    {
+        KeyT Diff = Key ^ Last;
+        if (Diff == 0)
+            return 0;
+#if defined(__GNUC__) || defined(__clang__)
+        return std::numeric_limits<unsigned long long>::digits - __builtin_clzll((unsigned long long)Diff);
+#else
+        size_t B = 0;
+        while (Diff != 0)
+        {
+            Diff >>= 1;
+            B++;
+        }
+        return B;
+#endif
+    }
+
+    void Place(size_t Element)
+    {
+        size_t B = BucketOf(m_Keys[Element], m_Last);
+        m_Bucket[Element] = (uint8_t)B;
+        m_Pos[Element] = (IndexT)m_Buckets[B].size();
+        m_Buckets[B].push_back((IndexT)Element);
+    }
+
+    void Unplace(size_t Element)
+    {
+        // Swap with the last element of the bucket
+        std::vector<IndexT>& Bucket = m_Buckets[m_Bucket[Element]];
+        IndexT Back = Bucket.back();
+        Bucket[m_Pos[Element]] = Back;
+        m_Pos[Back] = m_Pos[Element];
+        Bucket.pop_back();
+    }
+
+    // Make sure that bucket 0 contains the minimum
+    void Refill()
+    {
+        if (!m_Buckets[0].empty())
+            return;
+        size_t B = 1;
+        while (m_Buckets[B].empty())
+            B++;
+        // The new lower bound is the minimum of the bucket, and all the
+        // elements of the bucket move to smaller buckets
+        m_Last = m_Keys[m_Buckets[B][0]];
+        for (IndexT e : m_Buckets[B])
+            m_Last = std::min(m_Last, m_Keys[e]);
+        for (IndexT e : m_Buckets[B])
+            Place(e);
+        m_Buckets[B].clear();
+    }
+
+public:
+    /**
+     * @brief       Create a new empty heap.
+     * 
+     * @details     This constructor creates a new empty heap, whose lower
+     *              bound for the keys is 0.
+     */
+    RadixHeap()
+        : m_Last(0), m_Size(0)
+    { }
+
+
+    /**
+     * @brief       Returns the number of elements in the heap.
+     * @details     Returns the number of elements in the heap.
+     * 
+     * @return size_t The heap's size.
+     */
+    size_t Size() const { return m_Size; }
+
+    /**
+     * @brief       Checks whether the heap is empty.
+     * @details     Checks whether the heap is empty.
+     * 
+     * @return bool Whether or not the heap is empty.
+     */
+    bool Empty() const { return m_Size == 0; }
+
+    /**
+     * @brief       Checks whether an element is in the heap.
+     * @details     Checks whether an element is in the heap.
+     * 
+     * @param Element An element.
+     * @return bool Whether or not the element is in the heap.
+     */
+    bool Contains(size_t Element) const
+    {
+        return Element < m_Bucket.size() && m_Bucket[Element] != NotInHeap;
+    }
+
+    /**
+     * @brief       The last extracted key.
+     * 
+     * @details     This method returns the last extracted key, which is the
+     *              lower bound for all the keys that can be pushed.
+     * 
+     * @return KeyT The last extracted key.
+     */
+    KeyT LowerBound() const { return m_Last; }
+
+    /**
+     * @brief       Returns the minimum element.
+     * 
+     * @details     This method returns the element with the minimum key, with
+     *              its key. The method scans a bucket, hence it is not constant
+     *              time, but it does not modify the heap.
+     * 
+     * @return std::pair<KeyT, IndexT> The key-value pair in the heap with minimum key.
+     * 
+     * @throws cut::OutOfBoundError if the heap is empty.
+     */
+    std::pair<KeyT, IndexT> FindMin() const
+    {
+        CUTCheckGreater(Size(), (size_t)0);
+
+        size_t B = 0;
+        while (m_Buckets[B].empty())
+            B++;
+        IndexT Min = m_Buckets[B][0];
+        for (IndexT e : m_Buckets[B])
+        {
+            if (m_Keys[e] < m_Keys[Min])
+                Min = e;
+        }
+        return { m_Keys[Min], Min };
+    }
+
+    /**
+     * @brief       Returns the key of the element.
+     * 
+     * @details     This method returns the key associated to the given element.
+     * 
+     * @param Element An element of the heap.
+     * @return KeyT The key of the element.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    KeyT GetKey(size_t Element) const
+    {
+        CUTCheckLess(Element, m_Keys.size());
+        CUTAssert(Contains(Element));
+
+        return m_Keys[Element];
+    }
+
+    /**
+     * @brief       Set the key of the element to a given value.
+     * 
+     * @details     This method updates the key associated to the given element
+     *              with the given value, moving the element to its new bucket.
+     * 
+     * @param Element The element whose key must be modified.
+     * @param NewKey The new value of the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     * @throws cut::AssertionError if <code>NewKey < LowerBound()</code>.
+     */
+    void SetKey(size_t Element,
+                KeyT NewKey)
+    {
+        CUTCheckLess(Element, m_Keys.size());
+        CUTAssert(Contains(Element));
+        CUTAssert(NewKey >= m_Last);
+
+        m_Keys[Element] = NewKey;
+        if (BucketOf(NewKey, m_Last) != m_Bucket[Element])
+        {
+            Unplace(Element);
+            Place(Element);
+        }
+    }
+
+    /**
+     * @brief       Decreases the key of the element by the given value.
+     * 
+     * @details     This method subtracts the given value from the key associated
+     *              with the given element. The new key must not be smaller than
+     *              the last extracted key.
+     * 
+     * @param Element The element whose key must be decremented.
+     * @param Decrement The decrement to operate on the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     * @throws cut::AssertionError if the new key is smaller than <code>LowerBound()</code>.
+     */
+    void DecreaseKey(size_t Element,
+                     KeyT Decrement)
+    {
+        KeyT Key = GetKey(Element);
+        CUTAssert(Decrement <= Key - m_Last);
+        SetKey(Element, Key - Decrement);
+    }
+
+    /**
+     * @brief       Increases the key of the element by the given value.
+     * 
+     * @details     This method adds the given value to the key associated
+     *              with the given element.
+     * 
+     * @param Element The element whose key must be incremented.
+     * @param Increment The increment to operate on the key.
+     * 
+     * @throws cut::OutOfBoundError if Element has never been in the heap.
+     * @throws cut::AssertionError if Element is not in the heap.
+     */
+    void IncreaseKey(size_t Element,
+                     KeyT Increment)
+    {
+        SetKey(Element, GetKey(Element) + Increment);
+    }
+
+    /**
+     * @brief       Removes and returns the minimum element.
+     * 
+     * @details     This method removes from the heap the element with the
+     *              minimum key, and returns it with its key. The key becomes
+     *              the new lower bound of the heap.
+     * 
+     * @return std::pair<KeyT, IndexT> The key-value pair removed from the heap.
+     * 
+     * @throws cut::OutOfBoundError if the heap is empty.
+     */
+    std::pair<KeyT, IndexT> ExtractMin()
+    {
+        CUTCheckGreater(Size(), (size_t)0);
+
+        Refill();
+        IndexT Min = m_Buckets[0].back();
+        m_Buckets[0].pop_back();
+        m_Bucket[Min] = NotInHeap;
+        m_Size--;
+        return { m_Keys[Min], Min };
+    }
+
+    /**
+     * @brief       Adds an element to the heap.
+     * 
+     * @details     This method adds the given element to the heap, associating
+     *              it to the given key, which must not be smaller than the last
+     *              extracted key.
+     * 
+     * @param Element The element to add.
+     * @param Key The key of the element.
+     * 
+     * @throws cut::OutOfBoundError if Element does not fit IndexT.
+     * @throws cut::AssertionError if Element is already in the heap.
+     * @throws cut::AssertionError if <code>Key < LowerBound()</code>.
+     */
+    void Push(size_t Element,
+              KeyT Key)
+    {
+        CUTCheckLEQ(Element, (size_t)std::numeric_limits<IndexT>::max());
+        if (Element >= m_Keys.size())
+            Reserve(Element + 1);
+        CUTAssert(!Contains(Element));
+        CUTAssert(Key >= m_Last);
+
+        m_Keys[Element] = Key;
+        Place(Element);
+        m_Size++;
+    }
+
+    /**
+     * @brief       Removes all the elements from the heap.
+     * 
+     * @details     This method empties the heap, in time proportional to the
+     *              number of elements it contains, keeping the memory. The lower
+     *              bound of the keys is reset to 0.
+     */
+    void Clear()
+    {
+        for (size_t B = 0; B < NBuckets; ++B)
+        {
+            for (IndexT e : m_Buckets[B])
+                m_Bucket[e] = NotInHeap;
+            m_Buckets[B].clear();
+        }
+        m_Size = 0;
+        m_Last = 0;
+    }
+
+    /**
+     * @brief       Reserves the memory for the given number of elements.
+     * 
+     * @details     This method allocates the memory for the elements from
+     *              0 to <code>NumElements - 1</code>.
+     * 
+     * @param NumElements The number of elements.
+     */
+    void Reserve(size_t NumElements)
+    {
+        if (NumElements <= m_Keys.size())
+            return;
+        m_Keys.resize(NumElements);
+        m_Bucket.resize(NumElements, NotInHeap);
+        m_Pos.resize(NumElements);
+    }
+};
+
+template<typename KeyT, typename IndexT>
+constexpr size_t RadixHeap<KeyT, IndexT>::NBuckets;
+template<typename KeyT, typename IndexT>
+constexpr uint8_t RadixHeap<KeyT, IndexT>::NotInHeap;
+
+} // namespace cut
\ No newline at end of file
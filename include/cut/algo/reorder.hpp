@@ -0,0 +1,198 @@
+/**
+ * @file        reorder.hpp
+ * 
+ * @brief       Node reorderings for cache locality.
+ * 
+ * @details     This file contains the functions that compute a renumbering of the
+ *              nodes of an adjacency list (reverse Cuthill-McKee, breadth-first or
+ *              by degree) and rebuild a compressed list in the new order.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-01
+ */
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/wadjlist.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+
+/**
+ * @brief       Enumeration of node orderings.
+ * 
+ * @details     This enumeration provides the orderings computed by cut::ComputeOrdering():
+ *              - <code>REVERSE_CUTHILL_MCKEE</code> visits each connected component
+ *                breadth-first from a pseudo-peripheral node, taking the adjacents
+ *                by increasing degree, and reverses the result. It minimizes the
+ *                bandwidth, so the adjacents of a node are close to the node;
+ *              - <code>BREADTH_FIRST</code> visits each connected component
+ *                breadth-first from its smallest node;
+ *              - <code>DEGREE</code> sorts the nodes by decreasing degree, so that
+ *                the hubs share the first cache lines.
+ */
+enum NodeOrdering
+{
+    REVERSE_CUTHILL_MCKEE,
+    BREADTH_FIRST,
+    DEGREE
+};
+
+
+/**
+ * @brief       A renumbering of the nodes.
+ * 
+ * @details     The struct cut::NodePermutation stores a permutation of the nodes
+ *              and its inverse: the node with new index <code>n</code> had index
+ *              <code>NewToOld[n]</code>, and the node with old index <code>o</code>
+ *              has index <code>OldToNew[o]</code>.
+ */
+struct NodePermutation
+{
+    std::vector<int> NewToOld;
+    std::vector<int> OldToNew;
+};
+
+
+/**
+ * @brief       Compute a reordering of the nodes.
+ * 
+ * @details     This function computes the permutation of the nodes of the given list
+ *              according to the given ordering (see cut::NodeOrdering).\n 
+ *              The traversals follow the connections as they are, hence the orderings
+ *              based on them are meaningful for symmetric lists. Adjacents that are
+ *              not nodes of the list (i.e. not less than <code>NumNodes()</code>)
+ *              are ignored.
+ * 
+ * @param G The adjacency list.
+ * @param Order The ordering to compute.
+ * @return cut::NodePermutation The permutation and its inverse.
+ */
+cut::NodePermutation ComputeOrdering(const cut::BaseAdjacencyList& G,
+                                     cut::NodeOrdering Order = REVERSE_CUTHILL_MCKEE);
+
+/**
+ * @brief       Build a renumbered copy of an adjacency list.
+ * 
+ * @details     This function builds a cut::CompatAdjacencyList in which the node
+ *              <code>n</code> has the adjacents of node <code>P.NewToOld[n]</code>
+ *              in <code>G</code>, renumbered through <code>P.OldToNew</code> and sorted.
+ *              Adjacents that are not nodes of the list are left unchanged.\n 
+ *              The rows are filled in parallel, with the number of threads
+ *              given by cut::GetNumThreads().
+ * 
+ * @param G The adjacency list.
+ * @param P The permutation of the nodes.
+ * @return cut::CompatAdjacencyList The renumbered list.
+ * 
+ * @throws cut::AssertionError if the permutation does not match the number of nodes.
+ */
+cut::CompatAdjacencyList Permute(const cut::BaseAdjacencyList& G,
+                                 const cut::NodePermutation& P);
+
+/**
+ * @brief       Build a renumbered copy of a weighted adjacency list.
+ * 
+ * @details     This function behaves as cut::Permute() for a generic list, but the
+ *              weights move along with their connections when the rows are sorted.
+ * 
+ * @param G The weighted adjacency list.
+ * @param P The permutation of the nodes.
+ * @return cut::WeightedAdjacencyList<WeightT> The renumbered list.
+ * 
+ * @throws cut::AssertionError if the permutation does not match the number of nodes.
+ * 
+ * @tparam WeightT The type of the weights.
+ */
+template<typename WeightT>
+cut::WeightedAdjacencyList<WeightT> Permute(const cut::WeightedAdjacencyList<WeightT>& G,
+                                            const cut::NodePermutation& P)
+{
+    int N = G.NumNodes();
+    CUTAssert(P.NewToOld.size() == (size_t)N);
+    CUTAssert(P.OldToNew.size() == (size_t)N);
+
+    cut::CompatAdjacencyList::ArrayType Idx(N + 1, 0);
+    for (int n = 0; n < N; ++n)
+        Idx[n + 1] = G.NumAdjacents(P.NewToOld[n]);
+    cut::ParallelPrefixSum(Idx.data(), Idx.size());
+
+    cut::CompatAdjacencyList::ArrayType Adj(Idx[N]);
+    std::vector<WeightT> Weights(Idx[N]);
+    cut::ParallelFor(0, N, [&](size_t b, size_t e)
+    {
+        std::vector<std::pair<int, WeightT>> Row;
+        for (size_t n = b; n < e; ++n)
+        {
+            std::pair<cut::Span<int>, cut::Span<WeightT>> Old = G.WeightedNeighbors(P.NewToOld[n]);
+            Row.clear();
+            for (size_t k = 0; k < Old.first.Size(); ++k)
+            {
+                int j = Old.first[k];
+                Row.emplace_back(j >= 0 && j < N ? P.OldToNew[j] : j, Old.second[k]);
+            }
+            std::sort(Row.begin(), Row.end());
+            for (size_t k = 0; k < Row.size(); ++k)
+            {
+                Adj[Idx[n] + k] = Row[k].first;
+                Weights[Idx[n] + k] = Row[k].second;
+            }
+        }
+    }, -1, 1024);
+
+    return cut::WeightedAdjacencyList<WeightT>(std::move(Idx), std::move(Adj), std::move(Weights));
+}
+
+/**
+ * @brief       Reorder an adjacency list in place.
+ * 
+ * @details     This function computes the given ordering of the nodes of the list
+ *              and renumbers the list accordingly. The returned permutation maps
+ *              the new indices back to the old ones, and vice versa.
+ * 
+ *              The list must be exactly a cut::CompatAdjacencyList: the data of a
+ *              derived list, such as the weights of a cut::WeightedAdjacencyList reached
+ *              through a reference to its base, would be lost.
+ * 
+ * @param G The adjacency list.
+ * @param Order The ordering to apply.
+ * @return cut::NodePermutation The applied permutation and its inverse.
+ * 
+ * @throws cut::AssertionError if <code>G</code> is of a type derived from cut::CompatAdjacencyList.
+ */
+cut::NodePermutation Reorder(cut::CompatAdjacencyList& G,
+                             cut::NodeOrdering Order = REVERSE_CUTHILL_MCKEE);
+
+/**
+ * @brief       Reorder a weighted adjacency list in place.
+ * 
+ * @details     This function behaves as cut::Reorder() for a cut::CompatAdjacencyList,
+ *              and the weights move along with their connections.
+ * 
+ * @param G The weighted adjacency list.
+ * @param Order The ordering to apply.
+ * @return cut::NodePermutation The applied permutation and its inverse.
+ * 
+ * @tparam WeightT The type of the weights.
+ */
+template<typename WeightT>
+cut::NodePermutation Reorder(cut::WeightedAdjacencyList<WeightT>& G,
+                             cut::NodeOrdering Order = REVERSE_CUTHILL_MCKEE)
+{
+    cut::NodePermutation P = cut::ComputeOrdering(G, Order);
+    G = cut::Permute(G, P);
+    return P;
+}
+
+
+} // namespace cut
\ No newline at end of file
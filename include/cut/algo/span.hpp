@@ -0,0 +1,131 @@
+/**
+ * @file        span.hpp
+ * 
+ * @brief       A lightweight read-only view over contiguous memory.
+ * 
+ * @details     This file contains the declaration of the class template cut::Span,
+ *              which provides a non-owning, read-only view over a contiguous array
+ *              of elements.\n 
+ *              The class is used by the data structures of the library to expose
+ *              their internal memory without copies and without virtual calls.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-20
+ */
+#pragma once
+
+#include <cstddef>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A read-only view over a contiguous array.
+ * 
+ * @details     The class cut::Span is a pair pointer-length that refers to a
+ *              contiguous array of elements of type T.\n 
+ *              The span does not own the memory, and it is invalidated by any
+ *              operation that reallocates or modifies the memory it refers to.\n 
+ *              The span can be iterated with a range-based for, and iterating it
+ *              reduces to a plain loop over a pointer.
+ * 
+ * @tparam T The type of the elements.
+ */
+template<typename T>
+class Span
+{
+private:
+    /**
+     * @brief       Pointer to the first element.
+     * @details     Pointer to the first element.
+     */
+    const T* m_Data;
+
+    /**
+     * @brief       Number of elements.
+     * @details     Number of elements.
+     */
+    size_t m_Size;
+
+public:
+    /**
+     * @brief       Construct an empty span.
+     * 
+     * @details     Construct an empty span.
+     */
+    Span() : m_Data(nullptr), m_Size(0) { }
+
+    /**
+     * @brief       Construct a span over an array.
+     * 
+     * @details     This constructor initializes a span over the array
+     *              of <code>Size</code> elements starting at <code>Data</code>.
+     * 
+     * @param Data The pointer to the first element.
+     * @param Size The number of elements.
+     */
+    Span(const T* Data, size_t Size) : m_Data(Data), m_Size(Size) { }
+
+    /**
+     * @brief       Pointer to the first element.
+     * 
+     * @details     Pointer to the first element.
+     * 
+     * @return const T* The pointer to the first element.
+     */
+    const T* Data() const { return m_Data; }
+
+    /**
+     * @brief       Number of elements.
+     * 
+     * @details     Number of elements.
+     * 
+     * @return size_t The number of elements in the span.
+     */
+    size_t Size() const { return m_Size; }
+
+    /**
+     * @brief       Tell if the span is empty.
+     * 
+     * @details     Tell if the span is empty.
+     * 
+     * @return true If the span has no elements.
+     * @return false If the span has at least one element.
+     */
+    bool Empty() const { return m_Size == 0; }
+
+    /**
+     * @brief       Access an element of the span.
+     * 
+     * @details     This operator returns the element in position <code>i</code>.\n 
+     *              No bound checks are performed.
+     * 
+     * @param i The position of the element.
+     * @return const T& The element in position <code>i</code>.
+     */
+    const T& operator[](size_t i) const { return m_Data[i]; }
+
+    /**
+     * @brief       Iterator to the first element.
+     * 
+     * @details     Iterator to the first element.
+     * 
+     * @return const T* The iterator to the first element.
+     */
+    const T* begin() const { return m_Data; }
+
+    /**
+     * @brief       Iterator past the last element.
+     * 
+     * @details     Iterator past the last element.
+     * 
+     * @return const T* The iterator past the last element.
+     */
+    const T* end() const { return m_Data + m_Size; }
+};
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,382 @@
+/**
+ * @file        wadjlist.hpp
+ * 
+ * @brief       A compressed adjacency list with weighted connections.
+ * 
+ * @details     This file contains the declaration and the implementation of the
+ *              class template cut::WeightedAdjacencyList, a cut::CompatAdjacencyList
+ *              that stores a weight for each connection.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-30
+ */
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/csrbuild.hpp>
+#include <cut/algo/span.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A read-only adjacency list with weighted connections.
+ * 
+ * @details     The class cut::WeightedAdjacencyList extends cut::CompatAdjacencyList
+ *              with a weight for each connection.\n 
+ *              The weights are stored in their own array, aligned with the array of the
+ *              adjacents (structure of arrays): the weight of the connection in position
+ *              <code>idx</code> of node <code>i</code> is in the same position as its
+ *              adjacent. Hence, a traversal of a row reads two contiguous streams, and the
+ *              accesses that only need the structure do not pay for the weights.\n 
+ *              The weights can be fed to the algorithms of cut::GraphSearch through
+ *              cut::WeightedAdjacencyList::EdgeWeights().
+ * 
+ * @tparam WeightT The type of the weights, usually float or double.
+ */
+template<typename WeightT = double>
+class WeightedAdjacencyList final : public cut::CompatAdjacencyList
+{
+public:
+    /**
+     * @brief       The type of the weights.
+     * @details     The type of the weights.
+     */
+    typedef WeightT WeightType;
+
+    /**
+     * @brief       A weight functor for cut::GraphSearch.
+     * 
+     * @details     This functor returns the weight of the connection in position
+     *              <code>idx</code> of node <code>i</code>. It stays valid as long as
+     *              the list it comes from is not modified or destroyed.
+     */
+    struct WeightMap
+    {
+        const int* Idx;
+        const WeightT* Weights;
+
+        WeightT operator()(int i, int idx) const { return Weights[Idx[i] + idx]; }
+    };
+
+private:
+    /**
+     * @brief       The weight of each connection.
+     * @details     The weight of each connection, aligned with <code>m_Adj</code>.
+     */
+    std::vector<WeightT> m_Weights;
+
+    /**
+     * @brief       Set all the weights to one.
+     * @details     Set all the weights to one.
+     */
+    void UnitWeights()
+    {
+        m_Weights.assign(m_Adj.size(), WeightT(1));
+    }
+
+public:
+    /**
+     * @brief       Construct an empty list.
+     * 
+     * @details     This constructor initializes a list with no nodes.
+     */
+    WeightedAdjacencyList()
+        : cut::CompatAdjacencyList(ArrayType(1, 0), ArrayType())
+    { }
+
+    /**
+     * @brief       Construct a new WeightedAdjacencyList from a list of weighted connections.
+     * 
+     * @details     This constructor initializes an adjacency list from the given list
+     *              of connections, where <code>Weights[k]</code> is the weight of
+     *              <code>Connections[k]</code>.\n 
+     *              The rows are built by cut::BuildCSR(), that moves each weight along
+     *              with its adjacent. If <code>SortAndUnique</code> is true (default), the
+     *              adjacents of each node are sorted, and among duplicated connections
+     *              only the one with the smallest weight is kept.
+     * 
+     * @param Connections A list of connections.
+     * @param Weights The weight of each connection.
+     * @param SortAndUnique Whether or not the rows must be sorted and deduplicated.
+     * @param Stats If not null, receives the statistics about the construction.
+     * 
+     * @throws cut::AssertionError if the number of weights differs from the number of connections.
+     * @throws cut::OutOfBoundError if a node or an adjacent is negative.
+     */
+    WeightedAdjacencyList(const std::vector<std::pair<int, int>>& Connections,
+                          const std::vector<WeightT>& Weights,
+                          bool SortAndUnique = true,
+                          cut::CSRBuildStats* Stats = nullptr)
+        : cut::CompatAdjacencyList(ArrayType(1, 0), ArrayType())
+    {
+        // Never compiled out, the weights are read for every connection
+        if (Connections.size() != Weights.size())
+            throw cut::AssertionError("The number of weights differs from the number of connections.");
+        cut::BuildCSR(Connections.data(), Weights.data(), Connections.size(), m_Idx, m_Adj, m_Weights, SortAndUnique, Stats);
+    }
+
+    /**
+     * @brief       Construct a list from its arrays.
+     * 
+     * @details     This constructor takes ownership of the given arrays of offsets,
+     *              adjacents and weights, without copying them (see the constructor
+     *              of cut::CompatAdjacencyList from its arrays).
+     * 
+     * @param Offsets The offsets of the rows, with one element more than the nodes.
+     * @param Adjacents The adjacents of all the rows.
+     * @param Weights The weight of each adjacent.
+     * 
+     * @throws cut::AssertionError if the number of weights differs from the number of adjacents.
+     */
+    WeightedAdjacencyList(ArrayType&& Offsets,
+                          ArrayType&& Adjacents,
+                          std::vector<WeightT>&& Weights)
+        : cut::CompatAdjacencyList(std::move(Offsets), std::move(Adjacents)),
+          m_Weights(std::move(Weights))
+    {
+        if (m_Weights.size() != m_Adj.size())
+            throw cut::AssertionError("The number of weights differs from the number of adjacents.");
+    }
+
+    /**
+     * @brief       Construct a weighted copy of an adjacency list.
+     * 
+     * @details     This constructor copies the structure of the given list, and
+     *              assigns to each connection from <code>i</code> to <code>j</code>
+     *              the weight <code>WeightOf(i, j)</code>. The weights are computed
+     *              in parallel, with the number of threads given by cut::GetNumThreads().
+     * 
+     * @param AL The list to copy.
+     * @param WeightOf The functor computing the weights.
+     * 
+     * @tparam F The type of the functor, with signature <code>WeightT(int, int)</code>.
+     */
+    template<typename F>
+    WeightedAdjacencyList(const cut::BaseAdjacencyList& AL,
+                          F WeightOf)
+        : cut::CompatAdjacencyList(AL)
+    {
+        m_Weights.resize(m_Adj.size());
+        cut::ParallelFor(0, NumNodes(), [&](size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+            {
+                for (int k = m_Idx[i]; k < m_Idx[i + 1]; ++k)
+                    m_Weights[k] = (WeightT)WeightOf((int)i, m_Adj[k]);
+            }
+        }, -1, 1024);
+    }
+
+    /**
+     * @brief       Copy constructor.
+     * 
+     * @details     This constructor initializes a list as a copy of the given one,
+     *              including its weights.
+     * 
+     * @param AL The list to copy.
+     */
+    WeightedAdjacencyList(const cut::WeightedAdjacencyList<WeightT>& AL)
+        : cut::CompatAdjacencyList(ArrayType(AL.m_Idx), ArrayType(AL.m_Adj)),
+          m_Weights(AL.m_Weights)
+    { }
+
+    /**
+     * @brief       Move constructor.
+     * 
+     * @details     This constructor initializes a list by moving the memory
+     *              of the given one. The input is left empty.
+     * 
+     * @param AL The list to move.
+     */
+    WeightedAdjacencyList(cut::WeightedAdjacencyList<WeightT>&& AL)
+        : cut::CompatAdjacencyList(std::move(AL.m_Idx), std::move(AL.m_Adj)),
+          m_Weights(std::move(AL.m_Weights))
+    {
+        AL.m_Idx.assign(1, 0);
+        AL.m_Adj.clear();
+        AL.m_Weights.clear();
+    }
+
+    /**
+     * @brief       Assignment-copy operator.
+     * 
+     * @details     This operator copies the given list. If the given list is a
+     *              cut::WeightedAdjacencyList of the same type, the weights are
+     *              copied, otherwise all the weights are set to one.
+     * 
+     * @param AL The list to copy.
+     * @return cut::BaseAdjacencyList& This list.
+     */
+    virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override
+    {
+        if (&AL == this)
+            return *this;
+        const cut::WeightedAdjacencyList<WeightT>* WAL;
+        WAL = dynamic_cast<const cut::WeightedAdjacencyList<WeightT>*>(&AL);
+        cut::CompatAdjacencyList::operator=(AL);
+        if (WAL != nullptr)
+            m_Weights = WAL->m_Weights;
+        else
+            UnitWeights();
+        return *this;
+    }
+
+    /**
+     * @brief       Assignment-move operator.
+     * 
+     * @details     This operator moves the given list. If the given list is a
+     *              cut::WeightedAdjacencyList of the same type, the weights are
+     *              moved, otherwise the list is copied and all the weights are set to one.
+     * 
+     * @param AL The list to move.
+     * @return cut::CompatAdjacencyList& This list.
+     */
+    virtual cut::CompatAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override
+    {
+        if (&AL == this)
+            return *this;
+        cut::WeightedAdjacencyList<WeightT>* WAL;
+        WAL = dynamic_cast<cut::WeightedAdjacencyList<WeightT>*>(&AL);
+        if (WAL == nullptr)
+        {
+            operator=((const cut::BaseAdjacencyList&)AL);
+            return *this;
+        }
+        m_Idx = std::move(WAL->m_Idx);
+        m_Adj = std::move(WAL->m_Adj);
+        m_Weights = std::move(WAL->m_Weights);
+        WAL->m_Idx.assign(1, 0);
+        WAL->m_Adj.clear();
+        WAL->m_Weights.clear();
+        return *this;
+    }
+
+    cut::WeightedAdjacencyList<WeightT>& operator=(const cut::WeightedAdjacencyList<WeightT>& AL)
+    {
+        operator=((const cut::BaseAdjacencyList&)AL);
+        return *this;
+    }
+
+    cut::WeightedAdjacencyList<WeightT>& operator=(cut::WeightedAdjacencyList<WeightT>&& AL)
+    {
+        operator=((cut::BaseAdjacencyList&&)AL);
+        return *this;
+    }
+
+    virtual ~WeightedAdjacencyList() { }
+
+
+    /**
+     * @brief       Return the weight of a connection.
+     * 
+     * @details     This method returns the weight of the connection in position
+     *              <code>idx</code> in the list of adjacents of node <code>i</code>.
+     * 
+     * @param i The index of a node.
+     * @param idx The index of an adjacent.
+     * @return WeightT The weight of the connection.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     * @throws cut::OutOfBoundError if <code>idx >= NumAdjacents(i)</code>.
+     */
+    WeightT GetWeight(int i, int idx) const
+    {
+        CUTCheckGEQ(i, 0);
+        CUTCheckLess(i, NumNodes());
+        CUTCheckGEQ(idx, 0);
+        CUTCheckLess(idx, NumAdjacentsUnchecked(i));
+
+        return m_Weights[m_Idx[i] + idx];
+    }
+
+    /**
+     * @brief       Return the weights of the connections of node i.
+     * 
+     * @details     This method returns a read-only view over the weights of the
+     *              connections of node <code>i</code>, aligned with the view returned
+     *              by <code>Neighbors(i)</code>.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<WeightT> The weights of the connections of the given node.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     */
+    cut::Span<WeightT> Weights(int i) const
+    {
+        CUTCheckGEQ(i, 0);
+        CUTCheckLess(i, NumNodes());
+
+        return WeightsUnchecked(i);
+    }
+
+    /**
+     * @brief       Return the weights of the connections of node i, without bound checks.
+     * 
+     * @details     Same as cut::WeightedAdjacencyList::Weights(), but the input is never checked.
+     * 
+     * @warning     Calling this method with <code>i >= NumNodes()</code> is
+     *              undefined behavior.
+     * 
+     * @param i The index of a node.
+     * @return cut::Span<WeightT> The weights of the connections of the given node.
+     */
+    cut::Span<WeightT> WeightsUnchecked(int i) const
+    {
+        return cut::Span<WeightT>(m_Weights.data() + m_Idx[i], m_Idx[i + 1] - m_Idx[i]);
+    }
+
+    /**
+     * @brief       Return the adjacents and the weights of node i.
+     * 
+     * @details     This method returns both the views of <code>Neighbors(i)</code>
+     *              and <code>Weights(i)</code>, which have the same size.
+     * 
+     * @param i The index of a node.
+     * @return std::pair<cut::Span<int>, cut::Span<WeightT>> The adjacents and their weights.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     */
+    std::pair<cut::Span<int>, cut::Span<WeightT>> WeightedNeighbors(int i) const
+    {
+        CUTCheckGEQ(i, 0);
+        CUTCheckLess(i, NumNodes());
+
+        return { NeighborsUnchecked(i), WeightsUnchecked(i) };
+    }
+
+    /**
+     * @brief       The raw array of the weights.
+     * 
+     * @details     This method returns the weights of all the connections, in
+     *              the same order of the adjacents.
+     * 
+     * @return const std::vector<WeightT>& The array of weights.
+     */
+    const std::vector<WeightT>& AllWeights() const { return m_Weights; }
+
+    /**
+     * @brief       A weight functor for cut::GraphSearch.
+     * 
+     * @details     This method returns a functor that reads the weights of this list,
+     *              to be passed to cut::GraphSearch::Dijkstra(),
+     *              cut::GraphSearch::DeltaStepping() and cut::GraphSearch::ParallelDijkstra().
+     * 
+     * @return WeightMap The weight functor.
+     */
+    WeightMap EdgeWeights() const
+    {
+        return WeightMap{ m_Idx.data(), m_Weights.data() };
+    }
+};
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,292 @@
+/**
+ * @file        zadjlist.hpp
+ * 
+ * @brief       A compressed read-only adjacency list.
+ * 
+ * @details     This file contains the declaration of the class cut::CompressedAdjacencyList,
+ *              which stores the rows of an adjacency list as gap-encoded variable-length
+ *              integers.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-02
+ */
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/span.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A compressed read-only adjacency list.
+ * 
+ * @details     The class cut::CompressedAdjacencyList stores an adjacency list in a
+ *              fraction of the memory of cut::CompatAdjacencyList, at the cost of decoding
+ *              the rows when they are read.\n 
+ *              Each row is sorted and stored in a byte array as variable-length integers
+ *              (7 bits per byte, the highest bit flags a continuation): first the number
+ *              of adjacents, then the first adjacent as a zig-zag encoded difference from
+ *              the node, and then the gaps between consecutive adjacents. Graphs with good
+ *              locality (see cut::Reorder()) have small gaps, that take one byte each.\n 
+ *              The rows are read either with the iterators of cut::CompressedAdjacencyList::Row(),
+ *              which decode the row while iterating on it, or with <code>Neighbors()</code>,
+ *              which decodes the whole row into a per-thread buffer. Random accesses with
+ *              <code>GetAdjacent()</code> take time linear in the position.
+ */
+class CompressedAdjacencyList : public cut::BaseAdjacencyList
+{
+private:
+    /**
+     * @brief       The encoded rows.
+     * @details     The encoded rows.
+     */
+    std::vector<uint8_t> m_Data;
+
+    /**
+     * @brief       The position of each block of rows in the encoded data.
+     * @details     The position of each block of rows in the encoded data.
+     */
+    std::vector<size_t> m_BlockStart;
+
+    /**
+     * @brief       The position of each row in its block.
+     * @details     The position of each row in its block.
+     */
+    std::vector<uint32_t> m_Start;
+
+    /**
+     * @brief       The total number of connections.
+     * @details     The total number of connections.
+     */
+    int m_NConnections;
+
+    /**
+     * @brief       Encode the given list.
+     * 
+     * @details     This method replaces the content of this list with the encoding
+     *              of the given one. The rows are encoded in parallel, with the number
+     *              of threads given by cut::GetNumThreads().
+     * 
+     * @param AL The list to encode.
+     */
+    void Encode(const cut::BaseAdjacencyList& AL);
+
+    /**
+     * @brief       Read a variable-length integer.
+     * 
+     * @details     This method decodes the integer at the given position, and advances
+     *              the position past it.
+     * 
+     * @param Ptr The position of the integer.
+     * @return uint64_t The decoded integer.
+     */
+    static uint64_t ReadVarint(const uint8_t*& Ptr);
+
+    /**
+     * @brief       The encoded row of node i.
+     * @details     The position of the encoded row of node i.
+     */
+    const uint8_t* RowData(int i) const;
+
+public:
+    /**
+     * @brief       The number of rows in a block.
+     * 
+     * @details     The rows are grouped in blocks, that are encoded in parallel. The
+     *              position of each block takes 8 bytes, while the position of each row
+     *              in its block takes 4 bytes, hence a block cannot exceed 4 GiB.
+     */
+    static const size_t BlockSize = 1024;
+
+public:
+    /**
+     * @brief       A forward iterator decoding a row.
+     * 
+     * @details     This iterator decodes the adjacents of a row one at a time.
+     */
+    class RowIterator
+    {
+    private:
+        const uint8_t* m_Ptr;
+        int m_Left;
+        int m_Value;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        RowIterator(const uint8_t* Ptr, int Left, int Value)
+            : m_Ptr(Ptr), m_Left(Left), m_Value(Value) { }
+
+        const int& operator*() const { return m_Value; }
+        RowIterator& operator++()
+        {
+            if (--m_Left > 0)
+                m_Value += (int)ReadVarint(m_Ptr);
+            return *this;
+        }
+        RowIterator operator++(int)
+        {
+            RowIterator Old = *this;
+            ++(*this);
+            return Old;
+        }
+        bool operator==(const RowIterator& It) const { return m_Left == It.m_Left; }
+        bool operator!=(const RowIterator& It) const { return m_Left != It.m_Left; }
+    };
+
+    /**
+     * @brief       A decoded view over a row.
+     * 
+     * @details     This range provides the iterators decoding a row, to be used in
+     *              range-based loops.
+     */
+    class RowRange
+    {
+    private:
+        RowIterator m_Begin;
+        int m_Size;
+
+    public:
+        RowRange(RowIterator Begin, int Size) : m_Begin(Begin), m_Size(Size) { }
+
+        RowIterator begin() const { return m_Begin; }
+        RowIterator end() const { return RowIterator(nullptr, 0, 0); }
+        int Size() const { return m_Size; }
+    };
+
+    /**
+     * @brief       Construct an empty list.
+     * 
+     * @details     This constructor initializes a list with no nodes.
+     */
+    CompressedAdjacencyList();
+
+    /**
+     * @brief       Construct a new CompressedAdjacencyList from a list of connections.
+     * 
+     * @details     This constructor builds the compressed list of the given connections.
+     *              Duplicated connections are kept.
+     * 
+     * @param Connections A list of connections.
+     */
+    CompressedAdjacencyList(const std::vector<std::pair<int, int>>& Connections);
+
+    /**
+     * @brief       Copy constructor.
+     * 
+     * @details     This constructor initializes a compressed copy of the given list.
+     *              If the given list is compressed, its encoding is copied, otherwise
+     *              the rows are read through the abstract interface and encoded.
+     *              The rows of the copy are sorted.
+     * 
+     * @param AL The list to copy.
+     */
+    CompressedAdjacencyList(const cut::BaseAdjacencyList& AL);
+
+    CompressedAdjacencyList(const cut::CompressedAdjacencyList& AL);
+
+    /**
+     * @brief       Move constructor.
+     * 
+     * @details     This constructor initializes a list by moving the memory
+     *              of the given one. The input is left empty.
+     * 
+     * @param AL The list to move.
+     */
+    CompressedAdjacencyList(cut::CompressedAdjacencyList&& AL);
+
+    virtual cut::BaseAdjacencyList& operator=(const cut::BaseAdjacencyList& AL) override;
+    virtual cut::CompressedAdjacencyList& operator=(cut::BaseAdjacencyList&& AL) override;
+    cut::CompressedAdjacencyList& operator=(const cut::CompressedAdjacencyList& AL);
+    cut::CompressedAdjacencyList& operator=(cut::CompressedAdjacencyList&& AL);
+    virtual ~CompressedAdjacencyList();
+
+    virtual int NumNodes() const override;
+    virtual int NumConnections() const override;
+    virtual int NumAdjacents(int i) const override;
+    virtual int GetAdjacent(int i, int idx) const override;
+    virtual cut::Span<int> Neighbors(int i) const override;
+
+    /**
+     * @brief       Return a decoded view over the adjacents of node i.
+     * 
+     * @details     This method returns a range whose iterators decode the adjacents
+     *              of node <code>i</code> in increasing order while iterating.\n 
+     *              Differently from <code>Neighbors()</code>, the row is never copied.
+     * 
+     * @param i The index of a node.
+     * @return RowRange The adjacents of the given node.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     */
+    RowRange Row(int i) const;
+
+    /**
+     * @brief       Decode the adjacents of node i.
+     * 
+     * @details     This method writes the adjacents of node <code>i</code> in increasing
+     *              order into the given array, that must have room for
+     *              <code>NumAdjacents(i)</code> integers.
+     * 
+     * @param i The index of a node.
+     * @param Out The output array.
+     * @return int The number of adjacents written.
+     * 
+     * @throws cut::OutOfBoundError if <code>i >= NumNodes()</code>.
+     */
+    int Decode(int i, int* Out) const;
+
+    /**
+     * @brief       The memory used by the list.
+     * 
+     * @details     This method returns the number of bytes used by the encoded rows
+     *              and by their starting positions.
+     * 
+     * @return size_t The memory used, in bytes.
+     */
+    size_t MemoryUsage() const;
+
+    /**
+     * @brief       The compression ratio of the list.
+     * 
+     * @details     This method returns the ratio between the memory that a
+     *              cut::CompatAdjacencyList would use for the same connections and
+     *              the memory used by this list. Values above one mean that this list
+     *              is smaller.
+     * 
+     * @return double The compression ratio.
+     */
+    double CompressionRatio() const;
+};
+
+
+inline uint64_t CompressedAdjacencyList::ReadVarint(const uint8_t*& Ptr)
+{
+    uint64_t Value = *Ptr & 0x7F;
+    int Shift = 7;
+    while (*Ptr++ & 0x80)
+    {
+        Value |= (uint64_t)(*Ptr & 0x7F) << Shift;
+        Shift += 7;
+    }
+    return Value;
+}
+
+inline const uint8_t* CompressedAdjacencyList::RowData(int i) const
+{
+    return m_Data.data() + m_BlockStart[i / BlockSize] + m_Start[i];
+}
+
+} // namespace cut
\ No newline at end of file
@@ -14,4 +14,44 @@
 #pragma once
 
 #define __CUT_HELP_2_STR(x) #x
-#define __CUT_2_STR(x) __CUT_HELP_2_STR(x)
\ No newline at end of file
+#define __CUT_2_STR(x) __CUT_HELP_2_STR(x)
+
+
+/**
+ * @brief       Level of the runtime checks.
+ * 
+ * @details     This macro determines which runtime checks are compiled in the code.\n 
+ *              With level 2 (default) all the checks are enabled.\n 
+ *              With level 1 the bound checks (CUTCheckLess(), CUTCheckLEQ(),
+ *              CUTCheckGreater() and CUTCheckGEQ()) are compiled out, while assertions
+ *              are preserved.\n 
+ *              With level 0 both bound checks and assertions (CUTAssert()) are compiled out.\n 
+ *              Null pointer checks are never compiled out.\n 
+ *              The level is usually set with the CMake option CUT_CHECKS.
+ */
+#ifndef CUT_CHECKS
+#define CUT_CHECKS 2
+#endif
+
+
+/**
+ * @brief       Hint the compiler that a condition is unlikely to be true.
+ * 
+ * @details     This macro is used to move the failure paths of the checks out of
+ *              the hot code.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define __CUT_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define __CUT_UNLIKELY(x) (x)
+#endif
+
+
+/**
+ * @brief       Concatenate two tokens, after expanding them.
+ * 
+ * @details     This macro is used to build unique names of variables in other macros,
+ *              e.g. <code>__CUT_CONCAT(Name, __LINE__)</code>.
+ */
+#define __CUT_CONCAT_HELP(a, b) a##b
+#define __CUT_CONCAT(a, b) __CUT_CONCAT_HELP(a, b)
\ No newline at end of file
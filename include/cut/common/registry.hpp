@@ -0,0 +1,236 @@
+/**
+ * @file        registry.hpp
+ * 
+ * @brief       A thread-safe registry of named objects.
+ * 
+ * @details     This file contains the declaration and the implementation of the class
+ *              template cut::Registry, used for the global loggers and timers.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-05
+ */
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A thread-safe registry of named objects.
+ * 
+ * @details     The class cut::Registry associates objects to unique names, and can be
+ *              used concurrently by any number of threads.\n 
+ *              The registry is read-mostly: the map is never modified, but replaced by a
+ *              modified copy under a lock, and a version counter is advanced. Each thread
+ *              keeps its own reference to the last map it has seen, hence a lookup only
+ *              reads the version counter and searches the map, without any lock, unless
+ *              the registry changed since the previous lookup from the same thread.\n 
+ *              The objects are kept alive by the maps referring to them: a removed object
+ *              is destroyed when no thread can reach it anymore, that is after each thread
+ *              that has looked it up performs another lookup, or exits.
+ * 
+ * @tparam T The type of the registered objects.
+ */
+template<typename T>
+class Registry
+{
+private:
+    typedef std::unordered_map<std::string, std::shared_ptr<T>> Map;
+
+    /**
+     * @brief       Serializes the modifications.
+     * @details     Serializes the modifications, and the refreshes of the per-thread maps.
+     */
+    std::mutex m_Lock;
+
+    /**
+     * @brief       The current map.
+     * @details     The current map.
+     */
+    std::shared_ptr<const Map> m_Map;
+
+    /**
+     * @brief       The version of the current map.
+     * @details     The version of the current map, advanced at each modification.
+     */
+    std::atomic<uint64_t> m_Version;
+
+    /**
+     * @brief       The map seen by the calling thread.
+     * 
+     * @details     This method returns the current map, refreshing the copy of the
+     *              calling thread only if the registry has been modified.
+     * 
+     * @return const Map& The current map.
+     */
+    const Map& Snapshot()
+    {
+        static thread_local const cut::Registry<T>* Owner = nullptr;
+        static thread_local uint64_t Version = 0;
+        static thread_local std::shared_ptr<const Map> Cache;
+
+        uint64_t Current = m_Version.load(std::memory_order_acquire);
+        if (Owner != this || Version != Current)
+        {
+            std::lock_guard<std::mutex> Guard(m_Lock);
+            Cache = m_Map;
+            Version = m_Version.load(std::memory_order_relaxed);
+            Owner = this;
+        }
+        return *Cache;
+    }
+
+public:
+    /**
+     * @brief       Create an empty registry.
+     * @details     Create an empty registry.
+     */
+    Registry()
+        : m_Map(std::make_shared<const Map>()), m_Version(1)
+    { }
+
+    Registry(const cut::Registry<T>&) = delete;
+    cut::Registry<T>& operator=(const cut::Registry<T>&) = delete;
+
+    /**
+     * @brief       Create a new object with the given name.
+     * 
+     * @details     This method constructs a new object from the given arguments and
+     *              associates it with the given name.
+     * 
+     * @param Name The name of the object.
+     * @param Args The arguments of the constructor.
+     * 
+     * @throws cut::AssertionError if an object with the same name already exists.
+     */
+    template<typename... ArgsT>
+    void Attach(const std::string& Name, ArgsT&&... Args)
+    {
+        std::shared_ptr<T> Obj = std::make_shared<T>(std::forward<ArgsT>(Args)...);
+        std::lock_guard<std::mutex> Guard(m_Lock);
+        CUTAssert(m_Map->find(Name) == m_Map->end());
+        std::shared_ptr<Map> Next = std::make_shared<Map>(*m_Map);
+        Next->emplace(Name, std::move(Obj));
+        m_Map = std::move(Next);
+        m_Version.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief       Get the object with the given name.
+     * 
+     * @details     Get the object with the given name.
+     * 
+     * @param Name The name of the object.
+     * @return T& The object with that name.
+     * 
+     * @throws cut::AssertionError if no object has the given name.
+     */
+    T& Get(const std::string& Name)
+    {
+        const Map& M = Snapshot();
+        typename Map::const_iterator It = M.find(Name);
+        if (It == M.end())
+            throw cut::AssertionError("No object is registered as " + Name + ".");
+        return *It->second;
+    }
+
+    /**
+     * @brief       Get the object with the given name, creating it if needed.
+     * 
+     * @details     This method returns the object associated with the given name. If
+     *              there is none, a new object is constructed from the given arguments
+     *              and associated with the name.
+     * 
+     * @param Name The name of the object.
+     * @param Args The arguments of the constructor.
+     * @return T& The object with that name.
+     */
+    template<typename... ArgsT>
+    T& Acquire(const std::string& Name, ArgsT&&... Args)
+    {
+        {
+            const Map& M = Snapshot();
+            typename Map::const_iterator It = M.find(Name);
+            if (It != M.end())
+                return *It->second;
+        }
+        std::lock_guard<std::mutex> Guard(m_Lock);
+        typename Map::const_iterator It = m_Map->find(Name);
+        if (It != m_Map->end())
+            return *It->second;
+        std::shared_ptr<T> Obj = std::make_shared<T>(std::forward<ArgsT>(Args)...);
+        std::shared_ptr<Map> Next = std::make_shared<Map>(*m_Map);
+        Next->emplace(Name, Obj);
+        m_Map = std::move(Next);
+        m_Version.fetch_add(1, std::memory_order_release);
+        return *Obj;
+    }
+
+    /**
+     * @brief       Visit all the objects.
+     * 
+     * @details     This method calls <code>F(Name, Object)</code> for each object in the
+     *              registry, in no particular order. The objects are those registered when
+     *              the method is called: concurrent modifications are not visible.
+     * 
+     * @param F The function to call.
+     * 
+     * @tparam FuncT The type of the function.
+     */
+    template<typename FuncT>
+    void ForEach(FuncT F)
+    {
+        std::shared_ptr<const Map> M;
+        {
+            std::lock_guard<std::mutex> Guard(m_Lock);
+            M = m_Map;
+        }
+        for (typename Map::const_iterator It = M->begin(); It != M->end(); ++It)
+            F(It->first, *It->second);
+    }
+
+    /**
+     * @brief       Delete the object with the given name.
+     * 
+     * @details     This method removes the object from the registry, and returns it so
+     *              that the caller can release its resources right away. See the class
+     *              description for when the object is destroyed.
+     * 
+     * @param Name The name of the object.
+     * @return std::shared_ptr<T> The removed object.
+     * 
+     * @throws cut::AssertionError if no object has the given name.
+     */
+    std::shared_ptr<T> Remove(const std::string& Name)
+    {
+        std::shared_ptr<T> Removed;
+        {
+            std::lock_guard<std::mutex> Guard(m_Lock);
+            typename Map::const_iterator It = m_Map->find(Name);
+            if (It == m_Map->end())
+                throw cut::AssertionError("No object is registered as " + Name + ".");
+            Removed = It->second;
+            std::shared_ptr<Map> Next = std::make_shared<Map>(*m_Map);
+            Next->erase(Name);
+            m_Map = std::move(Next);
+            m_Version.fetch_add(1, std::memory_order_release);
+        }
+        // Drop the reference of the calling thread
+        Snapshot();
+        return Removed;
+    }
+};
+
+} // namespace cut
\ No newline at end of file
@@ -16,4 +16,5 @@
 #include <cut/excepts/excepts.hpp>
 #include <cut/time/time.hpp>
 #include <cut/log.hpp>
+#include <cut/parallel/parallel.hpp>
 #include <cut/algo/algo.hpp>
\ No newline at end of file
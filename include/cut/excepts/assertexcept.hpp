@@ -14,8 +14,8 @@
 #pragma once
 
 #include <string>
-#include <stdexcept>
 #include <cut/common/common.hpp>
+#include <cut/excepts/checkexcept.hpp>
 
 namespace cut
 {
@@ -26,14 +26,8 @@ namespace cut
  * @details     The class cut::AssertionError realizes a specific instance of exception
  *              which is specifically designed for signaling the failure of an assertion.
  */
-class AssertionError : public std::runtime_error
+class AssertionError : public cut::CheckException
 {
-private:
-    /**
-     * @brief       The error message.
-     */
-    std::string m_Msg;
-
 public:
     /**
      * @brief       Construct a cut::AssertionError from a given error message.
@@ -57,14 +51,26 @@ public:
      */
     AssertionError(const std::string& Code, const std::string& File, int Line);
 
+    /**
+     * @brief       Construct a cut::AssertionError from a failed check.
+     * 
+     * @details     Construct a cut::AssertionError from the code that failed, and the file
+     *              and line of code containing it, without copying nor formatting them:
+     *              the message is formatted by what(). The strings must outlive the
+     *              exception, as the string literals passed by the check macros do.
+     * 
+     * @param Code The code raising the error.
+     * @param File The file containing the code.
+     * @param Line The line containing the code.
+     */
+    AssertionError(const char* Code, const char* File, int Line);
+
     /**
      * @brief       Default destructor.
      * 
      * @details     Default destructor.
      */
     virtual ~AssertionError();
-
-    virtual char const* what() const noexcept override;
 };
 
 
@@ -73,14 +79,20 @@ public:
  * @brief       Check assertion and throws an error.
  * 
  * @details     This macro checks if the given expression evaluates to false. If so,
- *              it throws a cut::AssertionError.
+ *              it throws a cut::AssertionError.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 1</code>. In that case
+ *              the expression is not evaluated at all.
  * 
  * @param expr The expression to evaluate.
  */
+#if CUT_CHECKS >= 1
 #define CUTAssert(expr) do {\
-    if (!(expr))\
+    if (__CUT_UNLIKELY(!(expr)))\
         throw cut::AssertionError(__CUT_2_STR(expr), __FILE__, __LINE__);\
 } while(0)
+#else
+#define CUTAssert(expr) do { } while(0)
+#endif
 
 
 } // namespace cut
@@ -14,8 +14,8 @@
 #pragma once
 
 #include <string>
-#include <stdexcept>
 #include <cut/common/common.hpp>
+#include <cut/excepts/checkexcept.hpp>
 
 namespace cut
 {
@@ -27,14 +27,8 @@ namespace cut
  *              which is specifically designed for signaling the presence of values that
  *              exceed desired bounds.
  */
-class OutOfBoundError : public std::runtime_error
+class OutOfBoundError : public cut::CheckException
 {
-private:
-    /**
-     * @brief       The error message.
-     */
-    std::string m_Msg;
-
 public:
     /**
      * @brief       Construct a cut::OutOfBoundError from a given error message.
@@ -58,14 +52,26 @@ public:
      */
     OutOfBoundError(const std::string& Code, const std::string& File, int Line);
 
+    /**
+     * @brief       Construct a cut::OutOfBoundError from a failed check.
+     * 
+     * @details     Construct a cut::OutOfBoundError from the code that failed, and the file
+     *              and line of code containing it, without copying nor formatting them:
+     *              the message is formatted by what(). The strings must outlive the
+     *              exception, as the string literals passed by the check macros do.
+     * 
+     * @param Code The code raising the error.
+     * @param File The file containing the code.
+     * @param Line The line containing the code.
+     */
+    OutOfBoundError(const char* Code, const char* File, int Line);
+
     /**
      * @brief       Default destructor.
      * 
      * @details     Default destructor.
      */
     virtual ~OutOfBoundError();
-
-    virtual char const* what() const noexcept override;
 };
 
 
@@ -73,26 +79,77 @@ public:
 
 
 
+#if CUT_CHECKS >= 2
+
+/**
+ * @brief       Check that a value is strictly less than an upper bound.
+ * 
+ * @details     This macro checks if <code>x < ub</code>. If not, it throws a
+ *              cut::OutOfBoundError.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param ub The upper bound.
+ */
 #define CUTCheckLess(x, ub) do {\
-    if ((x) >= (ub))\
+    if (__CUT_UNLIKELY((x) >= (ub)))\
         throw cut::OutOfBoundError(__CUT_2_STR((x) < (ub)), __FILE__, __LINE__);\
 } while(0)
 
+/**
+ * @brief       Check that a value is less or equal than an upper bound.
+ * 
+ * @details     This macro checks if <code>x <= ub</code>. If not, it throws a
+ *              cut::OutOfBoundError.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param ub The upper bound.
+ */
 #define CUTCheckLEQ(x, ub) do {\
-    if ((x) > (ub))\
+    if (__CUT_UNLIKELY((x) > (ub)))\
         throw cut::OutOfBoundError(__CUT_2_STR((x) <= (ub)), __FILE__, __LINE__);\
 } while(0)
 
-#define CUTCheckGreater(x, ub) do {\
-    if ((x) <= (ub))\
-        throw cut::OutOfBoundError(__CUT_2_STR((x) > (ub)), __FILE__, __LINE__);\
+/**
+ * @brief       Check that a value is strictly greater than a lower bound.
+ * 
+ * @details     This macro checks if <code>x > lb</code>. If not, it throws a
+ *              cut::OutOfBoundError.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param lb The lower bound.
+ */
+#define CUTCheckGreater(x, lb) do {\
+    if (__CUT_UNLIKELY((x) <= (lb)))\
+        throw cut::OutOfBoundError(__CUT_2_STR((x) > (lb)), __FILE__, __LINE__);\
 } while(0)
 
-#define CUTCheckGEQ(x, ub) do {\
-    if ((x) < (ub))\
-        throw cut::OutOfBoundError(__CUT_2_STR((x) >= (ub)), __FILE__, __LINE__);\
+/**
+ * @brief       Check that a value is greater or equal than a lower bound.
+ * 
+ * @details     This macro checks if <code>x >= lb</code>. If not, it throws a
+ *              cut::OutOfBoundError.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param lb The lower bound.
+ */
+#define CUTCheckGEQ(x, lb) do {\
+    if (__CUT_UNLIKELY((x) < (lb)))\
+        throw cut::OutOfBoundError(__CUT_2_STR((x) >= (lb)), __FILE__, __LINE__);\
 } while(0)
 
+#else
+
+#define CUTCheckLess(x, ub) do { } while(0)
+#define CUTCheckLEQ(x, ub) do { } while(0)
+#define CUTCheckGreater(x, lb) do { } while(0)
+#define CUTCheckGEQ(x, lb) do { } while(0)
+
+#endif
+
 
 
 } // namespace cut
@@ -0,0 +1,139 @@
+/**
+ * @file        checkexcept.hpp
+ * 
+ * @brief       This file contains the declaration of cut::CheckException, the base
+ *              class of the exceptions thrown by the runtime checks.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-07
+ */
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <stdexcept>
+#include <cut/common/common.hpp>
+
+namespace cut
+{
+
+/**
+ * @brief       The base class of the exceptions thrown by the runtime checks.
+ * 
+ * @details     The class cut::CheckException stores where a check failed: the text of
+ *              the failed check, the file and the line. They are stored as pointers to the
+ *              string literals produced by the check macros, hence throwing the exception
+ *              does not allocate memory nor format strings.\n 
+ *              The error message is only formatted the first time what() is called.
+ */
+class CheckException : public std::runtime_error
+{
+private:
+    /**
+     * @brief       The description of the failure, e.g. "Assertion failed".
+     */
+    const char* m_Kind;
+
+    /**
+     * @brief       The text of the failed check, or null if the exception has a custom message.
+     */
+    const char* m_Code;
+
+    /**
+     * @brief       The file containing the failed check.
+     */
+    const char* m_File;
+
+    /**
+     * @brief       The line containing the failed check.
+     */
+    int m_Line;
+
+    /**
+     * @brief       The error message, formatted lazily.
+     */
+    mutable std::string m_Msg;
+
+    /**
+     * @brief       Serializes the formatting of the message.
+     */
+    mutable std::mutex m_Lock;
+
+protected:
+    /**
+     * @brief       Construct an exception from a given error message.
+     * 
+     * @details     Construct an exception from a given error message.
+     * 
+     * @param Kind The description of the failure, a string literal.
+     * @param Msg The error message.
+     */
+    CheckException(const char* Kind, const std::string& Msg);
+
+    /**
+     * @brief       Construct an exception from a failed check.
+     * 
+     * @details     Construct an exception from the code that failed, and the file and
+     *              line of code containing it. The strings are not copied, and must outlive
+     *              the exception, as string literals do.
+     * 
+     * @param Kind The description of the failure, a string literal.
+     * @param Code The code raising the error.
+     * @param File The file containing the code.
+     * @param Line The line containing the code.
+     */
+    CheckException(const char* Kind, const char* Code, const char* File, int Line);
+
+    /**
+     * @brief       Format the message of a failed check.
+     * 
+     * @details     Format the message of a failed check.
+     * 
+     * @param Kind The description of the failure.
+     * @param Code The code raising the error.
+     * @param File The file containing the code.
+     * @param Line The line containing the code.
+     * @return std::string The error message.
+     */
+    static std::string Format(const char* Kind, const char* Code, const char* File, int Line);
+
+public:
+    /**
+     * @brief       Copy constructor.
+     * 
+     * @details     Copy constructor.
+     */
+    CheckException(const cut::CheckException& E);
+
+    /**
+     * @brief       Default destructor.
+     * 
+     * @details     Default destructor.
+     */
+    virtual ~CheckException();
+
+    /**
+     * @brief       The code raising the error.
+     * @details     The code raising the error, or null if the exception has a custom message.
+     */
+    const char* Code() const noexcept;
+
+    /**
+     * @brief       The file containing the code raising the error.
+     * @details     The file containing the code raising the error, or null if the exception has a custom message.
+     */
+    const char* File() const noexcept;
+
+    /**
+     * @brief       The line containing the code raising the error.
+     * @details     The line containing the code raising the error, or 0 if the exception has a custom message.
+     */
+    int Line() const noexcept;
+
+    virtual char const* what() const noexcept override;
+};
+
+} // namespace cut
\ No newline at end of file
@@ -11,6 +11,8 @@
  */
 #pragma once
 
+#include <cut/excepts/checkexcept.hpp>
 #include <cut/excepts/nullptrexcept.hpp>
 #include <cut/excepts/assertexcept.hpp>
-#include <cut/excepts/boundsexcept.hpp>
\ No newline at end of file
+#include <cut/excepts/boundsexcept.hpp>
+#include <cut/excepts/status.hpp>
\ No newline at end of file
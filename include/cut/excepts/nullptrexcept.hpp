@@ -14,8 +14,8 @@
 #pragma once
 
 #include <string>
-#include <stdexcept>
 #include <cut/common/common.hpp>
+#include <cut/excepts/checkexcept.hpp>
 
 namespace cut
 {
@@ -27,14 +27,8 @@ namespace cut
  *              which is specifically designed for signaling the presence of an unwanted
  *              null pointer.
  */
-class NullPtrError : public std::runtime_error
+class NullPtrError : public cut::CheckException
 {
-private:
-    /**
-     * @brief       The error message.
-     */
-    std::string m_Msg;
-
 public:
     /**
      * @brief       Construct a cut::NullPtrError from a given error message.
@@ -58,14 +52,26 @@ public:
      */
     NullPtrError(const std::string& Code, const std::string& File, int Line);
 
+    /**
+     * @brief       Construct a cut::NullPtrError from a failed check.
+     * 
+     * @details     Construct a cut::NullPtrError from the code that failed, and the file
+     *              and line of code containing it, without copying nor formatting them:
+     *              the message is formatted by what(). The strings must outlive the
+     *              exception, as the string literals passed by the check macros do.
+     * 
+     * @param Code The code raising the error.
+     * @param File The file containing the code.
+     * @param Line The line containing the code.
+     */
+    NullPtrError(const char* Code, const char* File, int Line);
+
     /**
      * @brief       Default destructor.
      * 
      * @details     Default destructor.
      */
     virtual ~NullPtrError();
-
-    virtual char const* what() const noexcept override;
 };
 
 
@@ -76,12 +82,13 @@ public:
  * @brief       Check if null and throws an exception.
  * 
  * @details     This macro checks if the given pointer evalautes to null. If so, 
- *              a cut::NullPtrError is thrown.
+ *              a cut::NullPtrError is thrown.\n 
+ *              This check is never compiled out, independently of CUT_CHECKS.
  * 
  * @param ptr An expression that evaluates to a pointer.
  */
 #define CUTCheckNull(ptr) do {\
-if ((ptr) == nullptr)\
+if (__CUT_UNLIKELY((ptr) == nullptr))\
     throw cut::NullPtrError(__CUT_2_STR(ptr), __FILE__, __LINE__);\
 } while(0)
 
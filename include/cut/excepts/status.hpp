@@ -0,0 +1,254 @@
+/**
+ * @file        status.hpp
+ * 
+ * @brief       This file contains the declaration of cut::CheckStatus, which records
+ *              failed checks without throwing exceptions.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-07
+ */
+#pragma once
+
+#include <cut/common/common.hpp>
+
+namespace cut
+{
+
+/**
+ * @brief       The kinds of failed checks.
+ * 
+ * @details     The kinds of failed checks, each corresponding to an exception:
+ *              cut::AssertionError, cut::OutOfBoundError and cut::NullPtrError.
+ */
+enum CheckCode
+{
+    CHECK_OK = 0,
+    CHECK_ASSERTION,
+    CHECK_BOUND,
+    CHECK_NULL
+};
+
+
+/**
+ * @brief       The status of a sequence of checks.
+ * 
+ * @details     The class cut::CheckStatus is the non-throwing alternative to the check
+ *              macros, meant for hot loops where a throw would prevent optimizations, or
+ *              where the failure must be handled after the loop.\n 
+ *              The macros CUTAssertStatus(), CUTCheckLessStatus(), CUTCheckLEQStatus(),
+ *              CUTCheckGreaterStatus(), CUTCheckGEQStatus() and CUTCheckNullStatus() record
+ *              the first failed check in a cut::CheckStatus, and the following ones are
+ *              ignored. The failure can be inspected, or turned into the exception that
+ *              the throwing macro would have thrown with Raise().\n 
+ *              The macros are compiled out at the same levels of CUT_CHECKS as their
+ *              throwing counterparts.
+ */
+class CheckStatus
+{
+private:
+    cut::CheckCode m_Code;
+    const char* m_Expr;
+    const char* m_File;
+    int m_Line;
+
+public:
+    /**
+     * @brief       Create a successful status.
+     * @details     Create a status with no failed checks.
+     */
+    CheckStatus() : m_Code(cut::CheckCode::CHECK_OK), m_Expr(nullptr), m_File(nullptr), m_Line(0) { }
+
+    /**
+     * @brief       Record a failed check.
+     * 
+     * @details     This method records a failed check, unless a check has already failed.
+     *              The strings are not copied, and must outlive the status, as string
+     *              literals do.
+     * 
+     * @param Code The kind of check.
+     * @param Expr The code of the check.
+     * @param File The file containing the check.
+     * @param Line The line containing the check.
+     */
+    void Fail(cut::CheckCode Code, const char* Expr, const char* File, int Line)
+    {
+        if (m_Code != cut::CheckCode::CHECK_OK)
+            return;
+        m_Code = Code;
+        m_Expr = Expr;
+        m_File = File;
+        m_Line = Line;
+    }
+
+    /**
+     * @brief       Determine whether or not all the checks succeeded.
+     * @details     Determine whether or not all the checks succeeded.
+     * 
+     * @return true If no check failed.
+     * @return false Otherwise.
+     */
+    bool Ok() const { return m_Code == cut::CheckCode::CHECK_OK; }
+    explicit operator bool() const { return Ok(); }
+
+    /**
+     * @brief       The kind of the first failed check.
+     * @details     The kind of the first failed check, or cut::CheckCode::CHECK_OK.
+     */
+    cut::CheckCode Code() const { return m_Code; }
+
+    /**
+     * @brief       The code of the first failed check.
+     * @details     The code of the first failed check, or null.
+     */
+    const char* Expression() const { return m_Expr; }
+
+    /**
+     * @brief       The file containing the first failed check.
+     * @details     The file containing the first failed check, or null.
+     */
+    const char* File() const { return m_File; }
+
+    /**
+     * @brief       The line containing the first failed check.
+     * @details     The line containing the first failed check, or 0.
+     */
+    int Line() const { return m_Line; }
+
+    /**
+     * @brief       Forget the failed check.
+     * @details     Forget the failed check, if any.
+     */
+    void Clear() { *this = cut::CheckStatus(); }
+
+    /**
+     * @brief       Throw the exception of the failed check.
+     * 
+     * @details     This method throws the exception corresponding to the first failed
+     *              check, as the throwing check macro would have done. It does nothing if
+     *              no check failed.
+     * 
+     * @throws cut::AssertionError if an assertion failed.
+     * @throws cut::OutOfBoundError if a bound check failed.
+     * @throws cut::NullPtrError if a null pointer check failed.
+     */
+    void Raise() const;
+};
+
+
+
+/**
+ * @brief       Check assertion and records the failure.
+ * 
+ * @details     This macro checks if the given expression evaluates to false. If so,
+ *              the failure is recorded in the given cut::CheckStatus.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 1</code>. In that case
+ *              the expression is not evaluated at all.
+ * 
+ * @param expr The expression to evaluate.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#if CUT_CHECKS >= 1
+#define CUTAssertStatus(expr, status) do {\
+    if (__CUT_UNLIKELY(!(expr)))\
+        (status).Fail(cut::CheckCode::CHECK_ASSERTION, __CUT_2_STR(expr), __FILE__, __LINE__);\
+} while(0)
+#else
+#define CUTAssertStatus(expr, status) do { } while(0)
+#endif
+
+
+#if CUT_CHECKS >= 2
+
+/**
+ * @brief       Check that a value is strictly less than an upper bound.
+ * 
+ * @details     This macro checks if <code>x < ub</code>. If not, the failure is recorded
+ *              in the given cut::CheckStatus.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param ub The upper bound.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#define CUTCheckLessStatus(x, ub, status) do {\
+    if (__CUT_UNLIKELY((x) >= (ub)))\
+        (status).Fail(cut::CheckCode::CHECK_BOUND, __CUT_2_STR((x) < (ub)), __FILE__, __LINE__);\
+} while(0)
+
+/**
+ * @brief       Check that a value is less or equal than an upper bound.
+ * 
+ * @details     This macro checks if <code>x <= ub</code>. If not, the failure is recorded
+ *              in the given cut::CheckStatus.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param ub The upper bound.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#define CUTCheckLEQStatus(x, ub, status) do {\
+    if (__CUT_UNLIKELY((x) > (ub)))\
+        (status).Fail(cut::CheckCode::CHECK_BOUND, __CUT_2_STR((x) <= (ub)), __FILE__, __LINE__);\
+} while(0)
+
+/**
+ * @brief       Check that a value is strictly greater than a lower bound.
+ * 
+ * @details     This macro checks if <code>x > lb</code>. If not, the failure is recorded
+ *              in the given cut::CheckStatus.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param lb The lower bound.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#define CUTCheckGreaterStatus(x, lb, status) do {\
+    if (__CUT_UNLIKELY((x) <= (lb)))\
+        (status).Fail(cut::CheckCode::CHECK_BOUND, __CUT_2_STR((x) > (lb)), __FILE__, __LINE__);\
+} while(0)
+
+/**
+ * @brief       Check that a value is greater or equal than a lower bound.
+ * 
+ * @details     This macro checks if <code>x >= lb</code>. If not, the failure is recorded
+ *              in the given cut::CheckStatus.\n 
+ *              The check is compiled out if <code>CUT_CHECKS < 2</code>.
+ * 
+ * @param x The value to check.
+ * @param lb The lower bound.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#define CUTCheckGEQStatus(x, lb, status) do {\
+    if (__CUT_UNLIKELY((x) < (lb)))\
+        (status).Fail(cut::CheckCode::CHECK_BOUND, __CUT_2_STR((x) >= (lb)), __FILE__, __LINE__);\
+} while(0)
+
+#else
+
+#define CUTCheckLessStatus(x, ub, status) do { } while(0)
+#define CUTCheckLEQStatus(x, ub, status) do { } while(0)
+#define CUTCheckGreaterStatus(x, lb, status) do { } while(0)
+#define CUTCheckGEQStatus(x, lb, status) do { } while(0)
+
+#endif
+
+
+/**
+ * @brief       Check if null and records the failure.
+ * 
+ * @details     This macro checks if the given pointer evalautes to null. If so, the
+ *              failure is recorded in the given cut::CheckStatus.\n 
+ *              This check is never compiled out, independently of CUT_CHECKS.
+ * 
+ * @param ptr An expression that evaluates to a pointer.
+ * @param status The cut::CheckStatus recording the failure.
+ */
+#define CUTCheckNullStatus(ptr, status) do {\
+    if (__CUT_UNLIKELY((ptr) == nullptr))\
+        (status).Fail(cut::CheckCode::CHECK_NULL, __CUT_2_STR(ptr), __FILE__, __LINE__);\
+} while(0)
+
+} // namespace cut
\ No newline at end of file
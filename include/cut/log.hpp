@@ -15,7 +15,12 @@
 
 #include <string>
 #include <fstream>
-#include <unordered_map>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cut/common/registry.hpp>
+#include <cut/time/timer.hpp>
 
 
 
@@ -75,6 +80,40 @@ enum LogType
      */
     NONE        = 0
 };
+
+
+/**
+ * @brief       Policies for full asynchronous loggers.
+ * 
+ * @details     An enumeration of the behaviors of an asynchronous logger when its
+ *              queue of pending messages is full.
+ */
+enum LogOverflow
+{
+    /**
+     * @brief       Wait for room in the queue.
+     * 
+     * @details     The logging thread waits until the background thread makes room in
+     *              the queue. No message is lost.
+     */
+    LOG_BLOCK,
+
+    /**
+     * @brief       Drop the message.
+     * 
+     * @details     The message is discarded, and the logging thread returns immediately.
+     *              The number of discarded messages is available through cut::Logger::NumDropped().
+     */
+    LOG_DROP,
+
+    /**
+     * @brief       Drop the message and report it in the log.
+     * 
+     * @details     As cut::LogOverflow::LOG_DROP, but the background thread also writes a
+     *              warning with the number of messages discarded since the last report.
+     */
+    LOG_DROP_COUNT
+};
     
 
 /**
@@ -82,7 +121,10 @@ enum LogType
  * 
  * @details     The class cut::Logger provides a set of logging operations.\n 
  *              The interface exposes logging functions, as well as masking by message type.\n 
- *              The class also allows for static access to loggers associated to unique names.
+ *              The class also allows for static access to loggers associated to unique names.\n 
+ *              A logger can be used by any number of threads: each line is written at once,
+ *              under a lock owned by the logger (or through the lock-free queue in asynchronous
+ *              mode), and the named loggers are looked up without locks (see cut::Registry).
  */
 class Logger
 {
@@ -99,26 +141,67 @@ private:
      */
     std::ofstream       m_Stream;
 
+    /**
+     * @brief       Serializes the synchronous writes to the stream.
+     * @details     Serializes the synchronous writes to the stream, so that lines never interleave.
+     */
+    std::mutex          m_WriteLock;
+
     /**
      * @brief       The mask determining which type of messages must be logged.
      * @details     The mask determining which type of messages must be logged.
      */
-    cut::LogType        m_Mask;
+    std::atomic<int>    m_Mask;
 
     /**
      * @brief       Determines whether or not timestamps must be attached to messages.
      * @details     Determines whether or not timestamps must be attached to messages.
      */
-    bool                m_Timestamp;
+    std::atomic<bool>   m_Timestamp;
+
+    /**
+     * @brief       The precision of the timestamps.
+     * @details     The precision of the timestamps, as a cut::TimerPrecision.
+     */
+    std::atomic<int>    m_Precision;
+
+
+    /**
+     * @brief       The state of the asynchronous mode.
+     * @details     The queue and the background thread of the asynchronous mode.
+     */
+    struct AsyncBackend;
+
+    /**
+     * @brief       The asynchronous backend, if running.
+     * @details     The asynchronous backend, null when the logger is synchronous.
+     *              The logging methods read it without locks, so it is atomic.
+     */
+    std::atomic<AsyncBackend*> m_Async;
+
+    /**
+     * @brief       The loop of the background thread.
+     * 
+     * @details     This method pops the pending messages, formats them in a buffer
+     *              and writes the buffer to the stream in large chunks. The stream is
+     *              flushed when the flush interval expires, on request, and on exit.
+     */
+    void AsyncLoop();
 
 
     /**
      * @brief       The map associating static loggers to their names.
      * @details     The map associating static loggers to their names.
      */
-    static std::unordered_map<std::string, cut::Logger> m_Logs;
+    static cut::Registry<cut::Logger> m_Logs;
     
 public:
+    /**
+     * @brief       The default capacity of the asynchronous queue.
+     * @details     The default number of messages that can be pending in asynchronous mode.
+     */
+    static const size_t DefaultQueueCapacity = 8192;
+
     /**
      * @brief       Create a new logger.
      * 
@@ -138,13 +221,78 @@ public:
     /**
      * @brief       Destroy the logger and closes the stream.
      * 
-     * @details     Destroy the logger and closes the stream.
+     * @details     Destroy the logger and closes the stream. If the logger is asynchronous,
+     *              the pending messages are written first.
      */
     ~Logger();
 
 
 
 
+    /**
+     * @brief       Switch to asynchronous logging.
+     * 
+     * @details     This method starts a background thread that owns the stream. From now on,
+     *              the logging methods only capture the timestamp and push the message into a
+     *              bounded lock-free queue. The background thread formats the messages in
+     *              batches, writes them with large buffered writes, and flushes the stream
+     *              every <code>FlushInterval</code> instead of once per message.
+     *              When the queue is full, the logging methods behave as dictated by
+     *              <code>Policy</code> (see cut::LogOverflow).\n 
+     *              Other threads can keep logging while this method runs: the messages
+     *              written before the switch go straight to the stream, the later ones
+     *              through the queue.
+     *              If the logger is already asynchronous, nothing happens.
+     * 
+     * @param QueueCapacity The maximum number of pending messages.
+     * @param FlushInterval The maximum time a written message waits before the stream is flushed.
+     * @param Policy The behavior when the queue is full.
+     */
+    void StartAsync(size_t QueueCapacity = DefaultQueueCapacity,
+                    std::chrono::milliseconds FlushInterval = std::chrono::milliseconds(100),
+                    cut::LogOverflow Policy = cut::LogOverflow::LOG_BLOCK);
+
+    /**
+     * @brief       Switch back to synchronous logging.
+     * 
+     * @details     This method writes all the pending messages, flushes the stream and
+     *              stops the background thread.\n 
+     *              No thread must be logging while this method runs.
+     *              If the logger is synchronous, nothing happens.
+     */
+    void StopAsync();
+
+    /**
+     * @brief       Determine whether or not the logger is asynchronous.
+     * 
+     * @details     Determine whether or not the logger is asynchronous.
+     * 
+     * @return true If the logger is asynchronous.
+     * @return false If the logger is synchronous.
+     */
+    bool IsAsync() const;
+
+    /**
+     * @brief       Flush the logger.
+     * 
+     * @details     This method returns when all the messages logged so far are written
+     *              and the stream is flushed.
+     */
+    void Flush();
+
+    /**
+     * @brief       The number of dropped messages.
+     * 
+     * @details     This method returns the number of messages that have been discarded
+     *              because the asynchronous queue was full, since the last call to StartAsync().
+     * 
+     * @return size_t The number of dropped messages.
+     */
+    size_t NumDropped() const;
+
+
+
+
     /**
      * @brief       Logs a message of the given type.
      * 
@@ -299,6 +447,28 @@ public:
      */
     void DisableTimestamps();
 
+    /**
+     * @brief       Return the precision of the timestamps.
+     * 
+     * @details     Return the precision of the fraction of second in the timestamps.
+     * 
+     * @return cut::TimerPrecision The precision of the timestamps.
+     */
+    cut::TimerPrecision GetTimestampPrecision() const;
+
+    /**
+     * @brief       Set the precision of the timestamps.
+     * 
+     * @details     This method sets the precision of the fraction of second attached to
+     *              the timestamps of the messages. The default is cut::TimerPrecision::SECONDS,
+     *              that prints no fraction of second.\n 
+     *              Other threads can keep logging while this method runs. In asynchronous
+     *              mode, the messages already queued keep the precision they were logged with.
+     * 
+     * @param Precision The precision of the timestamps.
+     */
+    void SetTimestampPrecision(cut::TimerPrecision Precision);
+
 
 
 
@@ -339,6 +509,9 @@ public:
      * @brief       Deletes the logger with the given name.
      * 
      * @details     Deletes the logger with the given name.\n 
+     *              The pending messages are written and the file is closed before returning,
+     *              even if other threads still have the logger cached (see cut::Registry).
+     *              No thread must be logging with this logger while this method runs.\n 
      *              If a logger with this name does not exist, a cut::AssertError is thrown.
      * 
      * @param Name The name of a global logger.
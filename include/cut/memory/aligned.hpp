@@ -0,0 +1,224 @@
+/**
+ * @file        aligned.hpp
+ * 
+ * @brief       Aligned memory allocation with placement policies.
+ * 
+ * @details     This file contains the aligned variants of the allocation functions in
+ *              allocation.hpp, and the class template cut::AlignedAllocator, which lets
+ *              the STL containers use them.\n 
+ *              Besides the alignment, a cut::MemoryPolicy can request transparent huge
+ *              pages, the binding of the memory to a NUMA node, and the first-touch
+ *              placement of the pages by the threads of the library.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-09
+ */
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <cut/excepts/excepts.hpp>
+
+namespace cut
+{
+
+/**
+ * @brief       The size of a cache line.
+ * @details     The size of a cache line, in bytes. It is also the width of the widest
+ *              SIMD registers (AVX-512), hence the default alignment.
+ */
+const size_t CacheLineSize = 64;
+
+
+/**
+ * @brief       The placement of an aligned allocation.
+ * 
+ * @details     The struct cut::MemoryPolicy describes how the memory of an aligned
+ *              allocation is requested to the system:
+ *              - <code>Alignment</code> is the alignment of the memory, a power of two;
+ *              - if <code>HugePages</code> is true, the allocations larger than a huge page
+ *                are aligned to the huge pages and advised as such (MADV_HUGEPAGE);
+ *              - if <code>Node</code> is not negative, the pages are bound to the given
+ *                NUMA node;
+ *              - if <code>FirstTouch</code> is true, the pages are touched for the first time
+ *                by the threads of cut::ParallelFor(), with the number of threads given by
+ *                cut::GetNumThreads(). With the first-touch policy of the system, each
+ *                page is placed on the node of the thread that later processes the same
+ *                range with the same static partition.
+ * 
+ *              The huge pages and the NUMA placement are hints: they are only available on
+ *              Linux, they do not apply to the allocations smaller than a page, and they
+ *              are silently ignored if the system refuses them.
+ */
+struct MemoryPolicy
+{
+    size_t Alignment;
+    bool HugePages;
+    int Node;
+    bool FirstTouch;
+
+    MemoryPolicy(size_t Alignment = cut::CacheLineSize,
+                 bool HugePages = false,
+                 int Node = -1,
+                 bool FirstTouch = false)
+        : Alignment(Alignment), HugePages(HugePages), Node(Node), FirstTouch(FirstTouch)
+    { }
+};
+
+/**
+ * @brief       Set the default memory policy.
+ * 
+ * @details     This function sets the policy used by the default-constructed
+ *              cut::AlignedAllocator instances, and hence by the arrays of
+ *              cut::CompatAdjacencyList. The containers keep the policy they were
+ *              created with.\n 
+ *              The default is cache-line alignment, without huge pages and first-touch
+ *              placement, which must be requested explicitly.
+ * 
+ * @param P The new default policy.
+ * 
+ * @throws cut::AssertionError if the alignment is not a power of two.
+ */
+void SetDefaultMemoryPolicy(const cut::MemoryPolicy& P);
+
+/**
+ * @brief       The default memory policy.
+ * @details     The policy set with cut::SetDefaultMemoryPolicy().
+ * 
+ * @return cut::MemoryPolicy The default memory policy.
+ */
+cut::MemoryPolicy GetDefaultMemoryPolicy();
+
+/**
+ * @brief       The number of NUMA nodes.
+ * @details     The number of NUMA nodes of the system, 1 if it cannot be determined.
+ * 
+ * @return int The number of NUMA nodes.
+ */
+int NumNumaNodes();
+
+/**
+ * @brief       Allocate aligned memory.
+ * 
+ * @details     This function returns uninitialized memory of the given size, placed
+ *              according to the given policy. The memory must be released with
+ *              cut::AlignedFree().
+ * 
+ * @param Bytes The number of bytes.
+ * @param P The placement of the memory.
+ * @return void* The allocated memory.
+ * 
+ * @throws cut::AssertionError if the alignment is not a power of two.
+ * @throws cut::NullPtrError if the allocation fails.
+ */
+void* AlignedAllocate(size_t Bytes, const cut::MemoryPolicy& P = cut::MemoryPolicy());
+
+/**
+ * @brief       Release aligned memory.
+ * @details     Release the memory returned by cut::AlignedAllocate() or its variants.
+ * 
+ * @param Ptr The memory to release, or null.
+ */
+void AlignedFree(void* Ptr);
+
+
+template<typename T>
+T* AlignedMalloc(size_t numel, const cut::MemoryPolicy& P = cut::MemoryPolicy())
+{
+    CUTAssert(numel <= std::numeric_limits<size_t>::max() / sizeof(T));
+    CUTAssert(P.Alignment >= alignof(T));
+    return (T*)cut::AlignedAllocate(numel * sizeof(T), P);
+}
+
+template<typename T>
+T* AlignedCalloc(size_t numel, const cut::MemoryPolicy& P = cut::MemoryPolicy())
+{
+    T* res = cut::AlignedMalloc<T>(numel, P);
+    std::memset(res, 0, numel * sizeof(T));
+    return res;
+}
+
+template<typename T>
+T* AlignedAllocCopy(const T* src, size_t numel, const cut::MemoryPolicy& P = cut::MemoryPolicy())
+{
+    T* res = cut::AlignedMalloc<T>(numel, P);
+    std::memcpy(res, src, numel * sizeof(T));
+    return res;
+}
+
+
+
+/**
+ * @brief       An STL allocator serving aligned memory.
+ * 
+ * @details     The class template cut::AlignedAllocator lets a container allocate its
+ *              memory with cut::AlignedAllocate(), following a cut::MemoryPolicy.
+ *              The default-constructed allocators use the policy returned by
+ *              cut::GetDefaultMemoryPolicy() at the time of their construction.\n 
+ *              All the allocators are equal, since the memory can be released by
+ *              any of them.
+ * 
+ * @tparam T The type of the allocated elements.
+ */
+template<typename T>
+class AlignedAllocator
+{
+private:
+    template<typename U> friend class AlignedAllocator;
+
+    cut::MemoryPolicy m_Policy;
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    AlignedAllocator() : m_Policy(cut::GetDefaultMemoryPolicy()) { }
+
+    /**
+     * @brief       Create an allocator with the given policy.
+     * @details     Create an allocator with the given policy.
+     * 
+     * @param P The placement of the memory.
+     */
+    explicit AlignedAllocator(const cut::MemoryPolicy& P) noexcept : m_Policy(P) { }
+
+    template<typename U>
+    AlignedAllocator(const cut::AlignedAllocator<U>& Other) noexcept : m_Policy(Other.m_Policy) { }
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_alloc();
+        cut::MemoryPolicy P = m_Policy;
+        if (P.Alignment < alignof(T))
+            P.Alignment = alignof(T);
+        return (T*)cut::AlignedAllocate(n * sizeof(T), P);
+    }
+
+    void deallocate(T* p, size_t) noexcept
+    {
+        cut::AlignedFree(p);
+    }
+
+    /**
+     * @brief       The policy of the allocator.
+     * @details     The policy of the allocator.
+     * 
+     * @return const cut::MemoryPolicy& The policy.
+     */
+    const cut::MemoryPolicy& Policy() const noexcept { return m_Policy; }
+
+    template<typename U>
+    bool operator==(const cut::AlignedAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const cut::AlignedAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace cut
\ No newline at end of file
@@ -16,6 +16,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <cut/excepts/excepts.hpp>
 
 namespace cut
@@ -56,10 +57,8 @@ template<typename T>
 T* AllocInit(size_t numel, const T& value)
 {
     T* res = cut::Malloc<T>(numel);
-    for (size_t i = 0; i < numel; ++i)
-        res[i] = value;
-    // for (size_t i = 0; i < numel; ++i)
-    //     std::memcpy(res + i, &value, sizeof(T));
+    // The compilers turn std::fill_n into vectorized stores, or into memset for bytes
+    std::fill_n(res, numel, value);
     return res;
 }
 
@@ -0,0 +1,353 @@
+/**
+ * @file        arena.hpp
+ * 
+ * @brief       Arena allocation.
+ * 
+ * @details     This file contains the class cut::Arena, a bump-pointer allocator that
+ *              serves many small allocations from a few large blocks, and the class
+ *              template cut::ArenaAllocator, which lets the STL containers allocate
+ *              from an arena.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-08
+ */
+#pragma once
+
+#include <new>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <cut/excepts/excepts.hpp>
+
+namespace cut
+{
+
+/**
+ * @brief       A bump-pointer memory arena.
+ * 
+ * @details     The class cut::Arena allocates memory from large blocks, by advancing
+ *              a pointer. An allocation costs a few instructions, and the memory is not
+ *              released by the single allocations, but all at once when the arena is
+ *              rewound, reset, or destroyed.\n 
+ *              Memory can also be allocated in blocks of fixed size classes (powers of two)
+ *              with AllocateBlock(), and given back with ReleaseBlock(). The released blocks
+ *              are kept in a free list per size class, and reused by the next allocations
+ *              of the same class, or split to serve the smaller classes. This is how
+ *              cut::ArenaAllocator serves the containers that grow and shrink, without
+ *              fragmenting the memory outside the arena.\n 
+ *              Released blocks are never merged, hence a request larger than every
+ *              released block takes new memory from the arena. The arena can then hold
+ *              more than the peak usage, e.g. when many rows keep doubling their capacity,
+ *              until it is reset.\n 
+ *              The arena is not thread-safe.
+ */
+class Arena
+{
+public:
+    /**
+     * @brief       The default size of the blocks.
+     * @details     The default size of the blocks requested to the system, in bytes.
+     */
+    static const size_t DefaultBlockSize = 1 << 20;
+
+    /**
+     * @brief       A position in the arena.
+     * 
+     * @details     The struct cut::Arena::Marker identifies the state of the arena at
+     *              some point (see cut::Arena::Mark() and cut::Arena::Rewind()).
+     */
+    struct Marker
+    {
+        size_t Block;
+        size_t Offset;
+        size_t Allocated;
+    };
+
+private:
+    /**
+     * @brief       The number of size classes.
+     * @details     The number of size classes of AllocateBlock(), one per power of two.
+     */
+    static const size_t NumClasses = 64;
+
+    /**
+     * @brief       The smallest size class.
+     * @details     The smallest size class of AllocateBlock(), in bytes.
+     */
+    static const size_t MinClassSize = 16;
+
+    struct Block
+    {
+        char* Data;
+        size_t Size;
+    };
+
+    /**
+     * @brief       A released block, in the free list of its size class.
+     */
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    std::vector<Block> m_Blocks;
+    size_t m_Current;
+    size_t m_Offset;
+    size_t m_BlockSize;
+    size_t m_Allocated;
+    FreeBlock* m_Free[NumClasses];
+
+    /**
+     * @brief       The size class of an allocation.
+     * @details     The index of the smallest size class fitting the given number of bytes.
+     */
+    static size_t ClassOf(size_t Bytes)
+    {
+        size_t C = 4;
+        while (((size_t)1 << C) < Bytes)
+            C++;
+        return C;
+    }
+
+    /**
+     * @brief       Move to a block with the given free space.
+     * @details     Move to a block with at least the given free space, allocating it if needed.
+     */
+    void NextBlock(size_t Bytes);
+
+    /**
+     * @brief       Forget the released blocks.
+     * @details     Forget the released blocks.
+     */
+    void ClearFreeLists();
+
+public:
+    /**
+     * @brief       Create an empty arena.
+     * 
+     * @details     This constructor creates an arena that requests memory to the system
+     *              in blocks of the given size. Larger allocations get a block of their own.
+     *              No memory is requested until the first allocation.
+     * 
+     * @param BlockSize The size of the blocks, in bytes.
+     * 
+     * @throws cut::OutOfBoundError if <code>BlockSize</code> is 0.
+     */
+    explicit Arena(size_t BlockSize = DefaultBlockSize);
+
+    /**
+     * @brief       Release all the memory.
+     * 
+     * @details     The destructor releases all the memory to the system. The objects
+     *              allocated in the arena are not destroyed.
+     */
+    ~Arena();
+
+    Arena(const cut::Arena&) = delete;
+    cut::Arena& operator=(const cut::Arena&) = delete;
+
+    /**
+     * @brief       Allocate memory.
+     * 
+     * @details     This method returns uninitialized memory of the given size and
+     *              alignment. The memory is valid until the arena is rewound before
+     *              this allocation, reset or destroyed.
+     * 
+     * @param Bytes The number of bytes.
+     * @param Align The alignment, a power of two.
+     * @return void* The allocated memory.
+     * 
+     * @throws cut::AssertionError if <code>Align</code> is not a power of two.
+     */
+    void* Allocate(size_t Bytes, size_t Align = alignof(std::max_align_t))
+    {
+        CUTAssert(Align > 0 && (Align & (Align - 1)) == 0);
+        if (m_Current < m_Blocks.size())
+        {
+            const Block& B = m_Blocks[m_Current];
+            size_t Addr = (size_t)(B.Data + m_Offset);
+            size_t Pad = (Align - (Addr & (Align - 1))) & (Align - 1);
+            if (Pad + Bytes <= B.Size - m_Offset)
+            {
+                void* Ptr = B.Data + m_Offset + Pad;
+                m_Offset += Pad + Bytes;
+                m_Allocated += Pad + Bytes;
+                return Ptr;
+            }
+        }
+        NextBlock(Bytes + Align);
+        return Allocate(Bytes, Align);
+    }
+
+    /**
+     * @brief       Allocate an array.
+     * 
+     * @details     This method returns uninitialized memory for the given number of
+     *              elements of type <code>T</code> (see cut::Malloc()).
+     * 
+     * @param numel The number of elements.
+     * @return T* The allocated memory.
+     * 
+     * @tparam T The type of the elements.
+     */
+    template<typename T>
+    T* Malloc(size_t numel)
+    {
+        CUTAssert(numel <= std::numeric_limits<size_t>::max() / sizeof(T));
+        return (T*)Allocate(numel * sizeof(T), alignof(T));
+    }
+
+    /**
+     * @brief       Allocate a block of a size class.
+     * 
+     * @details     This method returns a block of at least the given size, rounded up to
+     *              a power of two, and aligned to 16 bytes. A block of the same class
+     *              released with ReleaseBlock() is reused if available, otherwise the
+     *              smallest larger released block is split.
+     * 
+     * @param Bytes The number of bytes.
+     * @return void* The allocated block.
+     */
+    void* AllocateBlock(size_t Bytes);
+
+    /**
+     * @brief       Release a block of a size class.
+     * 
+     * @details     This method gives back a block returned by AllocateBlock() with
+     *              the same size, so that it can be reused.
+     * 
+     * @param Ptr The block.
+     * @param Bytes The size requested to AllocateBlock().
+     */
+    void ReleaseBlock(void* Ptr, size_t Bytes);
+
+    /**
+     * @brief       Mark the current position.
+     * 
+     * @details     This method returns the current position in the arena, that can be
+     *              restored with Rewind().
+     * 
+     * @return cut::Arena::Marker The current position.
+     */
+    cut::Arena::Marker Mark() const;
+
+    /**
+     * @brief       Restore a position.
+     * 
+     * @details     This method frees all the memory allocated after the given position
+     *              was marked, keeping it reserved for the next allocations. The released
+     *              blocks of all the size classes are forgotten, since they may be past
+     *              the position.
+     * 
+     * @param M A position returned by Mark().
+     * 
+     * @throws cut::OutOfBoundError if the position is past the current one.
+     */
+    void Rewind(const cut::Arena::Marker& M);
+
+    /**
+     * @brief       Free all the allocations.
+     * 
+     * @details     This method frees all the allocations, keeping the memory reserved
+     *              for the next ones.
+     */
+    void Reset();
+
+    /**
+     * @brief       Release all the memory.
+     * @details     Free all the allocations, and release all the memory to the system.
+     */
+    void Release();
+
+    /**
+     * @brief       The allocated memory.
+     * 
+     * @details     The number of bytes allocated since the last reset, including the
+     *              alignment and the released blocks.
+     * 
+     * @return size_t The allocated memory, in bytes.
+     */
+    size_t BytesAllocated() const;
+
+    /**
+     * @brief       The reserved memory.
+     * @details     The number of bytes requested to the system.
+     * 
+     * @return size_t The reserved memory, in bytes.
+     */
+    size_t BytesReserved() const;
+};
+
+
+
+/**
+ * @brief       An STL allocator serving from a cut::Arena.
+ * 
+ * @details     The class template cut::ArenaAllocator lets a container allocate its
+ *              memory from a cut::Arena, through cut::Arena::AllocateBlock() and
+ *              cut::Arena::ReleaseBlock(). The arena must outlive the container.\n 
+ *              For example, all the rows of a <code>std::vector<std::vector<int, cut::ArenaAllocator<int>>></code>
+ *              can share an arena, instead of being separate allocations of the heap.\n 
+ *              Two allocators are equal if they use the same arena. The allocator
+ *              follows the moves and swaps of the containers, but not their copies: a copy
+ *              of a container uses the same arena as the original.
+ * 
+ * @tparam T The type of the allocated elements.
+ */
+template<typename T>
+class ArenaAllocator
+{
+private:
+    template<typename U> friend class ArenaAllocator;
+
+    cut::Arena* m_Arena;
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    static_assert(alignof(T) <= 16, "cut::ArenaAllocator only supports alignments up to 16 bytes.");
+
+    /**
+     * @brief       Create an allocator for the given arena.
+     * @details     Create an allocator for the given arena.
+     * 
+     * @param A The arena.
+     */
+    explicit ArenaAllocator(cut::Arena& A) noexcept : m_Arena(&A) { }
+
+    template<typename U>
+    ArenaAllocator(const cut::ArenaAllocator<U>& Other) noexcept : m_Arena(Other.m_Arena) { }
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_alloc();
+        return (T*)m_Arena->AllocateBlock(n * sizeof(T));
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        m_Arena->ReleaseBlock(p, n * sizeof(T));
+    }
+
+    /**
+     * @brief       The arena of the allocator.
+     * @details     The arena of the allocator.
+     * 
+     * @return cut::Arena& The arena.
+     */
+    cut::Arena& GetArena() const noexcept { return *m_Arena; }
+
+    template<typename U>
+    bool operator==(const cut::ArenaAllocator<U>& Other) const noexcept { return m_Arena == Other.m_Arena; }
+    template<typename U>
+    bool operator!=(const cut::ArenaAllocator<U>& Other) const noexcept { return m_Arena != Other.m_Arena; }
+};
+
+} // namespace cut
\ No newline at end of file
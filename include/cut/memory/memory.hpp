@@ -11,4 +11,7 @@
  */
 #pragma once
 
-#include <cut/memory/allocation.hpp>
\ No newline at end of file
+#include <cut/memory/allocation.hpp>
+#include <cut/memory/arena.hpp>
+#include <cut/memory/pool.hpp>
+#include <cut/memory/aligned.hpp>
\ No newline at end of file
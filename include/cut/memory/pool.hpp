@@ -0,0 +1,188 @@
+/**
+ * @file        pool.hpp
+ * 
+ * @brief       Pools of objects of the same type.
+ * 
+ * @details     This file contains the declaration and the implementation of the class
+ *              template cut::ObjectPool, an allocator of fixed-size objects.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-08
+ */
+#pragma once
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <cut/excepts/excepts.hpp>
+
+namespace cut
+{
+
+/**
+ * @brief       A pool of objects of the same type.
+ * 
+ * @details     The class template cut::ObjectPool allocates objects of type <code>T</code>
+ *              from chunks of slots. The free slots are linked in a list, hence both the
+ *              allocation and the deallocation cost a few instructions, and the memory of
+ *              a deallocated object is reused by the next allocation.\n 
+ *              The chunks grow geometrically, and are only released to the system when
+ *              the pool is destroyed. The pool does not destroy the objects still allocated
+ *              when it is destroyed.\n 
+ *              The pool is not thread-safe.
+ * 
+ * @tparam T The type of the objects.
+ */
+template<typename T>
+class ObjectPool
+{
+private:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "cut::ObjectPool does not support over-aligned types.");
+
+    /**
+     * @brief       A slot of the pool, either holding an object or linked in the free list.
+     */
+    union Slot
+    {
+        Slot* Next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_Chunks;
+    Slot* m_Free;
+    size_t m_NextChunk;
+    size_t m_Capacity;
+    size_t m_Live;
+
+    /**
+     * @brief       Allocate a new chunk.
+     * @details     Allocate a new chunk, and link its slots in the free list.
+     */
+    void Grow()
+    {
+        std::unique_ptr<Slot[]> Chunk(new Slot[m_NextChunk]);
+        for (size_t i = 0; i < m_NextChunk; ++i)
+            Chunk[i].Next = (i + 1 < m_NextChunk) ? &Chunk[i + 1] : m_Free;
+        m_Free = &Chunk[0];
+        m_Chunks.push_back(std::move(Chunk));
+        m_Capacity += m_NextChunk;
+        m_NextChunk *= 2;
+    }
+
+public:
+    /**
+     * @brief       Create an empty pool.
+     * 
+     * @details     This constructor creates a pool whose first chunk has the given number
+     *              of slots. No memory is allocated until the first allocation.
+     * 
+     * @param ChunkSize The number of slots of the first chunk.
+     * 
+     * @throws cut::OutOfBoundError if <code>ChunkSize</code> is 0.
+     */
+    explicit ObjectPool(size_t ChunkSize = 64)
+        : m_Free(nullptr), m_NextChunk(ChunkSize), m_Capacity(0), m_Live(0)
+    {
+        CUTCheckGreater(ChunkSize, (size_t)0);
+    }
+
+    ObjectPool(const cut::ObjectPool<T>&) = delete;
+    cut::ObjectPool<T>& operator=(const cut::ObjectPool<T>&) = delete;
+
+    /**
+     * @brief       Allocate a slot.
+     * 
+     * @details     This method returns uninitialized memory for an object of type <code>T</code>.
+     * 
+     * @return void* The allocated memory.
+     */
+    void* Allocate()
+    {
+        if (m_Free == nullptr)
+            Grow();
+        Slot* S = m_Free;
+        m_Free = S->Next;
+        m_Live++;
+        return S;
+    }
+
+    /**
+     * @brief       Deallocate a slot.
+     * 
+     * @details     This method gives back the memory returned by Allocate(), without
+     *              destroying the object it holds.
+     * 
+     * @param Ptr The memory to deallocate.
+     */
+    void Deallocate(void* Ptr)
+    {
+        if (Ptr == nullptr)
+            return;
+        Slot* S = (Slot*)Ptr;
+        S->Next = m_Free;
+        m_Free = S;
+        m_Live--;
+    }
+
+    /**
+     * @brief       Create an object.
+     * 
+     * @details     This method constructs an object from the given arguments in a slot of the pool.
+     * 
+     * @param Args The arguments of the constructor.
+     * @return T* The new object.
+     */
+    template<typename... ArgsT>
+    T* New(ArgsT&&... Args)
+    {
+        void* Ptr = Allocate();
+        try
+        {
+            return new (Ptr) T(std::forward<ArgsT>(Args)...);
+        }
+        catch(...)
+        {
+            Deallocate(Ptr);
+            throw;
+        }
+    }
+
+    /**
+     * @brief       Destroy an object.
+     * 
+     * @details     This method destroys an object returned by New(), and gives back its slot.
+     * 
+     * @param Obj The object to destroy.
+     */
+    void Delete(T* Obj)
+    {
+        if (Obj == nullptr)
+            return;
+        Obj->~T();
+        Deallocate(Obj);
+    }
+
+    /**
+     * @brief       The number of allocated objects.
+     * @details     The number of slots currently allocated.
+     * 
+     * @return size_t The number of allocated objects.
+     */
+    size_t Size() const { return m_Live; }
+
+    /**
+     * @brief       The number of slots.
+     * @details     The number of slots in all the chunks.
+     * 
+     * @return size_t The number of slots.
+     */
+    size_t Capacity() const { return m_Capacity; }
+};
+
+} // namespace cut
\ No newline at end of file
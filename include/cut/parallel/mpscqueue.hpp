@@ -0,0 +1,172 @@
+/**
+ * @file        mpscqueue.hpp
+ * 
+ * @brief       A bounded lock-free queue for many producers and one consumer.
+ * 
+ * @details     This file contains the declaration and the implementation of the
+ *              class template cut::MPSCQueue.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-04
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A bounded lock-free queue for many producers and one consumer.
+ * 
+ * @details     The class cut::MPSCQueue is a ring buffer that any number of threads
+ *              can push into, while a single thread pops from it.\n 
+ *              Each cell carries a sequence number telling whether it is free or full
+ *              for the current lap of the ring: producers reserve a cell with an atomic
+ *              increment of the tail and publish it by advancing its sequence, hence
+ *              they never wait for each other, and never take a lock. The capacity is
+ *              rounded up to a power of two.
+ * 
+ * @tparam T The type of the elements, that must be default constructible and movable.
+ */
+template<typename T>
+class MPSCQueue
+{
+private:
+    struct Cell
+    {
+        std::atomic<size_t> Seq;
+        T Value;
+    };
+
+    /**
+     * @brief       The cells of the ring.
+     * @details     The cells of the ring.
+     */
+    std::unique_ptr<Cell[]> m_Cells;
+
+    /**
+     * @brief       The number of cells minus one.
+     * @details     The number of cells minus one, used to wrap the positions.
+     */
+    size_t m_Mask;
+
+    /**
+     * @brief       The next position to push, shared by the producers.
+     * @details     The next position to push, shared by the producers.
+     */
+    std::atomic<size_t> m_Tail;
+
+    /**
+     * @brief       Padding between the producers' and the consumer's positions.
+     * @details     Padding that keeps the two positions on different cache lines.
+     */
+    char m_Pad[64];
+
+    /**
+     * @brief       The next position to pop, owned by the consumer.
+     * @details     The next position to pop, owned by the consumer.
+     */
+    size_t m_Head;
+
+public:
+    /**
+     * @brief       Create an empty queue.
+     * 
+     * @details     This constructor allocates a ring of at least <code>Capacity</code> cells.
+     * 
+     * @param Capacity The minimum number of elements the queue can hold.
+     * 
+     * @throws cut::AssertionError if <code>Capacity</code> is zero.
+     */
+    explicit MPSCQueue(size_t Capacity)
+        : m_Tail(0), m_Head(0)
+    {
+        CUTAssert(Capacity > 0);
+        size_t Size = 1;
+        while (Size < Capacity)
+            Size <<= 1;
+        m_Cells.reset(new Cell[Size]);
+        for (size_t i = 0; i < Size; ++i)
+            m_Cells[i].Seq.store(i, std::memory_order_relaxed);
+        m_Mask = Size - 1;
+    }
+
+    MPSCQueue(const cut::MPSCQueue<T>&) = delete;
+    cut::MPSCQueue<T>& operator=(const cut::MPSCQueue<T>&) = delete;
+
+    /**
+     * @brief       The number of elements the queue can hold.
+     * @details     The number of elements the queue can hold.
+     * 
+     * @return size_t The capacity of the queue.
+     */
+    size_t Capacity() const { return m_Mask + 1; }
+
+    /**
+     * @brief       Push an element, if there is room.
+     * 
+     * @details     This method moves the given element into the queue. It can be called
+     *              concurrently by any number of threads. If the queue is full, the
+     *              element is left untouched and the method returns false.
+     * 
+     * @param Value The element to push.
+     * @return true If the element has been pushed.
+     * @return false If the queue is full.
+     */
+    bool TryPush(T& Value)
+    {
+        size_t Pos = m_Tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell& C = m_Cells[Pos & m_Mask];
+            size_t Seq = C.Seq.load(std::memory_order_acquire);
+            std::ptrdiff_t Diff = (std::ptrdiff_t)Seq - (std::ptrdiff_t)Pos;
+            if (Diff == 0)
+            {
+                // The cell is free for this lap, try to reserve it
+                if (m_Tail.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+                {
+                    C.Value = std::move(Value);
+                    C.Seq.store(Pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Diff < 0)
+                return false;
+            else
+                Pos = m_Tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief       Pop an element, if any.
+     * 
+     * @details     This method moves the oldest published element out of the queue.
+     *              It must be called by a single thread at a time.
+     * 
+     * @param Value The popped element.
+     * @return true If an element has been popped.
+     * @return false If the queue is empty.
+     */
+    bool TryPop(T& Value)
+    {
+        Cell& C = m_Cells[m_Head & m_Mask];
+        size_t Seq = C.Seq.load(std::memory_order_acquire);
+        if (Seq != m_Head + 1)
+            return false;
+        Value = std::move(C.Value);
+        C.Seq.store(m_Head + m_Mask + 1, std::memory_order_release);
+        m_Head++;
+        return true;
+    }
+};
+
+} // namespace cut
\ No newline at end of file
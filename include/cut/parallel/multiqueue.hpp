@@ -0,0 +1,198 @@
+/**
+ * @file        multiqueue.hpp
+ * 
+ * @brief       A relaxed priority queue shared by many threads.
+ * 
+ * @details     This file contains the declaration of the class cut::MultiQueue,
+ *              a concurrent priority queue that trades the exact order of the
+ *              extractions for scalability.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-14
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+
+namespace cut
+{
+
+/**
+ * @brief       A relaxed priority queue shared by many threads.
+ * 
+ * @details     The class cut::MultiQueue keeps several binary min-heaps, each with
+ *              its own lock, and it can be used concurrently by any number of threads
+ *              (Rihani, Sanders and Dementiev, 2015).\n 
+ *              cut::MultiQueue::Push() adds the element to a random heap.
+ *              cut::MultiQueue::TryExtractApproxMin() looks at the minimum keys of two
+ *              random heaps, without locking them, and extracts from the smaller one.
+ *              When a heap is locked by another thread, the operation picks other heaps
+ *              instead of waiting, so threads rarely contend.\n 
+ *              The extracted element is not always the minimum of the whole queue, but
+ *              its rank is small on average, which suits label-correcting algorithms
+ *              such as cut::GraphSearch::ParallelDijkstra().\n 
+ *              Differently from cut::MinHeap, the queue does not track its elements:
+ *              an element can be in the queue many times, with different keys. This
+ *              makes cut::MultiQueue::DecreaseKey() a new insertion, and the caller
+ *              skips the stale entries when they are extracted.
+ */
+class MultiQueue
+{
+private:
+    /**
+     * @brief       A heap and its lock.
+     * 
+     * @details     The minimum key of the heap is mirrored in an atomic, so that
+     *              extractions can compare heaps without locking them. The padding
+     *              keeps the hot fields of different heaps on different cache lines.
+     */
+    struct Queue
+    {
+        std::mutex Lock;
+        std::vector<std::pair<double, size_t>> Heap;
+        std::atomic<double> Top;
+        char Pad[64];
+    };
+
+    /**
+     * @brief       The heaps.
+     * @details     The heaps.
+     */
+    std::unique_ptr<Queue[]> m_Queues;
+
+    /**
+     * @brief       The number of heaps.
+     * @details     The number of heaps.
+     */
+    size_t m_NumQueues;
+
+    /**
+     * @brief       The number of entries in the queue.
+     * 
+     * @details     The number of entries in the queue. It is incremented before an
+     *              entry is added and decremented after it is removed, so that it
+     *              never underestimates the entries in the heaps.
+     */
+    std::atomic<size_t> m_Size;
+
+    /**
+     * @brief       The number of random attempts before looking at every heap.
+     * @details     The number of random attempts before looking at every heap.
+     */
+    static const int NumAttempts = 8;
+
+    size_t RandomQueue() const;
+    void PopLocked(Queue& Q, std::pair<double, size_t>& Min);
+
+public:
+    /**
+     * @brief       Create an empty queue.
+     * 
+     * @details     This constructor creates a queue with <code>QueuesPerThread</code>
+     *              heaps for each of the given threads. More heaps per thread reduce
+     *              the contention, but extract elements of higher rank.
+     * 
+     * @param NumThreads The number of threads (see cut::ResolveNumThreads()).
+     * @param QueuesPerThread The number of heaps for each thread.
+     * 
+     * @throws cut::OutOfBoundError if <code>QueuesPerThread <= 0</code>.
+     */
+    explicit MultiQueue(int NumThreads = -1,
+                        int QueuesPerThread = 2);
+
+    MultiQueue(const cut::MultiQueue&) = delete;
+    cut::MultiQueue& operator=(const cut::MultiQueue&) = delete;
+
+    /**
+     * @brief       The number of heaps.
+     * @details     The number of heaps.
+     * 
+     * @return size_t The number of heaps.
+     */
+    size_t NumQueues() const;
+
+    /**
+     * @brief       The number of entries in the queue.
+     * 
+     * @details     This method returns the number of entries in the queue. While other
+     *              threads push or extract, the value may count entries that are being
+     *              added or removed.
+     * 
+     * @return size_t The number of entries.
+     */
+    size_t Size() const;
+
+    /**
+     * @brief       Checks whether the queue is empty.
+     * 
+     * @details     This method returns true if the queue has no entries, with the
+     *              same approximation of cut::MultiQueue::Size().
+     * 
+     * @return bool Whether or not the queue is empty.
+     */
+    bool Empty() const;
+
+    /**
+     * @brief       Adds an element to the queue.
+     * 
+     * @details     This method adds the given element to a random heap, associating it
+     *              to the given key. It can be called concurrently by any number of threads.
+     * 
+     * @param Element The element to add.
+     * @param Key The key of the element.
+     */
+    void Push(size_t Element,
+              double Key);
+
+    /**
+     * @brief       Lowers the key of an element.
+     * 
+     * @details     This method inserts the element again with the new key, as
+     *              cut::MultiQueue::Push(). The entry with the old key stays in the
+     *              queue, and the caller must recognize and skip it when it is extracted.
+     * 
+     * @param Element The element.
+     * @param NewKey The new key of the element.
+     */
+    void DecreaseKey(size_t Element,
+                     double NewKey);
+
+    /**
+     * @brief       Removes an element with a small key.
+     * 
+     * @details     This method removes the minimum entry of one of the heaps, chosen as
+     *              the smaller of two random ones. It can be called concurrently by any
+     *              number of threads.\n 
+     *              The method fails only when the queue is empty. If the random heaps keep
+     *              being empty or locked, the method looks at all the heaps in order.
+     * 
+     * @param Min The removed pair (key, element).
+     * @return true If an entry has been removed.
+     * @return false If the queue is empty.
+     */
+    bool TryExtractApproxMin(std::pair<double, size_t>& Min);
+
+    /**
+     * @brief       Removes all the elements from the queue.
+     * 
+     * @details     This method empties all the heaps, keeping their memory. It must
+     *              not be called while other threads use the queue.
+     */
+    void Clear();
+};
+
+
+inline void MultiQueue::DecreaseKey(size_t Element, double NewKey)
+{
+    Push(Element, NewKey);
+}
+
+} // namespace cut
\ No newline at end of file
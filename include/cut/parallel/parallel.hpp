@@ -0,0 +1,200 @@
+/**
+ * @file        parallel.hpp
+ * 
+ * @brief       Minimal multithreading primitives.
+ * 
+ * @details     This file contains the functions used by the library to split work
+ *              across multiple threads: a global knob for the number of threads,
+ *              a parallel loop over a range of indices, and a parallel prefix sum.\n 
+ *              The primitives are built on top of std::thread, hence they do not
+ *              require any external dependency.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-22
+ */
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <exception>
+#include <mutex>
+#include <algorithm>
+#include <cstddef>
+
+
+namespace cut
+{
+
+/**
+ * @brief       Set the number of threads used by the library.
+ * 
+ * @details     This function sets the number of threads that the parallel
+ *              algorithms of the library use when the caller does not specify it.\n 
+ *              A value of 0 means that all the hardware threads are used.\n 
+ *              The default is 1, meaning that the library runs sequentially.
+ * 
+ * @param NumThreads The number of threads.
+ * 
+ * @throws cut::OutOfBoundError if <code>NumThreads < 0</code>.
+ */
+void SetNumThreads(int NumThreads);
+
+/**
+ * @brief       Get the number of threads used by the library.
+ * 
+ * @details     This function returns the number of threads that the parallel
+ *              algorithms of the library use, as set by cut::SetNumThreads().\n 
+ *              The returned value is always at least 1.
+ * 
+ * @return int The number of threads.
+ */
+int GetNumThreads();
+
+/**
+ * @brief       Resolve a thread count.
+ * 
+ * @details     This function resolves a thread count requested by the caller:
+ *              a negative value selects the global setting (see cut::GetNumThreads()),
+ *              zero selects all the hardware threads, and a positive value is
+ *              returned unchanged.
+ * 
+ * @param NumThreads The requested number of threads.
+ * @return int The number of threads to use, always at least 1.
+ */
+int ResolveNumThreads(int NumThreads);
+
+
+/**
+ * @brief       Run a loop over a range of indices in parallel.
+ * 
+ * @details     This function splits the range <code>[Begin, End)</code> in blocks of
+ *              <code>Grain</code> indices, and makes <code>NumThreads</code> threads
+ *              process them, calling <code>Body(b, e)</code> for each block
+ *              <code>[b, e)</code>. Blocks are assigned dynamically, so unbalanced
+ *              blocks do not stall the loop.\n 
+ *              If <code>Grain</code> is 0, the range is split in one block per thread.\n 
+ *              The calling thread takes part to the loop. If the loop requires a single
+ *              thread, the body is called directly, without spawning threads.\n 
+ *              If a body throws, the remaining blocks are skipped and the first exception
+ *              is rethrown to the caller.
+ * 
+ * @param Begin The first index of the range.
+ * @param End The end of the range.
+ * @param Body The callable processing a block.
+ * @param NumThreads The number of threads (see cut::ResolveNumThreads()).
+ * @param Grain The number of indices in each block.
+ * 
+ * @tparam F The type of the callable, with signature <code>void(size_t, size_t)</code>.
+ */
+template<typename F>
+void ParallelFor(size_t Begin,
+                 size_t End,
+                 F Body,
+                 int NumThreads = -1,
+                 size_t Grain = 0)
+{
+    if (End <= Begin)
+        return;
+    size_t N = End - Begin;
+    size_t T = cut::ResolveNumThreads(NumThreads);
+    if (Grain == 0)
+        Grain = (N + T - 1) / T;
+    size_t NBlocks = (N + Grain - 1) / Grain;
+    T = std::min(T, NBlocks);
+    if (T <= 1)
+    {
+        Body(Begin, End);
+        return;
+    }
+
+    std::atomic<size_t> Next(0);
+    std::exception_ptr Error;
+    std::mutex ErrorLock;
+    auto Worker = [&]()
+    {
+        while (true)
+        {
+            size_t Blk = Next.fetch_add(1);
+            if (Blk >= NBlocks)
+                break;
+            size_t b = Begin + Blk * Grain;
+            size_t e = std::min(b + Grain, End);
+            try
+            {
+                Body(b, e);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> Lock(ErrorLock);
+                if (!Error)
+                    Error = std::current_exception();
+                Next.store(NBlocks);
+            }
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(T - 1);
+    for (size_t t = 1; t < T; ++t)
+        Threads.emplace_back(Worker);
+    Worker();
+    for (std::thread& th : Threads)
+        th.join();
+
+    if (Error)
+        std::rethrow_exception(Error);
+}
+
+
+/**
+ * @brief       Compute an inclusive prefix sum in parallel.
+ * 
+ * @details     This function replaces each element of the array with the sum
+ *              of all the elements up to it, included.\n 
+ *              The array is split in one chunk per thread: each thread sums its chunk,
+ *              the partial sums are scanned sequentially, and each thread finally
+ *              offsets its chunk.
+ * 
+ * @param Data The array to scan.
+ * @param N The number of elements in the array.
+ * @param NumThreads The number of threads (see cut::ResolveNumThreads()).
+ * 
+ * @tparam T The type of the elements.
+ */
+template<typename T>
+void ParallelPrefixSum(T* Data,
+                       size_t N,
+                       int NumThreads = -1)
+{
+    size_t NT = cut::ResolveNumThreads(NumThreads);
+    // Small arrays are not worth the threads
+    if (NT <= 1 || N < 4096 * NT)
+    {
+        for (size_t i = 1; i < N; ++i)
+            Data[i] += Data[i - 1];
+        return;
+    }
+
+    size_t Chunk = (N + NT - 1) / NT;
+    std::vector<T> Partials(NT + 1, T(0));
+    cut::ParallelFor(0, N, [&](size_t b, size_t e)
+    {
+        for (size_t i = b + 1; i < e; ++i)
+            Data[i] += Data[i - 1];
+        Partials[b / Chunk + 1] = Data[e - 1];
+    }, (int)NT, Chunk);
+    for (size_t t = 1; t <= NT; ++t)
+        Partials[t] += Partials[t - 1];
+    cut::ParallelFor(Chunk, N, [&](size_t b, size_t e)
+    {
+        T Offset = Partials[b / Chunk];
+        for (size_t i = b; i < e; ++i)
+            Data[i] += Offset;
+    }, (int)NT, Chunk);
+}
+
+} // namespace cut
\ No newline at end of file
@@ -0,0 +1,495 @@
+/**
+ * @file        profiler.hpp
+ * 
+ * @brief       Low-overhead profiling of code regions.
+ * 
+ * @details     This file contains the classes used to measure the time spent in
+ *              named regions of code: a monotonic tick clock, the per-region statistics
+ *              with a fixed-size histogram, a scoped timer, and the collection of nested
+ *              regions into traces that can be exported.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-06
+ */
+#pragma once
+
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <cut/common/macros.hpp>
+
+#ifndef CUT_PROFILE_RDTSC
+#define CUT_PROFILE_RDTSC 0
+#endif
+
+#ifndef CUT_PROFILE_LIBRARY
+#define CUT_PROFILE_LIBRARY 0
+#endif
+
+#if CUT_PROFILE_RDTSC && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define __CUT_HAS_RDTSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define __CUT_HAS_RDTSC 0
+#endif
+
+
+namespace cut
+{
+
+/**
+ * @brief       A monotonic clock for profiling.
+ * 
+ * @details     The class cut::ProfileClock reads a monotonic counter of ticks.\n 
+ *              By default, the ticks are the nanoseconds of std::chrono::steady_clock.
+ *              If the library is compiled with the CMake option CUT_PROFILE_RDTSC on an
+ *              x86 processor, the ticks are read from the time stamp counter, which is
+ *              cheaper, and are converted to nanoseconds with a rate calibrated against
+ *              std::chrono::steady_clock at the first conversion. The time stamp counter
+ *              must be invariant, as on all recent x86 processors.
+ */
+class ProfileClock
+{
+public:
+    /**
+     * @brief       Read the clock.
+     * @details     Read the current value of the clock, in ticks.
+     * 
+     * @return uint64_t The current value of the clock.
+     */
+    static uint64_t Now()
+    {
+#if __CUT_HAS_RDTSC
+        return (uint64_t)__rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * @brief       The duration of a tick.
+     * @details     The duration of a tick, in nanoseconds.
+     * 
+     * @return double The nanoseconds per tick.
+     */
+    static double NanosecondsPerTick();
+
+    /**
+     * @brief       Determine whether or not the clock reads the time stamp counter.
+     * @details     Determine whether or not the clock reads the time stamp counter.
+     * 
+     * @return true If the ticks come from the time stamp counter.
+     * @return false If the ticks come from std::chrono::steady_clock.
+     */
+    static bool IsTSC();
+};
+
+
+/**
+ * @brief       Statistics of a profiled region.
+ * 
+ * @details     The struct cut::ProfileStats summarizes the samples of a cut::ProfileRegion.
+ *              All the times are in nanoseconds. The percentiles are approximated
+ *              by the histogram, within 12.5% of the true value.
+ */
+struct ProfileStats
+{
+    uint64_t Count;
+    double Total;
+    double Mean;
+    double Min;
+    double P50;
+    double P90;
+    double P99;
+    double Max;
+};
+
+
+/**
+ * @brief       A profiled region of code.
+ * 
+ * @details     The class cut::ProfileRegion collects the durations of the executions of
+ *              a region of code: the number of samples, their total, minimum and maximum,
+ *              and a histogram with logarithmic buckets, eight per power of two, from
+ *              which the percentiles are read.\n 
+ *              The memory is fixed, and recording a sample only takes a few relaxed atomic
+ *              operations, hence a region can be recorded concurrently by any number of
+ *              threads, and left enabled in production.\n 
+ *              The regions are usually named, and accessed with cut::ProfileRegion::Get()
+ *              or the macro CUTProfileScope().
+ */
+class ProfileRegion
+{
+public:
+    /**
+     * @brief       The number of buckets of the histogram.
+     * @details     The number of buckets of the histogram, eight per power of two of a 64 bit tick count.
+     */
+    static const size_t NumBuckets = 496;
+
+private:
+    std::string m_Name;
+    uint32_t m_Id;
+    std::atomic<uint64_t> m_Count;
+    std::atomic<uint64_t> m_Total;
+    std::atomic<uint64_t> m_Min;
+    std::atomic<uint64_t> m_Max;
+    std::atomic<uint64_t> m_Buckets[NumBuckets];
+
+    /**
+     * @brief       The bucket of a duration.
+     * @details     The bucket of the histogram containing the given number of ticks.
+     */
+    static size_t BucketOf(uint64_t Ticks)
+    {
+        if (Ticks < 8)
+            return (size_t)Ticks;
+#if defined(__GNUC__) || defined(__clang__)
+        size_t Exp = 63 - __builtin_clzll((unsigned long long)Ticks);
+#else
+        size_t Exp = 0;
+        for (uint64_t T = Ticks; T > 1; T >>= 1)
+            Exp++;
+#endif
+        return (Exp - 2) * 8 + (size_t)((Ticks >> (Exp - 3)) & 7);
+    }
+
+    /**
+     * @brief       The smallest duration in a bucket.
+     * @details     The smallest number of ticks falling in the given bucket.
+     */
+    static uint64_t BucketBegin(size_t B);
+
+public:
+    /**
+     * @brief       Create an empty region.
+     * 
+     * @details     This constructor creates a region with no samples, and assigns it
+     *              a unique identifier.
+     * 
+     * @param Name The name of the region.
+     */
+    explicit ProfileRegion(const std::string& Name = std::string());
+
+    /**
+     * @brief       The name of the region.
+     * @details     The name of the region.
+     * 
+     * @return const std::string& The name of the region.
+     */
+    const std::string& Name() const;
+
+    /**
+     * @brief       The identifier of the region.
+     * @details     The unique identifier of the region, assigned in order of creation.
+     * 
+     * @return uint32_t The identifier of the region.
+     */
+    uint32_t Id() const;
+
+    ProfileRegion(const cut::ProfileRegion&) = delete;
+    cut::ProfileRegion& operator=(const cut::ProfileRegion&) = delete;
+
+    /**
+     * @brief       Record a sample.
+     * 
+     * @details     This method adds a sample of the given duration, as measured by
+     *              cut::ProfileClock.
+     * 
+     * @param Ticks The duration of the sample, in ticks.
+     */
+    void Record(uint64_t Ticks)
+    {
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+        m_Total.fetch_add(Ticks, std::memory_order_relaxed);
+        m_Buckets[BucketOf(Ticks)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t Cur = m_Min.load(std::memory_order_relaxed);
+        while (Ticks < Cur && !m_Min.compare_exchange_weak(Cur, Ticks, std::memory_order_relaxed)) { }
+        Cur = m_Max.load(std::memory_order_relaxed);
+        while (Ticks > Cur && !m_Max.compare_exchange_weak(Cur, Ticks, std::memory_order_relaxed)) { }
+    }
+
+    /**
+     * @brief       The number of samples.
+     * @details     The number of samples.
+     * 
+     * @return uint64_t The number of samples.
+     */
+    uint64_t Count() const;
+
+    /**
+     * @brief       Return a percentile of the samples.
+     * 
+     * @details     This method returns the duration below which lies the given fraction
+     *              of the samples, approximated by the histogram.
+     * 
+     * @param Q The fraction of the samples, in [0, 1].
+     * @return double The percentile, in nanoseconds, or 0 if there are no samples.
+     * 
+     * @throws cut::AssertionError if <code>Q</code> is not in [0, 1].
+     */
+    double Percentile(double Q) const;
+
+    /**
+     * @brief       Return the statistics of the samples.
+     * 
+     * @details     This method returns a summary of the samples recorded so far. The
+     *              samples recorded concurrently may be partially accounted.
+     * 
+     * @return cut::ProfileStats The statistics of the samples.
+     */
+    cut::ProfileStats Stats() const;
+
+    /**
+     * @brief       Delete all the samples.
+     * @details     Delete all the samples. It must not run concurrently with Record().
+     */
+    void Reset();
+
+
+    /**
+     * @brief       Get the region with the given name.
+     * 
+     * @details     This method returns the global region associated with the given name,
+     *              creating it if needed.
+     * 
+     * @param Name The name of the region.
+     * @return cut::ProfileRegion& The region with the given name.
+     */
+    static cut::ProfileRegion& Get(const std::string& Name);
+
+    /**
+     * @brief       Return the statistics of all the global regions.
+     * 
+     * @details     This method returns the name and the statistics of each global region,
+     *              sorted by name.
+     * 
+     * @return std::vector<std::pair<std::string, cut::ProfileStats>> The statistics of the regions.
+     */
+    static std::vector<std::pair<std::string, cut::ProfileStats>> AllStats();
+};
+
+
+/**
+ * @brief       An execution of a profiled region.
+ * 
+ * @details     The struct cut::ProfileEvent is an entry of a trace: the region, the thread
+ *              that executed it, the clock ticks when it began and ended, and its depth,
+ *              that is the number of profiled scopes enclosing it in the same thread.
+ */
+struct ProfileEvent
+{
+    const cut::ProfileRegion* Region;
+    uint64_t Begin;
+    uint64_t End;
+    uint32_t Depth;
+    uint32_t Thread;
+};
+
+
+class ScopedProfile;
+
+/**
+ * @brief       Collection and export of traces.
+ * 
+ * @details     The class cut::Profiler collects the executions of the profiled scopes
+ *              (see cut::ScopedProfile) while tracing is active.\n 
+ *              Each thread appends its events to its own buffer, and the buffers are only
+ *              merged when the trace is read, hence tracing does not synchronize the threads.
+ *              When tracing is inactive, the scopes only update their regions.\n 
+ *              A trace can be exported in the JSON format of the Chrome tracing tools
+ *              (chrome://tracing, Perfetto), or summarized in a text report, where the regions
+ *              are arranged in the tree of their nesting.
+ */
+class Profiler
+{
+private:
+    friend class cut::ScopedProfile;
+
+    /**
+     * @brief       Whether or not tracing is active.
+     * @details     Whether or not tracing is active.
+     */
+    static std::atomic<bool> m_Tracing;
+
+    /**
+     * @brief       The number of profiled scopes open in the calling thread.
+     * @details     The number of profiled scopes open in the calling thread.
+     */
+    static thread_local uint32_t m_Depth;
+
+    /**
+     * @brief       Append an event to the buffer of the calling thread.
+     * @details     Append an event to the buffer of the calling thread.
+     */
+    static void Trace(const cut::ProfileRegion& Region, uint64_t Begin, uint64_t End, uint32_t Depth);
+
+public:
+    /**
+     * @brief       The default number of events per thread.
+     * @details     The default maximum number of events kept for each thread.
+     */
+    static const size_t DefaultMaxEvents = 1 << 20;
+
+    /**
+     * @brief       Start tracing.
+     * 
+     * @details     This method starts collecting events, in addition to those already
+     *              collected. When a thread has collected the given number of events,
+     *              its other events are dropped.
+     * 
+     * @param MaxEventsPerThread The maximum number of events kept for each thread.
+     */
+    static void StartTracing(size_t MaxEventsPerThread = DefaultMaxEvents);
+
+    /**
+     * @brief       Stop tracing.
+     * @details     Stop collecting events. The events already collected are kept.
+     */
+    static void StopTracing();
+
+    /**
+     * @brief       Determine whether or not tracing is active.
+     * @details     Determine whether or not tracing is active.
+     * 
+     * @return true If tracing is active.
+     * @return false Otherwise.
+     */
+    static bool IsTracing();
+
+    /**
+     * @brief       Delete all the collected events.
+     * @details     Delete all the collected events, and reset the number of dropped events.
+     */
+    static void ClearTrace();
+
+    /**
+     * @brief       The number of dropped events.
+     * @details     The number of events dropped because a thread buffer was full.
+     * 
+     * @return size_t The number of dropped events.
+     */
+    static size_t NumDroppedEvents();
+
+    /**
+     * @brief       Return the collected events.
+     * 
+     * @details     This method merges the buffers of all the threads, including those that
+     *              have exited, and returns the events sorted by thread, then by beginning,
+     *              so that each event follows those enclosing it.
+     * 
+     * @return std::vector<cut::ProfileEvent> The collected events.
+     */
+    static std::vector<cut::ProfileEvent> CollectTrace();
+
+    /**
+     * @brief       Export the collected events to a Chrome trace.
+     * 
+     * @details     This method writes the collected events in the Trace Event Format,
+     *              as complete events with timestamps in microseconds from the first event.
+     * 
+     * @param Out The output stream.
+     */
+    static void WriteChromeTrace(std::ostream& Out);
+
+    /**
+     * @brief       Export the collected events to a Chrome trace file.
+     * 
+     * @details     Export the collected events to a Chrome trace file
+     *              (see cut::Profiler::WriteChromeTrace(std::ostream&)).
+     * 
+     * @param Filename The name of the output file.
+     * 
+     * @throws cut::AssertionError if the file cannot be opened.
+     */
+    static void WriteChromeTrace(const std::string& Filename);
+
+    /**
+     * @brief       Write a text report.
+     * 
+     * @details     This method writes a table with the statistics of all the global
+     *              regions, followed, if there are collected events, by their tree of calls:
+     *              for each path of nested regions, the number of executions and the time
+     *              spent in total and excluding the nested regions, summed over the threads.
+     * 
+     * @param Out The output stream.
+     */
+    static void WriteReport(std::ostream& Out);
+};
+
+
+/**
+ * @brief       A scoped profiling timer.
+ * 
+ * @details     The class cut::ScopedProfile reads cut::ProfileClock when it is created,
+ *              and records the elapsed ticks in a cut::ProfileRegion when it is destroyed.
+ *              If tracing is active, the execution is also added to the trace
+ *              (see cut::Profiler).
+ */
+class ScopedProfile
+{
+private:
+    cut::ProfileRegion& m_Region;
+    uint32_t m_Depth;
+    uint64_t m_Start;
+
+public:
+    explicit ScopedProfile(cut::ProfileRegion& Region)
+        : m_Region(Region), m_Depth(cut::Profiler::m_Depth++), m_Start(cut::ProfileClock::Now())
+    { }
+
+    ~ScopedProfile()
+    {
+        uint64_t End = cut::ProfileClock::Now();
+        m_Region.Record(End - m_Start);
+        cut::Profiler::m_Depth = m_Depth;
+        if (__CUT_UNLIKELY(cut::Profiler::m_Tracing.load(std::memory_order_relaxed)))
+            cut::Profiler::Trace(m_Region, m_Start, End, m_Depth);
+    }
+
+    ScopedProfile(const cut::ScopedProfile&) = delete;
+    cut::ScopedProfile& operator=(const cut::ScopedProfile&) = delete;
+};
+
+/**
+ * @brief       Profile the rest of the enclosing scope.
+ * 
+ * @details     This macro records the time from its expansion to the end of the enclosing
+ *              scope in the global region with the given name. The region is looked up only
+ *              the first time the line is executed, hence the overhead is two clock reads
+ *              and the recording of the sample.
+ * 
+ * @param Name The name of the region, a string literal.
+ */
+#define CUTProfileScope(Name) \
+    static cut::ProfileRegion& __CUT_CONCAT(__CUTProfRegion, __LINE__) = cut::ProfileRegion::Get(Name); \
+    cut::ScopedProfile __CUT_CONCAT(__CUTProfScope, __LINE__)(__CUT_CONCAT(__CUTProfRegion, __LINE__))
+
+/**
+ * @brief       Profile the rest of the enclosing scope, inside the library.
+ * 
+ * @details     This macro is used to instrument the library itself. It is equivalent to
+ *              CUTProfileScope() if the library is compiled with the CMake option
+ *              CUT_PROFILE_LIBRARY, and does nothing otherwise.
+ * 
+ * @param Name The name of the region, a string literal.
+ */
+#if CUT_PROFILE_LIBRARY
+#define __CUTProfileLibrary(Name) CUTProfileScope(Name)
+#else
+#define __CUTProfileLibrary(Name) do { } while(0)
+#endif
+
+} // namespace cut
\ No newline at end of file
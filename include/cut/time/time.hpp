@@ -12,4 +12,5 @@
 #pragma once
 
 #include <cut/time/timestamp.hpp>
-#include <cut/time/timer.hpp>
\ No newline at end of file
+#include <cut/time/timer.hpp>
+#include <cut/time/profiler.hpp>
\ No newline at end of file
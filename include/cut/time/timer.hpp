@@ -16,7 +16,7 @@
 
 #include <chrono>
 #include <ctime>
-#include <unordered_map>
+#include <cut/common/registry.hpp>
 #include <string>
 
 namespace cut
@@ -45,7 +45,8 @@ enum TimerPrecision
  *              The timer records both the wall clock time and the CPU time, and allows
  *              for basic operations like pausing and resetting.\n 
  *              The class also exposes static access to global timers by means of unique
- *              names.
+ *              names. The global timers can be created, looked up and deleted concurrently
+ *              (see cut::Registry), while each timer must be used by one thread at a time.
  */
 class Timer
 {
@@ -85,7 +86,7 @@ private:
      * @brief       The map associating the static timers to their name.
      * @details     The map associating the static timers to their name.
      */
-    static std::unordered_map<std::string, cut::Timer> m_Timers;
+    static cut::Registry<cut::Timer> m_Timers;
 
 
 public:
@@ -16,6 +16,8 @@
 
 #include <chrono>
 #include <string>
+#include <cstddef>
+#include <cut/time/timer.hpp>
 
 
 namespace cut
@@ -107,6 +109,36 @@ public:
      * @return std::string The formatted timestamp.
      */
     std::string ToString() const;
+
+    /**
+     * @brief       Format the timestamp into a buffer.
+     * 
+     * @details     This method writes the timestamp as yyyy-mm-dd HH:MM:SS into the given
+     *              buffer, followed by the fraction of second with the given precision
+     *              (e.g. yyyy-mm-dd HH:MM:SS.mmm for cut::TimerPrecision::MILLISECONDS), and
+     *              by a null character. The timestamp is formatted using the local time zone.\n 
+     *              Each thread caches the last second it has formatted, hence consecutive
+     *              timestamps in the same second only render the fraction of second, and the
+     *              method never allocates memory. A buffer of
+     *              cut::Timestamp::MaxFormatLength characters is always large enough.
+     * 
+     * @param Buffer The output buffer.
+     * @param Size The size of the buffer.
+     * @param Precision The precision of the fraction of second.
+     * @return size_t The number of characters written, without the null character.
+     * 
+     * @throws cut::NullPtrError if <code>Buffer</code> is null.
+     * @throws cut::AssertionError if the buffer is too small, whatever the value of CUT_CHECKS.
+     */
+    size_t Format(char* Buffer,
+                  size_t Size,
+                  cut::TimerPrecision Precision = cut::TimerPrecision::SECONDS) const;
+
+    /**
+     * @brief       The size of a buffer that fits any formatted timestamp.
+     * @details     The size of a buffer that fits any timestamp formatted by cut::Timestamp::Format().
+     */
+    static const size_t MaxFormatLength = 48;
 };
 
 } // namespace cut
@@ -0,0 +1,221 @@
+/**
+ * @file        adjbuilder.cpp
+ * 
+ * @brief       Implementation of cut::AdjacencyListBuilder.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-24
+ */
+#include <cut/algo/adjbuilder.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <fstream>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+
+
+const size_t cut::AdjacencyListBuilder::DefaultChunkSize;
+
+
+namespace
+{
+    // Parse a non-negative int, advancing the pointer. Returns false on failure
+    bool ParseIndex(const char*& Str, int& Value)
+    {
+        char* End = nullptr;
+        errno = 0;
+        long V = std::strtol(Str, &End, 10);
+        if (End == Str || errno != 0 || V < 0 || V > INT_MAX)
+            return false;
+        Str = End;
+        Value = (int)V;
+        return true;
+    }
+}
+
+
+cut::AdjacencyListBuilder::AdjacencyListBuilder(size_t ChunkSize)
+    : m_ChunkSize(ChunkSize), m_NConns(0), m_Spill(nullptr), m_NSpills(0)
+{
+    CUTCheckGreater(ChunkSize, (size_t)0);
+}
+
+cut::AdjacencyListBuilder::~AdjacencyListBuilder()
+{
+    Reset();
+}
+
+void cut::AdjacencyListBuilder::Reset()
+{
+    if (m_Spill != nullptr)
+        std::fclose(m_Spill);
+    m_Spill = nullptr;
+    m_NSpills = 0;
+    m_NConns = 0;
+    std::vector<std::pair<int, int>>().swap(m_Buffer);
+    std::vector<int>().swap(m_Degree);
+}
+
+void cut::AdjacencyListBuilder::Spill()
+{
+    if (m_Buffer.empty())
+        return;
+    if (m_Spill == nullptr)
+    {
+        // The temporary file is removed automatically when closed
+        m_Spill = std::tmpfile();
+        if (m_Spill == nullptr)
+            throw cut::AssertionError("Cannot create the temporary file of the adjacency list builder.");
+    }
+    if (std::fwrite(m_Buffer.data(), sizeof(std::pair<int, int>), m_Buffer.size(), m_Spill) != m_Buffer.size())
+        throw cut::AssertionError("Cannot write the temporary file of the adjacency list builder.");
+    m_Buffer.clear();
+    m_NSpills++;
+}
+
+
+void cut::AdjacencyListBuilder::AddEdge(int Node, int Adjacent)
+{
+    CUTCheckGEQ(Node, 0);
+    CUTCheckGEQ(Adjacent, 0);
+
+    if (m_Buffer.capacity() < m_ChunkSize)
+        m_Buffer.reserve(m_ChunkSize);
+    if ((size_t)Node >= m_Degree.size())
+        m_Degree.resize(std::max((size_t)Node + 1, 2 * m_Degree.size()), 0);
+    m_Degree[Node]++;
+    m_Buffer.emplace_back(Node, Adjacent);
+    m_NConns++;
+    if (m_Buffer.size() == m_ChunkSize)
+        Spill();
+}
+
+void cut::AdjacencyListBuilder::AddEdges(const std::pair<int, int>* Edges, size_t NEdges)
+{
+    for (size_t i = 0; i < NEdges; ++i)
+        AddEdge(Edges[i].first, Edges[i].second);
+}
+
+size_t cut::AdjacencyListBuilder::AddEdges(const std::function<size_t(std::pair<int, int>*, size_t)>& Source)
+{
+    // Chunks are produced in a small staging area, not in the buffer,
+    // since the buffer may be spilled in the middle of a chunk
+    std::vector<std::pair<int, int>> Chunk(std::min(m_ChunkSize, (size_t)4096));
+    size_t NAdded = 0;
+    while (true)
+    {
+        size_t N = Source(Chunk.data(), Chunk.size());
+        if (N == 0)
+            break;
+        CUTCheckLEQ(N, Chunk.size());
+        AddEdges(Chunk.data(), N);
+        NAdded += N;
+    }
+    return NAdded;
+}
+
+size_t cut::AdjacencyListBuilder::ReadEdgeList(std::istream& Stream)
+{
+    std::string Line;
+    size_t NLine = 0;
+    size_t NAdded = 0;
+    while (std::getline(Stream, Line))
+    {
+        NLine++;
+        const char* Str = Line.c_str();
+        while (*Str == ' ' || *Str == '\t' || *Str == '\r')
+            Str++;
+        if (*Str == '\0' || *Str == '#' || *Str == '%')
+            continue;
+        int Node, Adjacent;
+        if (!ParseIndex(Str, Node) || !ParseIndex(Str, Adjacent))
+            throw cut::AssertionError("Malformed connection at line " + std::to_string(NLine) + " of the edge list.");
+        AddEdge(Node, Adjacent);
+        NAdded++;
+    }
+    return NAdded;
+}
+
+size_t cut::AdjacencyListBuilder::ReadEdgeList(const std::string& Filename)
+{
+    std::ifstream Stream(Filename);
+    if (!Stream.is_open())
+        throw cut::AssertionError("Cannot open the edge list (" + Filename + ")");
+    return ReadEdgeList(Stream);
+}
+
+
+int cut::AdjacencyListBuilder::NumNodes() const
+{
+    // The degrees grow geometrically, so trailing nodes may be empty
+    size_t N = m_Degree.size();
+    while (N > 0 && m_Degree[N - 1] == 0)
+        N--;
+    return (int)N;
+}
+size_t cut::AdjacencyListBuilder::NumConnections() const { return m_NConns; }
+size_t cut::AdjacencyListBuilder::NumSpills() const { return m_NSpills; }
+
+
+cut::CompatAdjacencyList cut::AdjacencyListBuilder::Build(bool SortAndUnique,
+                                                          cut::CSRBuildStats* Stats)
+{
+    if (m_NConns > (size_t)INT_MAX)
+    {
+        Reset();
+        throw cut::AssertionError("Too many connections for a cut::CompatAdjacencyList.");
+    }
+    size_t NNodes = NumNodes();
+    size_t NConns = m_NConns;
+    size_t Peak = m_Buffer.capacity() * sizeof(std::pair<int, int>) + (NNodes + 2) * sizeof(int) + NConns * sizeof(int);
+
+    // Offsets from the degrees, two positions ahead as in cut::BuildCSR()
+    cut::CompatAdjacencyList::ArrayType Idx(NNodes + 2, 0);
+    for (size_t i = 0; i < NNodes; ++i)
+        Idx[i + 2] = m_Degree[i];
+    std::vector<int>().swap(m_Degree);
+    for (size_t i = 2; i < NNodes + 2; ++i)
+        Idx[i] += Idx[i - 1];
+
+    // Scatter the spilled chunks first, then the buffer, preserving the input order
+    cut::CompatAdjacencyList::ArrayType Adj(NConns);
+    if (m_Spill != nullptr)
+    {
+        Spill();
+        std::rewind(m_Spill);
+        size_t NRead;
+        m_Buffer.resize(m_Buffer.capacity());
+        while ((NRead = std::fread(m_Buffer.data(), sizeof(std::pair<int, int>), m_Buffer.size(), m_Spill)) > 0)
+        {
+            for (size_t i = 0; i < NRead; ++i)
+                Adj[Idx[m_Buffer[i].first + 1]++] = m_Buffer[i].second;
+        }
+        bool Failed = std::ferror(m_Spill) != 0 || (size_t)Idx[NNodes + 1] != NConns;
+        m_Buffer.clear();
+        if (Failed)
+        {
+            Reset();
+            throw cut::AssertionError("Cannot read the temporary file of the adjacency list builder.");
+        }
+    }
+    for (const std::pair<int, int>& E : m_Buffer)
+        Adj[Idx[E.first + 1]++] = E.second;
+    Idx.pop_back();
+    Reset();
+
+    size_t NSorted = 0;
+    if (SortAndUnique)
+        NSorted = cut::SortAndUniqueRows(Idx, Adj);
+
+    if (Stats != nullptr)
+    {
+        Stats->PeakMemory = Peak;
+        Stats->NumDuplicates = NConns - Adj.size();
+        Stats->NumSortedRows = NSorted;
+    }
+    return cut::CompatAdjacencyList(std::move(Idx), std::move(Adj));
+}
\ No newline at end of file
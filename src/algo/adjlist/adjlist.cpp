@@ -10,150 +10,247 @@
  * @date        2023-11-15
  */
 #include <cut/algo/adjlist.hpp>
+#include <cut/algo/intersect.hpp>
 #include <cut/excepts/excepts.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/time/profiler.hpp>
 #include <typeinfo>
+#include <atomic>
 #include <algorithm>
 
 
+namespace
+{
+    // The rows are small, blocks larger than this would be mostly empty for small lists
+    const size_t RowsBlockSize = 1 << 16;
+
+    // Remove from Row[From, end) the values that appear earlier in the row,
+    // preserving the order of the others. Returns the number of removed values
+    size_t RemoveNewDuplicates(cut::AdjacencyList::RowType& Row, size_t From)
+    {
+        size_t N = Row.size();
+        if (From >= N)
+            return 0;
+        cut::AdjacencyList::RowType::iterator Out;
+        // Short rows are cheaper to scan
+        if (N <= 32)
+        {
+            Out = Row.begin() + From;
+            for (size_t k = From; k < N; ++k)
+            {
+                int v = Row[k];
+                if (std::find(Row.begin(), Out, v) == Out)
+                    *Out++ = v;
+            }
+        }
+        else
+        {
+            // Sort a scratch copy of (value, position), and mark as removed each
+            // new position that is not the first one of its value
+            thread_local std::vector<std::pair<int, size_t>> Scratch;
+            thread_local std::vector<char> Removed;
+            Scratch.resize(N);
+            for (size_t k = 0; k < N; ++k)
+                Scratch[k] = std::make_pair(Row[k], k);
+            std::sort(Scratch.begin(), Scratch.end());
+            Removed.assign(N, 0);
+            for (size_t k = 1; k < N; ++k)
+            {
+                if (Scratch[k].first == Scratch[k - 1].first && Scratch[k].second >= From)
+                    Removed[Scratch[k].second] = 1;
+            }
+            Out = Row.begin() + From;
+            for (size_t k = From; k < N; ++k)
+            {
+                if (!Removed[k])
+                    *Out++ = Row[k];
+            }
+        }
+        size_t NRemoved = Row.end() - Out;
+        Row.erase(Out, Row.end());
+        return NRemoved;
+    }
+}
+
+
 cut::AdjacencyList::AdjacencyList(int N)
-    : cut::BaseAdjacencyList()
+    : cut::BaseAdjacencyList(), m_Arena(new cut::Arena(RowsBlockSize))
 {
-    m_Adj.resize(N);
+    m_Adj.resize(N, EmptyRow());
     m_NConnections = 0;
 }
 
 cut::AdjacencyList::AdjacencyList(const std::vector<std::pair<int,int>>& Connections)
-    : cut::BaseAdjacencyList()
+    : cut::BaseAdjacencyList(), m_Arena(new cut::Arena(RowsBlockSize))
 {
-    m_NConnections = Connections.size();
-    // Get the number of nodes
-    int NNodes = 0;
-    for (const std::pair<int, int>& c : Connections)
-        NNodes = std::max(NNodes, c.first + 1);
-    if (NNodes == 0)
-    {
-        m_Adj.resize(0);
-        return;
-    }
-    // Get the number of connections per node
-    std::vector<int> NConns;
-    NConns.resize(NNodes, 0);
-    for (const std::pair<int, int>& c : Connections)
-        NConns[c.first]++;
-    // Resize the adjacency list properly
-    m_Adj.resize(NNodes);
-    for (int i = 0; i < NNodes; ++i)
-        m_Adj[i].reserve(NConns[i]);
-    for (const std::pair<int, int>& c : Connections)
-    {
-        try
-        {
-            AddAdjacent(c.first, c.second);
-        }
-        catch(const std::exception& e) { }
-        
-    }
+    BuildFrom(Connections);
 }
 
 cut::AdjacencyList::AdjacencyList(const cut::BaseAdjacencyList& AL)
-    : cut::BaseAdjacencyList(AL)
+    : cut::BaseAdjacencyList(AL), m_Arena(new cut::Arena(RowsBlockSize))
 {
-    // If same class, it's easy
-    try
-    {
-        const cut::AdjacencyList& FAL = dynamic_cast<const cut::AdjacencyList&>(AL);
-        m_Adj = FAL.m_Adj;
-        m_NConnections = FAL.m_NConnections;
-    }
-    catch(const std::bad_cast& e) { }
-    catch(const std::exception& e)
-    {
-        throw e;
-    }
-    
-    // Otherwise, use abstract interface
-    m_NConnections = AL.NumConnections();
-    // Get the number of nodes
-    int NNodes = AL.NumNodes();
-    m_Adj.resize(NNodes);
-    if (NNodes == 0)
-        return;
-    // Fill adjacency list
-    for (int i = 0; i < NNodes; ++i)
-    {
-        int NAdjs = AL.NumAdjacents(i);
-        m_Adj[i].reserve(NAdjs);
-        for (int j = 0; j < NAdjs; ++j)
-            m_Adj[i].push_back(AL.GetAdjacent(i, j));
-    }
+    AssignFrom(AL);
 }
 
+cut::AdjacencyList::AdjacencyList(const cut::AdjacencyList& AL)
+    : cut::AdjacencyList((const cut::BaseAdjacencyList&)AL)
+{ }
+
 cut::AdjacencyList::AdjacencyList(cut::BaseAdjacencyList&& AL)
-    : cut::BaseAdjacencyList()
+    : cut::BaseAdjacencyList(), m_Arena(new cut::Arena(RowsBlockSize))
 {
-    try
-    {
-        cut::AdjacencyList&& FAL = dynamic_cast<cut::AdjacencyList&&>(AL);
-        m_Adj = std::move(FAL.m_Adj);
-        m_NConnections = FAL.m_NConnections;
-    }
-    catch(const std::exception& e)
-    {
-        throw e;
-    }   
+    MoveFrom(std::move(AL));
 }
 
+cut::AdjacencyList::AdjacencyList(cut::AdjacencyList&& AL)
+    : cut::AdjacencyList((cut::BaseAdjacencyList&&)AL)
+{ }
+
 cut::BaseAdjacencyList& cut::AdjacencyList::operator=(const cut::BaseAdjacencyList& AL)
 {
+    // The rows are cleared before reading the input
+    if (this == &AL)
+        return *this;
     cut::BaseAdjacencyList::operator=(AL);
-    // If same class, it's easy
-    try
+    AssignFrom(AL);
+    return *this;
+}
+
+cut::AdjacencyList& cut::AdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+{
+    if (this != &AL)
+        MoveFrom(std::move(AL));
+    return *this;
+}
+
+cut::AdjacencyList& cut::AdjacencyList::operator=(const cut::AdjacencyList& AL)
+{
+    operator=((const cut::BaseAdjacencyList&)AL);
+    return *this;
+}
+
+cut::AdjacencyList& cut::AdjacencyList::operator=(cut::AdjacencyList&& AL)
+{
+    return operator=((cut::BaseAdjacencyList&&)AL);
+}
+
+cut::AdjacencyList::~AdjacencyList() { }
+
+
+void cut::AdjacencyList::ClearRows()
+{
+    m_Adj.clear();
+    m_Arena->Reset();
+}
+
+cut::AdjacencyList::RowType cut::AdjacencyList::EmptyRow() const
+{
+    return RowType(cut::ArenaAllocator<int>(*m_Arena));
+}
+
+void cut::AdjacencyList::AssignFrom(const cut::BaseAdjacencyList& AL)
+{
+    // Same class, copy the rows and the free list
+    const cut::AdjacencyList* FAL = dynamic_cast<const cut::AdjacencyList*>(&AL);
+    if (FAL != nullptr)
     {
-        const cut::AdjacencyList& FAL = dynamic_cast<const cut::AdjacencyList&>(AL);
-        m_Adj = FAL.m_Adj;
-        m_NConnections = FAL.m_NConnections;
+        CopyRows(*FAL);
+        m_NConnections = FAL->m_NConnections;
+        m_Deleted = FAL->m_Deleted;
+        m_FreeNodes = FAL->m_FreeNodes;
+        return;
     }
-    catch(const std::bad_cast& e) { }
-    catch(const std::exception& e)
+
+    // Compact list, copy the rows directly from its arrays
+    const cut::CompatAdjacencyList* CAL = dynamic_cast<const cut::CompatAdjacencyList*>(&AL);
+    if (CAL != nullptr)
     {
-        throw e;
+        CopyFromCompat(*CAL);
+        return;
     }
-    
+
     // Otherwise, use abstract interface
-    m_NConnections = AL.NumConnections();
-    // Get the number of nodes
-    int NNodes = AL.NumNodes();
-    m_Adj.resize(NNodes);
-    if (NNodes == 0)
-        return *this;
-    // Fill adjacency list
-    for (int i = 0; i < NNodes; ++i)
+    CopyFrom(AL);
+}
+
+void cut::AdjacencyList::MoveFrom(cut::BaseAdjacencyList&& AL)
+{
+    cut::AdjacencyList* FAL = dynamic_cast<cut::AdjacencyList*>(&AL);
+    if (FAL == nullptr)
     {
-        int NAdjs = AL.NumAdjacents(i);
-        m_Adj[i].reserve(NAdjs);
-        for (int j = 0; j < NAdjs; ++j)
-            m_Adj[i].push_back(AL.GetAdjacent(i, j));
+        // The rows cannot be taken from another class: copy them, and release
+        // the memory of a compact list, that would be discarded anyway
+        AssignFrom(AL);
+        cut::CompatAdjacencyList* CAL = dynamic_cast<cut::CompatAdjacencyList*>(&AL);
+        if (CAL != nullptr)
+            *CAL = cut::CompatAdjacencyList(std::vector<std::pair<int, int>>());
+        return;
     }
 
-    return *this;
+    // The rows move together with their arena, and the input gets a new one
+    m_Adj.swap(FAL->m_Adj);
+    m_Arena.swap(FAL->m_Arena);
+    FAL->m_Adj.clear();
+    FAL->m_Arena.reset(new cut::Arena(RowsBlockSize));
+    m_NConnections = FAL->m_NConnections;
+    m_Deleted = std::move(FAL->m_Deleted);
+    m_FreeNodes = std::move(FAL->m_FreeNodes);
+    FAL->m_NConnections = 0;
+    FAL->m_Deleted.clear();
+    FAL->m_FreeNodes.clear();
 }
 
-cut::AdjacencyList& cut::AdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+void cut::AdjacencyList::CopyFromCompat(const cut::CompatAdjacencyList& CAL)
 {
-    try
+    __CUTProfileLibrary("AdjacencyList::Convert");
+
+    // Each row is a single copy of a contiguous range, without virtual calls
+    int NNodes = CAL.NumNodes();
+    ClearRows();
+    m_Deleted.clear();
+    m_FreeNodes.clear();
+    m_Adj.reserve(NNodes);
+    for (int i = 0; i < NNodes; ++i)
     {
-        cut::AdjacencyList&& FAL = dynamic_cast<cut::AdjacencyList&&>(AL);
-        m_Adj = std::move(FAL.m_Adj);
-        m_NConnections = FAL.m_NConnections;
+        cut::Span<int> Adjs = CAL.NeighborsUnchecked(i);
+        m_Adj.emplace_back(Adjs.begin(), Adjs.end(), cut::ArenaAllocator<int>(*m_Arena));
     }
-    catch(const std::exception& e)
+    m_NConnections = CAL.NumConnections();
+}
+
+void cut::AdjacencyList::CopyRows(const cut::AdjacencyList& FAL)
+{
+    // The rows are copied one by one, so that they are allocated from this arena
+    ClearRows();
+    m_Adj.reserve(FAL.m_Adj.size());
+    for (const RowType& Row : FAL.m_Adj)
+        m_Adj.emplace_back(Row.begin(), Row.end(), cut::ArenaAllocator<int>(*m_Arena));
+}
+
+
+void cut::AdjacencyList::CopyFrom(const cut::BaseAdjacencyList& AL)
+{
+    m_NConnections = AL.NumConnections();
+    // Get the number of nodes
+    int NNodes = AL.NumNodes();
+    ClearRows();
+    m_Adj.resize(NNodes, EmptyRow());
+    m_Deleted.clear();
+    m_FreeNodes.clear();
+    // The arena is not thread-safe, hence the rows are allocated before the parallel fill
+    for (int i = 0; i < NNodes; ++i)
+        m_Adj[i].reserve(AL.NumAdjacents(i));
+    // Fill adjacency list, each row is independent
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
     {
-        throw e;
-    }
-    return *this;
+        for (size_t i = b; i < e; ++i)
+        {
+            cut::Span<int> Adjs = AL.Neighbors(i);
+            m_Adj[i].assign(Adjs.begin(), Adjs.end());
+        }
+    }, -1, 1024);
 }
 
-cut::AdjacencyList::~AdjacencyList() { }
 
 int cut::AdjacencyList::NumNodes() const { return m_Adj.size(); }
 int cut::AdjacencyList::NumConnections() const { return m_NConnections; }
@@ -169,15 +266,31 @@ int cut::AdjacencyList::GetAdjacent(int i, int idx) const
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
     CUTCheckGEQ(idx, 0);
-    CUTCheckLess(idx, NumAdjacents(i));
+    CUTCheckLess(idx, NumAdjacentsUnchecked(i));
 
     return m_Adj[i][idx];
 }
+cut::Span<int> cut::AdjacencyList::Neighbors(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    return NeighborsUnchecked(i);
+}
+
+bool cut::AdjacencyList::HasConnection(int i, int j) const
+{
+    if (i < 0 || i >= NumNodes())
+        return false;
+    return cut::Contains(NeighborsUnchecked(i), j);
+}
 
 
 void cut::AdjacencyList::AddNode()
 {
-    m_Adj.emplace_back();
+    m_Adj.emplace_back(EmptyRow());
+    if (!m_Deleted.empty())
+        m_Deleted.push_back(0);
 }
 
 void cut::AdjacencyList::InsertNode(int i)
@@ -185,7 +298,12 @@ void cut::AdjacencyList::InsertNode(int i)
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
 
-    m_Adj.emplace(m_Adj.begin() + i);
+    m_Adj.emplace(m_Adj.begin() + i, EmptyRow());
+    if (!m_Deleted.empty())
+    {
+        m_Deleted.insert(m_Deleted.begin() + i, 0);
+        ResetFreeNodes();
+    }
 }
 
 void cut::AdjacencyList::SwapNodes(int i, int j)
@@ -196,6 +314,11 @@ void cut::AdjacencyList::SwapNodes(int i, int j)
     CUTCheckLess(j, NumNodes());
 
     std::swap(m_Adj[i], m_Adj[j]);
+    if (!m_Deleted.empty() && m_Deleted[i] != m_Deleted[j])
+    {
+        std::swap(m_Deleted[i], m_Deleted[j]);
+        ResetFreeNodes();
+    }
 }
 
 void cut::AdjacencyList::RemoveNode(int i)
@@ -203,7 +326,121 @@ void cut::AdjacencyList::RemoveNode(int i)
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
 
+    m_NConnections -= m_Adj[i].size();
     m_Adj.erase(m_Adj.begin() + i);
+    if (!m_Deleted.empty())
+    {
+        m_Deleted.erase(m_Deleted.begin() + i);
+        ResetFreeNodes();
+    }
+}
+
+void cut::AdjacencyList::ResetFreeNodes()
+{
+    // The connections are not renumbered by the shift, so the deleted
+    // nodes must be purged again before they can be reused
+    m_FreeNodes.clear();
+}
+
+int cut::AdjacencyList::NewNode()
+{
+    if (m_FreeNodes.empty())
+    {
+        AddNode();
+        return NumNodes() - 1;
+    }
+    int i = m_FreeNodes.back();
+    m_FreeNodes.pop_back();
+    m_Deleted[i] = 0;
+    return i;
+}
+
+void cut::AdjacencyList::DeleteNode(int i)
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+    CUTAssert(!IsDeleted(i));
+
+    if (m_Deleted.empty())
+        m_Deleted.resize(m_Adj.size(), 0);
+    m_NConnections -= m_Adj[i].size();
+    // Release the memory of the row, it will not be used until the node is reused
+    EmptyRow().swap(m_Adj[i]);
+    // The node is only reused after the connections towards it are purged
+    m_Deleted[i] = 1;
+}
+
+bool cut::AdjacencyList::IsDeleted(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    return !m_Deleted.empty() && m_Deleted[i] != 0;
+}
+
+int cut::AdjacencyList::NumDeletedNodes() const
+{
+    return (int)std::count(m_Deleted.begin(), m_Deleted.end(), 1);
+}
+
+void cut::AdjacencyList::PurgeDeleted()
+{
+    if (m_Deleted.empty())
+        return;
+
+    int NNodes = NumNodes();
+    m_NConnections = 0;
+    for (int i = 0; i < NNodes; ++i)
+    {
+        RowType& Row = m_Adj[i];
+        Row.erase(std::remove_if(Row.begin(), Row.end(), [&](int j) { return j >= 0 && j < NNodes && m_Deleted[j]; }),
+                  Row.end());
+        m_NConnections += Row.size();
+    }
+
+    // Reuse the smallest indices first
+    m_FreeNodes.clear();
+    for (int i = NNodes - 1; i >= 0; --i)
+    {
+        if (m_Deleted[i])
+            m_FreeNodes.push_back(i);
+    }
+}
+
+std::vector<int> cut::AdjacencyList::Compact()
+{
+    // Map the live nodes to their new index, preserving their order
+    int NNodes = NumNodes();
+    std::vector<int> NewIdx(NNodes);
+    int NLive = 0;
+    for (int i = 0; i < NNodes; ++i)
+        NewIdx[i] = (m_Deleted.empty() || !m_Deleted[i]) ? NLive++ : -1;
+
+    // Move the rows in place, renumbering their adjacents and dropping the
+    // connections towards deleted nodes
+    m_NConnections = 0;
+    for (int i = 0; i < NNodes; ++i)
+    {
+        if (NewIdx[i] < 0)
+            continue;
+        RowType& Row = m_Adj[i];
+        auto Out = Row.begin();
+        for (int j : Row)
+        {
+            if (j < 0 || j >= NNodes)
+                *Out++ = j;
+            else if (NewIdx[j] >= 0)
+                *Out++ = NewIdx[j];
+        }
+        Row.erase(Out, Row.end());
+        m_NConnections += Row.size();
+        if (NewIdx[i] != i)
+            m_Adj[NewIdx[i]] = std::move(Row);
+    }
+    m_Adj.erase(m_Adj.begin() + NLive, m_Adj.end());
+    m_Deleted.clear();
+    m_FreeNodes.clear();
+    return NewIdx;
 }
 
 
@@ -211,9 +448,58 @@ void cut::AdjacencyList::AddAdjacent(int i, int j)
 {
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
-    CUTAssert(std::find(m_Adj[i].begin(), m_Adj[i].end(), j) == m_Adj[i].end());
+    CUTAssert(!HasConnection(i, j));
 
     m_Adj[i].emplace_back(j);
+    m_NConnections++;
+}
+
+int cut::AdjacencyList::AddAdjacents(int i, const int* Begin, const int* End, bool CheckDuplicates)
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    size_t From = m_Adj[i].size();
+    m_Adj[i].insert(m_Adj[i].end(), Begin, End);
+    if (CheckDuplicates)
+        RemoveNewDuplicates(m_Adj[i], From);
+    int NAdded = m_Adj[i].size() - From;
+    m_NConnections += NAdded;
+    return NAdded;
+}
+
+void cut::AdjacencyList::BuildFrom(const std::vector<std::pair<int, int>>& Connections, bool CheckDuplicates)
+{
+    // Get the number of nodes
+    int NNodes = 0;
+    for (const std::pair<int, int>& c : Connections)
+        NNodes = std::max(NNodes, c.first + 1);
+    // Get the number of connections per node, and fill the rows in input order
+    std::vector<int> NConns(NNodes, 0);
+    for (const std::pair<int, int>& c : Connections)
+        NConns[c.first]++;
+    ClearRows();
+    m_Adj.resize(NNodes, EmptyRow());
+    m_Deleted.clear();
+    m_FreeNodes.clear();
+    for (int i = 0; i < NNodes; ++i)
+        m_Adj[i].reserve(NConns[i]);
+    for (const std::pair<int, int>& c : Connections)
+        m_Adj[c.first].emplace_back(c.second);
+    
+    m_NConnections = Connections.size();
+    if (!CheckDuplicates)
+        return;
+    // Remove the duplicates, each row is independent
+    std::atomic<size_t> NRemoved(0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        size_t LocRemoved = 0;
+        for (size_t i = b; i < e; ++i)
+            LocRemoved += RemoveNewDuplicates(m_Adj[i], 0);
+        NRemoved.fetch_add(LocRemoved);
+    }, -1, 1024);
+    m_NConnections -= NRemoved.load();
 }
 
 void cut::AdjacencyList::InsertAdjacent(int i, int j, int idx)
@@ -221,10 +507,11 @@ void cut::AdjacencyList::InsertAdjacent(int i, int j, int idx)
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
     CUTCheckGEQ(idx, 0);
-    CUTCheckLess(idx, NumAdjacents(i));
-    CUTAssert(std::find(m_Adj[i].begin(), m_Adj[i].end(), j) == m_Adj[i].end());
+    CUTCheckLess(idx, NumAdjacentsUnchecked(i));
+    CUTAssert(!HasConnection(i, j));
 
     m_Adj[i].emplace(m_Adj[i].begin() + idx, j);
+    m_NConnections++;
 }
 
 void cut::AdjacencyList::UpdateAdjacent(int i, int j, int idx)
@@ -232,13 +519,13 @@ void cut::AdjacencyList::UpdateAdjacent(int i, int j, int idx)
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
     CUTCheckGEQ(idx, 0);
-    CUTCheckLess(idx, NumAdjacents(i));
+    CUTCheckLess(idx, NumAdjacentsUnchecked(i));
 
     // Ignore if the update does not change the value
     if (m_Adj[i][idx] == j)
         return;
 
-    CUTAssert(std::find(m_Adj[i].begin(), m_Adj[i].end(), j) == m_Adj[i].end());
+    CUTAssert(!HasConnection(i, j));
     m_Adj[i][idx] = j;
 }
 
@@ -246,7 +533,7 @@ void cut::AdjacencyList::ReplaceAdjacent(int i, int j, int k)
 {
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
-    CUTAssert(std::find(m_Adj[i].begin(), m_Adj[i].end(), k) == m_Adj[i].end());
+    CUTAssert(!HasConnection(i, k));
 
     auto j_pos = std::find(m_Adj[i].begin(), m_Adj[i].end(), j);
     CUTAssert(j_pos != m_Adj[i].end());
@@ -258,7 +545,8 @@ void cut::AdjacencyList::RemoveAdjacent(int i, int idx)
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
     CUTCheckGEQ(idx, 0);
-    CUTCheckLess(idx, NumAdjacents(i));
+    CUTCheckLess(idx, NumAdjacentsUnchecked(i));
 
     m_Adj[i].erase(m_Adj[i].begin() + idx);
+    m_NConnections--;
 }
\ No newline at end of file
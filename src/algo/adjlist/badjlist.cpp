@@ -10,6 +10,7 @@
  * @date        2023-11-15
  */
 #include <cut/algo/adjlist.hpp>
+#include <cut/excepts/excepts.hpp>
 
 cut::BaseAdjacencyList::BaseAdjacencyList() { }
 cut::BaseAdjacencyList::BaseAdjacencyList(const cut::BaseAdjacencyList &AL) { }
@@ -22,4 +23,19 @@ cut::BaseAdjacencyList::~BaseAdjacencyList() { }
 int cut::BaseAdjacencyList::operator()(int i, int idx) const
 {
     return GetAdjacent(i, idx);
+}
+
+cut::Span<int> cut::BaseAdjacencyList::Neighbors(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    // Gather the adjacents in a buffer owned by the calling thread
+    static thread_local std::vector<int> Buffer;
+    int NAdjs = NumAdjacents(i);
+    Buffer.resize(NAdjs);
+    for (int j = 0; j < NAdjs; ++j)
+        Buffer[j] = GetAdjacent(i, j);
+    
+    return cut::Span<int>(Buffer.data(), Buffer.size());
 }
\ No newline at end of file
@@ -10,136 +10,186 @@
  * @date        2023-11-15
  */
 #include <cut/algo/adjlist.hpp>
+#include <cut/algo/intersect.hpp>
 #include <cut/memory/memory.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/time/profiler.hpp>
 #include <algorithm>
 #include <typeinfo>
 
 
 cut::CompatAdjacencyList::CompatAdjacencyList(const std::vector<std::pair<int,int>>& Connections)
+    : cut::CompatAdjacencyList(Connections, true)
+{ }
+
+cut::CompatAdjacencyList::CompatAdjacencyList(const std::vector<std::pair<int,int>>& Connections,
+                                              bool SortAndUnique,
+                                              cut::CSRBuildStats* Stats)
     : cut::BaseAdjacencyList()
 {
-    // Sort the connections and get the number of nodes
-    int NConns = Connections.size();
-    std::pair<int, int>* Conns = cut::AllocCopy(Connections.data(), NConns);
-    std::sort(Conns, Conns + NConns);
-    std::pair<int, int>* CEnd = std::unique(Conns, Conns + NConns);
-    NConns = CEnd - Conns;
-    int NNodes = Conns[NConns - 1].first + 1;
-
-    // Initialize the data
-    m_Adj.reserve(NConns);
-    m_Idx.resize(NNodes + 1);
-    int CurNode = 0;
-    for (int i = 0; i < NConns; ++i)
-    {
-        int Node = Conns[i].first;
-        while (Node > CurNode)
-        {
-            CurNode += 1;
-            m_Idx[CurNode + 1] = m_Idx[CurNode];
-        }
-        m_Adj.emplace_back(Conns[i].second);
-        m_Idx[CurNode + 1] += 1;
-    }
+    __CUTProfileLibrary("CompatAdjacencyList::Build");
 
-    free(Conns);
+    // Counting sort directly from the input, without copying it
+    if (SortAndUnique && cut::GetNumThreads() > 1)
+        cut::BuildCSRParallel(Connections.data(), Connections.size(), m_Idx, m_Adj, Stats);
+    else
+        cut::BuildCSR(Connections.data(), Connections.size(), m_Idx, m_Adj, SortAndUnique, Stats);
 }
 
 
+cut::CompatAdjacencyList::CompatAdjacencyList(ArrayType&& Offsets,
+                                              ArrayType&& Adjacents)
+    : cut::BaseAdjacencyList(), m_Adj(std::move(Adjacents)), m_Idx(std::move(Offsets))
+{
+    CUTAssert(!m_Idx.empty());
+    CUTAssert(m_Idx.front() == 0);
+    CUTAssert((size_t)m_Idx.back() == m_Adj.size());
+}
+
+cut::CompatAdjacencyList::CompatAdjacencyList(const std::vector<int>& Offsets,
+                                              const std::vector<int>& Adjacents)
+    : cut::CompatAdjacencyList(ArrayType(Offsets.begin(), Offsets.end()),
+                               ArrayType(Adjacents.begin(), Adjacents.end()))
+{ }
+
 cut::CompatAdjacencyList::CompatAdjacencyList(const cut::BaseAdjacencyList& AL)
     : cut::BaseAdjacencyList(AL)
 {
-    // If same class, it's easy
-    try
-    {
-        const cut::CompatAdjacencyList& CAL = dynamic_cast<const cut::CompatAdjacencyList&>(AL);
-        m_Adj = CAL.m_Adj;
-        m_Idx = CAL.m_Idx;
-    }
-    catch(const std::bad_cast& e) { }
-    catch(const std::exception& e)
-    {
-        throw e;
-    }
-
-    // Otherwise, use abstract interface
-    int NNodes = AL.NumNodes();
-    m_Adj.reserve(AL.NumConnections());
-    m_Idx.resize(NNodes + 1);
-    // Fill the data
-    for (int i = 0; i < NNodes; ++i)
-    {
-        int NAdjs = AL.NumAdjacents(i);
-        m_Idx[i + 1] = m_Idx[i] + NAdjs;
-        for (int j = 0; j < NAdjs; ++j)
-            m_Adj.emplace_back(AL.GetAdjacent(i, j));
-    }
+    AssignFrom(AL);
 }
 
 cut::CompatAdjacencyList::CompatAdjacencyList(cut::BaseAdjacencyList&& AL)
     : cut::BaseAdjacencyList()
 {
-    try
-    {
-        cut::CompatAdjacencyList&& CAL = dynamic_cast<cut::CompatAdjacencyList&&>(AL);
-        m_Adj = std::move(CAL.m_Adj);
-        m_Idx = std::move(CAL.m_Idx);
-    }
-    catch(const std::exception& e)
-    {
-        throw e;
-    }
+    operator=(std::move(AL));
 }
 
+cut::CompatAdjacencyList::CompatAdjacencyList(const cut::CompatAdjacencyList& AL)
+    : cut::BaseAdjacencyList(AL), m_Adj(AL.m_Adj), m_Idx(AL.m_Idx)
+{ }
+
+cut::CompatAdjacencyList::CompatAdjacencyList(cut::CompatAdjacencyList&& AL)
+    : cut::CompatAdjacencyList((cut::BaseAdjacencyList&&)AL)
+{ }
+
 cut::BaseAdjacencyList& cut::CompatAdjacencyList::operator=(const cut::BaseAdjacencyList& AL)
 {
+    if (this == &AL)
+        return *this;
     cut::BaseAdjacencyList::operator=(AL);
-    
-    // If same class, it's easy
-    try
+    AssignFrom(AL);
+    return *this;
+}
+
+cut::CompatAdjacencyList& cut::CompatAdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+{
+    if (this == &AL)
+        return *this;
+    cut::CompatAdjacencyList* CAL = dynamic_cast<cut::CompatAdjacencyList*>(&AL);
+    if (CAL != nullptr)
     {
-        const cut::CompatAdjacencyList& CAL = dynamic_cast<const cut::CompatAdjacencyList&>(AL);
-        m_Adj = CAL.m_Adj;
-        m_Idx = CAL.m_Idx;
+        m_Adj = std::move(CAL->m_Adj);
+        m_Idx = std::move(CAL->m_Idx);
+        CAL->m_Adj.clear();
+        CAL->m_Idx.assign(1, 0);
+        return *this;
     }
-    catch(const std::bad_cast& e) { }
-    catch(const std::exception& e)
+
+    // The rows cannot be taken from another class: copy them, and release
+    // the memory of a flexible list, that would be discarded anyway
+    AssignFrom(AL);
+    cut::AdjacencyList* FAL = dynamic_cast<cut::AdjacencyList*>(&AL);
+    if (FAL != nullptr)
+        *FAL = cut::AdjacencyList(0);
+    return *this;
+}
+
+cut::CompatAdjacencyList& cut::CompatAdjacencyList::operator=(const cut::CompatAdjacencyList& AL)
+{
+    operator=((const cut::BaseAdjacencyList&)AL);
+    return *this;
+}
+
+cut::CompatAdjacencyList& cut::CompatAdjacencyList::operator=(cut::CompatAdjacencyList&& AL)
+{
+    return operator=((cut::BaseAdjacencyList&&)AL);
+}
+
+cut::CompatAdjacencyList::~CompatAdjacencyList() { }
+
+
+void cut::CompatAdjacencyList::AssignFrom(const cut::BaseAdjacencyList& AL)
+{
+    // Same class, copy the arrays
+    const cut::CompatAdjacencyList* CAL = dynamic_cast<const cut::CompatAdjacencyList*>(&AL);
+    if (CAL != nullptr)
     {
-        throw e;
+        m_Adj = CAL->m_Adj;
+        m_Idx = CAL->m_Idx;
+        return;
     }
 
-    // Otherwise, use abstract interface
-    int NNodes = AL.NumNodes();
-    m_Adj.reserve(AL.NumConnections());
-    m_Idx.resize(NNodes + 1);
-    // Fill the data
-    for (int i = 0; i < NNodes; ++i)
+    __CUTProfileLibrary("CompatAdjacencyList::Convert");
+    // Flexible list, copy the rows directly
+    const cut::AdjacencyList* FAL = dynamic_cast<const cut::AdjacencyList*>(&AL);
+    if (FAL != nullptr)
     {
-        int NAdjs = AL.NumAdjacents(i);
-        m_Idx[i + 1] = m_Idx[i] + NAdjs;
-        for (int j = 0; j < NAdjs; ++j)
-            m_Adj.emplace_back(AL.GetAdjacent(i, j));
+        CopyFromList(*FAL);
+        return;
     }
 
-    return *this;
+    // Otherwise, use abstract interface
+    CopyFrom(AL);
 }
 
-cut::CompatAdjacencyList& cut::CompatAdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+void cut::CompatAdjacencyList::CopyFromList(const cut::AdjacencyList& FAL)
 {
-    try
+    // Count the adjacents of each node and accumulate the offsets
+    int NNodes = FAL.NumNodes();
+    m_Idx.assign(NNodes + 1, 0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
     {
-        cut::CompatAdjacencyList&& CAL = dynamic_cast<cut::CompatAdjacencyList&&>(AL);
-        m_Adj = std::move(CAL.m_Adj);
-        m_Idx = std::move(CAL.m_Idx);
-    }
-    catch(const std::exception& e)
+        for (size_t i = b; i < e; ++i)
+            m_Idx[i + 1] = FAL.NumAdjacentsUnchecked(i);
+    });
+    cut::ParallelPrefixSum(m_Idx.data() + 1, NNodes);
+
+    // A single allocation for all the rows, then a copy per row
+    ArrayType().swap(m_Adj);
+    m_Adj.resize(m_Idx[NNodes]);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
     {
-        throw e;
-    }
-    return *this;
+        for (size_t i = b; i < e; ++i)
+        {
+            cut::Span<int> Adjs = FAL.NeighborsUnchecked(i);
+            std::copy(Adjs.begin(), Adjs.end(), m_Adj.data() + m_Idx[i]);
+        }
+    }, -1, 1024);
 }
 
-cut::CompatAdjacencyList::~CompatAdjacencyList() { }
+void cut::CompatAdjacencyList::CopyFrom(const cut::BaseAdjacencyList& AL)
+{
+    // Count the adjacents of each node and accumulate the offsets
+    int NNodes = AL.NumNodes();
+    m_Idx.assign(NNodes + 1, 0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            m_Idx[i + 1] = AL.NumAdjacents(i);
+    });
+    cut::ParallelPrefixSum(m_Idx.data() + 1, NNodes);
+
+    // Fill the data, each row has its own range
+    m_Adj.resize(m_Idx[NNodes]);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+        {
+            cut::Span<int> Adjs = AL.Neighbors(i);
+            std::copy(Adjs.begin(), Adjs.end(), m_Adj.data() + m_Idx[i]);
+        }
+    }, -1, 1024);
+}
 
 
 int cut::CompatAdjacencyList::NumNodes() const { return m_Idx.size() - 1; }
@@ -156,7 +206,35 @@ int cut::CompatAdjacencyList::GetAdjacent(int i, int idx) const
     CUTCheckGEQ(i, 0);
     CUTCheckLess(i, NumNodes());
     CUTCheckGEQ(idx, 0);
-    CUTCheckLess(idx, NumAdjacents(i));
+    CUTCheckLess(idx, NumAdjacentsUnchecked(i));
 
     return m_Adj[m_Idx[i] + idx];
+}
+cut::Span<int> cut::CompatAdjacencyList::Neighbors(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    return NeighborsUnchecked(i);
+}
+
+bool cut::CompatAdjacencyList::HasConnection(int i, int j) const
+{
+    if (i < 0 || i >= NumNodes())
+        return false;
+    return cut::Contains(NeighborsUnchecked(i), j);
+}
+
+bool cut::CompatAdjacencyList::HasSortedConnection(int i, int j) const
+{
+    if (i < 0 || i >= NumNodes())
+        return false;
+    return cut::SortedContains(NeighborsUnchecked(i), j);
+}
+
+std::vector<int> cut::CompatAdjacencyList::Degrees() const
+{
+    std::vector<int> Deg(NumNodes());
+    cut::RowDegrees(m_Idx.data(), Deg.size(), Deg.data());
+    return Deg;
 }
\ No newline at end of file
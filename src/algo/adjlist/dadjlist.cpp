@@ -0,0 +1,536 @@
+/**
+ * @file        dadjlist.cpp
+ * 
+ * @brief       Implementation of cut::DynamicAdjacencyList.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-10
+ */
+#include <cut/algo/dadjlist.hpp>
+#include <cut/algo/csrbuild.hpp>
+#include <cut/algo/intersect.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/time/profiler.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <algorithm>
+#include <iterator>
+
+
+const size_t cut::DynamicAdjacencyList::MinMergeThreshold;
+
+
+namespace
+{
+    // Sort a batch of connections by node and adjacent, dropping the duplicates
+    std::vector<std::pair<int, int>> SortedBatch(const std::vector<std::pair<int, int>>& Connections)
+    {
+        std::vector<std::pair<int, int>> Batch(Connections);
+        if (!std::is_sorted(Batch.begin(), Batch.end()))
+            std::sort(Batch.begin(), Batch.end());
+        Batch.erase(std::unique(Batch.begin(), Batch.end()), Batch.end());
+        return Batch;
+    }
+}
+
+
+cut::DynamicAdjacencyList::DynamicAdjacencyList(size_t MergeThreshold)
+    : cut::BaseAdjacencyList(), m_Idx(1, 0), m_NNodes(0), m_NConnections(0),
+      m_NPending(0), m_MergeThreshold(MergeThreshold), m_NMerges(0)
+{ }
+
+cut::DynamicAdjacencyList::DynamicAdjacencyList(const std::vector<std::pair<int, int>>& Connections,
+                                                size_t MergeThreshold)
+    : cut::BaseAdjacencyList(), m_NPending(0), m_MergeThreshold(MergeThreshold), m_NMerges(0)
+{
+    if (cut::GetNumThreads() > 1)
+        cut::BuildCSRParallel(Connections.data(), Connections.size(), m_Idx, m_Adj);
+    else
+        cut::BuildCSR(Connections.data(), Connections.size(), m_Idx, m_Adj, true);
+    m_NNodes = m_Idx.size() - 1;
+    m_NConnections = m_Adj.size();
+}
+
+cut::DynamicAdjacencyList::DynamicAdjacencyList(const cut::BaseAdjacencyList& AL)
+    : cut::DynamicAdjacencyList()
+{
+    operator=(AL);
+}
+
+cut::DynamicAdjacencyList::DynamicAdjacencyList(const cut::DynamicAdjacencyList& AL)
+    : cut::BaseAdjacencyList(), m_Adj(AL.m_Adj), m_Idx(AL.m_Idx), m_Deltas(AL.m_Deltas),
+      m_NNodes(AL.m_NNodes), m_NConnections(AL.m_NConnections), m_NPending(AL.m_NPending),
+      m_MergeThreshold(AL.m_MergeThreshold), m_NMerges(AL.m_NMerges)
+{ }
+
+cut::DynamicAdjacencyList::DynamicAdjacencyList(cut::DynamicAdjacencyList&& AL)
+    : cut::DynamicAdjacencyList()
+{
+    operator=(std::move(AL));
+}
+
+cut::BaseAdjacencyList& cut::DynamicAdjacencyList::operator=(const cut::BaseAdjacencyList& AL)
+{
+    if (&AL == this)
+        return *this;
+    cut::BaseAdjacencyList::operator=(AL);
+
+    // If same class, copy the rows and the deltas
+    const cut::DynamicAdjacencyList* DAL = dynamic_cast<const cut::DynamicAdjacencyList*>(&AL);
+    if (DAL != nullptr)
+    {
+        m_Adj = DAL->m_Adj;
+        m_Idx = DAL->m_Idx;
+        m_Deltas = DAL->m_Deltas;
+        m_NNodes = DAL->m_NNodes;
+        m_NConnections = DAL->m_NConnections;
+        m_NPending = DAL->m_NPending;
+        m_MergeThreshold = DAL->m_MergeThreshold;
+        m_NMerges = DAL->m_NMerges;
+        return *this;
+    }
+
+    // Otherwise, read through the abstract interface
+    Load(AL);
+    return *this;
+}
+
+cut::DynamicAdjacencyList& cut::DynamicAdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+{
+    if (&AL == this)
+        return *this;
+    cut::DynamicAdjacencyList* DAL = dynamic_cast<cut::DynamicAdjacencyList*>(&AL);
+    if (DAL == nullptr)
+    {
+        // Nothing to steal from other lists
+        Load(AL);
+        return *this;
+    }
+
+    m_Adj = std::move(DAL->m_Adj);
+    m_Idx = std::move(DAL->m_Idx);
+    m_Deltas = std::move(DAL->m_Deltas);
+    m_NNodes = DAL->m_NNodes;
+    m_NConnections = DAL->m_NConnections;
+    m_NPending = DAL->m_NPending;
+    m_MergeThreshold = DAL->m_MergeThreshold;
+    m_NMerges = DAL->m_NMerges;
+    DAL->m_Adj.clear();
+    DAL->m_Idx.assign(1, 0);
+    DAL->m_Deltas.clear();
+    DAL->m_NNodes = 0;
+    DAL->m_NConnections = 0;
+    DAL->m_NPending = 0;
+    return *this;
+}
+
+cut::DynamicAdjacencyList& cut::DynamicAdjacencyList::operator=(const cut::DynamicAdjacencyList& AL)
+{
+    operator=((const cut::BaseAdjacencyList&)AL);
+    return *this;
+}
+
+cut::DynamicAdjacencyList& cut::DynamicAdjacencyList::operator=(cut::DynamicAdjacencyList&& AL)
+{
+    return operator=((cut::BaseAdjacencyList&&)AL);
+}
+
+cut::DynamicAdjacencyList::~DynamicAdjacencyList() { }
+
+
+void cut::DynamicAdjacencyList::Load(const cut::BaseAdjacencyList& AL)
+{
+    // Count the adjacents of each node and accumulate the offsets
+    int NNodes = AL.NumNodes();
+    m_Idx.assign(NNodes + 1, 0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            m_Idx[i + 1] = AL.NumAdjacents(i);
+    });
+    cut::ParallelPrefixSum(m_Idx.data() + 1, NNodes);
+
+    // Fill the rows, then sort them and drop the duplicates
+    m_Adj.resize(m_Idx[NNodes]);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+        {
+            cut::Span<int> Adjs = AL.Neighbors(i);
+            std::copy(Adjs.begin(), Adjs.end(), m_Adj.data() + m_Idx[i]);
+        }
+    }, -1, 1024);
+    cut::SortAndUniqueRows(m_Idx, m_Adj);
+
+    m_Deltas.clear();
+    m_NNodes = NNodes;
+    m_NConnections = m_Adj.size();
+    m_NPending = 0;
+}
+
+
+const cut::DynamicAdjacencyList::Delta* cut::DynamicAdjacencyList::DeltaOf(int i) const
+{
+    if (m_Deltas.empty())
+        return nullptr;
+    auto It = m_Deltas.find(i);
+    return It == m_Deltas.end() ? nullptr : &It->second;
+}
+
+cut::Span<int> cut::DynamicAdjacencyList::CompactRow(int i) const
+{
+    if ((size_t)i + 1 >= m_Idx.size())
+        return cut::Span<int>(nullptr, 0);
+    return cut::Span<int>(m_Adj.data() + m_Idx[i], m_Idx[i + 1] - m_Idx[i]);
+}
+
+
+int cut::DynamicAdjacencyList::NumNodes() const { return m_NNodes; }
+int cut::DynamicAdjacencyList::NumConnections() const { return m_NConnections; }
+int cut::DynamicAdjacencyList::NumAdjacents(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    int N = CompactRow(i).Size();
+    const Delta* D = DeltaOf(i);
+    if (D != nullptr)
+        N += (int)D->Added.size() - (int)D->Removed.size();
+    return N;
+}
+
+int cut::DynamicAdjacencyList::GetAdjacent(int i, int idx) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+    CUTCheckGEQ(idx, 0);
+    CUTCheckLess(idx, NumAdjacents(i));
+
+    cut::Span<int> Row = CompactRow(i);
+    const Delta* D = DeltaOf(i);
+    if (D == nullptr)
+        return Row[idx];
+
+    // The merged row is made of the kept adjacents of the compact row and of the added
+    // ones. Both are sorted, so the position is found by binary searches, without
+    // walking or copying the row
+    const std::vector<int>& Added = D->Added;
+    const std::vector<int>& Removed = D->Removed;
+    auto KeptBefore = [&](int j) -> size_t
+    {
+        return (std::lower_bound(Row.begin(), Row.end(), j) - Row.begin()) -
+               (std::lower_bound(Removed.begin(), Removed.end(), j) - Removed.begin());
+    };
+
+    // The added adjacent t is in position t + KeptBefore(Added[t]) of the merged row,
+    // count those before position idx
+    size_t Lo = 0;
+    size_t Hi = Added.size();
+    while (Lo < Hi)
+    {
+        size_t Mid = (Lo + Hi) / 2;
+        if (Mid + KeptBefore(Added[Mid]) < (size_t)idx)
+            Lo = Mid + 1;
+        else
+            Hi = Mid;
+    }
+    if (Lo < Added.size() && Lo + KeptBefore(Added[Lo]) == (size_t)idx)
+        return Added[Lo];
+
+    // Otherwise, it is the kept adjacent in position idx - Lo: the first one of the
+    // compact row with idx - Lo + 1 kept adjacents up to it
+    size_t Kept = (size_t)idx - Lo + 1;
+    Lo = 0;
+    Hi = Row.Size();
+    while (Lo < Hi)
+    {
+        size_t Mid = (Lo + Hi) / 2;
+        size_t NRemoved = std::upper_bound(Removed.begin(), Removed.end(), Row[Mid]) - Removed.begin();
+        if (Mid + 1 - NRemoved < Kept)
+            Lo = Mid + 1;
+        else
+            Hi = Mid;
+    }
+    return Row[Lo];
+}
+
+cut::Span<int> cut::DynamicAdjacencyList::Neighbors(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    // Unmodified rows are read in place
+    if (DeltaOf(i) == nullptr)
+        return CompactRow(i);
+
+    // Merge the modified ones in a buffer owned by the calling thread
+    static thread_local std::vector<int> Buffer;
+    Buffer.clear();
+    ForEachAdjacent(i, [&](int j) { Buffer.push_back(j); });
+    return cut::Span<int>(Buffer.data(), Buffer.size());
+}
+
+
+bool cut::DynamicAdjacencyList::HasConnection(int i, int j) const
+{
+    if (i < 0 || i >= NumNodes())
+        return false;
+    cut::Span<int> Row = CompactRow(i);
+    const Delta* D = DeltaOf(i);
+    if (cut::SortedContains(Row, j))
+        return D == nullptr || !cut::SortedContains(D->Removed.data(), D->Removed.size(), j);
+    return D != nullptr && cut::SortedContains(D->Added.data(), D->Added.size(), j);
+}
+
+bool cut::DynamicAdjacencyList::Insert(int i, int j)
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckGEQ(j, 0);
+
+    cut::Span<int> Row = CompactRow(i);
+    if (std::binary_search(Row.begin(), Row.end(), j))
+    {
+        // The adjacent is in the compact row, it exists unless it was removed
+        auto It = m_Deltas.find(i);
+        if (It == m_Deltas.end())
+            return false;
+        std::vector<int>& Removed = It->second.Removed;
+        auto Pos = std::lower_bound(Removed.begin(), Removed.end(), j);
+        if (Pos == Removed.end() || *Pos != j)
+            return false;
+        Removed.erase(Pos);
+        if (Removed.empty() && It->second.Added.empty())
+            m_Deltas.erase(It);
+        m_NPending--;
+    }
+    else
+    {
+        std::vector<int>& Added = m_Deltas[i].Added;
+        auto Pos = std::lower_bound(Added.begin(), Added.end(), j);
+        if (Pos != Added.end() && *Pos == j)
+            return false;
+        Added.insert(Pos, j);
+        m_NPending++;
+        m_NNodes = std::max(m_NNodes, i + 1);
+    }
+    m_NConnections++;
+    return true;
+}
+
+bool cut::DynamicAdjacencyList::Erase(int i, int j)
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckGEQ(j, 0);
+
+    if (i >= NumNodes())
+        return false;
+    cut::Span<int> Row = CompactRow(i);
+    if (std::binary_search(Row.begin(), Row.end(), j))
+    {
+        // The adjacent is in the compact row, mark it as removed
+        std::vector<int>& Removed = m_Deltas[i].Removed;
+        auto Pos = std::lower_bound(Removed.begin(), Removed.end(), j);
+        if (Pos != Removed.end() && *Pos == j)
+            return false;
+        Removed.insert(Pos, j);
+        m_NPending++;
+    }
+    else
+    {
+        // The adjacent exists only if it was added
+        auto It = m_Deltas.find(i);
+        if (It == m_Deltas.end())
+            return false;
+        std::vector<int>& Added = It->second.Added;
+        auto Pos = std::lower_bound(Added.begin(), Added.end(), j);
+        if (Pos == Added.end() || *Pos != j)
+            return false;
+        Added.erase(Pos);
+        if (Added.empty() && It->second.Removed.empty())
+            m_Deltas.erase(It);
+        m_NPending--;
+    }
+    m_NConnections--;
+    return true;
+}
+
+void cut::DynamicAdjacencyList::MergeIfNeeded()
+{
+    size_t Threshold = m_MergeThreshold;
+    if (Threshold == 0)
+        Threshold = std::max(MinMergeThreshold, m_Adj.size() / 8);
+    if (m_NPending >= Threshold)
+        Merge();
+}
+
+bool cut::DynamicAdjacencyList::AddConnection(int i, int j)
+{
+    bool Added = Insert(i, j);
+    MergeIfNeeded();
+    return Added;
+}
+
+bool cut::DynamicAdjacencyList::RemoveConnection(int i, int j)
+{
+    bool Removed = Erase(i, j);
+    MergeIfNeeded();
+    return Removed;
+}
+
+size_t cut::DynamicAdjacencyList::AddConnections(const std::vector<std::pair<int, int>>& Connections)
+{
+    // The edits of each node are merged with its delta at once, in linear time
+    std::vector<std::pair<int, int>> Batch = SortedBatch(Connections);
+    std::vector<int> New;
+    std::vector<int> Restored;
+    std::vector<int> Merged;
+    size_t NAdded = 0;
+    size_t b = 0;
+    while (b < Batch.size())
+    {
+        int i = Batch[b].first;
+        CUTCheckGEQ(i, 0);
+        cut::Span<int> Row = CompactRow(i);
+        New.clear();
+        Restored.clear();
+        for (; b < Batch.size() && Batch[b].first == i; ++b)
+        {
+            int j = Batch[b].second;
+            CUTCheckGEQ(j, 0);
+            // The adjacents of the compact row come back only if they were removed
+            if (std::binary_search(Row.begin(), Row.end(), j))
+                Restored.push_back(j);
+            else
+                New.push_back(j);
+        }
+
+        auto It = m_Deltas.find(i);
+        if (It == m_Deltas.end())
+        {
+            if (New.empty())
+                continue;
+            It = m_Deltas.emplace(i, Delta()).first;
+        }
+        Delta& D = It->second;
+        size_t NBefore = D.Removed.size();
+        Merged.clear();
+        std::set_difference(D.Removed.begin(), D.Removed.end(), Restored.begin(), Restored.end(), std::back_inserter(Merged));
+        D.Removed.swap(Merged);
+        size_t NRestored = NBefore - D.Removed.size();
+        NBefore = D.Added.size();
+        Merged.clear();
+        std::set_union(D.Added.begin(), D.Added.end(), New.begin(), New.end(), std::back_inserter(Merged));
+        D.Added.swap(Merged);
+        size_t NNew = D.Added.size() - NBefore;
+        if (NNew > 0)
+            m_NNodes = std::max(m_NNodes, i + 1);
+        if (D.Added.empty() && D.Removed.empty())
+            m_Deltas.erase(It);
+
+        m_NPending = m_NPending + NNew - NRestored;
+        m_NConnections += (int)(NNew + NRestored);
+        NAdded += NNew + NRestored;
+    }
+    MergeIfNeeded();
+    return NAdded;
+}
+
+size_t cut::DynamicAdjacencyList::RemoveConnections(const std::vector<std::pair<int, int>>& Connections)
+{
+    // The edits of each node are merged with its delta at once, in linear time
+    std::vector<std::pair<int, int>> Batch = SortedBatch(Connections);
+    std::vector<int> Removing;
+    std::vector<int> Dropped;
+    std::vector<int> Merged;
+    size_t NRemoved = 0;
+    size_t b = 0;
+    while (b < Batch.size())
+    {
+        int i = Batch[b].first;
+        CUTCheckGEQ(i, 0);
+        cut::Span<int> Row = CompactRow(i);
+        Removing.clear();
+        Dropped.clear();
+        for (; b < Batch.size() && Batch[b].first == i; ++b)
+        {
+            int j = Batch[b].second;
+            CUTCheckGEQ(j, 0);
+            // The adjacents outside the compact row exist only if they were added
+            if (std::binary_search(Row.begin(), Row.end(), j))
+                Removing.push_back(j);
+            else
+                Dropped.push_back(j);
+        }
+        if (i >= NumNodes())
+            continue;
+
+        auto It = m_Deltas.find(i);
+        if (It == m_Deltas.end())
+        {
+            if (Removing.empty())
+                continue;
+            It = m_Deltas.emplace(i, Delta()).first;
+        }
+        Delta& D = It->second;
+        size_t NBefore = D.Removed.size();
+        Merged.clear();
+        std::set_union(D.Removed.begin(), D.Removed.end(), Removing.begin(), Removing.end(), std::back_inserter(Merged));
+        D.Removed.swap(Merged);
+        size_t NNew = D.Removed.size() - NBefore;
+        NBefore = D.Added.size();
+        Merged.clear();
+        std::set_difference(D.Added.begin(), D.Added.end(), Dropped.begin(), Dropped.end(), std::back_inserter(Merged));
+        D.Added.swap(Merged);
+        size_t NDropped = NBefore - D.Added.size();
+        if (D.Added.empty() && D.Removed.empty())
+            m_Deltas.erase(It);
+
+        m_NPending = m_NPending + NNew - NDropped;
+        m_NConnections -= (int)(NNew + NDropped);
+        NRemoved += NNew + NDropped;
+    }
+    MergeIfNeeded();
+    return NRemoved;
+}
+
+
+void cut::DynamicAdjacencyList::Merge()
+{
+    if (m_Deltas.empty() && m_Idx.size() == (size_t)m_NNodes + 1)
+        return;
+    __CUTProfileLibrary("DynamicAdjacencyList::Merge");
+
+    // The offsets of the merged rows
+    int NNodes = m_NNodes;
+    cut::CompatAdjacencyList::ArrayType NewIdx(NNodes + 1, 0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            NewIdx[i + 1] = NumAdjacents(i);
+    });
+    cut::ParallelPrefixSum(NewIdx.data() + 1, NNodes);
+
+    // Each merged row has its own range
+    cut::CompatAdjacencyList::ArrayType NewAdj(NewIdx[NNodes]);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+        {
+            int* Out = NewAdj.data() + NewIdx[i];
+            ForEachAdjacent(i, [&](int j) { *Out++ = j; });
+        }
+    }, -1, 1024);
+
+    m_Idx.swap(NewIdx);
+    m_Adj.swap(NewAdj);
+    m_Deltas.clear();
+    m_NPending = 0;
+    m_NMerges++;
+}
+
+size_t cut::DynamicAdjacencyList::NumPendingEdits() const { return m_NPending; }
+size_t cut::DynamicAdjacencyList::MergeThreshold() const { return m_MergeThreshold; }
+void cut::DynamicAdjacencyList::SetMergeThreshold(size_t Threshold) { m_MergeThreshold = Threshold; }
+size_t cut::DynamicAdjacencyList::NumMerges() const { return m_NMerges; }
\ No newline at end of file
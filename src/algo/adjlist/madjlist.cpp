@@ -0,0 +1,310 @@
+/**
+ * @file        madjlist.cpp
+ * 
+ * @brief       Implementation of cut::MappedAdjacencyList.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-23
+ */
+#include <cut/algo/madjlist.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <climits>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+static_assert(sizeof(cut::BinaryAdjacencyHeader) == 64, "The binary header must be 64 bytes long.");
+
+const uint32_t cut::MappedAdjacencyList::Version;
+
+
+namespace
+{
+    const char BinMagic[8] = { 'C', 'U', 'T', 'A', 'D', 'J', 'L', '\0' };
+    const uint64_t BinAlign = 64;
+
+    bool IsLittleEndian()
+    {
+        const uint16_t Probe = 1;
+        return *reinterpret_cast<const uint8_t*>(&Probe) == 1;
+    }
+
+    uint64_t AlignUp(uint64_t Pos)
+    {
+        return (Pos + BinAlign - 1) / BinAlign * BinAlign;
+    }
+
+    [[noreturn]] void Fail(const std::string& Msg, const std::string& Filename)
+    {
+        throw cut::AssertionError(Msg + " (" + Filename + ")");
+    }
+}
+
+
+cut::MappedAdjacencyList::MappedAdjacencyList(const std::string& Filename)
+    : cut::BaseAdjacencyList(),
+      m_Map(nullptr), m_MapSize(0), m_Handle(nullptr),
+      m_NNodes(0), m_NConns(0), m_Idx(nullptr), m_Adj(nullptr)
+{
+    if (!IsLittleEndian())
+        Fail("The binary adjacency list format requires a little-endian host.", Filename);
+
+#if defined(_WIN32)
+    HANDLE File = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (File == INVALID_HANDLE_VALUE)
+        Fail("Cannot open the binary adjacency list.", Filename);
+    LARGE_INTEGER FSize;
+    if (!GetFileSizeEx(File, &FSize))
+    {
+        CloseHandle(File);
+        Fail("Cannot read the size of the binary adjacency list.", Filename);
+    }
+    m_MapSize = (size_t)FSize.QuadPart;
+    if (m_MapSize < sizeof(cut::BinaryAdjacencyHeader))
+    {
+        CloseHandle(File);
+        Fail("The file is too small to be a binary adjacency list.", Filename);
+    }
+    HANDLE Mapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(File);
+    if (Mapping == NULL)
+        Fail("Cannot map the binary adjacency list.", Filename);
+    m_Map = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_Map == NULL)
+    {
+        CloseHandle(Mapping);
+        Fail("Cannot map the binary adjacency list.", Filename);
+    }
+    m_Handle = Mapping;
+#else
+    int FD = open(Filename.c_str(), O_RDONLY);
+    if (FD < 0)
+        Fail("Cannot open the binary adjacency list.", Filename);
+    struct stat FStat;
+    if (fstat(FD, &FStat) != 0)
+    {
+        close(FD);
+        Fail("Cannot read the size of the binary adjacency list.", Filename);
+    }
+    m_MapSize = (size_t)FStat.st_size;
+    if (m_MapSize < sizeof(cut::BinaryAdjacencyHeader))
+    {
+        close(FD);
+        Fail("The file is too small to be a binary adjacency list.", Filename);
+    }
+    void* Map = mmap(nullptr, m_MapSize, PROT_READ, MAP_SHARED, FD, 0);
+    close(FD);
+    if (Map == MAP_FAILED)
+        Fail("Cannot map the binary adjacency list.", Filename);
+    m_Map = Map;
+#endif
+
+    // Validate the header before trusting any pointer
+    cut::BinaryAdjacencyHeader Header;
+    std::memcpy(&Header, m_Map, sizeof(Header));
+    const char* Error = nullptr;
+    if (std::memcmp(Header.Magic, BinMagic, sizeof(BinMagic)) != 0)
+        Error = "The file is not a binary adjacency list.";
+    else if (Header.Version != cut::MappedAdjacencyList::Version)
+        Error = "Unsupported version of the binary adjacency list format.";
+    else if (Header.OffsetBytes != sizeof(uint64_t) || Header.IndexBytes != sizeof(int))
+        Error = "Unsupported types in the binary adjacency list.";
+    else if (Header.OffsetsPos % BinAlign != 0 || Header.AdjacentsPos % BinAlign != 0)
+        Error = "Misaligned arrays in the binary adjacency list.";
+    else if (Header.NumNodes > (uint64_t)INT_MAX)
+        Error = "Too many nodes in the binary adjacency list.";
+    // The lengths are compared with the space left after each array, so that nothing overflows
+    else if (Header.OffsetsPos > m_MapSize || Header.AdjacentsPos > m_MapSize ||
+             Header.NumNodes >= (m_MapSize - Header.OffsetsPos) / sizeof(uint64_t) ||
+             Header.NumConnections > (m_MapSize - Header.AdjacentsPos) / sizeof(int))
+        Error = "The binary adjacency list is truncated.";
+    if (Error != nullptr)
+    {
+        Unmap();
+        Fail(Error, Filename);
+    }
+
+    m_NNodes = Header.NumNodes;
+    m_NConns = Header.NumConnections;
+    m_Idx = reinterpret_cast<const uint64_t*>(static_cast<const char*>(m_Map) + Header.OffsetsPos);
+    m_Adj = reinterpret_cast<const int*>(static_cast<const char*>(m_Map) + Header.AdjacentsPos);
+    // Every offset is read once, so that no row can point outside the mapping
+    bool Consistent = m_Idx[0] == 0 && m_Idx[m_NNodes] == m_NConns;
+    for (size_t i = 0; Consistent && i < m_NNodes; ++i)
+        Consistent = m_Idx[i] <= m_Idx[i + 1] && m_Idx[i + 1] <= m_NConns && m_Idx[i + 1] - m_Idx[i] <= (uint64_t)INT_MAX;
+    if (!Consistent)
+    {
+        Unmap();
+        Fail("Inconsistent offsets in the binary adjacency list.", Filename);
+    }
+}
+
+cut::MappedAdjacencyList::MappedAdjacencyList(cut::MappedAdjacencyList&& AL)
+    : cut::BaseAdjacencyList(),
+      m_Map(AL.m_Map), m_MapSize(AL.m_MapSize), m_Handle(AL.m_Handle),
+      m_NNodes(AL.m_NNodes), m_NConns(AL.m_NConns), m_Idx(AL.m_Idx), m_Adj(AL.m_Adj)
+{
+    AL.m_Map = nullptr;
+    AL.m_MapSize = 0;
+    AL.m_Handle = nullptr;
+    AL.m_NNodes = 0;
+    AL.m_NConns = 0;
+    AL.m_Idx = nullptr;
+    AL.m_Adj = nullptr;
+}
+
+cut::BaseAdjacencyList& cut::MappedAdjacencyList::operator=(const cut::BaseAdjacencyList&)
+{
+    throw cut::AssertionError("A cut::MappedAdjacencyList is read-only and cannot be assigned.");
+}
+
+cut::BaseAdjacencyList& cut::MappedAdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+{
+    cut::MappedAdjacencyList* MAL = dynamic_cast<cut::MappedAdjacencyList*>(&AL);
+    if (MAL == nullptr)
+        throw cut::AssertionError("A cut::MappedAdjacencyList can only be moved from another cut::MappedAdjacencyList.");
+    if (MAL == this)
+        return *this;
+
+    Unmap();
+    std::swap(m_Map, MAL->m_Map);
+    std::swap(m_MapSize, MAL->m_MapSize);
+    std::swap(m_Handle, MAL->m_Handle);
+    std::swap(m_NNodes, MAL->m_NNodes);
+    std::swap(m_NConns, MAL->m_NConns);
+    std::swap(m_Idx, MAL->m_Idx);
+    std::swap(m_Adj, MAL->m_Adj);
+    return *this;
+}
+
+cut::MappedAdjacencyList::~MappedAdjacencyList()
+{
+    Unmap();
+}
+
+void cut::MappedAdjacencyList::Unmap()
+{
+    if (m_Map != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_Map);
+        CloseHandle((HANDLE)m_Handle);
+#else
+        munmap(m_Map, m_MapSize);
+#endif
+    }
+    m_Map = nullptr;
+    m_MapSize = 0;
+    m_Handle = nullptr;
+    m_NNodes = 0;
+    m_NConns = 0;
+    m_Idx = nullptr;
+    m_Adj = nullptr;
+}
+
+
+int cut::MappedAdjacencyList::NumNodes() const { return (int)m_NNodes; }
+int cut::MappedAdjacencyList::NumConnections() const
+{
+    // Lists larger than an int must be sized with NumConnections64()
+    if (m_NConns > (uint64_t)INT_MAX)
+        throw cut::OutOfBoundError("The number of connections of the mapped list does not fit an int.");
+    return (int)m_NConns;
+}
+int cut::MappedAdjacencyList::NumAdjacents(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    return (int)(m_Idx[i + 1] - m_Idx[i]);
+}
+int cut::MappedAdjacencyList::GetAdjacent(int i, int idx) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+    CUTCheckGEQ(idx, 0);
+    CUTCheckLess((uint64_t)idx, m_Idx[i + 1] - m_Idx[i]);
+
+    return m_Adj[m_Idx[i] + idx];
+}
+cut::Span<int> cut::MappedAdjacencyList::Neighbors(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    return NeighborsUnchecked(i);
+}
+
+
+void cut::MappedAdjacencyList::Save(const cut::BaseAdjacencyList& AL,
+                                    const std::string& Filename)
+{
+    if (!IsLittleEndian())
+        Fail("The binary adjacency list format requires a little-endian host.", Filename);
+
+    std::ofstream Stream(Filename, std::ios::out | std::ios::binary);
+    if (!Stream.is_open())
+        Fail("Cannot open the file for writing the binary adjacency list.", Filename);
+
+    // Header
+    cut::BinaryAdjacencyHeader Header;
+    std::memset(&Header, 0, sizeof(Header));
+    std::memcpy(Header.Magic, BinMagic, sizeof(BinMagic));
+    Header.Version = cut::MappedAdjacencyList::Version;
+    Header.NumNodes = AL.NumNodes();
+    Header.NumConnections = AL.NumConnections();
+    Header.OffsetBytes = sizeof(uint64_t);
+    Header.IndexBytes = sizeof(int);
+    Header.OffsetsPos = AlignUp(sizeof(Header));
+    Header.AdjacentsPos = AlignUp(Header.OffsetsPos + (Header.NumNodes + 1) * sizeof(uint64_t));
+    Stream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    // Offsets, written in blocks
+    const char Padding[BinAlign] = { 0 };
+    Stream.write(Padding, Header.OffsetsPos - sizeof(Header));
+    std::vector<uint64_t> Block;
+    Block.reserve(4096);
+    uint64_t Offset = 0;
+    Block.push_back(Offset);
+    for (int i = 0; i < AL.NumNodes(); ++i)
+    {
+        Offset += AL.NumAdjacents(i);
+        Block.push_back(Offset);
+        if (Block.size() == Block.capacity())
+        {
+            Stream.write(reinterpret_cast<const char*>(Block.data()), Block.size() * sizeof(uint64_t));
+            Block.clear();
+        }
+    }
+    Stream.write(reinterpret_cast<const char*>(Block.data()), Block.size() * sizeof(uint64_t));
+    CUTAssert(Offset == Header.NumConnections);
+
+    // Adjacents, written row by row
+    uint64_t Pos = Header.OffsetsPos + (Header.NumNodes + 1) * sizeof(uint64_t);
+    Stream.write(Padding, Header.AdjacentsPos - Pos);
+    for (int i = 0; i < AL.NumNodes(); ++i)
+    {
+        cut::Span<int> Adjs = AL.Neighbors(i);
+        Stream.write(reinterpret_cast<const char*>(Adjs.Data()), Adjs.Size() * sizeof(int));
+    }
+
+    Stream.close();
+    if (Stream.fail())
+        Fail("Cannot write the binary adjacency list.", Filename);
+}
\ No newline at end of file
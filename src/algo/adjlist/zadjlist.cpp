@@ -0,0 +1,263 @@
+/**
+ * @file        zadjlist.cpp
+ * 
+ * @brief       Implementation of cut::CompressedAdjacencyList.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-02
+ */
+#include <cut/algo/zadjlist.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <algorithm>
+#include <atomic>
+#include <typeinfo>
+
+
+const size_t cut::CompressedAdjacencyList::BlockSize;
+
+
+namespace
+{
+    void WriteVarint(std::vector<uint8_t>& Out, uint64_t Value)
+    {
+        while (Value >= 0x80)
+        {
+            Out.push_back((uint8_t)(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.push_back((uint8_t)Value);
+    }
+
+    uint64_t ZigZag(int64_t Value)
+    {
+        return ((uint64_t)Value << 1) ^ (uint64_t)(Value >> 63);
+    }
+
+    int64_t UnZigZag(uint64_t Value)
+    {
+        return (int64_t)(Value >> 1) ^ -(int64_t)(Value & 1);
+    }
+}
+
+
+cut::CompressedAdjacencyList::CompressedAdjacencyList()
+    : cut::BaseAdjacencyList(), m_BlockStart(1, 0), m_NConnections(0)
+{ }
+
+cut::CompressedAdjacencyList::CompressedAdjacencyList(const std::vector<std::pair<int, int>>& Connections)
+    : cut::BaseAdjacencyList()
+{
+    Encode(cut::CompatAdjacencyList(Connections, false));
+}
+
+cut::CompressedAdjacencyList::CompressedAdjacencyList(const cut::BaseAdjacencyList& AL)
+    : cut::BaseAdjacencyList()
+{
+    operator=(AL);
+}
+
+cut::CompressedAdjacencyList::CompressedAdjacencyList(const cut::CompressedAdjacencyList& AL)
+    : cut::BaseAdjacencyList(), m_Data(AL.m_Data), m_BlockStart(AL.m_BlockStart),
+      m_Start(AL.m_Start), m_NConnections(AL.m_NConnections)
+{ }
+
+cut::CompressedAdjacencyList::CompressedAdjacencyList(cut::CompressedAdjacencyList&& AL)
+    : cut::BaseAdjacencyList(),
+      m_Data(std::move(AL.m_Data)), m_BlockStart(std::move(AL.m_BlockStart)),
+      m_Start(std::move(AL.m_Start)), m_NConnections(AL.m_NConnections)
+{
+    AL.m_Data.clear();
+    AL.m_BlockStart.assign(1, 0);
+    AL.m_Start.clear();
+    AL.m_NConnections = 0;
+}
+
+cut::BaseAdjacencyList& cut::CompressedAdjacencyList::operator=(const cut::BaseAdjacencyList& AL)
+{
+    if (&AL == this)
+        return *this;
+    cut::BaseAdjacencyList::operator=(AL);
+
+    // If same class, copy the encoding
+    try
+    {
+        const cut::CompressedAdjacencyList& ZAL = dynamic_cast<const cut::CompressedAdjacencyList&>(AL);
+        m_Data = ZAL.m_Data;
+        m_BlockStart = ZAL.m_BlockStart;
+        m_Start = ZAL.m_Start;
+        m_NConnections = ZAL.m_NConnections;
+        return *this;
+    }
+    catch(const std::bad_cast& e) { }
+
+    // Otherwise, encode through the abstract interface
+    Encode(AL);
+    return *this;
+}
+
+cut::CompressedAdjacencyList& cut::CompressedAdjacencyList::operator=(cut::BaseAdjacencyList&& AL)
+{
+    if (&AL == this)
+        return *this;
+    try
+    {
+        cut::CompressedAdjacencyList&& ZAL = dynamic_cast<cut::CompressedAdjacencyList&&>(AL);
+        m_Data = std::move(ZAL.m_Data);
+        m_BlockStart = std::move(ZAL.m_BlockStart);
+        m_Start = std::move(ZAL.m_Start);
+        m_NConnections = ZAL.m_NConnections;
+        ZAL.m_Data.clear();
+        ZAL.m_BlockStart.assign(1, 0);
+        ZAL.m_Start.clear();
+        ZAL.m_NConnections = 0;
+        return *this;
+    }
+    catch(const std::bad_cast& e) { }
+
+    // Nothing to steal from other lists, encode them
+    Encode(AL);
+    return *this;
+}
+
+cut::CompressedAdjacencyList& cut::CompressedAdjacencyList::operator=(const cut::CompressedAdjacencyList& AL)
+{
+    operator=((const cut::BaseAdjacencyList&)AL);
+    return *this;
+}
+
+cut::CompressedAdjacencyList& cut::CompressedAdjacencyList::operator=(cut::CompressedAdjacencyList&& AL)
+{
+    operator=((cut::BaseAdjacencyList&&)AL);
+    return *this;
+}
+
+cut::CompressedAdjacencyList::~CompressedAdjacencyList() { }
+
+
+void cut::CompressedAdjacencyList::Encode(const cut::BaseAdjacencyList& AL)
+{
+    // Each block of rows is encoded in its own buffer, then the buffers are joined
+    size_t NNodes = AL.NumNodes();
+    std::vector<std::vector<uint8_t>> Blocks((NNodes + BlockSize - 1) / BlockSize);
+    m_Start.assign(NNodes, 0);
+    std::atomic<int> NConns(0);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        std::vector<int> Row;
+        int Loc = 0;
+        for (size_t i = b; i < e; ++i)
+        {
+            cut::Span<int> Adjs = AL.Neighbors(i);
+            Row.assign(Adjs.begin(), Adjs.end());
+            std::sort(Row.begin(), Row.end());
+
+            std::vector<uint8_t>& Out = Blocks[i / BlockSize];
+            m_Start[i] = (uint32_t)Out.size();
+            WriteVarint(Out, Row.size());
+            if (!Row.empty())
+                WriteVarint(Out, ZigZag((int64_t)Row[0] - (int64_t)i));
+            for (size_t k = 1; k < Row.size(); ++k)
+                WriteVarint(Out, (uint64_t)((int64_t)Row[k] - (int64_t)Row[k - 1]));
+            Loc += (int)Row.size();
+        }
+        NConns.fetch_add(Loc);
+    }, -1, BlockSize);
+
+    m_BlockStart.assign(Blocks.size() + 1, 0);
+    for (size_t B = 0; B < Blocks.size(); ++B)
+    {
+        CUTAssert(Blocks[B].size() <= UINT32_MAX);
+        m_BlockStart[B + 1] = m_BlockStart[B] + Blocks[B].size();
+    }
+    m_Data.resize(m_BlockStart.back());
+    cut::ParallelFor(0, Blocks.size(), [&](size_t b, size_t e)
+    {
+        for (size_t B = b; B < e; ++B)
+        {
+            std::copy(Blocks[B].begin(), Blocks[B].end(), m_Data.begin() + m_BlockStart[B]);
+            std::vector<uint8_t>().swap(Blocks[B]);
+        }
+    }, -1, 1);
+    m_Data.shrink_to_fit();
+    m_NConnections = NConns.load();
+}
+
+
+int cut::CompressedAdjacencyList::NumNodes() const
+{
+    return (int)m_Start.size();
+}
+
+int cut::CompressedAdjacencyList::NumConnections() const
+{
+    return m_NConnections;
+}
+
+int cut::CompressedAdjacencyList::NumAdjacents(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    const uint8_t* Ptr = RowData(i);
+    return (int)ReadVarint(Ptr);
+}
+
+int cut::CompressedAdjacencyList::GetAdjacent(int i, int idx) const
+{
+    CUTCheckGEQ(idx, 0);
+    CUTCheckLess(idx, NumAdjacents(i));
+
+    cut::CompressedAdjacencyList::RowIterator It = Row(i).begin();
+    for (int k = 0; k < idx; ++k)
+        ++It;
+    return *It;
+}
+
+cut::Span<int> cut::CompressedAdjacencyList::Neighbors(int i) const
+{
+    // Decode the row in a buffer owned by the calling thread
+    static thread_local std::vector<int> Buffer;
+    cut::CompressedAdjacencyList::RowRange R = Row(i);
+    Buffer.resize(R.Size());
+    std::copy(R.begin(), R.end(), Buffer.begin());
+
+    return cut::Span<int>(Buffer.data(), Buffer.size());
+}
+
+cut::CompressedAdjacencyList::RowRange cut::CompressedAdjacencyList::Row(int i) const
+{
+    CUTCheckGEQ(i, 0);
+    CUTCheckLess(i, NumNodes());
+
+    const uint8_t* Ptr = RowData(i);
+    int NAdjs = (int)ReadVarint(Ptr);
+    if (NAdjs == 0)
+        return RowRange(RowIterator(Ptr, 0, 0), 0);
+    int First = (int)((int64_t)i + UnZigZag(ReadVarint(Ptr)));
+    return RowRange(RowIterator(Ptr, NAdjs, First), NAdjs);
+}
+
+int cut::CompressedAdjacencyList::Decode(int i, int* Out) const
+{
+    CUTCheckNull(Out);
+
+    cut::CompressedAdjacencyList::RowRange R = Row(i);
+    std::copy(R.begin(), R.end(), Out);
+    return R.Size();
+}
+
+size_t cut::CompressedAdjacencyList::MemoryUsage() const
+{
+    return m_Data.size() * sizeof(uint8_t) + m_BlockStart.size() * sizeof(size_t) +
+           m_Start.size() * sizeof(uint32_t);
+}
+
+double cut::CompressedAdjacencyList::CompressionRatio() const
+{
+    size_t Uncompressed = (m_Start.size() + 1 + m_NConnections) * sizeof(int);
+    return (double)Uncompressed / (double)MemoryUsage();
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+/**
+ * @file        graph.cpp
+ * 
+ * @brief       Implementation of cut::GraphSearch.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-29
+ */
+#include <cut/algo/graph.hpp>
+
+
+const size_t cut::GraphSearch::BlockSize;
+const int cut::GraphSearch::QueuesPerThread;
+const int cut::GraphSearch::Unreached;
+
+
+namespace
+{
+    // Switch to bottom-up when the frontier has more than 1/Alpha of the
+    // unexplored connections, and back to top-down when it has less than
+    // 1/Beta of the nodes (Beamer et al., 2012)
+    const size_t Alpha = 14;
+    const size_t Beta = 24;
+}
+
+
+cut::GraphSearch::GraphSearch()
+    : m_DepthCap(0), m_DistCap(0), m_Heap(), m_Queue()
+{ }
+
+
+void cut::GraphSearch::PrepareBlocks(size_t N)
+{
+    size_t NBlocks = (N + BlockSize - 1) / BlockSize;
+    if (m_Blocks.size() < NBlocks)
+        m_Blocks.resize(NBlocks);
+    for (std::vector<int>& B : m_Blocks)
+        B.clear();
+}
+
+void cut::GraphSearch::GatherBlocks(std::vector<int>& Out)
+{
+    Out.clear();
+    for (const std::vector<int>& B : m_Blocks)
+        Out.insert(Out.end(), B.begin(), B.end());
+}
+
+void cut::GraphSearch::ResetDistances(size_t NNodes)
+{
+    if (m_DistCap < NNodes)
+    {
+        m_Dist.reset(new std::atomic<double>[NNodes]);
+        m_DistCap = NNodes;
+    }
+    const double Inf = std::numeric_limits<double>::infinity();
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            m_Dist[i].store(Inf, std::memory_order_relaxed);
+    });
+}
+
+void cut::GraphSearch::GatherDistances(std::vector<double>& Dist, size_t NNodes)
+{
+    Dist.resize(NNodes);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Dist[i] = m_Dist[i].load(std::memory_order_relaxed);
+    });
+}
+
+uint64_t cut::GraphSearch::BucketOf(double Dist, double Delta)
+{
+    // Converting a quotient out of range is undefined, check it in any build.
+    // Negative distances only come from negative weights
+    double B = Dist / Delta;
+    if (!(B >= 0.0 && B < 18446744073709551616.0))
+        throw cut::OutOfBoundError("The distances are negative or too large for the bucket width of the delta-stepping.");
+    return (uint64_t)B;
+}
+
+void cut::GraphSearch::PushBucket(int v, double Delta)
+{
+    uint64_t B = BucketOf(m_Dist[v].load(std::memory_order_relaxed), Delta);
+    std::map<uint64_t, std::vector<int>>::iterator It = m_Buckets.find(B);
+    if (It == m_Buckets.end())
+    {
+        // A new bucket takes the memory of a processed one
+        It = m_Buckets.emplace(B, std::vector<int>()).first;
+        if (!m_SpareBuckets.empty())
+        {
+            It->second.swap(m_SpareBuckets.back());
+            m_SpareBuckets.pop_back();
+        }
+    }
+    It->second.push_back(v);
+}
+
+void cut::GraphSearch::ReleaseBuckets()
+{
+    // Buckets left by a query interrupted by an exception
+    for (std::pair<const uint64_t, std::vector<int>>& B : m_Buckets)
+    {
+        B.second.clear();
+        m_SpareBuckets.push_back(std::move(B.second));
+    }
+    m_Buckets.clear();
+}
+
+
+int cut::GraphSearch::BFS(const cut::BaseAdjacencyList& G,
+                          int Source,
+                          std::vector<int>& Depth,
+                          const cut::BaseAdjacencyList* Incoming)
+{
+    CUTCheckGEQ(Source, 0);
+    CUTCheckLess(Source, G.NumNodes());
+    if (Incoming != nullptr)
+        CUTAssert(Incoming->NumNodes() == G.NumNodes());
+
+    size_t NNodes = G.NumNodes();
+    if (m_DepthCap < NNodes)
+    {
+        m_Depth.reset(new std::atomic<int>[NNodes]);
+        m_DepthCap = NNodes;
+    }
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            m_Depth[i].store(Unreached, std::memory_order_relaxed);
+    });
+
+    m_Depth[Source].store(0);
+    m_Frontier.assign(1, Source);
+    size_t Unexplored = G.NumConnections();
+    size_t Reached = 1;
+    bool BottomUp = false;
+    for (int Level = 0; !m_Frontier.empty(); ++Level)
+    {
+        // Connections going out of the frontier
+        std::atomic<size_t> FrontierConns(0);
+        cut::ParallelFor(0, m_Frontier.size(), [&](size_t b, size_t e)
+        {
+            size_t Loc = 0;
+            for (size_t i = b; i < e; ++i)
+                Loc += G.NumAdjacents(m_Frontier[i]);
+            FrontierConns.fetch_add(Loc);
+        }, -1, BlockSize);
+        size_t MF = FrontierConns.load();
+        if (Incoming != nullptr)
+        {
+            if (!BottomUp && MF > Unexplored / Alpha)
+                BottomUp = true;
+            else if (BottomUp && m_Frontier.size() < NNodes / Beta)
+                BottomUp = false;
+        }
+        Unexplored -= std::min(Unexplored, MF);
+
+        if (!BottomUp)
+        {
+            // Each frontier node claims its unvisited adjacents
+            PrepareBlocks(m_Frontier.size());
+            cut::ParallelFor(0, m_Frontier.size(), [&](size_t b, size_t e)
+            {
+                std::vector<int>& Out = m_Blocks[b / BlockSize];
+                for (size_t i = b; i < e; ++i)
+                {
+                    for (int v : G.Neighbors(m_Frontier[i]))
+                    {
+                        int Expected = Unreached;
+                        if (m_Depth[v].load(std::memory_order_relaxed) == Unreached &&
+                            m_Depth[v].compare_exchange_strong(Expected, Level + 1, std::memory_order_relaxed))
+                            Out.push_back(v);
+                    }
+                }
+            }, -1, BlockSize);
+        }
+        else
+        {
+            // Each unvisited node looks for a parent in the frontier. Only
+            // the owner of a node writes it, so no atomic update is needed
+            PrepareBlocks(NNodes);
+            cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+            {
+                std::vector<int>& Out = m_Blocks[b / BlockSize];
+                for (size_t v = b; v < e; ++v)
+                {
+                    if (m_Depth[v].load(std::memory_order_relaxed) != Unreached)
+                        continue;
+                    for (int u : Incoming->Neighbors(v))
+                    {
+                        if (m_Depth[u].load(std::memory_order_relaxed) == Level)
+                        {
+                            m_Depth[v].store(Level + 1, std::memory_order_relaxed);
+                            Out.push_back(v);
+                            break;
+                        }
+                    }
+                }
+            }, -1, BlockSize);
+        }
+        GatherBlocks(m_Next);
+        std::swap(m_Frontier, m_Next);
+        Reached += m_Frontier.size();
+    }
+
+    Depth.resize(NNodes);
+    cut::ParallelFor(0, NNodes, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            Depth[i] = m_Depth[i].load(std::memory_order_relaxed);
+    });
+    return (int)Reached;
+}
\ No newline at end of file
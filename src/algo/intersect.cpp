@@ -0,0 +1,462 @@
+/**
+ * @file        intersect.cpp
+ * 
+ * @brief       Implements the vectorized kernels over the rows of adjacency lists.
+ * 
+ * @details     The SIMD kernels are compiled for their instruction set independently of
+ *              the flags of the library (through the target attribute on GCC and Clang),
+ *              and a table of kernels is selected at runtime.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-11
+ */
+#include <cut/algo/intersect.hpp>
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CUT_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CUT_TARGET_AVX2
+#else
+#define CUT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CUT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+
+namespace
+{
+    // Below this size the sorted search scans the row instead of halving it
+    const size_t SortedScanSize = 16;
+
+    // Above this ratio between the sizes of the rows the intersection searches
+    // each element of the shorter row in the longer one
+    const size_t SkewedRatio = 32;
+
+    struct Kernels
+    {
+        cut::SimdLevel Level;
+        size_t (*Intersect)(const int*, size_t, const int*, size_t, int*);
+        size_t (*IntersectCount)(const int*, size_t, const int*, size_t, int*);
+        bool (*Contains)(const int*, size_t, int);
+        void (*Degrees)(const int*, size_t, int*);
+    };
+
+    inline int LowestBit(unsigned Mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long Idx;
+        _BitScanForward(&Idx, Mask);
+        return (int)Idx;
+#else
+        return __builtin_ctz(Mask);
+#endif
+    }
+
+    inline int CountBits(unsigned Mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int N = 0;
+        for (; Mask != 0; Mask &= Mask - 1)
+            N++;
+        return N;
+#else
+        return __builtin_popcount(Mask);
+#endif
+    }
+
+    // Write the elements of the block selected by the mask, or just count them
+    template<bool Write>
+    inline size_t Emit(const int* Block, unsigned Mask, int* Out)
+    {
+        if (!Write)
+            return CountBits(Mask);
+        size_t N = 0;
+        for (; Mask != 0; Mask &= Mask - 1)
+            Out[N++] = Block[LowestBit(Mask)];
+        return N;
+    }
+
+
+
+    template<bool Write>
+    size_t IntersectScalar(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+    {
+        size_t i = 0, j = 0, N = 0;
+        while (i < NA && j < NB)
+        {
+            if (A[i] < B[j])
+                ++i;
+            else if (B[j] < A[i])
+                ++j;
+            else
+            {
+                if (Write)
+                    Out[N] = A[i];
+                ++N;
+                ++i;
+                ++j;
+            }
+        }
+        return N;
+    }
+
+    // A is the shorter row: search each of its elements in the rest of B
+    template<bool Write>
+    size_t IntersectSkewed(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+    {
+        const int* Pos = B;
+        const int* End = B + NB;
+        size_t N = 0;
+        for (size_t i = 0; i < NA && Pos != End; ++i)
+        {
+            Pos = std::lower_bound(Pos, End, A[i]);
+            if (Pos != End && *Pos == A[i])
+            {
+                if (Write)
+                    Out[N] = A[i];
+                ++N;
+                ++Pos;
+            }
+        }
+        return N;
+    }
+
+    bool ContainsScalar(const int* A, size_t N, int x)
+    {
+        return std::find(A, A + N, x) != A + N;
+    }
+
+    void DegreesScalar(const int* Offsets, size_t NRows, int* Out)
+    {
+        for (size_t r = 0; r < NRows; ++r)
+            Out[r] = Offsets[r + 1] - Offsets[r];
+    }
+
+    const Kernels ScalarKernels = { cut::SimdLevel::Scalar,
+                                    &IntersectScalar<true>, &IntersectScalar<false>,
+                                    &ContainsScalar, &DegreesScalar };
+
+
+
+#if CUT_SIMD_X86
+    // Compare a block of 4 elements of A with all the rotations of a block of B,
+    // and advance the block with the smaller maximum (both if they are equal)
+    template<bool Write>
+    size_t IntersectSSE2(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+    {
+        size_t i = 0, j = 0, N = 0;
+        while (i + 4 <= NA && j + 4 <= NB)
+        {
+            __m128i VA = _mm_loadu_si128((const __m128i*)(A + i));
+            __m128i VB = _mm_loadu_si128((const __m128i*)(B + j));
+            __m128i M = _mm_cmpeq_epi32(VA, VB);
+            M = _mm_or_si128(M, _mm_cmpeq_epi32(VA, _mm_shuffle_epi32(VB, _MM_SHUFFLE(0, 3, 2, 1))));
+            M = _mm_or_si128(M, _mm_cmpeq_epi32(VA, _mm_shuffle_epi32(VB, _MM_SHUFFLE(1, 0, 3, 2))));
+            M = _mm_or_si128(M, _mm_cmpeq_epi32(VA, _mm_shuffle_epi32(VB, _MM_SHUFFLE(2, 1, 0, 3))));
+            N += Emit<Write>(A + i, (unsigned)_mm_movemask_ps(_mm_castsi128_ps(M)), Out + (Write ? N : 0));
+
+            int MaxA = A[i + 3];
+            int MaxB = B[j + 3];
+            i += (MaxA <= MaxB) ? 4 : 0;
+            j += (MaxB <= MaxA) ? 4 : 0;
+        }
+        return N + IntersectScalar<Write>(A + i, NA - i, B + j, NB - j, Out + (Write ? N : 0));
+    }
+
+    bool ContainsSSE2(const int* A, size_t N, int x)
+    {
+        __m128i X = _mm_set1_epi32(x);
+        size_t i = 0;
+        for (; i + 4 <= N; i += 4)
+        {
+            __m128i M = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(A + i)), X);
+            if (_mm_movemask_epi8(M) != 0)
+                return true;
+        }
+        return ContainsScalar(A + i, N - i, x);
+    }
+
+    void DegreesSSE2(const int* Offsets, size_t NRows, int* Out)
+    {
+        size_t r = 0;
+        for (; r + 4 <= NRows; r += 4)
+        {
+            __m128i Lo = _mm_loadu_si128((const __m128i*)(Offsets + r));
+            __m128i Hi = _mm_loadu_si128((const __m128i*)(Offsets + r + 1));
+            _mm_storeu_si128((__m128i*)(Out + r), _mm_sub_epi32(Hi, Lo));
+        }
+        DegreesScalar(Offsets + r, NRows - r, Out + r);
+    }
+
+    // The same as IntersectSSE2(), on blocks of 8 elements
+    template<bool Write>
+    CUT_TARGET_AVX2 size_t IntersectAVX2(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+    {
+        const __m256i Rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+        size_t i = 0, j = 0, N = 0;
+        while (i + 8 <= NA && j + 8 <= NB)
+        {
+            __m256i VA = _mm256_loadu_si256((const __m256i*)(A + i));
+            __m256i VB = _mm256_loadu_si256((const __m256i*)(B + j));
+            __m256i M = _mm256_cmpeq_epi32(VA, VB);
+            for (int r = 1; r < 8; ++r)
+            {
+                VB = _mm256_permutevar8x32_epi32(VB, Rotate);
+                M = _mm256_or_si256(M, _mm256_cmpeq_epi32(VA, VB));
+            }
+            N += Emit<Write>(A + i, (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(M)), Out + (Write ? N : 0));
+
+            int MaxA = A[i + 7];
+            int MaxB = B[j + 7];
+            i += (MaxA <= MaxB) ? 8 : 0;
+            j += (MaxB <= MaxA) ? 8 : 0;
+        }
+        return N + IntersectSSE2<Write>(A + i, NA - i, B + j, NB - j, Out + (Write ? N : 0));
+    }
+
+    CUT_TARGET_AVX2 bool ContainsAVX2(const int* A, size_t N, int x)
+    {
+        __m256i X = _mm256_set1_epi32(x);
+        size_t i = 0;
+        for (; i + 8 <= N; i += 8)
+        {
+            __m256i M = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(A + i)), X);
+            if (!_mm256_testz_si256(M, M))
+                return true;
+        }
+        return ContainsSSE2(A + i, N - i, x);
+    }
+
+    CUT_TARGET_AVX2 void DegreesAVX2(const int* Offsets, size_t NRows, int* Out)
+    {
+        size_t r = 0;
+        for (; r + 8 <= NRows; r += 8)
+        {
+            __m256i Lo = _mm256_loadu_si256((const __m256i*)(Offsets + r));
+            __m256i Hi = _mm256_loadu_si256((const __m256i*)(Offsets + r + 1));
+            _mm256_storeu_si256((__m256i*)(Out + r), _mm256_sub_epi32(Hi, Lo));
+        }
+        DegreesSSE2(Offsets + r, NRows - r, Out + r);
+    }
+
+    const Kernels SSE2Kernels = { cut::SimdLevel::SSE2,
+                                  &IntersectSSE2<true>, &IntersectSSE2<false>,
+                                  &ContainsSSE2, &DegreesSSE2 };
+
+    const Kernels AVX2Kernels = { cut::SimdLevel::AVX2,
+                                  &IntersectAVX2<true>, &IntersectAVX2<false>,
+                                  &ContainsAVX2, &DegreesAVX2 };
+#endif // CUT_SIMD_X86
+
+
+
+#if CUT_SIMD_NEON
+    // The same as IntersectSSE2(), on NEON registers
+    template<bool Write>
+    size_t IntersectNEON(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+    {
+        static const uint32_t Bits[4] = { 1, 2, 4, 8 };
+        const uint32x4_t VBits = vld1q_u32(Bits);
+        size_t i = 0, j = 0, N = 0;
+        while (i + 4 <= NA && j + 4 <= NB)
+        {
+            int32x4_t VA = vld1q_s32(A + i);
+            int32x4_t VB = vld1q_s32(B + j);
+            uint32x4_t M = vceqq_s32(VA, VB);
+            M = vorrq_u32(M, vceqq_s32(VA, vextq_s32(VB, VB, 1)));
+            M = vorrq_u32(M, vceqq_s32(VA, vextq_s32(VB, VB, 2)));
+            M = vorrq_u32(M, vceqq_s32(VA, vextq_s32(VB, VB, 3)));
+            N += Emit<Write>(A + i, vaddvq_u32(vandq_u32(M, VBits)), Out + (Write ? N : 0));
+
+            int MaxA = A[i + 3];
+            int MaxB = B[j + 3];
+            i += (MaxA <= MaxB) ? 4 : 0;
+            j += (MaxB <= MaxA) ? 4 : 0;
+        }
+        return N + IntersectScalar<Write>(A + i, NA - i, B + j, NB - j, Out + (Write ? N : 0));
+    }
+
+    bool ContainsNEON(const int* A, size_t N, int x)
+    {
+        int32x4_t X = vdupq_n_s32(x);
+        size_t i = 0;
+        for (; i + 4 <= N; i += 4)
+        {
+            if (vmaxvq_u32(vceqq_s32(vld1q_s32(A + i), X)) != 0)
+                return true;
+        }
+        return ContainsScalar(A + i, N - i, x);
+    }
+
+    void DegreesNEON(const int* Offsets, size_t NRows, int* Out)
+    {
+        size_t r = 0;
+        for (; r + 4 <= NRows; r += 4)
+            vst1q_s32(Out + r, vsubq_s32(vld1q_s32(Offsets + r + 1), vld1q_s32(Offsets + r)));
+        DegreesScalar(Offsets + r, NRows - r, Out + r);
+    }
+
+    const Kernels NEONKernels = { cut::SimdLevel::NEON,
+                                  &IntersectNEON<true>, &IntersectNEON<false>,
+                                  &ContainsNEON, &DegreesNEON };
+#endif // CUT_SIMD_NEON
+
+
+
+    bool IsSupported(cut::SimdLevel Level)
+    {
+        cut::SimdLevel Detected = cut::DetectSimdLevel();
+        switch (Level)
+        {
+        case cut::SimdLevel::Scalar:
+            return true;
+        case cut::SimdLevel::SSE2:
+            return Detected == cut::SimdLevel::SSE2 || Detected == cut::SimdLevel::AVX2;
+        default:
+            return Detected == Level;
+        }
+    }
+
+    const Kernels* KernelsOf(cut::SimdLevel Level)
+    {
+        switch (Level)
+        {
+#if CUT_SIMD_X86
+        case cut::SimdLevel::SSE2:
+            return &SSE2Kernels;
+        case cut::SimdLevel::AVX2:
+            return &AVX2Kernels;
+#endif
+#if CUT_SIMD_NEON
+        case cut::SimdLevel::NEON:
+            return &NEONKernels;
+#endif
+        default:
+            return &ScalarKernels;
+        }
+    }
+
+    std::atomic<const Kernels*> g_Kernels(nullptr);
+
+    const Kernels& Active()
+    {
+        const Kernels* K = g_Kernels.load(std::memory_order_acquire);
+        if (K != nullptr)
+            return *K;
+        // First use: the table may have been set concurrently, keep that one
+        const Kernels* Expected = nullptr;
+        K = KernelsOf(cut::DetectSimdLevel());
+        if (!g_Kernels.compare_exchange_strong(Expected, K, std::memory_order_acq_rel))
+            K = Expected;
+        return *K;
+    }
+}
+
+
+cut::SimdLevel cut::DetectSimdLevel()
+{
+#if CUT_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    // AVX2 needs the support of the processor (leaf 7) and of the OS for the YMM registers
+    static const bool HasAVX2 = []()
+    {
+        int Info[4];
+        __cpuid(Info, 0);
+        if (Info[0] < 7)
+            return false;
+        __cpuid(Info, 1);
+        bool OSXSave = (Info[2] & (1 << 27)) != 0;
+        bool AVX = (Info[2] & (1 << 28)) != 0;
+        if (!OSXSave || !AVX || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(Info, 7, 0);
+        return (Info[1] & (1 << 5)) != 0;
+    }();
+#else
+    static const bool HasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+    return HasAVX2 ? cut::SimdLevel::AVX2 : cut::SimdLevel::SSE2;
+#elif CUT_SIMD_NEON
+    return cut::SimdLevel::NEON;
+#else
+    return cut::SimdLevel::Scalar;
+#endif
+}
+
+cut::SimdLevel cut::GetSimdLevel()
+{
+    return Active().Level;
+}
+
+cut::SimdLevel cut::SetSimdLevel(cut::SimdLevel Level)
+{
+    if (!IsSupported(Level))
+        Level = cut::SimdLevel::Scalar;
+    g_Kernels.store(KernelsOf(Level), std::memory_order_release);
+    return Level;
+}
+
+
+size_t cut::IntersectSorted(const int* A, size_t NA, const int* B, size_t NB, int* Out)
+{
+    if (NA > NB)
+    {
+        std::swap(A, B);
+        std::swap(NA, NB);
+    }
+    if (NA == 0)
+        return 0;
+    if (NA * SkewedRatio < NB)
+        return IntersectSkewed<true>(A, NA, B, NB, Out);
+    return Active().Intersect(A, NA, B, NB, Out);
+}
+
+size_t cut::IntersectSortedCount(const int* A, size_t NA, const int* B, size_t NB)
+{
+    if (NA > NB)
+    {
+        std::swap(A, B);
+        std::swap(NA, NB);
+    }
+    if (NA == 0)
+        return 0;
+    if (NA * SkewedRatio < NB)
+        return IntersectSkewed<false>(A, NA, B, NB, nullptr);
+    return Active().IntersectCount(A, NA, B, NB, nullptr);
+}
+
+bool cut::Contains(const int* A, size_t N, int x)
+{
+    return Active().Contains(A, N, x);
+}
+
+bool cut::SortedContains(const int* A, size_t N, int x)
+{
+    // Halve the range keeping the elements that are not larger than x at its start
+    while (N > SortedScanSize)
+    {
+        size_t Half = N / 2;
+        if (A[Half] <= x)
+        {
+            A += Half;
+            N -= Half;
+        }
+        else
+            N = Half;
+    }
+    return Active().Contains(A, N, x);
+}
+
+void cut::RowDegrees(const int* Offsets, size_t NRows, int* Out)
+{
+    Active().Degrees(Offsets, NRows, Out);
+}
\ No newline at end of file
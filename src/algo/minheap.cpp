@@ -11,9 +11,13 @@
  */
 #include <cut/algo/minheap.hpp>
 #include <cut/excepts/excepts.hpp>
+#include <cut/time/profiler.hpp>
 #include <cmath>
 #include <iostream>
 
+
+const size_t cut::MinHeap::NotInHeap;
+
 std::pair<double, size_t> cut::MinHeap::FindMin() const
 {
     CUTCheckGreater(Size(), 0);
@@ -22,6 +26,7 @@ std::pair<double, size_t> cut::MinHeap::FindMin() const
 }
 
 size_t cut::MinHeap::Size() const { return m_Nodes.size(); }
+bool cut::MinHeap::Empty() const { return m_Nodes.empty(); }
 
 
 void cut::MinHeap::MoveUp(size_t Element)
@@ -78,14 +83,17 @@ void cut::MinHeap::MoveDown(size_t Element)
 
 double cut::MinHeap::GetKey(size_t Element) const
 {
-    CUTCheckLess(Element, Size());
+    CUTCheckLess(Element, m_Perm.size());
+    CUTAssert(Contains(Element));
 
     return m_Sign * m_Nodes[m_Perm[Element]].first;
 }
 
 void cut::MinHeap::DecreaseKey(size_t Element, double Decrement)
 {
-    CUTCheckLess(Element, Size());
+    __CUTProfileLibrary("MinHeap::DecreaseKey");
+    CUTCheckLess(Element, m_Perm.size());
+    CUTAssert(Contains(Element));
 
     size_t v = m_Perm[Element];
     m_Nodes[v].first -= m_Sign * Decrement;
@@ -102,7 +110,8 @@ void cut::MinHeap::DecreaseKey(size_t Element, double Decrement)
 
 void cut::MinHeap::IncreaseKey(size_t Element, double Increment)
 {
-    CUTCheckLess(Element, Size());
+    CUTCheckLess(Element, m_Perm.size());
+    CUTAssert(Contains(Element));
 
     size_t v = m_Perm[Element];
     m_Nodes[v].first += m_Sign * Increment;
@@ -119,33 +128,152 @@ void cut::MinHeap::IncreaseKey(size_t Element, double Increment)
 
 void cut::MinHeap::SetKey(size_t Element, double NewKey)
 {
-    CUTCheckLess(Element, Size());
+    __CUTProfileLibrary("MinHeap::SetKey");
+    CUTCheckLess(Element, m_Perm.size());
+    CUTAssert(Contains(Element));
+
+    UpdateKey(Element, m_Sign * NewKey);
+}
 
-    NewKey *= m_Sign;
+void cut::MinHeap::UpdateKey(size_t Element, double StoredKey)
+{
     size_t v = m_Perm[Element];
     // If the operation increases the key, move down
-    if (NewKey > m_Nodes[v].first)
+    if (StoredKey > m_Nodes[v].first)
     {
-        m_Nodes[v].first = NewKey;
+        m_Nodes[v].first = StoredKey;
         MoveDown(Element);
     }
     // If the operation decreases the key, move up
-    else if (NewKey < m_Nodes[v].first)
+    else if (StoredKey < m_Nodes[v].first)
     {
-        m_Nodes[v].first = NewKey;
+        m_Nodes[v].first = StoredKey;
         MoveUp(Element);
     }
     // If key is unchanged, there is no need to modify the heap
 }
 
+void cut::MinHeap::SetKeys(const std::pair<size_t, double>* const Updates, size_t NumUpdates)
+{
+    __CUTProfileLibrary("MinHeap::SetKeys");
+    if (NumUpdates == 0)
+        return;
+    CUTCheckNull(Updates);
+
+    // Check the whole batch once, and count the updates that change a key
+    size_t NumChanged = 0;
+    for (size_t i = 0; i < NumUpdates; ++i)
+    {
+        CUTCheckLess(Updates[i].first, m_Perm.size());
+        CUTAssert(Contains(Updates[i].first));
+        if (m_Sign * Updates[i].second != m_Nodes[m_Perm[Updates[i].first]].first)
+            NumChanged++;
+    }
+    if (NumChanged == 0)
+        return;
+
+    // Each sift costs up to the depth of the tree, rebuilding costs about the size
+    size_t Depth = 1;
+    for (size_t n = Size(); n > 1; n >>= 1)
+        Depth++;
+    if (NumChanged * Depth < Size())
+    {
+        for (size_t i = 0; i < NumUpdates; ++i)
+            UpdateKey(Updates[i].first, m_Sign * Updates[i].second);
+    }
+    else
+    {
+        for (size_t i = 0; i < NumUpdates; ++i)
+            m_Nodes[m_Perm[Updates[i].first]].first = m_Sign * Updates[i].second;
+        Rebuild();
+    }
+}
+
+
+std::pair<double, size_t> cut::MinHeap::ExtractMin()
+{
+    __CUTProfileLibrary("MinHeap::ExtractMin");
+    CUTCheckGreater(Size(), 0);
+
+    std::pair<double, size_t> Min = { m_Sign * m_Nodes[0].first, m_Nodes[0].second };
+    m_Perm[Min.second] = NotInHeap;
+    // Move the last node to the root, and let it sink
+    if (m_Nodes.size() > 1)
+    {
+        m_Nodes[0] = m_Nodes.back();
+        m_Perm[m_Nodes[0].second] = 0;
+        m_Nodes.pop_back();
+        MoveDown(m_Nodes[0].second);
+    }
+    else
+        m_Nodes.pop_back();
+    return Min;
+}
+
+void cut::MinHeap::Push(size_t Element, double Key)
+{
+    __CUTProfileLibrary("MinHeap::Push");
+    if (Element >= m_Perm.size())
+        m_Perm.resize(Element + 1, NotInHeap);
+    CUTAssert(!Contains(Element));
+
+    m_Perm[Element] = m_Nodes.size();
+    m_Nodes.emplace_back(m_Sign * Key, Element);
+    MoveUp(Element);
+}
+
+bool cut::MinHeap::Contains(size_t Element) const
+{
+    return Element < m_Perm.size() && m_Perm[Element] != NotInHeap;
+}
+
+void cut::MinHeap::Clear()
+{
+    // Only the elements in the heap have a valid position
+    for (const std::pair<double, size_t>& Node : m_Nodes)
+        m_Perm[Node.second] = NotInHeap;
+    m_Nodes.clear();
+}
 
-void cut::MinHeap::Insert(double Key)
+void cut::MinHeap::Reserve(size_t NumElements)
 {
-    m_Perm.push_back(m_Nodes.size());
-    m_Nodes.emplace_back(m_Sign * Key, m_Nodes.size());
-    MoveUp(m_Nodes.size() - 1);
+    m_Nodes.reserve(NumElements);
+    if (NumElements > m_Perm.size())
+        m_Perm.resize(NumElements, NotInHeap);
 }
 
+void cut::MinHeap::Heapify(const double* const Keys, size_t NumKeys)
+{
+    __CUTProfileLibrary("MinHeap::Heapify");
+    // Store all the keys at once, element i in position i
+    m_Nodes.resize(NumKeys);
+    m_Perm.resize(NumKeys);
+    for (size_t i = 0; i < NumKeys; ++i)
+    {
+        m_Nodes[i] = { m_Sign * Keys[i], i };
+        m_Perm[i] = i;
+    }
+
+    Rebuild();
+}
+
+void cut::MinHeap::Rebuild()
+{
+    // Floyd's construction: sift down every internal node, from the last
+    // one to the root. Total cost is linear in the number of keys
+    for (size_t v = Size() / 2; v > 0; --v)
+        MoveDown(m_Nodes[v - 1].second);
+}
+
+
+cut::MinHeap::MinHeap(bool IsMaxHeap)
+{
+    // Min-heap store keys with the right sign.
+    // Max-heap store keys with negated sign.
+    m_Sign = 1;
+    if (IsMaxHeap)
+        m_Sign = -1;
+}
 
 cut::MinHeap::MinHeap(const std::vector<double>& Keys,
                       bool IsMaxHeap)
@@ -156,9 +284,7 @@ cut::MinHeap::MinHeap(const std::vector<double>& Keys,
     if (IsMaxHeap)
         m_Sign = -1;
     
-    // Add one by one and update the heap
-    for (double k : Keys)
-        Insert(k);
+    Heapify(Keys.data(), Keys.size());
 }
 
 cut::MinHeap::MinHeap(const double* const Keys,
@@ -173,9 +299,7 @@ cut::MinHeap::MinHeap(const double* const Keys,
     if (IsMaxHeap)
         m_Sign = -1;
     
-    // Add one by one and update the heap
-    for (size_t i = 0; i < NumKeys; ++i)
-        Insert(Keys[i]);
+    Heapify(Keys, NumKeys);
 }
 
 cut::MinHeap::~MinHeap() { }
\ No newline at end of file
@@ -0,0 +1,548 @@
+/**
+ * @file        partition.cpp
+ * 
+ * @brief       Implementation of the partitioners and of the shards.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-12
+ */
+#include <cut/algo/partition.hpp>
+#include <cut/algo/madjlist.hpp>
+#include <cut/algo/reorder.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+
+static_assert(sizeof(cut::BinaryShardHeader) == 64, "The shard header must be 64 bytes long.");
+
+const uint32_t cut::GraphShard::Version;
+
+
+namespace
+{
+    const char ShardMagic[8] = { 'C', 'U', 'T', 'S', 'H', 'R', 'D', '\0' };
+    const uint64_t ShardAlign = 64;
+
+    bool IsNode(int v, int N) { return v >= 0 && v < N; }
+
+    uint64_t AlignUp(uint64_t Pos)
+    {
+        return (Pos + ShardAlign - 1) / ShardAlign * ShardAlign;
+    }
+
+    [[noreturn]] void Fail(const std::string& Msg, const std::string& Filename)
+    {
+        throw cut::AssertionError(Msg + " (" + Filename + ")");
+    }
+
+    uint64_t NodeLoad(const cut::BaseAdjacencyList& G, int v)
+    {
+        return (uint64_t)G.NumAdjacents(v) + 1;
+    }
+
+    // Split the nodes, taken in the given order, in contiguous ranges with the same load
+    void SplitByLoad(const cut::BaseAdjacencyList& G,
+                     const std::vector<int>& Order,
+                     int NParts,
+                     std::vector<int>& Owner)
+    {
+        uint64_t Total = 0;
+        for (int v : Order)
+            Total += NodeLoad(G, v);
+        uint64_t Prefix = 0;
+        for (int v : Order)
+        {
+            Owner[v] = (int)(Prefix * NParts / Total);
+            Prefix += NodeLoad(G, v);
+        }
+    }
+
+    // Move each node to the part of most of its adjacents, while the parts stay
+    // within the capacity. A node only moves if the move strictly improves it
+    void LabelPropagation(const cut::BaseAdjacencyList& G,
+                          int NParts,
+                          int NIterations,
+                          double MaxImbalance,
+                          std::vector<int>& Owner)
+    {
+        int N = G.NumNodes();
+        std::vector<uint64_t> Load(NParts, 0);
+        uint64_t Total = 0;
+        for (int v = 0; v < N; ++v)
+        {
+            Load[Owner[v]] += NodeLoad(G, v);
+            Total += NodeLoad(G, v);
+        }
+        double Capacity = MaxImbalance * Total / NParts;
+
+        std::vector<int> Count(NParts, 0);
+        std::vector<int> Touched;
+        for (int Iter = 0; Iter < NIterations; ++Iter)
+        {
+            size_t NMoves = 0;
+            for (int v = 0; v < N; ++v)
+            {
+                Touched.clear();
+                for (int j : G.Neighbors(v))
+                {
+                    if (!IsNode(j, N))
+                        continue;
+                    if (Count[Owner[j]]++ == 0)
+                        Touched.push_back(Owner[j]);
+                }
+                int Cur = Owner[v];
+                int Best = Cur;
+                uint64_t W = NodeLoad(G, v);
+                for (int q : Touched)
+                {
+                    if (Count[q] > Count[Best] && Load[q] + W <= Capacity)
+                        Best = q;
+                }
+                for (int q : Touched)
+                    Count[q] = 0;
+                if (Best != Cur)
+                {
+                    Load[Cur] -= W;
+                    Load[Best] += W;
+                    Owner[v] = Best;
+                    NMoves++;
+                }
+            }
+            if (NMoves == 0)
+                break;
+        }
+    }
+
+    void WriteArray(std::ofstream& Stream, const std::vector<int>& A)
+    {
+        const char Padding[ShardAlign] = { 0 };
+        uint64_t Bytes = A.size() * sizeof(int);
+        Stream.write(reinterpret_cast<const char*>(A.data()), Bytes);
+        Stream.write(Padding, AlignUp(Bytes) - Bytes);
+    }
+
+    // Validate offsets delimiting NElems elements
+    bool ValidOffsets(const std::vector<int>& Offsets, uint64_t NElems)
+    {
+        if (Offsets.front() != 0 || (uint64_t)Offsets.back() != NElems)
+            return false;
+        for (size_t k = 1; k < Offsets.size(); ++k)
+        {
+            if (Offsets[k] < Offsets[k - 1])
+                return false;
+        }
+        return true;
+    }
+}
+
+
+std::vector<int> cut::ComputePartition(const cut::BaseAdjacencyList& G,
+                                       int NParts,
+                                       cut::PartitionMethod Method,
+                                       int NIterations,
+                                       double MaxImbalance)
+{
+    CUTCheckGreater(NParts, 0);
+
+    int N = G.NumNodes();
+    std::vector<int> Owner(N, 0);
+    if (N == 0)
+        return Owner;
+    if (Method == RANGE_PARTITION)
+    {
+        std::vector<int> Order(N);
+        for (int v = 0; v < N; ++v)
+            Order[v] = v;
+        SplitByLoad(G, Order, NParts, Owner);
+        return Owner;
+    }
+
+    SplitByLoad(G, cut::ComputeOrdering(G, BREADTH_FIRST).NewToOld, NParts, Owner);
+    LabelPropagation(G, NParts, NIterations, MaxImbalance, Owner);
+    return Owner;
+}
+
+size_t cut::EdgeCut(const cut::BaseAdjacencyList& G, const std::vector<int>& Owner)
+{
+    CUTAssert(Owner.size() == (size_t)G.NumNodes());
+
+    int N = G.NumNodes();
+    size_t Cut = 0;
+    for (int v = 0; v < N; ++v)
+    {
+        for (int j : G.Neighbors(v))
+            Cut += IsNode(j, N) && Owner[j] != Owner[v];
+    }
+    return Cut;
+}
+
+
+
+cut::GraphShard::GraphShard()
+    : m_Part(0), m_NParts(0), m_NOwned(0)
+{ }
+
+cut::GraphShard::GraphShard(const std::string& Filename)
+    : m_Part(0), m_NParts(0), m_NOwned(0)
+{
+    std::unique_ptr<cut::MappedAdjacencyList> Map(new cut::MappedAdjacencyList(Filename));
+    const char* Base = Map->MappedData();
+    uint64_t Size = Map->MappedSize();
+
+    // The shard section starts after the adjacents
+    uint64_t Pos = AlignUp((uint64_t)(reinterpret_cast<const char*>(Map->Adjacents() + Map->NumConnections64()) - Base));
+    if (Pos + sizeof(cut::BinaryShardHeader) > Size)
+        Fail("The file does not contain a graph shard.", Filename);
+    cut::BinaryShardHeader Header;
+    std::memcpy(&Header, Base + Pos, sizeof(Header));
+    if (std::memcmp(Header.Magic, ShardMagic, sizeof(ShardMagic)) != 0)
+        Fail("The file does not contain a graph shard.", Filename);
+    if (Header.Version != cut::GraphShard::Version)
+        Fail("Unsupported version of the graph shard format.", Filename);
+    if (Header.NumLocal != (uint64_t)Map->NumNodes() || Header.NumOwned > Header.NumLocal ||
+        Header.Part >= Header.NumParts || Header.NumRecv != Header.NumLocal - Header.NumOwned ||
+        Header.NumParts >= Size || Header.NumSend >= Size)
+        Fail("Inconsistent header of the graph shard.", Filename);
+
+    // The arrays follow the header, each one at an aligned position
+    Pos += sizeof(Header);
+    auto ReadArray = [&](uint64_t NElems, std::vector<int>& A)
+    {
+        if (Pos + NElems * sizeof(int) > Size)
+            Fail("The graph shard is truncated.", Filename);
+        A.resize(NElems);
+        std::memcpy(A.data(), Base + Pos, NElems * sizeof(int));
+        Pos = AlignUp(Pos + NElems * sizeof(int));
+    };
+    ReadArray(Header.NumLocal, m_Global);
+    ReadArray(Header.NumParts + 1, m_SendOffsets);
+    ReadArray(Header.NumSend, m_SendNodes);
+    ReadArray(Header.NumParts + 1, m_RecvOffsets);
+    ReadArray(Header.NumRecv, m_RecvNodes);
+    if (!ValidOffsets(m_SendOffsets, Header.NumSend) || !ValidOffsets(m_RecvOffsets, Header.NumRecv))
+        Fail("Inconsistent halos in the graph shard.", Filename);
+
+    m_Part = Header.Part;
+    m_NParts = Header.NumParts;
+    m_NOwned = Header.NumOwned;
+    m_GhostOwner.assign(Header.NumRecv, -1);
+    for (int p = 0; p < m_NParts; ++p)
+    {
+        for (int k = m_RecvOffsets[p]; k < m_RecvOffsets[p + 1]; ++k)
+        {
+            int l = m_RecvNodes[k];
+            if (l < m_NOwned || (uint64_t)l >= Header.NumLocal || m_GhostOwner[l - m_NOwned] >= 0)
+                Fail("Inconsistent halos in the graph shard.", Filename);
+            m_GhostOwner[l - m_NOwned] = p;
+        }
+    }
+    for (int l : m_SendNodes)
+    {
+        if (l < 0 || l >= m_NOwned)
+            Fail("Inconsistent halos in the graph shard.", Filename);
+    }
+    m_Local = std::move(Map);
+}
+
+cut::GraphShard::GraphShard(cut::GraphShard&& S)
+    : m_Part(S.m_Part), m_NParts(S.m_NParts), m_NOwned(S.m_NOwned),
+      m_Local(std::move(S.m_Local)),
+      m_Global(std::move(S.m_Global)),
+      m_GhostOwner(std::move(S.m_GhostOwner)),
+      m_SendOffsets(std::move(S.m_SendOffsets)),
+      m_SendNodes(std::move(S.m_SendNodes)),
+      m_RecvOffsets(std::move(S.m_RecvOffsets)),
+      m_RecvNodes(std::move(S.m_RecvNodes))
+{
+    S.m_Part = 0;
+    S.m_NParts = 0;
+    S.m_NOwned = 0;
+}
+
+cut::GraphShard& cut::GraphShard::operator=(cut::GraphShard&& S)
+{
+    if (&S == this)
+        return *this;
+    m_Part = S.m_Part;
+    m_NParts = S.m_NParts;
+    m_NOwned = S.m_NOwned;
+    m_Local = std::move(S.m_Local);
+    m_Global = std::move(S.m_Global);
+    m_GhostOwner = std::move(S.m_GhostOwner);
+    m_SendOffsets = std::move(S.m_SendOffsets);
+    m_SendNodes = std::move(S.m_SendNodes);
+    m_RecvOffsets = std::move(S.m_RecvOffsets);
+    m_RecvNodes = std::move(S.m_RecvNodes);
+    S.m_Part = 0;
+    S.m_NParts = 0;
+    S.m_NOwned = 0;
+    return *this;
+}
+
+cut::GraphShard::~GraphShard() { }
+
+
+int cut::GraphShard::Part() const { return m_Part; }
+int cut::GraphShard::NumParts() const { return m_NParts; }
+int cut::GraphShard::NumOwned() const { return m_NOwned; }
+int cut::GraphShard::NumGhosts() const { return m_Global.size() - m_NOwned; }
+int cut::GraphShard::NumLocal() const { return m_Global.size(); }
+
+const cut::BaseAdjacencyList& cut::GraphShard::Local() const
+{
+    // A moved shard has no rows
+    static const cut::CompatAdjacencyList Empty((std::vector<std::pair<int, int>>()));
+    if (m_Local == nullptr)
+        return Empty;
+    return *m_Local;
+}
+
+int cut::GraphShard::ToGlobal(int l) const
+{
+    CUTCheckGEQ(l, 0);
+    CUTCheckLess(l, NumLocal());
+
+    return m_Global[l];
+}
+
+int cut::GraphShard::ToLocal(int g) const
+{
+    std::vector<int>::const_iterator OwnedEnd = m_Global.begin() + m_NOwned;
+    std::vector<int>::const_iterator It = std::lower_bound(m_Global.begin(), OwnedEnd, g);
+    if (It != OwnedEnd && *It == g)
+        return It - m_Global.begin();
+    It = std::lower_bound(OwnedEnd, m_Global.end(), g);
+    if (It != m_Global.end() && *It == g)
+        return It - m_Global.begin();
+    return -1;
+}
+
+bool cut::GraphShard::IsGhost(int l) const
+{
+    return l >= m_NOwned && l < NumLocal();
+}
+
+int cut::GraphShard::GhostOwner(int l) const
+{
+    CUTCheckGEQ(l, m_NOwned);
+    CUTCheckLess(l, NumLocal());
+
+    return m_GhostOwner[l - m_NOwned];
+}
+
+cut::Span<int> cut::GraphShard::SendList(int p) const
+{
+    CUTCheckGEQ(p, 0);
+    CUTCheckLess(p, m_NParts);
+
+    return cut::Span<int>(m_SendNodes.data() + m_SendOffsets[p], m_SendOffsets[p + 1] - m_SendOffsets[p]);
+}
+
+cut::Span<int> cut::GraphShard::RecvList(int p) const
+{
+    CUTCheckGEQ(p, 0);
+    CUTCheckLess(p, m_NParts);
+
+    return cut::Span<int>(m_RecvNodes.data() + m_RecvOffsets[p], m_RecvOffsets[p + 1] - m_RecvOffsets[p]);
+}
+
+void cut::GraphShard::Save(const std::string& Filename) const
+{
+    cut::MappedAdjacencyList::Save(Local(), Filename);
+
+    // Append the shard section after the adjacents
+    uint64_t Size;
+    {
+        std::ifstream In(Filename, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!In.is_open())
+            Fail("Cannot open the file for writing the graph shard.", Filename);
+        Size = (uint64_t)In.tellg();
+    }
+    std::ofstream Stream(Filename, std::ios::out | std::ios::binary | std::ios::app);
+    if (!Stream.is_open())
+        Fail("Cannot open the file for writing the graph shard.", Filename);
+
+    cut::BinaryShardHeader Header;
+    std::memset(&Header, 0, sizeof(Header));
+    std::memcpy(Header.Magic, ShardMagic, sizeof(ShardMagic));
+    Header.Version = cut::GraphShard::Version;
+    Header.Part = m_Part;
+    Header.NumParts = m_NParts;
+    Header.NumOwned = m_NOwned;
+    Header.NumLocal = m_Global.size();
+    Header.NumSend = m_SendNodes.size();
+    Header.NumRecv = m_RecvNodes.size();
+
+    const char Padding[ShardAlign] = { 0 };
+    Stream.write(Padding, AlignUp(Size) - Size);
+    Stream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    WriteArray(Stream, m_Global);
+    WriteArray(Stream, m_SendOffsets);
+    WriteArray(Stream, m_SendNodes);
+    WriteArray(Stream, m_RecvOffsets);
+    WriteArray(Stream, m_RecvNodes);
+
+    Stream.close();
+    if (Stream.fail())
+        Fail("Cannot write the graph shard.", Filename);
+}
+
+
+
+cut::PartitionedGraph::PartitionedGraph(const cut::BaseAdjacencyList& G,
+                                        const std::vector<int>& Owner,
+                                        int NParts)
+    : m_Owner(Owner)
+{
+    CUTCheckGreater(NParts, 0);
+    // Never compiled out, the owners index the arrays of the parts
+    if (Owner.size() != (size_t)G.NumNodes())
+        throw cut::AssertionError("The owners do not match the nodes of the graph.");
+    for (int p : Owner)
+    {
+        if (p < 0 || p >= NParts)
+            throw cut::OutOfBoundError("Owner " + std::to_string(p) + " is not a part in [0, " + std::to_string(NParts) + ").");
+    }
+
+    // The nodes of each part in increasing order, and their local indices
+    int N = G.NumNodes();
+    std::vector<int> PartIdx(NParts + 1, 0);
+    for (int p : Owner)
+        PartIdx[p + 1]++;
+    for (int p = 0; p < NParts; ++p)
+        PartIdx[p + 1] += PartIdx[p];
+    std::vector<int> PartNodes(N);
+    std::vector<int> LocalOf(N);
+    std::vector<int> Next(PartIdx.begin(), PartIdx.end() - 1);
+    for (int v = 0; v < N; ++v)
+    {
+        LocalOf[v] = Next[Owner[v]] - PartIdx[Owner[v]];
+        PartNodes[Next[Owner[v]]++] = v;
+    }
+
+    m_Shards.reserve(NParts);
+    for (int p = 0; p < NParts; ++p)
+        m_Shards.push_back(cut::GraphShard());
+
+    // Owned nodes, ghosts, local rows and receive lists of each shard
+    cut::ParallelFor(0, NParts, [&](size_t b, size_t e)
+    {
+        for (size_t p = b; p < e; ++p)
+        {
+            cut::GraphShard& S = m_Shards[p];
+            const int* Owned = PartNodes.data() + PartIdx[p];
+            int NOwned = PartIdx[p + 1] - PartIdx[p];
+            std::vector<int> Ghosts;
+            for (int k = 0; k < NOwned; ++k)
+            {
+                for (int j : G.Neighbors(Owned[k]))
+                {
+                    if (IsNode(j, N) && Owner[j] != (int)p)
+                        Ghosts.push_back(j);
+                }
+            }
+            std::sort(Ghosts.begin(), Ghosts.end());
+            Ghosts.erase(std::unique(Ghosts.begin(), Ghosts.end()), Ghosts.end());
+            int NGhosts = Ghosts.size();
+
+            S.m_Part = p;
+            S.m_NParts = NParts;
+            S.m_NOwned = NOwned;
+            S.m_Global.assign(Owned, Owned + NOwned);
+            S.m_Global.insert(S.m_Global.end(), Ghosts.begin(), Ghosts.end());
+
+            // The rows of the ghosts are empty
+            cut::CompatAdjacencyList::ArrayType Idx(NOwned + NGhosts + 1, 0);
+            cut::CompatAdjacencyList::ArrayType Adj;
+            for (int k = 0; k < NOwned; ++k)
+            {
+                for (int j : G.Neighbors(Owned[k]))
+                {
+                    if (!IsNode(j, N))
+                        continue;
+                    if (Owner[j] == (int)p)
+                        Adj.push_back(LocalOf[j]);
+                    else
+                        Adj.push_back(NOwned + (std::lower_bound(Ghosts.begin(), Ghosts.end(), j) - Ghosts.begin()));
+                }
+                Idx[k + 1] = Adj.size();
+            }
+            std::fill(Idx.begin() + NOwned + 1, Idx.end(), (int)Adj.size());
+            S.m_Local.reset(new cut::CompatAdjacencyList(std::move(Idx), std::move(Adj)));
+
+            // The ghosts grouped by owner, in increasing global order
+            S.m_GhostOwner.resize(NGhosts);
+            S.m_RecvOffsets.assign(NParts + 1, 0);
+            for (int g = 0; g < NGhosts; ++g)
+            {
+                S.m_GhostOwner[g] = Owner[Ghosts[g]];
+                S.m_RecvOffsets[S.m_GhostOwner[g] + 1]++;
+            }
+            for (int q = 0; q < NParts; ++q)
+                S.m_RecvOffsets[q + 1] += S.m_RecvOffsets[q];
+            S.m_RecvNodes.resize(NGhosts);
+            std::vector<int> RecvNext(S.m_RecvOffsets.begin(), S.m_RecvOffsets.end() - 1);
+            for (int g = 0; g < NGhosts; ++g)
+                S.m_RecvNodes[RecvNext[S.m_GhostOwner[g]]++] = NOwned + g;
+        }
+    }, -1, 1);
+
+    // The send list of p to q matches the receive list of q from p
+    cut::ParallelFor(0, NParts, [&](size_t b, size_t e)
+    {
+        for (size_t p = b; p < e; ++p)
+        {
+            cut::GraphShard& S = m_Shards[p];
+            S.m_SendOffsets.assign(NParts + 1, 0);
+            for (int q = 0; q < NParts; ++q)
+            {
+                const cut::GraphShard& R = m_Shards[q];
+                for (int k = R.m_RecvOffsets[p]; k < R.m_RecvOffsets[p + 1]; ++k)
+                    S.m_SendNodes.push_back(LocalOf[R.m_Global[R.m_RecvNodes[k]]]);
+                S.m_SendOffsets[q + 1] = S.m_SendNodes.size();
+            }
+        }
+    }, -1, 1);
+}
+
+cut::PartitionedGraph::PartitionedGraph(const cut::BaseAdjacencyList& G,
+                                        int NParts,
+                                        cut::PartitionMethod Method)
+    : cut::PartitionedGraph(G, cut::ComputePartition(G, NParts, Method), NParts)
+{ }
+
+int cut::PartitionedGraph::NumParts() const { return m_Shards.size(); }
+int cut::PartitionedGraph::NumNodes() const { return m_Owner.size(); }
+
+int cut::PartitionedGraph::Owner(int g) const
+{
+    CUTCheckGEQ(g, 0);
+    CUTCheckLess(g, NumNodes());
+
+    return m_Owner[g];
+}
+
+const cut::GraphShard& cut::PartitionedGraph::Shard(int p) const
+{
+    CUTCheckGEQ(p, 0);
+    CUTCheckLess(p, NumParts());
+
+    return m_Shards[p];
+}
+
+void cut::PartitionedGraph::Save(const std::string& Prefix) const
+{
+    for (int p = 0; p < NumParts(); ++p)
+        m_Shards[p].Save(ShardFilename(Prefix, p));
+}
+
+std::string cut::PartitionedGraph::ShardFilename(const std::string& Prefix, int p)
+{
+    return Prefix + "." + std::to_string(p) + ".shard";
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+/**
+ * @file        reorder.cpp
+ * 
+ * @brief       Implementation of the node reorderings.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-01
+ */
+#include <cut/algo/reorder.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <algorithm>
+#include <typeinfo>
+
+
+namespace
+{
+    // Maximum number of restarts in the search of a pseudo-peripheral node
+    const int MaxPeripheralIters = 8;
+
+    bool IsNode(int v, int N) { return v >= 0 && v < N; }
+
+    // Breadth-first visit of the component of Root, marking the nodes with Stamp.
+    // Queue receives the visit, Depth the eccentricity of Root, and the returned
+    // value is the position in Queue where the last level starts
+    size_t LevelBFS(const cut::BaseAdjacencyList& G,
+                    int Root,
+                    std::vector<int>& Mark,
+                    int Stamp,
+                    std::vector<int>& Queue,
+                    int& Depth)
+    {
+        int N = G.NumNodes();
+        Queue.assign(1, Root);
+        Mark[Root] = Stamp;
+        Depth = 0;
+        size_t Begin = 0;
+        size_t LastLevel = 0;
+        while (Begin < Queue.size())
+        {
+            size_t End = Queue.size();
+            LastLevel = Begin;
+            for (size_t k = Begin; k < End; ++k)
+            {
+                for (int v : G.Neighbors(Queue[k]))
+                {
+                    if (IsNode(v, N) && Mark[v] != Stamp)
+                    {
+                        Mark[v] = Stamp;
+                        Queue.push_back(v);
+                    }
+                }
+            }
+            if (Queue.size() > End)
+                Depth++;
+            Begin = End;
+        }
+        return LastLevel;
+    }
+
+    // George-Liu search of a pseudo-peripheral node in the component of Root:
+    // restart from the smallest degree node of the last level as long as the
+    // eccentricity grows
+    int PseudoPeripheral(const cut::BaseAdjacencyList& G,
+                         int Root,
+                         const std::vector<int>& Deg,
+                         std::vector<int>& Mark,
+                         int& Stamp,
+                         std::vector<int>& Queue)
+    {
+        int Depth;
+        size_t Last = LevelBFS(G, Root, Mark, ++Stamp, Queue, Depth);
+        for (int Iter = 0; Iter < MaxPeripheralIters; ++Iter)
+        {
+            int Cand = Queue[Last];
+            for (size_t k = Last + 1; k < Queue.size(); ++k)
+            {
+                if (Deg[Queue[k]] < Deg[Cand])
+                    Cand = Queue[k];
+            }
+            int NewDepth;
+            size_t NewLast = LevelBFS(G, Cand, Mark, ++Stamp, Queue, NewDepth);
+            if (NewDepth <= Depth)
+                break;
+            Root = Cand;
+            Depth = NewDepth;
+            Last = NewLast;
+        }
+        return Root;
+    }
+}
+
+
+cut::NodePermutation cut::ComputeOrdering(const cut::BaseAdjacencyList& G,
+                                          cut::NodeOrdering Order)
+{
+    int N = G.NumNodes();
+    std::vector<int> Deg(N);
+    for (int i = 0; i < N; ++i)
+        Deg[i] = G.NumAdjacents(i);
+
+    cut::NodePermutation P;
+    P.NewToOld.reserve(N);
+    if (Order == cut::DEGREE)
+    {
+        for (int i = 0; i < N; ++i)
+            P.NewToOld.push_back(i);
+        std::stable_sort(P.NewToOld.begin(), P.NewToOld.end(), [&](int a, int b) { return Deg[a] > Deg[b]; });
+    }
+    else
+    {
+        // Visit the components one after the other
+        std::vector<char> Visited(N, 0);
+        std::vector<int> Mark(N, 0);
+        std::vector<int> Queue;
+        std::vector<int> Next;
+        int Stamp = 0;
+        for (int i = 0; i < N; ++i)
+        {
+            if (Visited[i])
+                continue;
+            int Root = i;
+            if (Order == cut::REVERSE_CUTHILL_MCKEE)
+                Root = PseudoPeripheral(G, i, Deg, Mark, Stamp, Queue);
+
+            size_t Head = P.NewToOld.size();
+            P.NewToOld.push_back(Root);
+            Visited[Root] = 1;
+            for (; Head < P.NewToOld.size(); ++Head)
+            {
+                Next.clear();
+                for (int v : G.Neighbors(P.NewToOld[Head]))
+                {
+                    if (IsNode(v, N) && !Visited[v])
+                    {
+                        Visited[v] = 1;
+                        Next.push_back(v);
+                    }
+                }
+                // Cuthill-McKee takes the adjacents by increasing degree
+                if (Order == cut::REVERSE_CUTHILL_MCKEE)
+                    std::stable_sort(Next.begin(), Next.end(), [&](int a, int b) { return Deg[a] < Deg[b]; });
+                P.NewToOld.insert(P.NewToOld.end(), Next.begin(), Next.end());
+            }
+        }
+        if (Order == cut::REVERSE_CUTHILL_MCKEE)
+            std::reverse(P.NewToOld.begin(), P.NewToOld.end());
+    }
+
+    P.OldToNew.resize(N);
+    for (int n = 0; n < N; ++n)
+        P.OldToNew[P.NewToOld[n]] = n;
+    return P;
+}
+
+
+cut::CompatAdjacencyList cut::Permute(const cut::BaseAdjacencyList& G,
+                                      const cut::NodePermutation& P)
+{
+    int N = G.NumNodes();
+    CUTAssert(P.NewToOld.size() == (size_t)N);
+    CUTAssert(P.OldToNew.size() == (size_t)N);
+
+    cut::CompatAdjacencyList::ArrayType Idx(N + 1, 0);
+    for (int n = 0; n < N; ++n)
+        Idx[n + 1] = G.NumAdjacents(P.NewToOld[n]);
+    cut::ParallelPrefixSum(Idx.data(), Idx.size());
+
+    cut::CompatAdjacencyList::ArrayType Adj(Idx[N]);
+    cut::ParallelFor(0, N, [&](size_t b, size_t e)
+    {
+        for (size_t n = b; n < e; ++n)
+        {
+            int* Row = Adj.data() + Idx[n];
+            cut::Span<int> Old = G.Neighbors(P.NewToOld[n]);
+            for (size_t k = 0; k < Old.Size(); ++k)
+                Row[k] = IsNode(Old[k], N) ? P.OldToNew[Old[k]] : Old[k];
+            std::sort(Row, Row + Old.Size());
+        }
+    }, -1, 1024);
+
+    return cut::CompatAdjacencyList(std::move(Idx), std::move(Adj));
+}
+
+
+cut::NodePermutation cut::Reorder(cut::CompatAdjacencyList& G,
+                                  cut::NodeOrdering Order)
+{
+    // A derived list would be assigned a plain copy, silently dropping its own data
+    if (typeid(G) != typeid(cut::CompatAdjacencyList))
+        throw cut::AssertionError("Only a plain cut::CompatAdjacencyList can be reordered in place.");
+    cut::NodePermutation P = cut::ComputeOrdering(G, Order);
+    cut::CompatAdjacencyList R = cut::Permute(G, P);
+    G = std::move(static_cast<cut::BaseAdjacencyList&>(R));
+    return P;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * @file        adjlist.cpp
+ * 
+ * @brief       Benchmarks of the construction and traversal of the adjacency lists.
+ * 
+ * @details     The connections are generated with both ends drawn from a power law,
+ *              whose exponent is controlled by the skew: 0 gives uniform nodes, larger
+ *              values concentrate the connections on the first nodes.\n 
+ *              The size is the number of connections, the nodes are one eighth of them.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-13
+ */
+#include "bench.hpp"
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/csr.hpp>
+#include <memory>
+#include <random>
+#include <cmath>
+
+
+std::vector<std::pair<int, int>> MakeConnections(size_t NNodes, size_t NConns, double Skew, uint32_t Seed)
+{
+    std::mt19937 Gen(Seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    auto Node = [&]() { return std::min((int)(NNodes * std::pow(U(Gen), 1.0 + Skew)), (int)NNodes - 1); };
+    std::vector<std::pair<int, int>> Conns(NConns);
+    for (std::pair<int, int>& c : Conns)
+    {
+        c.first = Node();
+        c.second = Node();
+    }
+    return Conns;
+}
+
+
+int main(int argc, const char* const argv[])
+{
+    bench::Suite Suite("adjlist", 1 << 22, argc, argv);
+    if (Suite.Failed())
+        return -1;
+    const bench::Options& Opts = Suite.Opts();
+    size_t NConns = std::max(Opts.Size, (size_t)8);
+    std::vector<std::pair<int, int>> Conns = MakeConnections(NConns / 8, NConns, Opts.Skew, Opts.Seed);
+
+    // Construction
+    std::unique_ptr<cut::CompatAdjacencyList> CAL;
+    Suite.Run("BuildCSR", NConns, [&]() { CAL.reset(); },
+              [&]() { CAL.reset(new cut::CompatAdjacencyList(Conns)); });
+    Suite.Run("BuildCSRUnsorted", NConns, [&]() { CAL.reset(); },
+              [&]() { CAL.reset(new cut::CompatAdjacencyList(Conns, false)); });
+    std::unique_ptr<cut::AdjacencyList> AL;
+    Suite.Run("BuildAdjacencyList", NConns, [&]() { AL.reset(); },
+              [&]() { AL.reset(new cut::AdjacencyList(Conns)); });
+    std::vector<std::pair<uint32_t, uint32_t>> UConns(Conns.begin(), Conns.end());
+    std::unique_ptr<cut::CSRAdjacencyList<>> CSR;
+    Suite.Run("BuildCSRTyped", NConns, [&]() { CSR.reset(); },
+              [&]() { CSR.reset(new cut::CSRAdjacencyList<>(UConns)); });
+
+    // Traversals of the same rows, summing the adjacents
+    CAL.reset(new cut::CompatAdjacencyList(Conns));
+    AL.reset(new cut::AdjacencyList(*CAL));
+    CSR.reset(new cut::CSRAdjacencyList<>(UConns));
+    const cut::BaseAdjacencyList& Base = *CAL;
+    size_t NItems = CAL->NumConnections();
+    int NNodes = CAL->NumNodes();
+    Suite.Run("TraverseCompat", NItems, [&]()
+    {
+        int64_t Sum = 0;
+        for (int i = 0; i < NNodes; ++i)
+            for (int j : CAL->NeighborsUnchecked(i))
+                Sum += j;
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("TraverseVirtualNeighbors", NItems, [&]()
+    {
+        int64_t Sum = 0;
+        for (int i = 0; i < NNodes; ++i)
+            for (int j : Base.Neighbors(i))
+                Sum += j;
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("TraverseVirtualGetAdjacent", NItems, [&]()
+    {
+        int64_t Sum = 0;
+        for (int i = 0; i < NNodes; ++i)
+        {
+            int NAdj = Base.NumAdjacents(i);
+            for (int k = 0; k < NAdj; ++k)
+                Sum += Base.GetAdjacent(i, k);
+        }
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("TraverseAdjacencyList", NItems, [&]()
+    {
+        int64_t Sum = 0;
+        for (int i = 0; i < NNodes; ++i)
+            for (int j : AL->NeighborsUnchecked(i))
+                Sum += j;
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("TraverseCSRTyped", NItems, [&]()
+    {
+        int64_t Sum = 0;
+        for (size_t i = 0; i < CSR->NodeCount(); ++i)
+            for (uint32_t j : CSR->RowUnchecked((uint32_t)i))
+                Sum += j;
+        bench::DoNotOptimize(Sum);
+    });
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+/**
+ * @file        bench.hpp
+ * 
+ * @brief       A minimal harness for the benchmarks.
+ * 
+ * @details     This file contains the harness shared by the benchmark applications.
+ *              Each benchmark case is run once to warm up and then a given number
+ *              of times, and the harness prints the minimum, median and mean times,
+ *              one record per case, as CSV or JSON.\n 
+ *              The options are read from the command line:
+ *              - <code>--size=N</code> the size of the problem, whose meaning depends on the case;
+ *              - <code>--skew=S</code> the skew of the generated data, 0 for uniform;
+ *              - <code>--reps=R</code> the number of measured runs of each case;
+ *              - <code>--threads=T</code> the number of threads of the library;
+ *              - <code>--seed=S</code> the seed of the generated data;
+ *              - <code>--filter=F</code> only runs the cases whose name contains <code>F</code>;
+ *              - <code>--format=csv|json</code> the format of the output;
+ *              - <code>--output=File</code> writes the output to the given file instead of
+ *                the standard output.
+ * 
+ *              The generated data only depends on the options, so the records of two
+ *              versions of the library run with the same options can be compared line
+ *              by line.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-13
+ */
+#pragma once
+
+#include <cut/parallel/parallel.hpp>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+
+namespace bench
+{
+
+/**
+ * @brief       Prevent the compiler from discarding a value.
+ * 
+ * @details     This function makes the compiler assume that the given value is
+ *              read, so that the computation producing it is not eliminated.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& Value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&Value) : "memory");
+#else
+    static volatile const void* Sink;
+    Sink = &Value;
+#endif
+}
+
+
+/**
+ * @brief       The options of a benchmark run.
+ */
+struct Options
+{
+    size_t Size;
+    double Skew;
+    int Reps;
+    int Threads;
+    uint32_t Seed;
+    std::string Filter;
+    std::string Format;
+    std::string Output;
+
+    Options(size_t DefaultSize)
+        : Size(DefaultSize), Skew(0.0), Reps(5), Threads(1), Seed(0), Filter(), Format("csv"), Output()
+    { }
+};
+
+
+/**
+ * @brief       A suite of benchmark cases.
+ * 
+ * @details     The class bench::Suite parses the options, runs the cases and prints their
+ *              records. The header of the output is printed on construction and the footer
+ *              on destruction.
+ */
+class Suite
+{
+private:
+    std::string m_Name;
+    bench::Options m_Opts;
+    size_t m_NRecords;
+    bool m_Failed;
+    std::ofstream m_File;
+    std::ostream* m_Out;
+
+    static bool Match(const std::string& Arg, const std::string& Key, std::string& Value)
+    {
+        std::string Prefix = "--" + Key + "=";
+        if (Arg.compare(0, Prefix.size(), Prefix) != 0)
+            return false;
+        Value = Arg.substr(Prefix.size());
+        return true;
+    }
+
+public:
+    Suite(const std::string& Name, size_t DefaultSize, int argc, const char* const argv[])
+        : m_Name(Name), m_Opts(DefaultSize), m_NRecords(0), m_Failed(false), m_Out(&std::cout)
+    {
+        for (int a = 1; a < argc; ++a)
+        {
+            std::string Arg = argv[a];
+            std::string Value;
+            if (Match(Arg, "size", Value))
+                m_Opts.Size = std::strtoull(Value.c_str(), nullptr, 10);
+            else if (Match(Arg, "skew", Value))
+                m_Opts.Skew = std::strtod(Value.c_str(), nullptr);
+            else if (Match(Arg, "reps", Value))
+                m_Opts.Reps = std::max(1, std::atoi(Value.c_str()));
+            else if (Match(Arg, "threads", Value))
+                m_Opts.Threads = std::max(1, std::atoi(Value.c_str()));
+            else if (Match(Arg, "seed", Value))
+                m_Opts.Seed = (uint32_t)std::strtoul(Value.c_str(), nullptr, 10);
+            else if (Match(Arg, "filter", Value))
+                m_Opts.Filter = Value;
+            else if (Match(Arg, "format", Value) && (Value == "csv" || Value == "json"))
+                m_Opts.Format = Value;
+            else if (Match(Arg, "output", Value))
+                m_Opts.Output = Value;
+            else
+            {
+                std::cerr << "Unknown option " << Arg << std::endl;
+                m_Failed = true;
+            }
+        }
+        cut::SetNumThreads(m_Opts.Threads);
+        if (!m_Opts.Output.empty())
+        {
+            m_File.open(m_Opts.Output);
+            if (!m_File.is_open())
+            {
+                std::cerr << "Cannot open " << m_Opts.Output << std::endl;
+                m_Failed = true;
+            }
+            m_Out = &m_File;
+        }
+
+        if (m_Opts.Format == "csv")
+            *m_Out << "suite,case,size,skew,threads,reps,items,min_ns,median_ns,mean_ns,ns_per_item" << std::endl;
+        else
+            *m_Out << "[" << std::endl;
+    }
+
+    ~Suite()
+    {
+        if (m_Opts.Format == "json")
+            *m_Out << std::endl << "]" << std::endl;
+        cut::SetNumThreads(1);
+    }
+
+    Suite(const bench::Suite&) = delete;
+    bench::Suite& operator=(const bench::Suite&) = delete;
+
+    const bench::Options& Opts() const { return m_Opts; }
+
+    /**
+     * @brief       Whether or not the command line was invalid.
+     */
+    bool Failed() const { return m_Failed; }
+
+    /**
+     * @brief       Change the number of threads of the next cases.
+     * 
+     * @details     This method sets the number of threads of the library and the one
+     *              reported by the next records, to measure how a case scales.
+     */
+    void SetThreads(int Threads)
+    {
+        m_Opts.Threads = std::max(1, Threads);
+        cut::SetNumThreads(m_Opts.Threads);
+    }
+
+    /**
+     * @brief       Run a benchmark case.
+     * 
+     * @details     This method calls <code>Setup()</code> and then measures <code>Body()</code>,
+     *              once to warm up and then <code>Reps</code> times, and prints the record
+     *              of the case. The setup is not measured, and runs before every call of the body.
+     * 
+     * @param Case The name of the case.
+     * @param Items The number of items processed by each call of the body.
+     * @param Setup The preparation of a run.
+     * @param Body The measured code.
+     */
+    template<typename SetupT, typename BodyT>
+    void Run(const std::string& Case, size_t Items, SetupT&& Setup, BodyT&& Body)
+    {
+        if (!m_Opts.Filter.empty() && Case.find(m_Opts.Filter) == std::string::npos)
+            return;
+
+        std::vector<double> Times;
+        for (int r = -1; r < m_Opts.Reps; ++r)
+        {
+            Setup();
+            std::chrono::steady_clock::time_point Begin = std::chrono::steady_clock::now();
+            Body();
+            std::chrono::steady_clock::time_point End = std::chrono::steady_clock::now();
+            if (r >= 0)
+                Times.push_back(std::chrono::duration<double, std::nano>(End - Begin).count());
+        }
+        std::sort(Times.begin(), Times.end());
+        double Min = Times.front();
+        double Median = Times.size() % 2 == 1 ? Times[Times.size() / 2]
+                                              : (Times[Times.size() / 2 - 1] + Times[Times.size() / 2]) / 2;
+        double Mean = 0;
+        for (double t : Times)
+            Mean += t;
+        Mean /= Times.size();
+        double PerItem = Median / std::max(Items, (size_t)1);
+
+        if (m_Opts.Format == "csv")
+        {
+            *m_Out << m_Name << ',' << Case << ',' << m_Opts.Size << ',' << m_Opts.Skew << ','
+                   << m_Opts.Threads << ',' << m_Opts.Reps << ',' << Items << ','
+                   << (uint64_t)Min << ',' << (uint64_t)Median << ',' << (uint64_t)Mean << ','
+                   << PerItem << std::endl;
+        }
+        else
+        {
+            *m_Out << (m_NRecords > 0 ? ",\n" : "")
+                   << "  {\"suite\": \"" << m_Name << "\", \"case\": \"" << Case << "\", "
+                   << "\"size\": " << m_Opts.Size << ", \"skew\": " << m_Opts.Skew << ", "
+                   << "\"threads\": " << m_Opts.Threads << ", \"reps\": " << m_Opts.Reps << ", "
+                   << "\"items\": " << Items << ", "
+                   << "\"min_ns\": " << (uint64_t)Min << ", \"median_ns\": " << (uint64_t)Median << ", "
+                   << "\"mean_ns\": " << (uint64_t)Mean << ", \"ns_per_item\": " << PerItem << "}";
+        }
+        m_NRecords++;
+    }
+
+    /**
+     * @brief       Run a benchmark case without setup.
+     */
+    template<typename BodyT>
+    void Run(const std::string& Case, size_t Items, BodyT&& Body)
+    {
+        Run(Case, Items, []() { }, std::forward<BodyT>(Body));
+    }
+};
+
+} // namespace bench
\ No newline at end of file
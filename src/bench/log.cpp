@@ -0,0 +1,81 @@
+/**
+ * @file        log.cpp
+ * 
+ * @brief       Benchmarks of cut::Logger.
+ * 
+ * @details     The size is the number of lines written by each case, into a file in
+ *              the working directory that is removed at the end. The asynchronous
+ *              cases include the final flush of the pending lines.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-13
+ */
+#include "bench.hpp"
+#include <cut/log.hpp>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+
+int main(int argc, const char* const argv[])
+{
+    bench::Suite Suite("log", 1 << 17, argc, argv);
+    if (Suite.Failed())
+        return -1;
+    const bench::Options& Opts = Suite.Opts();
+    size_t N = Opts.Size;
+    const std::string LogFile = "bench.log";
+    const std::string Line = "A benchmark line of a typical length, with a number: 123456.";
+
+    std::unique_ptr<cut::Logger> Log;
+    auto Open = [&](bool Timestamps)
+    {
+        Log.reset();
+        Log.reset(new cut::Logger(LogFile, cut::LogType::ALL, Timestamps));
+    };
+    Suite.Run("Sync", N, [&]() { Open(true); }, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+            Log->Message(Line);
+        Log->Flush();
+    });
+    Suite.Run("SyncNoTimestamp", N, [&]() { Open(false); }, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+            Log->Message(Line);
+        Log->Flush();
+    });
+    Suite.Run("Async", N, [&]() { Open(true); Log->StartAsync(); }, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+            Log->Message(Line);
+        Log->Flush();
+    });
+    Suite.Run("AsyncFourThreads", N, [&]() { Open(true); Log->StartAsync(); }, [&]()
+    {
+        std::vector<std::thread> Threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            Threads.emplace_back([&, t]()
+            {
+                for (size_t k = t; k < N; k += 4)
+                    Log->Message(Line);
+            });
+        }
+        for (std::thread& th : Threads)
+            th.join();
+        Log->Flush();
+    });
+    Suite.Run("Masked", N, [&]() { Open(true); Log->Enable(cut::LogType::NONE); }, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+            Log->Message(Line);
+    });
+
+    Log.reset();
+    std::remove(LogFile.c_str());
+    return 0;
+}
\ No newline at end of file
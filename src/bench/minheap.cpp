@@ -0,0 +1,80 @@
+/**
+ * @file        minheap.cpp
+ * 
+ * @brief       Benchmarks of cut::MinHeap.
+ * 
+ * @details     The size is the number of keys in the heap. The keys are uniform, and
+ *              the skew is ignored.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-13
+ */
+#include "bench.hpp"
+#include <cut/algo/minheap.hpp>
+#include <memory>
+#include <random>
+
+
+int main(int argc, const char* const argv[])
+{
+    bench::Suite Suite("minheap", 1 << 20, argc, argv);
+    if (Suite.Failed())
+        return -1;
+    const bench::Options& Opts = Suite.Opts();
+    size_t N = std::max(Opts.Size, (size_t)1);
+
+    std::mt19937 Gen(Opts.Seed);
+    std::uniform_real_distribution<double> Key(0.0, 1.0);
+    std::uniform_int_distribution<size_t> Element(0, N - 1);
+    std::vector<double> Keys(N);
+    for (double& k : Keys)
+        k = Key(Gen);
+    std::vector<size_t> Decreased(N);
+    std::vector<double> Decrements(N);
+    for (size_t k = 0; k < N; ++k)
+    {
+        Decreased[k] = Element(Gen);
+        Decrements[k] = Key(Gen);
+    }
+
+    std::unique_ptr<cut::MinHeap> Heap;
+    Suite.Run("Build", N, [&]() { Heap.reset(); },
+              [&]() { Heap.reset(new cut::MinHeap(Keys)); });
+    Suite.Run("Push", N, [&]() { Heap.reset(new cut::MinHeap()); Heap->Reserve(N); }, [&]()
+    {
+        for (size_t e = 0; e < N; ++e)
+            Heap->Push(e, Keys[e]);
+    });
+    Suite.Run("DecreaseKey", N, [&]() { Heap.reset(new cut::MinHeap(Keys)); }, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+            Heap->DecreaseKey(Decreased[k], Decrements[k]);
+    });
+    // Batched updates of few and many keys, against the same updates one at a time
+    for (size_t K : { std::max(N / 64, (size_t)1), std::max(N / 2, (size_t)1) })
+    {
+        std::vector<std::pair<size_t, double>> Updates(K);
+        for (size_t k = 0; k < K; ++k)
+            Updates[k] = { Decreased[k], Keys[Decreased[k]] - Decrements[k] };
+        std::string Suffix = K < N / 2 ? "Few" : "Many";
+        Suite.Run("SetKey" + Suffix, K, [&]() { Heap.reset(new cut::MinHeap(Keys)); }, [&]()
+        {
+            for (const std::pair<size_t, double>& u : Updates)
+                Heap->SetKey(u.first, u.second);
+        });
+        Suite.Run("SetKeys" + Suffix, K, [&]() { Heap.reset(new cut::MinHeap(Keys)); },
+                  [&]() { Heap->SetKeys(Updates.data(), Updates.size()); });
+    }
+    Suite.Run("ExtractMin", N, [&]() { Heap.reset(new cut::MinHeap(Keys)); }, [&]()
+    {
+        double Sum = 0;
+        while (!Heap->Empty())
+            Sum += Heap->ExtractMin().first;
+        bench::DoNotOptimize(Sum);
+    });
+
+    return 0;
+}
\ No newline at end of file
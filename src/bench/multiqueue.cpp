@@ -0,0 +1,117 @@
+/**
+ * @file        multiqueue.cpp
+ * 
+ * @brief       Benchmarks of cut::MultiQueue and of the parallel shortest paths.
+ * 
+ * @details     The size is the number of entries pushed to the queues, and the number
+ *              of connections of the random graph of the shortest paths, which has one
+ *              node every 8 connections and integer weights from 1 to 100. The skew is
+ *              ignored.\n 
+ *              Each case runs with 1, 2, 4, ... threads, up to <code>--threads</code>,
+ *              or up to all the hardware threads if <code>--threads</code> is 1, so that
+ *              the records show how the cases scale.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-14
+ */
+#include "bench.hpp"
+#include <cut/parallel/multiqueue.hpp>
+#include <cut/algo/minheap.hpp>
+#include <cut/algo/wadjlist.hpp>
+#include <cut/algo/graph.hpp>
+#include <mutex>
+#include <random>
+#include <thread>
+
+
+int main(int argc, const char* const argv[])
+{
+    bench::Suite Suite("multiqueue", 1 << 20, argc, argv);
+    if (Suite.Failed())
+        return -1;
+    const bench::Options& Opts = Suite.Opts();
+    size_t N = std::max(Opts.Size, (size_t)8);
+    int MaxThreads = Opts.Threads > 1 ? Opts.Threads : std::max((int)std::thread::hardware_concurrency(), 1);
+
+    std::mt19937 Gen(Opts.Seed);
+    std::vector<double> Keys(N);
+    std::uniform_real_distribution<double> Key(0.0, 1.0);
+    for (double& k : Keys)
+        k = Key(Gen);
+
+    // Random graph, with a ring through all the nodes so that every node is reached
+    int NNodes = (int)(N / 8);
+    std::uniform_int_distribution<int> Node(0, NNodes - 1);
+    std::uniform_int_distribution<int> Weight(1, 100);
+    std::vector<std::pair<int, int>> Conns;
+    std::vector<double> Weights;
+    for (int i = 0; i < NNodes; ++i)
+    {
+        Conns.emplace_back(i, (i + 1) % NNodes);
+        Weights.push_back(Weight(Gen));
+    }
+    while (Conns.size() < N)
+    {
+        Conns.emplace_back(Node(Gen), Node(Gen));
+        Weights.push_back(Weight(Gen));
+    }
+    cut::WeightedAdjacencyList<double> G(Conns, Weights);
+    cut::GraphSearch GS;
+    std::vector<double> Dist;
+
+    for (int T = 1; T <= MaxThreads; T = T < MaxThreads ? std::min(2 * T, MaxThreads) : T + 1)
+    {
+        Suite.SetThreads(T);
+
+        // Each thread pushes its share of the entries and then empties the queue
+        std::unique_ptr<cut::MultiQueue> MQ;
+        Suite.Run("MultiQueuePushExtract", N, [&]() { MQ.reset(new cut::MultiQueue(T)); }, [&]()
+        {
+            cut::ParallelFor(0, N, [&](size_t b, size_t e)
+            {
+                for (size_t i = b; i < e; ++i)
+                    MQ->Push(i, Keys[i]);
+                std::pair<double, size_t> Min;
+                double Sum = 0;
+                while (MQ->TryExtractApproxMin(Min))
+                    Sum += Min.first;
+                bench::DoNotOptimize(Sum);
+            }, T);
+        });
+
+        // The same pattern on a single heap behind one lock
+        std::unique_ptr<cut::MinHeap> Heap;
+        std::mutex HeapLock;
+        Suite.Run("LockedMinHeapPushExtract", N, [&]() { Heap.reset(new cut::MinHeap()); Heap->Reserve(N); }, [&]()
+        {
+            cut::ParallelFor(0, N, [&](size_t b, size_t e)
+            {
+                for (size_t i = b; i < e; ++i)
+                {
+                    std::lock_guard<std::mutex> Lock(HeapLock);
+                    Heap->Push(i, Keys[i]);
+                }
+                double Sum = 0;
+                while (true)
+                {
+                    std::lock_guard<std::mutex> Lock(HeapLock);
+                    if (Heap->Empty())
+                        break;
+                    Sum += Heap->ExtractMin().first;
+                }
+                bench::DoNotOptimize(Sum);
+            }, T);
+        });
+
+        // Shortest paths, with the sequential Dijkstra's algorithm as the baseline
+        if (T == 1)
+            Suite.Run("Dijkstra", G.NumConnections(), [&]() { GS.Dijkstra(G, 0, G.EdgeWeights(), Dist); });
+        Suite.Run("DeltaStepping", G.NumConnections(), [&]() { GS.DeltaStepping(G, 0, G.EdgeWeights(), 50.0, Dist); });
+        Suite.Run("ParallelDijkstra", G.NumConnections(), [&]() { GS.ParallelDijkstra(G, 0, G.EdgeWeights(), Dist); });
+    }
+
+    return 0;
+}
\ No newline at end of file
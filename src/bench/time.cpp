@@ -0,0 +1,67 @@
+/**
+ * @file        time.cpp
+ * 
+ * @brief       Benchmarks of the overhead of the timers and of the profiler.
+ * 
+ * @details     The size is the number of operations of each case. The skew is ignored.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-13
+ */
+#include "bench.hpp"
+#include <cut/time/timer.hpp>
+#include <cut/time/profiler.hpp>
+
+
+int main(int argc, const char* const argv[])
+{
+    bench::Suite Suite("time", 1 << 20, argc, argv);
+    if (Suite.Failed())
+        return -1;
+    const bench::Options& Opts = Suite.Opts();
+    size_t N = Opts.Size;
+
+    cut::Timer T;
+    Suite.Run("Timer::GetTime", N, [&]()
+    {
+        double Sum = 0;
+        for (size_t k = 0; k < N; ++k)
+            Sum += T.GetTime();
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("Timer::GetCPUTime", N, [&]()
+    {
+        double Sum = 0;
+        for (size_t k = 0; k < N; ++k)
+            Sum += T.GetCPUTime();
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("Timer::StartPause", N, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+        {
+            T.Start();
+            T.Pause();
+        }
+        bench::DoNotOptimize(T);
+    });
+    Suite.Run("ProfileClock::Now", N, [&]()
+    {
+        uint64_t Sum = 0;
+        for (size_t k = 0; k < N; ++k)
+            Sum += cut::ProfileClock::Now();
+        bench::DoNotOptimize(Sum);
+    });
+    Suite.Run("CUTProfileScope", N, [&]()
+    {
+        for (size_t k = 0; k < N; ++k)
+        {
+            CUTProfileScope("bench");
+        }
+    });
+
+    return 0;
+}
\ No newline at end of file
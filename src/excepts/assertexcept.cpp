@@ -10,28 +10,23 @@
  * @date        2023-10-09
  */
 #include <cut/excepts/assertexcept.hpp>
-#include <sstream>
 
 
 cut::AssertionError::AssertionError(const std::string& Msg)
-    : m_Msg(Msg), std::runtime_error("")
+    : cut::CheckException("Assertion failed", Msg)
 { }
 
 cut::AssertionError::AssertionError(const std::string& Code,
                                     const std::string& File,
                                     int Line)
-    : std::runtime_error("")
-{
-    std::stringstream ss;
-    ss << "Assertion failed at " << File << ':' << Line << ". ";
-    ss << "( " << Code << " )";
-    m_Msg = ss.str();
-}
+    : cut::CheckException("Assertion failed", Format("Assertion failed", Code.c_str(), File.c_str(), Line))
+{ }
 
+cut::AssertionError::AssertionError(const char* Code,
+                                    const char* File,
+                                    int Line)
+    : cut::CheckException("Assertion failed", Code, File, Line)
+{ }
 
-cut::AssertionError::~AssertionError() { }
 
-char const* cut::AssertionError::what() const noexcept
-{
-    return m_Msg.c_str();
-}
\ No newline at end of file
+cut::AssertionError::~AssertionError() { }
\ No newline at end of file
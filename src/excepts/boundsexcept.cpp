@@ -10,28 +10,23 @@
  * @date        2023-10-09
  */
 #include <cut/excepts/boundsexcept.hpp>
-#include <sstream>
 
 
 cut::OutOfBoundError::OutOfBoundError(const std::string& Msg)
-    : m_Msg(Msg), std::runtime_error("")
+    : cut::CheckException("Bound violated", Msg)
 { }
 
 cut::OutOfBoundError::OutOfBoundError(const std::string& Code,
                                       const std::string& File,
                                       int Line)
-    : std::runtime_error("")
-{
-    std::stringstream ss;
-    ss << "Bound violated at " << File << ':' << Line << ". ";
-    ss << "( " << Code << " )";
-    m_Msg = ss.str();
-}
+    : cut::CheckException("Bound violated", Format("Bound violated", Code.c_str(), File.c_str(), Line))
+{ }
 
+cut::OutOfBoundError::OutOfBoundError(const char* Code,
+                                      const char* File,
+                                      int Line)
+    : cut::CheckException("Bound violated", Code, File, Line)
+{ }
 
-cut::OutOfBoundError::~OutOfBoundError() { }
 
-char const* cut::OutOfBoundError::what() const noexcept
-{
-    return m_Msg.c_str();
-}
\ No newline at end of file
+cut::OutOfBoundError::~OutOfBoundError() { }
\ No newline at end of file
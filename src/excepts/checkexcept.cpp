@@ -0,0 +1,72 @@
+/**
+ * @file        checkexcept.cpp
+ * 
+ * @brief       Implements cut::CheckException.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-07
+ */
+#include <cut/excepts/checkexcept.hpp>
+
+
+cut::CheckException::CheckException(const char* Kind, const std::string& Msg)
+    : std::runtime_error(""), m_Kind(Kind), m_Code(nullptr), m_File(nullptr), m_Line(0), m_Msg(Msg)
+{ }
+
+cut::CheckException::CheckException(const char* Kind,
+                                    const char* Code,
+                                    const char* File,
+                                    int Line)
+    : std::runtime_error(""), m_Kind(Kind), m_Code(Code), m_File(File), m_Line(Line)
+{ }
+
+cut::CheckException::CheckException(const cut::CheckException& E)
+    : std::runtime_error(E), m_Kind(E.m_Kind), m_Code(E.m_Code), m_File(E.m_File), m_Line(E.m_Line)
+{
+    std::lock_guard<std::mutex> Guard(E.m_Lock);
+    m_Msg = E.m_Msg;
+}
+
+
+cut::CheckException::~CheckException() { }
+
+
+std::string cut::CheckException::Format(const char* Kind, const char* Code, const char* File, int Line)
+{
+    std::string Msg(Kind);
+    Msg += " at ";
+    Msg += File;
+    Msg += ':';
+    Msg += std::to_string(Line);
+    Msg += ". ( ";
+    Msg += Code;
+    Msg += " )";
+    return Msg;
+}
+
+
+const char* cut::CheckException::Code() const noexcept { return m_Code; }
+const char* cut::CheckException::File() const noexcept { return m_File; }
+int cut::CheckException::Line() const noexcept { return m_Line; }
+
+
+char const* cut::CheckException::what() const noexcept
+{
+    std::lock_guard<std::mutex> Guard(m_Lock);
+    if (m_Code != nullptr && m_Msg.empty())
+    {
+        try
+        {
+            m_Msg = Format(m_Kind, m_Code, m_File, m_Line);
+        }
+        catch(...)
+        {
+            // Without memory for the message, the description is the best we can do
+            return m_Kind;
+        }
+    }
+    return m_Msg.c_str();
+}
\ No newline at end of file
@@ -10,28 +10,23 @@
  * @date        2023-10-09
  */
 #include <cut/excepts/nullptrexcept.hpp>
-#include <sstream>
 
 
 cut::NullPtrError::NullPtrError(const std::string& Msg)
-    : m_Msg(Msg), std::runtime_error("")
+    : cut::CheckException("Null pointer detected", Msg)
 { }
 
 cut::NullPtrError::NullPtrError(const std::string& Code,
                                 const std::string& File,
                                 int Line)
-    : std::runtime_error("")
-{
-    std::stringstream ss;
-    ss << "Null pointer detected at " << File << ':' << Line << ". ";
-    ss << "( " << Code << " )";
-    m_Msg = ss.str();
-}
+    : cut::CheckException("Null pointer detected", Format("Null pointer detected", Code.c_str(), File.c_str(), Line))
+{ }
 
+cut::NullPtrError::NullPtrError(const char* Code,
+                                const char* File,
+                                int Line)
+    : cut::CheckException("Null pointer detected", Code, File, Line)
+{ }
 
-cut::NullPtrError::~NullPtrError() { }
 
-char const* cut::NullPtrError::what() const noexcept
-{
-    return m_Msg.c_str();
-}
\ No newline at end of file
+cut::NullPtrError::~NullPtrError() { }
\ No newline at end of file
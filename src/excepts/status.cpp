@@ -0,0 +1,32 @@
+/**
+ * @file        status.cpp
+ * 
+ * @brief       Implements cut::CheckStatus.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-07
+ */
+#include <cut/excepts/status.hpp>
+#include <cut/excepts/excepts.hpp>
+
+
+void cut::CheckStatus::Raise() const
+{
+    switch (m_Code)
+    {
+    case cut::CheckCode::CHECK_ASSERTION:
+        throw cut::AssertionError(m_Expr, m_File, m_Line);
+
+    case cut::CheckCode::CHECK_BOUND:
+        throw cut::OutOfBoundError(m_Expr, m_File, m_Line);
+
+    case cut::CheckCode::CHECK_NULL:
+        throw cut::NullPtrError(m_Expr, m_File, m_Line);
+
+    default:
+        break;
+    }
+}
\ No newline at end of file
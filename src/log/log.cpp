@@ -12,18 +12,113 @@
 #include <cut/log.hpp>
 #include <cut/time/timestamp.hpp>
 #include <cut/excepts/excepts.hpp>
+#include <cut/parallel/mpscqueue.hpp>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 
 
-std::unordered_map<std::string, cut::Logger> cut::Logger::m_Logs;
+cut::Registry<cut::Logger> cut::Logger::m_Logs;
+const size_t cut::Logger::DefaultQueueCapacity;
+
+
+namespace
+{
+    // Size of the buffer written to the stream at once
+    const size_t BatchBytes = 1 << 16;
+
+    // A message waiting in the asynchronous queue
+    struct LogRecord
+    {
+        cut::LogType Type;
+        bool HasTimestamp;
+        cut::TimerPrecision Precision;
+        cut::Timestamp TS;
+        std::string Msg;
+    };
+
+    // Append a log line, without the line terminator
+    void FormatLine(std::string& Out,
+                    cut::LogType Type,
+                    const cut::Timestamp* TS,
+                    cut::TimerPrecision Precision,
+                    const std::string& Msg)
+    {
+        if (TS != nullptr)
+        {
+            char Buffer[cut::Timestamp::MaxFormatLength];
+            Out.append(Buffer, TS->Format(Buffer, sizeof(Buffer), Precision));
+            Out += ' ';
+        }
+
+        switch (Type)
+        {
+        case cut::LogType::MESSAGE:
+            Out += "(MESSAGE): ";
+            break;
+
+        case cut::LogType::WARNING:
+            Out += "(WARNING): ";
+            break;
+
+        case cut::LogType::ERROR:
+            Out += "(ERROR): ";
+            break;
+
+        default:
+            break;
+        }
+
+        Out += Msg;
+    }
+}
+
+
+struct cut::Logger::AsyncBackend
+{
+    cut::MPSCQueue<LogRecord> Queue;
+    std::chrono::milliseconds FlushInterval;
+    cut::LogOverflow Policy;
+
+    // Pushed is advanced by the producers, Flushed by the background thread
+    std::atomic<size_t> Pushed;
+    std::atomic<size_t> Flushed;
+    std::atomic<size_t> Dropped;
+    std::atomic<bool> Stop;
+    std::atomic<bool> Sleeping;
+    std::atomic<bool> FlushRequest;
+
+    // The producers only take the lock to wake up a sleeping background thread
+    std::mutex Lock;
+    std::condition_variable Wake;
+    std::thread Worker;
+
+    AsyncBackend(size_t Capacity, std::chrono::milliseconds Interval, cut::LogOverflow Overflow)
+        : Queue(Capacity), FlushInterval(Interval), Policy(Overflow),
+          Pushed(0), Flushed(0), Dropped(0), Stop(false), Sleeping(false), FlushRequest(false)
+    { }
+
+    void Notify()
+    {
+        if (Sleeping.load())
+        {
+            std::lock_guard<std::mutex> Guard(Lock);
+            Wake.notify_one();
+        }
+    }
+};
 
 
 cut::Logger::Logger(const std::string& LogFile,
                     cut::LogType Mask,
                     bool WithTimestamps)
-    : m_Timestamp(WithTimestamps),
-      m_Mask(Mask),
-      m_Filename(LogFile)
+    : m_Filename(LogFile),
+      m_Mask((int)Mask),
+      m_Timestamp(WithTimestamps),
+      m_Precision((int)cut::TimerPrecision::SECONDS),
+      m_Async(nullptr)
 {
     m_Stream.open(m_Filename, std::ios::out);
     CUTAssert(m_Stream.is_open());
@@ -32,6 +127,7 @@ cut::Logger::Logger(const std::string& LogFile,
 
 cut::Logger::~Logger()
 {
+    StopAsync();
     m_Stream.close();
 }
 
@@ -42,48 +138,187 @@ void cut::Logger::Log(cut::LogType Type,
     CUTAssert((Type == cut::LogType::MESSAGE) || (Type == cut::LogType::WARNING) || (Type == cut::LogType::ERROR));
 
     // Ignore disabled log types
-    if ((((int)Type) & ((int)m_Mask)) == 0)
+    if ((((int)Type) & m_Mask.load(std::memory_order_relaxed)) == 0)
         return;
 
-    if (HasTimestamps())
-        m_Stream << cut::Timestamp().ToString() << ' ';
-    
-    switch (Type)
+    AsyncBackend* A = m_Async.load(std::memory_order_acquire);
+    if (A == nullptr)
     {
-    case cut::LogType::MESSAGE:
-        m_Stream << "(MESSAGE): ";
-        break;
-        
-    case cut::LogType::WARNING:
-        m_Stream << "(WARNING): ";
-        break;
-        
-    case cut::LogType::ERROR:
-        m_Stream << "(ERROR): ";
-        break;
-    
-    default:
-        break;
+        // The line buffer is reused, so that steady logging does not allocate
+        static thread_local std::string Line;
+        Line.clear();
+        cut::Timestamp TS;
+        FormatLine(Line, Type, HasTimestamps() ? &TS : nullptr, GetTimestampPrecision(), Msg);
+        Line += '\n';
+        std::lock_guard<std::mutex> Guard(m_WriteLock);
+        // StartAsync() publishes the backend under the same lock, then the stream is no longer ours
+        A = m_Async.load(std::memory_order_acquire);
+        if (A == nullptr)
+        {
+            m_Stream.write(Line.data(), Line.size());
+            m_Stream.flush();
+            return;
+        }
     }
 
-    m_Stream << Msg << std::endl;
+    // Only capture the message, the background thread formats it
+    LogRecord Rec;
+    Rec.Type = Type;
+    Rec.HasTimestamp = HasTimestamps();
+    Rec.Precision = GetTimestampPrecision();
+    Rec.Msg = Msg;
+    while (!A->Queue.TryPush(Rec))
+    {
+        if (A->Policy != cut::LogOverflow::LOG_BLOCK)
+        {
+            A->Dropped.fetch_add(1);
+            return;
+        }
+        A->Notify();
+        std::this_thread::yield();
+    }
+    A->Pushed.fetch_add(1);
+    A->Notify();
 }
 
+
+void cut::Logger::StartAsync(size_t QueueCapacity,
+                             std::chrono::milliseconds FlushInterval,
+                             cut::LogOverflow Policy)
+{
+    std::lock_guard<std::mutex> Guard(m_WriteLock);
+    if (m_Async.load() != nullptr)
+        return;
+    m_Stream.flush();
+    AsyncBackend* A = new AsyncBackend(QueueCapacity, FlushInterval, Policy);
+    m_Async.store(A, std::memory_order_release);
+    A->Worker = std::thread(&cut::Logger::AsyncLoop, this);
+}
+
+void cut::Logger::StopAsync()
+{
+    AsyncBackend* A = m_Async.load();
+    if (A == nullptr)
+        return;
+    A->Stop.store(true);
+    {
+        std::lock_guard<std::mutex> Guard(A->Lock);
+        A->Wake.notify_one();
+    }
+    A->Worker.join();
+    m_Async.store(nullptr);
+    delete A;
+}
+
+bool cut::Logger::IsAsync() const { return m_Async.load() != nullptr; }
+
+void cut::Logger::Flush()
+{
+    AsyncBackend* A = m_Async.load();
+    if (A == nullptr)
+    {
+        std::lock_guard<std::mutex> Guard(m_WriteLock);
+        m_Stream.flush();
+        return;
+    }
+    size_t Target = A->Pushed.load();
+    while (A->Flushed.load() < Target)
+    {
+        A->FlushRequest.store(true);
+        {
+            std::lock_guard<std::mutex> Guard(A->Lock);
+            A->Wake.notify_one();
+        }
+        std::this_thread::yield();
+    }
+}
+
+size_t cut::Logger::NumDropped() const
+{
+    AsyncBackend* A = m_Async.load();
+    return A != nullptr ? A->Dropped.load() : 0;
+}
+
+void cut::Logger::AsyncLoop()
+{
+    AsyncBackend& A = *m_Async.load();
+    std::string Batch;
+    Batch.reserve(BatchBytes + 1024);
+    LogRecord Rec;
+    size_t Written = 0;
+    size_t Reported = 0;
+    std::chrono::steady_clock::time_point LastFlush = std::chrono::steady_clock::now();
+    while (true)
+    {
+        // Anything pushed before the stop request is written before exiting
+        bool Stopping = A.Stop.load();
+        bool Any = false;
+        while (A.Queue.TryPop(Rec))
+        {
+            Any = true;
+            FormatLine(Batch, Rec.Type, Rec.HasTimestamp ? &Rec.TS : nullptr, Rec.Precision, Rec.Msg);
+            Batch += '\n';
+            Written++;
+            if (Batch.size() >= BatchBytes)
+            {
+                m_Stream.write(Batch.data(), Batch.size());
+                Batch.clear();
+            }
+        }
+        size_t Dropped = A.Dropped.load();
+        if (A.Policy == cut::LogOverflow::LOG_DROP_COUNT && Dropped != Reported)
+        {
+            cut::Timestamp Now;
+            FormatLine(Batch, cut::LogType::WARNING, HasTimestamps() ? &Now : nullptr, GetTimestampPrecision(),
+                       std::to_string(Dropped - Reported) + " messages dropped.");
+            Batch += '\n';
+            Reported = Dropped;
+        }
+        if (!Batch.empty())
+        {
+            m_Stream.write(Batch.data(), Batch.size());
+            Batch.clear();
+        }
+
+        std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+        bool Requested = A.FlushRequest.exchange(false);
+        if (Written != A.Flushed.load() && (Stopping || Requested || Now - LastFlush >= A.FlushInterval))
+        {
+            m_Stream.flush();
+            A.Flushed.store(Written);
+            LastFlush = Now;
+        }
+        if (Stopping)
+            break;
+
+        if (!Any)
+        {
+            std::unique_lock<std::mutex> Guard(A.Lock);
+            A.Sleeping.store(true);
+            if (!A.Stop.load() && !A.FlushRequest.load())
+                A.Wake.wait_for(Guard, A.FlushInterval);
+            A.Sleeping.store(false);
+        }
+    }
+    m_Stream.flush();
+}
+
+
 void cut::Logger::Message(const std::string& Msg)   { Log(cut::LogType::MESSAGE, Msg); }
 void cut::Logger::Warning(const std::string& Msg)   { Log(cut::LogType::WARNING, Msg); }
 void cut::Logger::Error(const std::string& Msg)     { Log(cut::LogType::ERROR, Msg); }
 
 
-cut::LogType cut::Logger::GetMask() const { return m_Mask; }
-void cut::Logger::SetMask(cut::LogType Mask) { m_Mask = Mask; }
+cut::LogType cut::Logger::GetMask() const { return (cut::LogType)m_Mask.load(); }
+void cut::Logger::SetMask(cut::LogType Mask) { m_Mask.store((int)Mask); }
 
 void cut::Logger::Enable(cut::LogType Types)
 {
-    m_Mask = (cut::LogType)(((int)m_Mask) | ((int)Types));
+    m_Mask.fetch_or((int)Types);
 }
 void cut::Logger::Disable(cut::LogType Types)
 {
-    m_Mask = (cut::LogType)(((int)m_Mask) & ~((int)Types));
+    m_Mask.fetch_and(~((int)Types));
 }
 
 
@@ -99,6 +334,8 @@ bool cut::Logger::HasTimestamps() const { return m_Timestamp; }
 void cut::Logger::UseTimestamps(bool WithTimestamps) { m_Timestamp = WithTimestamps; }
 void cut::Logger::EnableTimestamps() { m_Timestamp = true; }
 void cut::Logger::DisableTimestamps() { m_Timestamp = false; }
+cut::TimerPrecision cut::Logger::GetTimestampPrecision() const { return (cut::TimerPrecision)m_Precision.load(); }
+void cut::Logger::SetTimestampPrecision(cut::TimerPrecision Precision) { m_Precision.store((int)Precision); }
 
 
 
@@ -110,21 +347,19 @@ void cut::Logger::AttachLogger(const std::string& Name,
                                cut::LogType Mask,
                                bool WithTimestamp)
 {
-    CUTAssert(m_Logs.find(Name) == m_Logs.end());
-
-    m_Logs.emplace(std::piecewise_construct,
-                   std::forward_as_tuple(Name),
-                   std::forward_as_tuple(LogFile, Mask, WithTimestamp));
+    m_Logs.Attach(Name, LogFile, Mask, WithTimestamp);
 }
 
 cut::Logger& cut::Logger::GetLogger(const std::string& Name)
 {
-    CUTAssert(m_Logs.find(Name) != m_Logs.end());
-    return m_Logs.at(Name);
+    return m_Logs.Get(Name);
 }
 
 void cut::Logger::DeleteLogger(const std::string& Name)
 {
-    CUTAssert(m_Logs.find(Name) != m_Logs.end());
-    m_Logs.erase(Name);
+    std::shared_ptr<cut::Logger> Removed = m_Logs.Remove(Name);
+    // Other threads may keep the logger alive for a while, but the file is released now
+    Removed->StopAsync();
+    std::lock_guard<std::mutex> Guard(Removed->m_WriteLock);
+    Removed->m_Stream.close();
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+/**
+ * @file        aligned.cpp
+ * 
+ * @brief       Implements the aligned allocation functions.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-09
+ */
+#include <cut/memory/aligned.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+
+namespace
+{
+    // The size of the huge pages of x86-64 and AArch64 with 4 KiB pages
+    const size_t HugePageSize = 2 << 20;
+
+    // The memory policies of the kernel (see mbind(2)), not to depend on numaif.h
+    const int MPOL_BIND_MODE = 2;
+
+    std::mutex g_PolicyMutex;
+    cut::MemoryPolicy g_Policy;
+
+    size_t PageSize()
+    {
+#if defined(_WIN32)
+        return 4096;
+#else
+        static const size_t Size = (size_t)sysconf(_SC_PAGESIZE);
+        return Size;
+#endif
+    }
+
+    size_t RoundUp(size_t Bytes, size_t Align)
+    {
+        return (Bytes + Align - 1) & ~(Align - 1);
+    }
+
+    void BindToNode(void* Ptr, size_t Bytes, int Node)
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        const size_t BitsPerWord = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> Mask(Node / BitsPerWord + 1, 0);
+        Mask[Node / BitsPerWord] = 1UL << (Node % BitsPerWord);
+        // A failure leaves the default placement
+        syscall(SYS_mbind, Ptr, Bytes, MPOL_BIND_MODE, Mask.data(), Mask.size() * BitsPerWord + 1, 0);
+#else
+        (void)Ptr; (void)Bytes; (void)Node;
+#endif
+    }
+}
+
+
+void cut::SetDefaultMemoryPolicy(const cut::MemoryPolicy& P)
+{
+    CUTAssert(P.Alignment > 0 && (P.Alignment & (P.Alignment - 1)) == 0);
+
+    std::lock_guard<std::mutex> Lock(g_PolicyMutex);
+    g_Policy = P;
+}
+
+cut::MemoryPolicy cut::GetDefaultMemoryPolicy()
+{
+    std::lock_guard<std::mutex> Lock(g_PolicyMutex);
+    return g_Policy;
+}
+
+int cut::NumNumaNodes()
+{
+    int NNodes = 1;
+#if defined(__linux__)
+    // The file contains the ranges of the online nodes, as in "0-1"
+    std::FILE* F = std::fopen("/sys/devices/system/node/online", "r");
+    if (F != nullptr)
+    {
+        int Begin, End;
+        while (std::fscanf(F, "%d", &Begin) == 1)
+        {
+            End = Begin;
+            if (std::fscanf(F, "-%d", &End) < 0)
+                End = Begin;
+            NNodes = std::max(NNodes, End + 1);
+            if (std::fgetc(F) != ',')
+                break;
+        }
+        std::fclose(F);
+    }
+#endif
+    return NNodes;
+}
+
+
+void* cut::AlignedAllocate(size_t Bytes, const cut::MemoryPolicy& P)
+{
+    CUTAssert(P.Alignment > 0 && (P.Alignment & (P.Alignment - 1)) == 0);
+
+    size_t Align = std::max(P.Alignment, sizeof(void*));
+    Bytes = std::max(Bytes, (size_t)1);
+    // The placement works on whole pages, that must not be shared with other allocations.
+    // Allocations smaller than a page are left to the default placement
+    bool Huge = P.HugePages && Bytes >= HugePageSize;
+    bool Paged = (P.Node >= 0 || P.FirstTouch) && Bytes >= PageSize();
+    if (Huge)
+        Align = std::max(Align, HugePageSize);
+    else if (Paged)
+        Align = std::max(Align, PageSize());
+    if (Align >= PageSize())
+        Bytes = RoundUp(Bytes, Align);
+
+    void* Ptr = nullptr;
+#if defined(_WIN32)
+    Ptr = _aligned_malloc(Bytes, Align);
+#else
+    if (posix_memalign(&Ptr, Align, Bytes) != 0)
+        Ptr = nullptr;
+#endif
+    CUTCheckNull(Ptr);
+
+#if defined(MADV_HUGEPAGE)
+    if (Huge)
+        madvise(Ptr, Bytes, MADV_HUGEPAGE);
+#endif
+    if (Paged && P.Node >= 0)
+        BindToNode(Ptr, Bytes, P.Node);
+    if (Paged && P.FirstTouch && cut::GetNumThreads() > 1)
+    {
+        // Write a byte per page, with the same static partition of the algorithms
+        char* Data = (char*)Ptr;
+        size_t Step = Huge ? HugePageSize : PageSize();
+        cut::ParallelFor(0, Bytes / Step, [&](size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+                Data[i * Step] = 0;
+        });
+    }
+
+    return Ptr;
+}
+
+void cut::AlignedFree(void* Ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(Ptr);
+#else
+    std::free(Ptr);
+#endif
+}
\ No newline at end of file
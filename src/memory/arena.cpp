@@ -0,0 +1,144 @@
+/**
+ * @file        arena.cpp
+ * 
+ * @brief       Implements cut::Arena.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-08
+ */
+#include <cut/memory/arena.hpp>
+#include <cut/memory/allocation.hpp>
+#include <algorithm>
+
+
+
+const size_t cut::Arena::DefaultBlockSize;
+const size_t cut::Arena::NumClasses;
+const size_t cut::Arena::MinClassSize;
+
+
+cut::Arena::Arena(size_t BlockSize)
+    : m_Current(0), m_Offset(0), m_BlockSize(BlockSize), m_Allocated(0)
+{
+    CUTCheckGreater(BlockSize, (size_t)0);
+    ClearFreeLists();
+}
+
+cut::Arena::~Arena()
+{
+    Release();
+}
+
+
+void cut::Arena::NextBlock(size_t Bytes)
+{
+    // Blocks kept by a reset are reused in order, skipping those too small
+    if (!m_Blocks.empty() && m_Offset > 0)
+        m_Current++;
+    while (m_Current < m_Blocks.size() && m_Blocks[m_Current].Size < Bytes)
+        m_Current++;
+    if (m_Current == m_Blocks.size())
+    {
+        Block B;
+        B.Size = std::max(m_BlockSize, Bytes);
+        B.Data = cut::Malloc<char>(B.Size);
+        m_Blocks.push_back(B);
+    }
+    m_Offset = 0;
+}
+
+void cut::Arena::ClearFreeLists()
+{
+    std::fill(m_Free, m_Free + NumClasses, nullptr);
+}
+
+
+void* cut::Arena::AllocateBlock(size_t Bytes)
+{
+    size_t C = ClassOf(std::max(Bytes, MinClassSize));
+    FreeBlock* F = m_Free[C];
+    if (F != nullptr)
+    {
+        m_Free[C] = F->Next;
+        return F;
+    }
+    // Split the smallest larger released block, keeping its upper halves in the free lists
+    for (size_t D = C + 1; D < NumClasses; ++D)
+    {
+        F = m_Free[D];
+        if (F == nullptr)
+            continue;
+        m_Free[D] = F->Next;
+        while (D > C)
+        {
+            D--;
+            FreeBlock* Half = (FreeBlock*)((char*)F + ((size_t)1 << D));
+            Half->Next = m_Free[D];
+            m_Free[D] = Half;
+        }
+        return F;
+    }
+    return Allocate((size_t)1 << C, MinClassSize);
+}
+
+void cut::Arena::ReleaseBlock(void* Ptr, size_t Bytes)
+{
+    if (Ptr == nullptr)
+        return;
+    size_t C = ClassOf(std::max(Bytes, MinClassSize));
+    FreeBlock* F = (FreeBlock*)Ptr;
+    F->Next = m_Free[C];
+    m_Free[C] = F;
+}
+
+
+cut::Arena::Marker cut::Arena::Mark() const
+{
+    cut::Arena::Marker M;
+    M.Block = m_Current;
+    M.Offset = m_Offset;
+    M.Allocated = m_Allocated;
+    return M;
+}
+
+void cut::Arena::Rewind(const cut::Arena::Marker& M)
+{
+    CUTCheckLEQ(M.Block, m_Current);
+    if (M.Block == m_Current)
+        CUTCheckLEQ(M.Offset, m_Offset);
+
+    m_Allocated = M.Allocated;
+    m_Current = M.Block;
+    m_Offset = M.Offset;
+    ClearFreeLists();
+}
+
+void cut::Arena::Reset()
+{
+    m_Current = 0;
+    m_Offset = 0;
+    m_Allocated = 0;
+    ClearFreeLists();
+}
+
+void cut::Arena::Release()
+{
+    for (const Block& B : m_Blocks)
+        std::free(B.Data);
+    m_Blocks.clear();
+    Reset();
+}
+
+
+size_t cut::Arena::BytesAllocated() const { return m_Allocated; }
+
+size_t cut::Arena::BytesReserved() const
+{
+    size_t Total = 0;
+    for (const Block& B : m_Blocks)
+        Total += B.Size;
+    return Total;
+}
\ No newline at end of file
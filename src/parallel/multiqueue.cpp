@@ -0,0 +1,157 @@
+/**
+ * @file        multiqueue.cpp
+ * 
+ * @brief       Implements cut::MultiQueue.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-14
+ */
+#include <cut/parallel/multiqueue.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <cut/time/profiler.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <cstdint>
+
+
+const int cut::MultiQueue::NumAttempts;
+
+
+namespace
+{
+    const double Inf = std::numeric_limits<double>::infinity();
+
+    // Each thread draws its heaps from its own generator, seeded once
+    std::atomic<uint64_t> g_NextSeed(0);
+    thread_local uint64_t t_State = 0;
+
+    uint64_t NextRandom()
+    {
+        if (t_State == 0)
+        {
+            // splitmix64 of a per-thread counter, never zero
+            uint64_t z = g_NextSeed.fetch_add(0x9E3779B97F4A7C15ull) + 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            t_State = (z ^ (z >> 31)) | 1;
+        }
+        // xorshift64
+        t_State ^= t_State << 13;
+        t_State ^= t_State >> 7;
+        t_State ^= t_State << 17;
+        return t_State;
+    }
+
+    // The heaps are min-heaps on the keys
+    typedef std::greater<std::pair<double, size_t>> HeapOrder;
+}
+
+
+cut::MultiQueue::MultiQueue(int NumThreads, int QueuesPerThread)
+    : m_NumQueues(0), m_Size(0)
+{
+    CUTCheckGreater(QueuesPerThread, 0);
+
+    m_NumQueues = (size_t)cut::ResolveNumThreads(NumThreads) * QueuesPerThread;
+    m_Queues.reset(new Queue[m_NumQueues]);
+    for (size_t i = 0; i < m_NumQueues; ++i)
+        m_Queues[i].Top.store(Inf, std::memory_order_relaxed);
+}
+
+size_t cut::MultiQueue::NumQueues() const { return m_NumQueues; }
+size_t cut::MultiQueue::Size() const { return m_Size.load(std::memory_order_relaxed); }
+bool cut::MultiQueue::Empty() const { return Size() == 0; }
+
+
+size_t cut::MultiQueue::RandomQueue() const
+{
+    return (size_t)(NextRandom() % m_NumQueues);
+}
+
+void cut::MultiQueue::PopLocked(Queue& Q, std::pair<double, size_t>& Min)
+{
+    std::pop_heap(Q.Heap.begin(), Q.Heap.end(), HeapOrder());
+    Min = Q.Heap.back();
+    Q.Heap.pop_back();
+    Q.Top.store(Q.Heap.empty() ? Inf : Q.Heap.front().first, std::memory_order_relaxed);
+}
+
+
+void cut::MultiQueue::Push(size_t Element, double Key)
+{
+    __CUTProfileLibrary("MultiQueue::Push");
+    // Count the entry first, so that the size never falls below the heaps' content
+    m_Size.fetch_add(1, std::memory_order_relaxed);
+    while (true)
+    {
+        Queue& Q = m_Queues[RandomQueue()];
+        // A locked heap is busy, another one will do
+        if (!Q.Lock.try_lock())
+            continue;
+        Q.Heap.emplace_back(Key, Element);
+        std::push_heap(Q.Heap.begin(), Q.Heap.end(), HeapOrder());
+        Q.Top.store(Q.Heap.front().first, std::memory_order_relaxed);
+        Q.Lock.unlock();
+        return;
+    }
+}
+
+bool cut::MultiQueue::TryExtractApproxMin(std::pair<double, size_t>& Min)
+{
+    __CUTProfileLibrary("MultiQueue::TryExtractApproxMin");
+    while (m_Size.load(std::memory_order_relaxed) > 0)
+    {
+        // Two random choices: extract from the heap with the smaller minimum
+        for (int a = 0; a < NumAttempts; ++a)
+        {
+            size_t i = RandomQueue();
+            size_t j = RandomQueue();
+            if (m_Queues[j].Top.load(std::memory_order_relaxed) < m_Queues[i].Top.load(std::memory_order_relaxed))
+                i = j;
+            Queue& Q = m_Queues[i];
+            if (Q.Top.load(std::memory_order_relaxed) == Inf || !Q.Lock.try_lock())
+                continue;
+            if (Q.Heap.empty())
+            {
+                Q.Lock.unlock();
+                continue;
+            }
+            PopLocked(Q, Min);
+            Q.Lock.unlock();
+            m_Size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // The random heaps were empty or busy, look at all of them
+        for (size_t i = 0; i < m_NumQueues; ++i)
+        {
+            // Infinite keys look like empty heaps, so each heap is locked here
+            Queue& Q = m_Queues[i];
+            std::lock_guard<std::mutex> Lock(Q.Lock);
+            if (Q.Heap.empty())
+                continue;
+            PopLocked(Q, Min);
+            m_Size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        // Some entries are still being pushed
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+void cut::MultiQueue::Clear()
+{
+    for (size_t i = 0; i < m_NumQueues; ++i)
+    {
+        m_Queues[i].Heap.clear();
+        m_Queues[i].Top.store(Inf, std::memory_order_relaxed);
+    }
+    m_Size.store(0);
+}
\ No newline at end of file
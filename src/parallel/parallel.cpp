@@ -0,0 +1,41 @@
+/**
+ * @file        parallel.cpp
+ * 
+ * @brief       Implements the global thread settings.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-22
+ */
+#include <cut/parallel/parallel.hpp>
+#include <cut/excepts/excepts.hpp>
+
+
+namespace
+{
+    std::atomic<int> g_NumThreads(1);
+}
+
+
+void cut::SetNumThreads(int NumThreads)
+{
+    CUTCheckGEQ(NumThreads, 0);
+
+    g_NumThreads.store(NumThreads);
+}
+
+int cut::GetNumThreads()
+{
+    return cut::ResolveNumThreads(g_NumThreads.load());
+}
+
+int cut::ResolveNumThreads(int NumThreads)
+{
+    if (NumThreads < 0)
+        NumThreads = g_NumThreads.load();
+    if (NumThreads == 0)
+        NumThreads = std::thread::hardware_concurrency();
+    return std::max(NumThreads, 1);
+}
\ No newline at end of file
@@ -10,7 +10,23 @@
  * @date        2023-11-17
  */
 #include <cut/algo/adjlist.hpp>
+#include <cut/algo/csr.hpp>
+#include <cut/algo/madjlist.hpp>
+#include <cut/algo/adjbuilder.hpp>
+#include <cut/algo/reorder.hpp>
+#include <cut/algo/wadjlist.hpp>
+#include <cut/algo/zadjlist.hpp>
+#include <cut/algo/dadjlist.hpp>
+#include <cut/algo/intersect.hpp>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cstdio>
 #include <iostream>
+#include <algorithm>
+#include <random>
+#include <set>
 
 const int M = 5;
 const int N = 2 * M;
@@ -102,6 +118,643 @@ int main(int argc, const char* const argv[])
         }
     }
 
+    // Unchecked accessors must agree with the checked ones
+    for (int i = 0; i < CAL.NumNodes(); ++i)
+    {
+        if (CAL.NumAdjacentsUnchecked(i) != CAL.NumAdjacents(i))
+            return -1;
+        for (int j = 0; j < CAL.NumAdjacents(i); ++j)
+        {
+            if (CAL.GetAdjacentUnchecked(i, j) != CAL.GetAdjacent(i, j))
+                return -1;
+        }
+    }
+
+    // Neighbor spans must agree with the element-wise accessors
+    FAL = cut::AdjacencyList(CAL);
+    for (int i = 0; i < CAL.NumNodes(); ++i)
+    {
+        cut::Span<int> CN = CAL.Neighbors(i);
+        cut::Span<int> FN = FAL.Neighbors(i);
+        if (CN.Size() != CAL.NumAdjacents(i) || FN.Size() != FAL.NumAdjacents(i))
+            return -1;
+        int j = 0;
+        for (int Adj : CN)
+        {
+            if (Adj != CAL.GetAdjacent(i, j) || Adj != FN[j])
+                return -1;
+            j++;
+        }
+    }
+
+    // Templated CSR with narrow types must match the compact list
+    std::vector<std::pair<uint16_t, uint16_t>> SPairs;
+    Pairs.clear();
+    for (int i = 0; i < FAL.NumNodes(); ++i)
+    {
+        for (int Adj : FAL.Neighbors(i))
+        {
+            SPairs.emplace_back(i, Adj);
+            SPairs.emplace_back(i, Adj);
+            Pairs.emplace_back(i, Adj);
+        }
+    }
+    CAL = cut::CompatAdjacencyList(Pairs);
+    cut::CSRAdjacencyList<uint16_t, uint32_t> SCSR(SPairs);
+    cut::CompatAdjacencyList SCAL(SCSR);
+    cut::CSRAdjacencyList<> LCSR(CAL);
+    if (SCSR.NodeCount() > CAL.NumNodes() || LCSR.NumConnections() != CAL.NumConnections())
+        return -1;
+    for (int i = 0; i < SCSR.NumNodes(); ++i)
+    {
+        cut::Span<int> Ref = CAL.Neighbors(i);
+        cut::Span<uint16_t> Row = SCSR.Row(i);
+        if (Row.Size() != Ref.Size() || SCAL.NumAdjacents(i) != (int)Ref.Size())
+            return -1;
+        for (size_t j = 0; j < Ref.Size(); ++j)
+        {
+            if (Row[j] != Ref[j] || SCAL.GetAdjacent(i, j) != Ref[j] || LCSR.Adjacent(i, j) != (uint32_t)Ref[j])
+                return -1;
+            if (SCSR.Neighbors(i)[j] != Ref[j] || LCSR.Neighbors(i)[j] != Ref[j])
+                return -1;
+        }
+    }
+
+    // Counting sort construction must discard duplicates and sort the rows
+    std::vector<std::pair<int, int>> Shuffled = Pairs;
+    Shuffled.insert(Shuffled.end(), Pairs.begin(), Pairs.end());
+    std::reverse(Shuffled.begin(), Shuffled.end());
+    cut::CSRBuildStats Stats;
+    cut::CompatAdjacencyList SortedCAL(Shuffled, true, &Stats);
+    if (Stats.NumDuplicates != Pairs.size() || Stats.PeakMemory == 0)
+        return -1;
+    if (SortedCAL.NumConnections() != CAL.NumConnections())
+        return -1;
+    for (int i = 0; i < CAL.NumNodes(); ++i)
+    {
+        if (!std::equal(CAL.Neighbors(i).begin(), CAL.Neighbors(i).end(), SortedCAL.Neighbors(i).begin()))
+            return -1;
+    }
+    // Without sorting, the rows keep the input order
+    cut::CompatAdjacencyList RawCAL(Shuffled, false);
+    if (RawCAL.NumConnections() != (int)Shuffled.size())
+        return -1;
+    if (cut::CompatAdjacencyList(std::vector<std::pair<int, int>>()).NumNodes() != 0)
+        return -1;
+
+    // Conversions between the flexible and the compact lists, copying and moving
+    {
+        auto SameRows = [](const cut::BaseAdjacencyList& A, const cut::BaseAdjacencyList& B)
+        {
+            if (A.NumNodes() != B.NumNodes() || A.NumConnections() != B.NumConnections())
+                return false;
+            for (int i = 0; i < A.NumNodes(); ++i)
+            {
+                cut::Span<int> RA = A.Neighbors(i);
+                cut::Span<int> RB = B.Neighbors(i);
+                if (RA.Size() != RB.Size() || !std::equal(RA.begin(), RA.end(), RB.begin()))
+                    return false;
+            }
+            return true;
+        };
+        cut::AdjacencyList Flex(SortedCAL);
+        cut::CompatAdjacencyList Compact(Flex);
+        if (!SameRows(Flex, SortedCAL) || !SameRows(Compact, SortedCAL))
+            return -1;
+        cut::CompatAdjacencyList Moved(std::move(Flex));
+        if (!SameRows(Moved, SortedCAL) || Flex.NumNodes() != 0 || Flex.NumConnections() != 0)
+            return -1;
+        cut::AdjacencyList Back(std::move(Moved));
+        if (!SameRows(Back, SortedCAL) || Moved.NumNodes() != 0 || Moved.NumConnections() != 0)
+            return -1;
+        cut::AdjacencyList SameFlex(std::move(Back));
+        if (!SameRows(SameFlex, SortedCAL) || Back.NumNodes() != 0)
+            return -1;
+        Back = std::move(SameFlex);
+        Compact = std::move(Back);
+        if (!SameRows(Compact, SortedCAL) || Back.NumNodes() != 0)
+            return -1;
+        Flex = std::move(Compact);
+        if (!SameRows(Flex, SortedCAL) || Compact.NumNodes() != 0)
+            return -1;
+        // Other classes are copied, and left unchanged
+        cut::AdjacencyList FromCSR(std::move(LCSR));
+        if (!SameRows(FromCSR, CAL) || !SameRows(LCSR, CAL))
+            return -1;
+        // The same conversions in parallel
+        cut::SetNumThreads(4);
+        cut::CompatAdjacencyList ParCompact(std::move(Flex));
+        cut::SetNumThreads(1);
+        if (!SameRows(ParCompact, SortedCAL))
+            return -1;
+    }
+
+    // The arrays are aligned to the cache lines, also when built from raw arrays
+    if (((uintptr_t)SortedCAL.Neighbors(0).begin() % cut::CacheLineSize) != 0)
+        return -1;
+    cut::CompatAdjacencyList ArraysCAL(std::vector<int>({ 0, 2, 3 }), std::vector<int>({ 1, 2, 0 }));
+    if (ArraysCAL.NumNodes() != 2 || ArraysCAL.GetAdjacent(0, 1) != 2 || ((uintptr_t)ArraysCAL.Neighbors(0).begin() % cut::CacheLineSize) != 0)
+        return -1;
+
+    // Binary format round trip through a memory mapping
+    cut::MappedAdjacencyList::Save(SortedCAL, "adjlist.bin");
+    cut::MappedAdjacencyList MAL("adjlist.bin");
+    if (MAL.NumNodes() != SortedCAL.NumNodes() || MAL.NumConnections() != SortedCAL.NumConnections())
+        return -1;
+    for (int i = 0; i < MAL.NumNodes(); ++i)
+    {
+        cut::Span<int> Ref = SortedCAL.Neighbors(i);
+        if (MAL.NumAdjacents(i) != (int)Ref.Size())
+            return -1;
+        if (!std::equal(Ref.begin(), Ref.end(), MAL.Neighbors(i).begin()))
+            return -1;
+    }
+    cut::CompatAdjacencyList LoadedCAL(MAL);
+    if (LoadedCAL.NumConnections() != SortedCAL.NumConnections())
+        return -1;
+    try
+    {
+        cut::MappedAdjacencyList Bad("adjlist.cpp.missing");
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
+    // An interior offset past the adjacents must be rejected at load
+    {
+        std::ifstream In("adjlist.bin", std::ios::binary);
+        std::string Bytes((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+        cut::BinaryAdjacencyHeader Header;
+        std::memcpy(&Header, Bytes.data(), sizeof(Header));
+        uint64_t Bogus = Header.NumConnections + 1000;
+        std::memcpy(&Bytes[Header.OffsetsPos + sizeof(uint64_t)], &Bogus, sizeof(Bogus));
+        std::ofstream("adjlist.bad.bin", std::ios::binary).write(Bytes.data(), Bytes.size());
+    }
+    try
+    {
+        cut::MappedAdjacencyList Bad("adjlist.bad.bin");
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
+    // Corrupt array positions and truncated files must be rejected, not dereferenced
+    {
+        std::ifstream In("adjlist.bin", std::ios::binary);
+        std::string Bytes((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+        cut::BinaryAdjacencyHeader Header;
+        std::memcpy(&Header, Bytes.data(), sizeof(Header));
+        std::string Corrupt = Bytes;
+        cut::BinaryAdjacencyHeader Bad = Header;
+        Bad.OffsetsPos = 0xFFFFFFFFFFFFFFC0ull;
+        std::memcpy(&Corrupt[0], &Bad, sizeof(Bad));
+        std::ofstream("adjlist.bad.bin", std::ios::binary).write(Corrupt.data(), Corrupt.size());
+        try
+        {
+            cut::MappedAdjacencyList BadList("adjlist.bad.bin");
+            return -1;
+        }
+        catch(const cut::AssertionError& e) { }
+        Corrupt = Bytes;
+        Bad = Header;
+        Bad.AdjacentsPos = 0xFFFFFFFFFFFFFFC0ull;
+        std::memcpy(&Corrupt[0], &Bad, sizeof(Bad));
+        std::ofstream("adjlist.bad.bin", std::ios::binary).write(Corrupt.data(), Corrupt.size());
+        try
+        {
+            cut::MappedAdjacencyList BadList("adjlist.bad.bin");
+            return -1;
+        }
+        catch(const cut::AssertionError& e) { }
+        std::ofstream("adjlist.bad.bin", std::ios::binary).write(Bytes.data(), Header.AdjacentsPos + 4);
+        try
+        {
+            cut::MappedAdjacencyList BadList("adjlist.bad.bin");
+            return -1;
+        }
+        catch(const cut::AssertionError& e) { }
+    }
+    std::remove("adjlist.bad.bin");
+
+    // Streaming construction, with a tiny buffer to force the spills
+    cut::AdjacencyListBuilder Builder(7);
+    Builder.AddEdges(Shuffled.data(), Shuffled.size() / 2);
+    size_t Pos = Shuffled.size() / 2;
+    Builder.AddEdges([&](std::pair<int, int>* Chunk, size_t Cap)
+    {
+        size_t N = std::min(Cap, Shuffled.size() - Pos);
+        std::copy(Shuffled.begin() + Pos, Shuffled.begin() + Pos + N, Chunk);
+        Pos += N;
+        return N;
+    });
+    if (Builder.NumSpills() == 0 || Builder.NumConnections() != Shuffled.size())
+        return -1;
+    cut::CompatAdjacencyList StreamCAL = Builder.Build(true, &Stats);
+    if (Stats.NumDuplicates != Pairs.size() || Builder.NumConnections() != 0)
+        return -1;
+    if (StreamCAL.NumNodes() != SortedCAL.NumNodes() || StreamCAL.NumConnections() != SortedCAL.NumConnections())
+        return -1;
+    for (int i = 0; i < StreamCAL.NumNodes(); ++i)
+    {
+        if (!std::equal(SortedCAL.Neighbors(i).begin(), SortedCAL.Neighbors(i).end(), StreamCAL.Neighbors(i).begin()))
+            return -1;
+    }
+    // Without sorting, the rows keep the input order, as the counting sort does
+    std::stringstream EdgeList;
+    EdgeList << "# Shuffled connections\n";
+    for (const std::pair<int, int>& E : Shuffled)
+        EdgeList << E.first << " " << E.second << "\n";
+    if (Builder.ReadEdgeList(EdgeList) != Shuffled.size())
+        return -1;
+    cut::CompatAdjacencyList RawStreamCAL = Builder.Build(false);
+    for (int i = 0; i < RawCAL.NumNodes(); ++i)
+    {
+        if (!std::equal(RawCAL.Neighbors(i).begin(), RawCAL.Neighbors(i).end(), RawStreamCAL.Neighbors(i).begin()))
+            return -1;
+    }
+    std::stringstream BadList("0 1\n2 x\n");
+    try
+    {
+        Builder.ReadEdgeList(BadList);
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
+
+    // Bulk insertion on a hub node must skip the old and the repeated adjacents
+    cut::AdjacencyList Hub(2);
+    std::vector<int> Batch;
+    for (int j = 0; j < 1000; ++j)
+        Batch.push_back((j * 7) % 500);
+    Hub.AddAdjacent(0, 3);
+    if (Hub.AddAdjacents(0, Batch.data(), Batch.data() + Batch.size()) != 499)
+        return -1;
+    if (Hub.NumAdjacents(0) != 500 || Hub.NumConnections() != 500 || Hub.GetAdjacent(0, 1) != 0 || Hub.GetAdjacent(0, 2) != 7)
+        return -1;
+    if (Hub.AddAdjacents(1, Batch.data(), Batch.data() + 500, false) != 500 || Hub.NumConnections() != 1000)
+        return -1;
+    // Tombstone deletion keeps the indices valid, compaction renumbers
+    std::vector<std::pair<int, int>> Ring;
+    for (int i = 0; i < 6; ++i)
+    {
+        Ring.emplace_back(i, (i + 1) % 6);
+        Ring.emplace_back((i + 1) % 6, i);
+    }
+    cut::AdjacencyList RAL(Ring);
+    RAL.DeleteNode(1);
+    RAL.DeleteNode(4);
+    if (RAL.NumNodes() != 6 || !RAL.IsDeleted(4) || RAL.IsDeleted(3) || RAL.NumDeletedNodes() != 2)
+        return -1;
+    if (RAL.NumAdjacents(1) != 0 || RAL.NumConnections() != 8 || RAL.GetAdjacent(3, 0) != 2)
+        return -1;
+    // Deleted nodes are not reused while other nodes still point to them
+    int Fresh = RAL.NewNode();
+    if (Fresh != 6 || RAL.HasConnection(0, Fresh) || RAL.HasConnection(3, Fresh) || RAL.HasConnection(5, Fresh))
+        return -1;
+    RAL.PurgeDeleted();
+    if (RAL.NumConnections() != 4 || RAL.NumDeletedNodes() != 2 || RAL.HasConnection(0, 1) || RAL.HasConnection(3, 4))
+        return -1;
+    int Reused = RAL.NewNode();
+    if (Reused != 1 || RAL.IsDeleted(1) || RAL.NumAdjacents(1) != 0 || RAL.NumDeletedNodes() != 1)
+        return -1;
+    if (RAL.HasConnection(0, Reused) || RAL.HasConnection(2, Reused))
+        return -1;
+    RAL.AddAdjacent(1, 0);
+    std::vector<int> NewIdx = RAL.Compact();
+    if (RAL.NumNodes() != 6 || RAL.NumDeletedNodes() != 0 || NewIdx[4] != -1 || NewIdx[5] != 4 || NewIdx[6] != 5)
+        return -1;
+    // Node 0 keeps its connection to the old node 5 (now 4), node 1 points to 0
+    if (RAL.NumAdjacents(0) != 1 || RAL.GetAdjacent(0, 0) != 4 || RAL.GetAdjacent(1, 0) != 0)
+        return -1;
+    if (RAL.NumConnections() != 5)
+        return -1;
+
+    // The connection constructor keeps the first occurrence of each connection
+    cut::AdjacencyList DedupAL(Shuffled);
+    if (DedupAL.NumConnections() != SortedCAL.NumConnections())
+        return -1;
+    for (int i = 0; i < DedupAL.NumNodes(); ++i)
+    {
+        std::vector<int> Row(DedupAL.Neighbors(i).begin(), DedupAL.Neighbors(i).end());
+        std::sort(Row.begin(), Row.end());
+        if (!std::equal(Row.begin(), Row.end(), SortedCAL.Neighbors(i).begin()))
+            return -1;
+    }
+
+    // Reordering a shuffled grid brings the adjacents close to their nodes
+    const int Side = 60;
+    std::vector<int> Label(Side * Side);
+    for (int i = 0; i < Side * Side; ++i)
+        Label[i] = i;
+    std::shuffle(Label.begin(), Label.end(), std::mt19937(7));
+    std::vector<std::pair<int, int>> Grid;
+    for (int r = 0; r < Side; ++r)
+    {
+        for (int c = 0; c < Side; ++c)
+        {
+            int u = Label[r * Side + c];
+            if (c + 1 < Side)
+            {
+                Grid.emplace_back(u, Label[r * Side + c + 1]);
+                Grid.emplace_back(Label[r * Side + c + 1], u);
+            }
+            if (r + 1 < Side)
+            {
+                Grid.emplace_back(u, Label[(r + 1) * Side + c]);
+                Grid.emplace_back(Label[(r + 1) * Side + c], u);
+            }
+        }
+    }
+    auto Bandwidth = [](const cut::BaseAdjacencyList& L)
+    {
+        int B = 0;
+        for (int i = 0; i < L.NumNodes(); ++i)
+        {
+            for (int j : L.Neighbors(i))
+                B = std::max(B, std::abs(i - j));
+        }
+        return B;
+    };
+    cut::CompatAdjacencyList GridCAL(Grid);
+    cut::CompatAdjacencyList RCM(Grid);
+    cut::NodePermutation Perm = cut::Reorder(RCM);
+    std::cout << "Bandwidth " << Bandwidth(GridCAL) << " -> " << Bandwidth(RCM) << std::endl;
+    if (Bandwidth(RCM) > 2 * Side || RCM.NumConnections() != GridCAL.NumConnections())
+        return -1;
+    for (int n = 0; n < RCM.NumNodes(); ++n)
+    {
+        int o = Perm.NewToOld[n];
+        if (Perm.OldToNew[o] != n || RCM.NumAdjacents(n) != GridCAL.NumAdjacents(o))
+            return -1;
+        for (int j : GridCAL.Neighbors(o))
+        {
+            cut::Span<int> Row = RCM.Neighbors(n);
+            if (!std::binary_search(Row.begin(), Row.end(), Perm.OldToNew[j]))
+                return -1;
+        }
+    }
+    cut::NodePermutation BFSPerm = cut::ComputeOrdering(GridCAL, cut::BREADTH_FIRST);
+    if (BFSPerm.NewToOld[0] != 0 || Bandwidth(cut::Permute(GridCAL, BFSPerm)) > 2 * Side)
+        return -1;
+    // The weights of a reordered weighted list stay on their connections
+    {
+        auto WeightOf = [](int i, int j) { return 5.0 + 2 * ((i + j) % 3); };
+        cut::WeightedAdjacencyList<double> WGrid(GridCAL, WeightOf);
+        cut::NodePermutation WPerm = cut::Reorder(WGrid);
+        if (WGrid.NumConnections() != GridCAL.NumConnections())
+            return -1;
+        for (int n = 0; n < WGrid.NumNodes(); ++n)
+        {
+            std::pair<cut::Span<int>, cut::Span<double>> Row = WGrid.WeightedNeighbors(n);
+            for (size_t k = 0; k < Row.first.Size(); ++k)
+            {
+                if (Row.second[k] != WeightOf(WPerm.NewToOld[n], WPerm.NewToOld[Row.first[k]]))
+                    return -1;
+            }
+        }
+        try
+        {
+            cut::CompatAdjacencyList& Base = WGrid;
+            cut::Reorder(Base);
+            return -1;
+        }
+        catch(const cut::AssertionError& e) { }
+    }
+    cut::NodePermutation DegPerm = cut::ComputeOrdering(GridCAL, cut::DEGREE);
+    for (int n = 1; n < GridCAL.NumNodes(); ++n)
+    {
+        if (GridCAL.NumAdjacents(DegPerm.NewToOld[n - 1]) < GridCAL.NumAdjacents(DegPerm.NewToOld[n]))
+            return -1;
+    }
+
+    // The compressed list matches the sorted rows and shrinks the reordered grid
+    cut::CompressedAdjacencyList ZAL(GridCAL);
+    cut::CompressedAdjacencyList ZRCM(RCM);
+    if (ZAL.NumNodes() != GridCAL.NumNodes() || ZAL.NumConnections() != GridCAL.NumConnections())
+        return -1;
+    for (int i = 0; i < ZAL.NumNodes(); ++i)
+    {
+        cut::Span<int> Row = GridCAL.Neighbors(i);
+        cut::Span<int> ZRow = ZAL.Neighbors(i);
+        if (ZAL.NumAdjacents(i) != (int)Row.Size() || !std::equal(Row.begin(), Row.end(), ZRow.begin()))
+            return -1;
+        if (!std::equal(Row.begin(), Row.end(), ZAL.Row(i).begin()) || ZAL.GetAdjacent(i, Row.Size() - 1) != Row[Row.Size() - 1])
+            return -1;
+    }
+    for (int i = 0; i < ZRCM.NumNodes(); ++i)
+    {
+        if (!std::equal(RCM.Neighbors(i).begin(), RCM.Neighbors(i).end(), ZRCM.Row(i).begin()))
+            return -1;
+    }
+    std::cout << "Compression ratio " << ZAL.CompressionRatio() << " -> " << ZRCM.CompressionRatio() << std::endl;
+    if (ZRCM.CompressionRatio() <= ZAL.CompressionRatio() || ZRCM.CompressionRatio() <= 1.0)
+        return -1;
+    // Unsorted rows, negative gaps from the node and empty rows
+    cut::CompressedAdjacencyList ZSmall({ { 0, 9 }, { 0, 3 }, { 3, 0 }, { 3, 1000000 }, { 3, 3 } });
+    cut::CompressedAdjacencyList ZCopy;
+    ZCopy = std::move(ZSmall);
+    if (ZCopy.NumNodes() != 4 || ZCopy.NumAdjacents(1) != 0 || ZCopy.GetAdjacent(0, 0) != 3 || ZCopy.GetAdjacent(3, 2) != 1000000)
+        return -1;
+    if (ZSmall.NumNodes() != 0 || cut::CompatAdjacencyList(ZCopy).NumConnections() != 5)
+        return -1;
+
+    // Dynamic list against a list of sets, with random batches of insertions and
+    // deletions, automatic merges and explicit ones
+    {
+        std::mt19937 Gen(11);
+        const int DN = 500;
+        std::uniform_int_distribution<int> Node(0, DN - 1);
+        std::vector<std::pair<int, int>> Init;
+        for (int k = 0; k < 4 * DN; ++k)
+            Init.emplace_back(Node(Gen) / 2, Node(Gen));
+        cut::DynamicAdjacencyList DAL(Init, 200);
+        std::vector<std::set<int>> Ref(DN);
+        for (const std::pair<int, int>& c : Init)
+            Ref[c.first].insert(c.second);
+        if (DAL.NumNodes() > DN / 2)
+            return -1;
+        for (int Round = 0; Round < 50; ++Round)
+        {
+            std::vector<std::pair<int, int>> Ins, Del;
+            for (int k = 0; k < 20; ++k)
+            {
+                Ins.emplace_back(Node(Gen), Node(Gen));
+                int i = Node(Gen) / 2;
+                if (!Ref[i].empty())
+                    Del.emplace_back(i, *Ref[i].begin());
+            }
+            size_t NIns = 0, NDel = 0;
+            for (const std::pair<int, int>& c : Ins)
+                NIns += Ref[c.first].insert(c.second).second;
+            for (const std::pair<int, int>& c : Del)
+                NDel += Ref[c.first].erase(c.second);
+            if (DAL.AddConnections(Ins) != NIns || DAL.RemoveConnections(Del) != NDel)
+                return -1;
+            // Every few rounds the removed connections come back in a single batch
+            if (Round % 5 == 0)
+            {
+                size_t NBack = 0;
+                for (const std::pair<int, int>& c : Del)
+                    NBack += Ref[c.first].insert(c.second).second;
+                if (DAL.AddConnections(Del) != NBack)
+                    return -1;
+            }
+            if (DAL.RemoveConnection(0, DN) || DAL.AddConnection(Ins[0].first, Ins[0].second))
+                return -1;
+            if (Round == 25)
+                DAL.Merge();
+
+            int NConns = 0;
+            for (int i = 0; i < DAL.NumNodes(); ++i)
+            {
+                cut::Span<int> Row = DAL.Neighbors(i);
+                if ((int)Row.Size() != DAL.NumAdjacents(i) || Row.Size() != Ref[i].size())
+                    return -1;
+                if (!std::equal(Row.begin(), Row.end(), Ref[i].begin()))
+                    return -1;
+                std::vector<int> Visited;
+                DAL.ForEachAdjacent(i, [&](int j) { Visited.push_back(j); });
+                if (!std::equal(Visited.begin(), Visited.end(), Row.begin()) || Visited.size() != Row.Size())
+                    return -1;
+                if (!Ref[i].empty() && !DAL.HasConnection(i, *Ref[i].rbegin()))
+                    return -1;
+                for (size_t idx = 0; idx < Row.Size(); ++idx)
+                {
+                    if (DAL.GetAdjacent(i, idx) != Row[idx])
+                        return -1;
+                }
+                NConns += Row.Size();
+            }
+            if (NConns != DAL.NumConnections())
+                return -1;
+        }
+        if (DAL.NumMerges() < 2 || DAL.NumNodes() > DN)
+            return -1;
+
+        // Conversions see the merged rows
+        cut::CompatAdjacencyList Merged(DAL);
+        cut::DynamicAdjacencyList Copy(DAL);
+        cut::SetNumThreads(4);
+        Copy.Merge();
+        cut::SetNumThreads(1);
+        if (Copy.NumPendingEdits() != 0 || Merged.NumConnections() != DAL.NumConnections())
+            return -1;
+        for (int i = 0; i < DAL.NumNodes(); ++i)
+        {
+            if (!std::equal(Merged.Neighbors(i).begin(), Merged.Neighbors(i).end(), Ref[i].begin()))
+                return -1;
+            if (!std::equal(Copy.Neighbors(i).begin(), Copy.Neighbors(i).end(), Ref[i].begin()))
+                return -1;
+        }
+        cut::DynamicAdjacencyList Moved(std::move(Copy));
+        if (Copy.NumNodes() != 0 || Moved.NumConnections() != DAL.NumConnections())
+            return -1;
+    }
+
+    // The row kernels of every supported instruction set against the scalar ones
+    {
+        std::mt19937 Gen(13);
+        std::vector<std::vector<int>> Rows;
+        for (int Size : { 0, 1, 3, 4, 7, 8, 9, 16, 31, 64, 100, 1000, 5000 })
+        {
+            for (int Range : { 2, 4, 16 })
+            {
+                std::uniform_int_distribution<int> Value(0, Range * Size + 1);
+                std::set<int> Row;
+                while ((int)Row.size() < Size)
+                    Row.insert(Value(Gen));
+                Rows.emplace_back(Row.begin(), Row.end());
+            }
+        }
+        cut::SimdLevel Detected = cut::DetectSimdLevel();
+        if (cut::GetSimdLevel() != Detected)
+            return -1;
+        for (cut::SimdLevel Level : { cut::SimdLevel::Scalar, cut::SimdLevel::SSE2, cut::SimdLevel::AVX2, cut::SimdLevel::NEON })
+        {
+            cut::SimdLevel Applied = cut::SetSimdLevel(Level);
+            if (Applied != Level && Applied != cut::SimdLevel::Scalar)
+                return -1;
+            for (const std::vector<int>& A : Rows)
+            {
+                for (const std::vector<int>& B : Rows)
+                {
+                    std::vector<int> Expected;
+                    std::set_intersection(A.begin(), A.end(), B.begin(), B.end(), std::back_inserter(Expected));
+                    std::vector<int> Out(std::min(A.size(), B.size()) + 1, -1);
+                    size_t N = cut::IntersectSorted(A.data(), A.size(), B.data(), B.size(), Out.data());
+                    if (N != Expected.size() || !std::equal(Expected.begin(), Expected.end(), Out.begin()) || Out[N] != -1)
+                        return -1;
+                    if (cut::IntersectSortedCount(cut::Span<int>(B.data(), B.size()), cut::Span<int>(A.data(), A.size())) != N)
+                        return -1;
+                }
+                for (int x = -1; x <= (A.empty() ? 1 : A.back() + 1); x += 1 + (int)A.size() / 50)
+                {
+                    bool Expected = std::binary_search(A.begin(), A.end(), x);
+                    if (cut::Contains(A.data(), A.size(), x) != Expected || cut::SortedContains(A.data(), A.size(), x) != Expected)
+                        return -1;
+                }
+            }
+            std::vector<int> Offsets(1, 0);
+            for (const std::vector<int>& A : Rows)
+                Offsets.push_back(Offsets.back() + A.size());
+            std::vector<int> Deg(Rows.size());
+            cut::RowDegrees(Offsets.data(), Rows.size(), Deg.data());
+            for (size_t r = 0; r < Rows.size(); ++r)
+                if (Deg[r] != (int)Rows[r].size())
+                    return -1;
+        }
+        cut::SetSimdLevel(Detected);
+
+        // Triangles of a random graph, counted with the intersections of the rows
+        std::vector<std::pair<int, int>> Edges;
+        std::uniform_int_distribution<int> Node(0, 199);
+        for (int k = 0; k < 3000; ++k)
+        {
+            int i = Node(Gen), j = Node(Gen);
+            if (i != j)
+            {
+                Edges.emplace_back(i, j);
+                Edges.emplace_back(j, i);
+            }
+        }
+        cut::CompatAdjacencyList G(Edges);
+        cut::AdjacencyList UG(G);
+        size_t Triangles = 0, Expected = 0;
+        for (int i = 0; i < G.NumNodes(); ++i)
+        {
+            for (int j : G.Neighbors(i))
+            {
+                if (j <= i)
+                    continue;
+                Triangles += cut::IntersectSortedCount(G.Neighbors(i), G.Neighbors(j));
+                for (int k : G.Neighbors(i))
+                    Expected += UG.HasConnection(j, k);
+            }
+        }
+        if (Triangles != Expected || Triangles == 0)
+            return -1;
+        std::vector<int> GDeg = G.Degrees();
+        for (int i = 0; i < G.NumNodes(); ++i)
+        {
+            if (GDeg[i] != G.NumAdjacents(i) || !G.HasSortedConnection(i, G.GetAdjacent(i, 0)) || G.HasSortedConnection(i, i))
+                return -1;
+            if (G.HasConnection(i, i) || UG.HasConnection(i, i) || !G.HasConnection(i, G.GetAdjacent(i, GDeg[i] - 1)))
+                return -1;
+        }
+        if (G.HasConnection(-1, 0) || UG.HasConnection(G.NumNodes(), 0))
+            return -1;
+    }
+
+    // Negative indices are rejected by the construction, sequential and parallel
+#if CUT_CHECKS >= 2
+    for (int NT = 1; NT <= 4; NT += 3)
+    {
+        cut::SetNumThreads(NT);
+        try
+        {
+            cut::CompatAdjacencyList Neg({ { 0, 1 }, { 1, -2 }, { 2, 0 } });
+            return -1;
+        }
+        catch(const cut::OutOfBoundError& e) { }
+    }
+    cut::SetNumThreads(1);
+#endif
+
 
     return 0;
 }
\ No newline at end of file
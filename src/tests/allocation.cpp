@@ -10,7 +10,14 @@
  * @date        2023-10-09
  */
 #include <cut/memory/allocation.hpp>
+#include <cut/memory/arena.hpp>
+#include <cut/memory/pool.hpp>
+#include <cut/memory/aligned.hpp>
+#include <cut/parallel/parallel.hpp>
 #include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
 
 #define _N 1024
 
@@ -43,10 +50,151 @@ int main(int argc, const char* const argv[])
         CUTAssert(Array1[i] == Array2[i]);
     std::cout << "AllocCopy (hence Memcpy) behaving as expected." << std::endl;
 
-
-
     free(Array1);
     free(Array2);
 
+
+    // Arena allocations are aligned, and rewinding gives back the same memory
+    cut::Arena A(4096);
+    char* c = A.Malloc<char>(3);
+    double* d = A.Malloc<double>(5);
+    CUTAssert(c != nullptr);
+    CUTAssert(((uintptr_t)d % alignof(double)) == 0);
+    void* v = A.Allocate(100, 64);
+    CUTAssert(((uintptr_t)v % 64) == 0);
+    cut::Arena::Marker M = A.Mark();
+    size_t Allocated = A.BytesAllocated();
+    int* i1 = A.Malloc<int>(10);
+    A.Rewind(M);
+    CUTAssert(A.BytesAllocated() == Allocated);
+    int* i2 = A.Malloc<int>(10);
+    CUTAssert(i1 == i2);
+    // Large allocations get a block of their own, and are reused after a reset
+    char* Big = A.Malloc<char>(10000);
+    Big[9999] = 1;
+    size_t Reserved = A.BytesReserved();
+    CUTAssert(Reserved >= 4096 + 10000);
+    A.Reset();
+    CUTAssert(A.BytesAllocated() == 0);
+    for (int k = 0; k < 30; ++k)
+        A.Malloc<char>(100);
+    A.Malloc<char>(10000);
+    CUTAssert(A.BytesReserved() == Reserved);
+    std::cout << "Arena behaving as expected." << std::endl;
+
+    // Released blocks are reused by the next allocations of the same class
+    void* b1 = A.AllocateBlock(40);
+    A.ReleaseBlock(b1, 40);
+    void* b2 = A.AllocateBlock(60);
+    CUTAssert(b1 == b2);
+    void* b3 = A.AllocateBlock(40);
+    CUTAssert(b3 != b2);
+    // A larger released block is split for the smaller classes
+    char* b4 = (char*)A.AllocateBlock(256);
+    A.ReleaseBlock(b4, 256);
+    void* b5 = A.AllocateBlock(64);
+    void* b6 = A.AllocateBlock(128);
+    void* b7 = A.AllocateBlock(50);
+    CUTAssert(b5 == b4 && b6 == b4 + 128 && b7 == b4 + 64);
+    std::cout << "Arena blocks behaving as expected." << std::endl;
+
+    // Containers sharing an arena
+    {
+        cut::Arena RowArena;
+        cut::ArenaAllocator<int> Alloc(RowArena);
+        typedef std::vector<int, cut::ArenaAllocator<int>> Row;
+        std::vector<Row> Rows(N, Row(Alloc));
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j <= i % 37; ++j)
+                Rows[i].push_back(i + j);
+        }
+        for (int i = 0; i < N; ++i)
+        {
+            CUTAssert(Rows[i].get_allocator() == Alloc);
+            CUTAssert((int)Rows[i].size() == i % 37 + 1);
+            for (int j = 0; j <= i % 37; ++j)
+                CUTAssert(Rows[i][j] == i + j);
+        }
+        // Growing and shrinking the rows recycles the memory of the arena
+        size_t Peak = RowArena.BytesAllocated();
+        for (int r = 0; r < 10; ++r)
+        {
+            for (Row& R : Rows)
+                Row(Alloc).swap(R);
+            for (int i = 0; i < N; ++i)
+                Rows[i].assign(i % 37 + 1, i);
+        }
+        CUTAssert(RowArena.BytesAllocated() <= 2 * Peak);
+    }
+    std::cout << "ArenaAllocator behaving as expected." << std::endl;
+
+    // Pools reuse the slots of the deleted objects
+    {
+        cut::ObjectPool<std::string> Pool(4);
+        std::vector<std::string*> Objs;
+        for (int i = 0; i < 100; ++i)
+            Objs.push_back(Pool.New(std::to_string(i)));
+        CUTAssert(Pool.Size() == 100);
+        CUTAssert(Pool.Capacity() >= 100);
+        for (int i = 0; i < 100; ++i)
+            CUTAssert(*Objs[i] == std::to_string(i));
+        size_t Capacity = Pool.Capacity();
+        std::string* Last = Objs.back();
+        Pool.Delete(Last);
+        Objs.pop_back();
+        std::string* Reused = Pool.New("reused");
+        CUTAssert(Reused == Last);
+        CUTAssert(*Last == "reused");
+        Objs.push_back(Reused);
+        for (std::string* S : Objs)
+            Pool.Delete(S);
+        CUTAssert(Pool.Size() == 0);
+        for (int i = 0; i < 100; ++i)
+            Objs[i] = Pool.New("again");
+        CUTAssert(Pool.Capacity() == Capacity);
+        for (std::string* S : Objs)
+            Pool.Delete(S);
+    }
+    std::cout << "ObjectPool behaving as expected." << std::endl;
+
+    // Aligned allocations, with all the placement policies
+    {
+        std::vector<cut::MemoryPolicy> Policies;
+        Policies.push_back(cut::MemoryPolicy());
+        Policies.push_back(cut::MemoryPolicy(16));
+        Policies.push_back(cut::MemoryPolicy(4096));
+        Policies.push_back(cut::MemoryPolicy(cut::CacheLineSize, true));
+        Policies.push_back(cut::MemoryPolicy(cut::CacheLineSize, false, 0));
+        Policies.push_back(cut::MemoryPolicy(cut::CacheLineSize, true, cut::NumNumaNodes() - 1, true));
+        cut::SetNumThreads(4);
+        for (const cut::MemoryPolicy& P : Policies)
+        {
+            for (size_t Size : { (size_t)1, (size_t)N, (size_t)(3 << 20) })
+            {
+                int* Aligned = cut::AlignedCalloc<int>(Size, P);
+                CUTAssert(((uintptr_t)Aligned % P.Alignment) == 0);
+                for (size_t i = 0; i < Size; ++i)
+                    CUTAssert(Aligned[i] == 0);
+                Aligned[Size - 1] = 1;
+                int* Copy = cut::AlignedAllocCopy(Aligned, Size, P);
+                CUTAssert(Copy[Size - 1] == 1);
+                cut::AlignedFree(Aligned);
+                cut::AlignedFree(Copy);
+            }
+        }
+        cut::SetNumThreads(1);
+
+        std::vector<double, cut::AlignedAllocator<double>> V(N, 1.0);
+        CUTAssert(((uintptr_t)V.data() % cut::CacheLineSize) == 0);
+        std::vector<double, cut::AlignedAllocator<double>> W(cut::AlignedAllocator<double>(cut::MemoryPolicy(256)));
+        W = V;
+        CUTAssert(W == V);
+        V.swap(W);
+        CUTAssert(V.get_allocator().Policy().Alignment == 256);
+        std::cout << "NUMA nodes: " << cut::NumNumaNodes() << std::endl;
+    }
+    std::cout << "Aligned allocations behaving as expected." << std::endl;
+
     return 0;
 }
\ No newline at end of file
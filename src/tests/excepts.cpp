@@ -11,6 +11,7 @@
  */
 #include <cut/excepts/excepts.hpp>
 #include <iostream>
+#include <string>
 
 int main(int argc, const char* const argv[])
 {
@@ -54,6 +55,79 @@ int main(int argc, const char* const argv[])
     {
         std::cout << "  " << e.what() << std::endl;
     }
+    std::cout << std::endl;
+
+    // The messages are formatted when read, and survive copies
+#if CUT_CHECKS >= 2
+    try
+    {
+        CUTCheckLess(argc, 1);
+        return -1;
+    }
+    catch(const cut::CheckException& e)
+    {
+        if (e.Line() != __LINE__ - 5 || std::string(e.Code()) != "(argc) < (1)")
+            return -1;
+        cut::OutOfBoundError Copy(dynamic_cast<const cut::OutOfBoundError&>(e));
+        std::string Expected = std::string("Bound violated at ") + __FILE__ + ':' + std::to_string(e.Line()) + ". ( (argc) < (1) )";
+        if (Expected != e.what() || Expected != Copy.what())
+            return -1;
+    }
+#endif
+    try
+    {
+        throw cut::AssertionError("Custom message.");
+    }
+    catch(const cut::CheckException& e)
+    {
+        if (std::string(e.what()) != "Custom message." || e.Code() != nullptr)
+            return -1;
+    }
+
+    // Failed checks recorded without throwing
+    std::cout << "Testing cut::CheckStatus." << std::endl;
+    cut::CheckStatus Status;
+    int Values[] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    for (int i = 0; i < 8; ++i)
+    {
+        CUTCheckLessStatus(Values[i], 10, Status);
+        CUTAssertStatus(Values[i] > 0, Status);
+    }
+    if (!Status || Status.Code() != cut::CheckCode::CHECK_OK)
+        return -1;
+    Status.Raise();
+    for (int i = 0; i < 8; ++i)
+    {
+        CUTCheckLessStatus(Values[i], 5, Status);
+        CUTCheckNullStatus(argv, Status);
+    }
+#if CUT_CHECKS >= 2
+    if (Status.Ok() || Status.Code() != cut::CheckCode::CHECK_BOUND || std::string(Status.Expression()) != "(Values[i]) < (5)")
+        return -1;
+    CUTCheckNullStatus(nullptr, Status);
+    if (Status.Code() != cut::CheckCode::CHECK_BOUND)
+        return -1;
+    try
+    {
+        Status.Raise();
+        return -1;
+    }
+    catch(const cut::OutOfBoundError& e)
+    {
+        std::cout << "  " << e.what() << std::endl;
+    }
+#endif
+    Status.Clear();
+    CUTCheckNullStatus(nullptr, Status);
+    try
+    {
+        Status.Raise();
+        return -1;
+    }
+    catch(const cut::NullPtrError& e)
+    {
+        std::cout << "  " << e.what() << std::endl;
+    }
     
 
 
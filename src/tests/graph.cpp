@@ -0,0 +1,385 @@
+/**
+ * @file        graph.cpp
+ * 
+ * @brief       Application to test the graph algorithms.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-29
+ */
+#include <cut/algo/graph.hpp>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/wadjlist.hpp>
+#include <cut/algo/madjlist.hpp>
+#include <cut/algo/partition.hpp>
+#include <cut/parallel/parallel.hpp>
+#include <iostream>
+#include <random>
+#include <queue>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+
+// Reference breadth-first search
+std::vector<int> SimpleBFS(const cut::BaseAdjacencyList& G, int Source)
+{
+    std::vector<int> Depth(G.NumNodes(), -1);
+    std::queue<int> Q;
+    Depth[Source] = 0;
+    Q.push(Source);
+    while (!Q.empty())
+    {
+        int u = Q.front();
+        Q.pop();
+        for (int v : G.Neighbors(u))
+        {
+            if (Depth[v] < 0)
+            {
+                Depth[v] = Depth[u] + 1;
+                Q.push(v);
+            }
+        }
+    }
+    return Depth;
+}
+
+
+int main(int argc, const char* const argv[])
+{
+    // Random symmetric graph, with a few isolated nodes
+    const int N = 20000;
+    std::mt19937 Gen(0);
+    std::uniform_int_distribution<int> Node(0, N - 100);
+    std::vector<std::pair<int, int>> Pairs;
+    for (int i = 0; i < 4 * N; ++i)
+    {
+        int u = Node(Gen), v = Node(Gen);
+        Pairs.emplace_back(u, v);
+        Pairs.emplace_back(v, u);
+    }
+    Pairs.emplace_back(N - 1, N - 1);
+    cut::CompatAdjacencyList G(Pairs);
+    // Weight of each connection, stored in CSR order
+    std::vector<double> Weights(G.NumConnections());
+    std::vector<int> Offset(G.NumNodes() + 1, 0);
+    for (int i = 0; i < G.NumNodes(); ++i)
+        Offset[i + 1] = Offset[i] + G.NumAdjacents(i);
+    for (int i = 0; i < G.NumNodes(); ++i)
+    {
+        // Symmetric weights, so that the graph stays undirected
+        for (int k = 0; k < G.NumAdjacents(i); ++k)
+            Weights[Offset[i] + k] = 1 + (std::min(i, G.GetAdjacent(i, k)) * 7 + std::max(i, G.GetAdjacent(i, k))) % 10;
+    }
+    auto W = [&](int i, int k) { return Weights[Offset[i] + k]; };
+
+    // The weighted list stores the same weights next to the structure
+    cut::WeightedAdjacencyList<double> WG(G, [](int i, int j) { return 1 + (std::min(i, j) * 7 + std::max(i, j)) % 10; });
+    if (WG.AllWeights() != Weights)
+        return -1;
+    for (int i = 0; i < N; ++i)
+    {
+        std::pair<cut::Span<int>, cut::Span<double>> Row = WG.WeightedNeighbors(i);
+        if (Row.first.Size() != Row.second.Size() || Row.first.Size() != (size_t)G.NumAdjacents(i))
+            return -1;
+    }
+    // Building from weighted pairs keeps the lightest of the duplicates
+    cut::WeightedAdjacencyList<float> Dup({ { 0, 2 }, { 0, 1 }, { 0, 2 }, { 1, 0 } }, { 5.0f, 3.0f, 2.0f, 3.0f });
+    if (Dup.NumConnections() != 3 || Dup.GetAdjacent(0, 1) != 2 || Dup.GetWeight(0, 1) != 2.0f || Dup.GetWeight(0, 0) != 3.0f)
+        return -1;
+    // Presorted rows keep their weights, and the statistics match the unweighted build
+    cut::CSRBuildStats WStats;
+    cut::WeightedAdjacencyList<float> Presorted({ { 0, 1 }, { 0, 1 }, { 0, 3 }, { 2, 0 } }, { 4.0f, 6.0f, 1.0f, 2.0f }, true, &WStats);
+    if (WStats.NumSortedRows != 0 || WStats.NumDuplicates != 1 || Presorted.GetWeight(0, 0) != 4.0f || Presorted.GetWeight(2, 0) != 2.0f)
+        return -1;
+#if CUT_CHECKS >= 2
+    // Weighted and unweighted lists reject negative indices in the same way
+    try
+    {
+        cut::WeightedAdjacencyList<float> Bad({ { 0, 1 }, { -3, 2 }, { 1, 0 } }, { 1.0f, 1.0f, 1.0f });
+        return -1;
+    }
+    catch (const cut::OutOfBoundError&) { }
+    try
+    {
+        cut::CompatAdjacencyList Bad({ { 0, 1 }, { -3, 2 }, { 1, 0 } });
+        return -1;
+    }
+    catch (const cut::OutOfBoundError&) { }
+#endif
+    cut::CompatAdjacencyList Unweighted(Pairs);
+    Dup = Unweighted;
+    if (Dup.NumConnections() != G.NumConnections() || Dup.Weights(0).Size() != (size_t)G.NumAdjacents(0) || Dup.GetWeight(0, 0) != 1.0f)
+        return -1;
+
+    std::vector<int> Ref = SimpleBFS(G, 0);
+    cut::GraphSearch GS;
+    for (int NT : { 1, 4 })
+    {
+        cut::SetNumThreads(NT);
+        std::cout << "Running with " << NT << " threads." << std::endl;
+
+        // Top-down and direction-optimizing searches must match the reference
+        std::vector<int> Depth;
+        int Reached = GS.BFS(G, 0, Depth);
+        if (Depth != Ref)
+            return -1;
+        if (GS.BFS(G, 0, Depth, &G) != Reached || Depth != Ref)
+            return -1;
+        if (Depth[N - 1] != cut::GraphSearch::Unreached)
+            return -1;
+        std::cout << "BFS reached " << Reached << " nodes." << std::endl;
+
+        // Unit weights give the depths
+        std::vector<double> Dist;
+        GS.Dijkstra(G, 0, cut::UnitWeight(), Dist);
+        for (int i = 0; i < N; ++i)
+        {
+            if ((Ref[i] < 0 && !std::isinf(Dist[i])) || (Ref[i] >= 0 && Dist[i] != Ref[i]))
+                return -1;
+        }
+
+        // Delta-stepping must agree with Dijkstra for any bucket width
+        std::vector<int> Pred;
+        GS.Dijkstra(G, 0, W, Dist, &Pred);
+        for (double Delta : { 1.0, 3.0, 100.0, 1e-9 })
+        {
+            std::vector<double> DSDist;
+            GS.DeltaStepping(G, 0, W, Delta, DSDist);
+            if (DSDist != Dist)
+                return -1;
+        }
+        // Negative weights are rejected rather than turned into bucket indices
+        try
+        {
+            std::vector<double> DSDist;
+            GS.DeltaStepping(G, 0, [](int, int) { return -1.0; }, 1.0, DSDist);
+            return -1;
+        }
+        catch (const cut::OutOfBoundError&) { }
+        // Bucket indices that do not fit 64 bits are rejected
+        try
+        {
+            std::vector<double> DSDist;
+            GS.DeltaStepping(G, 0, W, 1e-300, DSDist);
+            return -1;
+        }
+        catch (const cut::OutOfBoundError&) { }
+        // Weights read from the weighted list give the same distances
+        std::vector<double> WDist;
+        GS.Dijkstra(WG, 0, WG.EdgeWeights(), WDist);
+        if (WDist != Dist)
+            return -1;
+        GS.DeltaStepping(WG, 0, WG.EdgeWeights(), 3.0, WDist);
+        if (WDist != Dist)
+            return -1;
+        // The relaxed queue must converge to the same distances
+        GS.ParallelDijkstra(G, 0, W, WDist);
+        if (WDist != Dist)
+            return -1;
+        GS.ParallelDijkstra(WG, N - 1, WG.EdgeWeights(), WDist);
+        if (WDist[N - 1] != 0 || !std::isinf(WDist[0]))
+            return -1;
+        // Predecessors must form shortest paths
+        for (int v = 1; v < N; ++v)
+        {
+            if (Pred[v] < 0)
+                continue;
+            bool Found = false;
+            for (int k = 0; k < G.NumAdjacents(Pred[v]); ++k)
+                Found |= G.GetAdjacent(Pred[v], k) == v && Dist[Pred[v]] + W(Pred[v], k) == Dist[v];
+            if (!Found)
+                return -1;
+        }
+        std::cout << "Shortest paths agree." << std::endl;
+    }
+    cut::SetNumThreads(1);
+
+    // Label propagation cuts a shuffled grid much better than the ranges of its indices
+    {
+        const int Side = 60;
+        std::vector<int> Shuffle(Side * Side);
+        for (int v = 0; v < Side * Side; ++v)
+            Shuffle[v] = v;
+        std::shuffle(Shuffle.begin(), Shuffle.end(), Gen);
+        std::vector<std::pair<int, int>> Grid;
+        for (int r = 0; r < Side; ++r)
+        {
+            for (int c = 0; c < Side; ++c)
+            {
+                int v = Shuffle[r * Side + c];
+                if (c + 1 < Side)
+                {
+                    Grid.emplace_back(v, Shuffle[r * Side + c + 1]);
+                    Grid.emplace_back(Shuffle[r * Side + c + 1], v);
+                }
+                if (r + 1 < Side)
+                {
+                    Grid.emplace_back(v, Shuffle[(r + 1) * Side + c]);
+                    Grid.emplace_back(Shuffle[(r + 1) * Side + c], v);
+                }
+            }
+        }
+        cut::CompatAdjacencyList GG(Grid);
+        const int NParts = 4;
+        std::vector<int> RangeOwner = cut::ComputePartition(GG, NParts, cut::RANGE_PARTITION);
+        std::vector<int> LPOwner = cut::ComputePartition(GG, NParts, cut::LABEL_PROPAGATION, 20);
+        size_t RangeCut = cut::EdgeCut(GG, RangeOwner);
+        size_t LPCut = cut::EdgeCut(GG, LPOwner);
+        std::vector<int> RangeSize(NParts, 0), LPSize(NParts, 0);
+        for (int v = 0; v < GG.NumNodes(); ++v)
+        {
+            RangeSize[RangeOwner[v]] += GG.NumAdjacents(v) + 1;
+            LPSize[LPOwner[v]] += GG.NumAdjacents(v) + 1;
+            if (v > 0 && RangeOwner[v] < RangeOwner[v - 1])
+                return -1;
+        }
+        double AvgLoad = (GG.NumConnections() + GG.NumNodes()) / (double)NParts;
+        for (int p = 0; p < NParts; ++p)
+        {
+            if (std::abs(RangeSize[p] - AvgLoad) > 5 || LPSize[p] > 1.05 * AvgLoad)
+                return -1;
+        }
+        if (2 * LPCut > RangeCut)
+            return -1;
+        std::cout << "Grid cut: " << RangeCut << " by ranges, " << LPCut << " by label propagation." << std::endl;
+    }
+
+    // A breadth-first search over the shards, exchanging the halos at each level
+    cut::SetNumThreads(4);
+    {
+        const int NParts = 5;
+        cut::PartitionedGraph PG(G, NParts);
+        cut::SetNumThreads(1);
+        if (PG.NumParts() != NParts || PG.NumNodes() != G.NumNodes())
+            return -1;
+        // Owners outside the parts are rejected, at any check level
+        try
+        {
+            std::vector<int> BadOwner(G.NumNodes(), 0);
+            BadOwner.back() = NParts;
+            cut::PartitionedGraph Bad(G, BadOwner, NParts);
+            return -1;
+        }
+        catch (const cut::OutOfBoundError&) { }
+        int NOwned = 0;
+        for (int p = 0; p < NParts; ++p)
+        {
+            const cut::GraphShard& S = PG.Shard(p);
+            NOwned += S.NumOwned();
+            if (S.Local().NumNodes() != S.NumLocal() || S.NumLocal() != S.NumOwned() + S.NumGhosts())
+                return -1;
+            for (int l = 0; l < S.NumLocal(); ++l)
+            {
+                int g = S.ToGlobal(l);
+                if (S.ToLocal(g) != l || S.IsGhost(l) != (l >= S.NumOwned()))
+                    return -1;
+                if ((S.IsGhost(l) ? S.GhostOwner(l) : p) != PG.Owner(g))
+                    return -1;
+                if (S.IsGhost(l) && S.Local().NumAdjacents(l) != 0)
+                    return -1;
+                if (S.IsGhost(l))
+                    continue;
+                std::vector<int> Row;
+                for (int j : S.Local().Neighbors(l))
+                    Row.push_back(S.ToGlobal(j));
+                std::sort(Row.begin(), Row.end());
+                if (!std::equal(Row.begin(), Row.end(), G.Neighbors(g).begin()) || Row.size() != G.Neighbors(g).Size())
+                    return -1;
+            }
+            if (S.ToLocal(-1) != -1 || S.SendList(p).Size() != 0 || S.RecvList(p).Size() != 0)
+                return -1;
+        }
+        if (NOwned != G.NumNodes())
+            return -1;
+
+        // Written and mapped back shard by shard
+        PG.Save("graph");
+        std::vector<cut::GraphShard> Mapped;
+        for (int p = 0; p < NParts; ++p)
+            Mapped.emplace_back(cut::PartitionedGraph::ShardFilename("graph", p));
+        cut::MappedAdjacencyList AsList(cut::PartitionedGraph::ShardFilename("graph", 0));
+        if (AsList.NumNodes() != PG.Shard(0).NumLocal() || AsList.NumConnections() != PG.Shard(0).Local().NumConnections())
+            return -1;
+        for (int p = 0; p < NParts; ++p)
+        {
+            const cut::GraphShard& S = PG.Shard(p);
+            const cut::GraphShard& M = Mapped[p];
+            if (M.Part() != p || M.NumParts() != NParts || M.NumOwned() != S.NumOwned() || M.NumLocal() != S.NumLocal())
+                return -1;
+            for (int l = 0; l < S.NumLocal(); ++l)
+            {
+                if (M.ToGlobal(l) != S.ToGlobal(l) || M.Local().NumAdjacents(l) != S.Local().NumAdjacents(l))
+                    return -1;
+                if (!std::equal(S.Local().Neighbors(l).begin(), S.Local().Neighbors(l).end(), M.Local().Neighbors(l).begin()))
+                    return -1;
+            }
+            for (int q = 0; q < NParts; ++q)
+            {
+                if (!std::equal(S.SendList(q).begin(), S.SendList(q).end(), M.SendList(q).begin()) || S.SendList(q).Size() != M.SendList(q).Size())
+                    return -1;
+                if (!std::equal(S.RecvList(q).begin(), S.RecvList(q).end(), M.RecvList(q).begin()) || S.RecvList(q).Size() != M.RecvList(q).Size())
+                    return -1;
+            }
+        }
+        for (int p = 0; p < NParts; ++p)
+            std::remove(cut::PartitionedGraph::ShardFilename("graph", p).c_str());
+
+        // Pull-based search on the mapped shards: the owners refresh the ghosts, then
+        // the unvisited owned nodes with an adjacent in the last level join the next one
+        std::vector<std::vector<int>> Depth(NParts);
+        for (int p = 0; p < NParts; ++p)
+            Depth[p].assign(Mapped[p].NumLocal(), -1);
+        int Src = Mapped[PG.Owner(0)].ToLocal(0);
+        Depth[PG.Owner(0)][Src] = 0;
+        std::vector<int> Buffer;
+        for (int Level = 0; ; ++Level)
+        {
+            for (int p = 0; p < NParts; ++p)
+            {
+                for (int q = 0; q < NParts; ++q)
+                {
+                    Buffer.resize(Mapped[p].SendList(q).Size());
+                    Mapped[p].PackHalo(q, Depth[p].data(), Buffer.data());
+                    if (Buffer.size() != Mapped[q].RecvList(p).Size())
+                        return -1;
+                    Mapped[q].UnpackHalo(p, Buffer.data(), Depth[q].data());
+                }
+            }
+            bool Changed = false;
+            for (int p = 0; p < NParts; ++p)
+            {
+                for (int l = 0; l < Mapped[p].NumOwned(); ++l)
+                {
+                    if (Depth[p][l] >= 0)
+                        continue;
+                    for (int j : Mapped[p].Local().Neighbors(l))
+                    {
+                        if (Depth[p][j] == Level)
+                        {
+                            Depth[p][l] = Level + 1;
+                            Changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (!Changed)
+                break;
+        }
+        std::vector<int> Expected = SimpleBFS(G, 0);
+        for (int p = 0; p < NParts; ++p)
+        {
+            for (int l = 0; l < Mapped[p].NumLocal(); ++l)
+            {
+                if (Depth[p][l] != Expected[Mapped[p].ToGlobal(l)])
+                    return -1;
+            }
+        }
+        std::cout << "Sharded search agrees." << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -10,6 +10,30 @@
  * @date        2023-10-24
  */
 #include <cut/log.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+
+// Count the lines of a file, and those containing the given text
+size_t CountLines(const std::string& Filename, const std::string& Text, size_t& Matching)
+{
+    std::ifstream In(Filename);
+    std::string Line;
+    size_t N = 0;
+    Matching = 0;
+    while (std::getline(In, Line))
+    {
+        N++;
+        if (Line.find(Text) != std::string::npos)
+            Matching++;
+    }
+    return N;
+}
 
 
 int main(int argc, const char* const argv[])
@@ -44,6 +68,110 @@ int main(int argc, const char* const argv[])
     cut::Logger::GetLogger("second").Error("This is an error.");
     
 
+    // Asynchronous logging from several threads loses nothing when blocking
+    const int NThreads = 4;
+    const int NMsgs = 2000;
+    cut::Logger::AttachLogger("async", "async.log");
+    cut::Logger& Async = cut::Logger::GetLogger("async");
+    Async.StartAsync(64, std::chrono::milliseconds(10), cut::LogOverflow::LOG_BLOCK);
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < NThreads; ++t)
+    {
+        Threads.emplace_back([&Async, t, NMsgs]()
+        {
+            for (int i = 0; i < NMsgs; ++i)
+                Async.Message("Thread " + std::to_string(t) + " message " + std::to_string(i));
+        });
+    }
+    for (std::thread& th : Threads)
+        th.join();
+    Async.Flush();
+    size_t Matching;
+    if (CountLines("async.log", "(MESSAGE): Thread ", Matching) != NThreads * NMsgs || Matching != NThreads * NMsgs)
+        return -1;
+    if (Async.NumDropped() != 0)
+        return -1;
+
+    // Dropped messages are counted and reported
+    Async.StopAsync();
+    Async.StartAsync(4, std::chrono::milliseconds(10), cut::LogOverflow::LOG_DROP_COUNT);
+    for (int i = 0; i < NMsgs; ++i)
+        Async.Warning("Burst " + std::to_string(i));
+    size_t Dropped = Async.NumDropped();
+    Async.StopAsync();
+    size_t Reports;
+    size_t Total = CountLines("async.log", "messages dropped.", Reports);
+    if (Total - NThreads * NMsgs - Reports + Dropped != NMsgs || (Dropped > 0 && Reports == 0))
+        return -1;
+    std::cout << Dropped << " messages dropped in " << Reports << " reports." << std::endl;
+    cut::Logger::DeleteLogger("async");
+
+    // Threads attach and look up loggers concurrently, and lines never interleave
+    cut::Logger::AttachLogger("shared", "shared.log");
+    Threads.clear();
+    for (int t = 0; t < NThreads; ++t)
+    {
+        Threads.emplace_back([t, NMsgs]()
+        {
+            std::string Own = "own" + std::to_string(t);
+            cut::Logger::AttachLogger(Own, Own + ".log", cut::LogType::ALL, false);
+            for (int i = 0; i < NMsgs; ++i)
+            {
+                cut::Logger::GetLogger("shared").Message("Thread " + std::to_string(t) + " message " + std::to_string(i));
+                cut::Logger::GetLogger(Own).Message("Line " + std::to_string(i));
+            }
+            cut::Logger::DeleteLogger(Own);
+        });
+    }
+    // Switching to asynchronous mode while the threads are logging loses no line
+    cut::Logger::GetLogger("shared").StartAsync();
+    for (std::thread& th : Threads)
+        th.join();
+    cut::Logger::GetLogger("shared").Flush();
+    if (CountLines("shared.log", "(MESSAGE): Thread ", Matching) != NThreads * NMsgs || Matching != NThreads * NMsgs)
+        return -1;
+    if (CountLines("own0.log", "(MESSAGE): Line ", Matching) != NMsgs || Matching != NMsgs)
+        return -1;
+    cut::Logger::DeleteLogger("shared");
+
+    // Timestamps with milliseconds
+    cut::Logger::AttachLogger("precise", "precise.log");
+    cut::Logger::GetLogger("precise").SetTimestampPrecision(cut::TimerPrecision::MILLISECONDS);
+    cut::Logger::GetLogger("precise").Message("Precise message.");
+    cut::Logger::DeleteLogger("precise");
+    {
+        std::ifstream In("precise.log");
+        std::string Line;
+        std::getline(In, Line);
+        if (Line.size() != 24 + std::string("(MESSAGE): Precise message.").size() || Line[19] != '.' || Line[23] != ' ')
+            return -1;
+    }
+
+    // A deleted logger writes its file at once, even while another thread has it cached
+    cut::Logger::AttachLogger("cached", "cached.log");
+    cut::Logger::GetLogger("cached").StartAsync();
+    std::atomic<int> Step(0);
+    std::thread Holder([&Step]()
+    {
+        cut::Logger::GetLogger("cached").Message("Cached message.");
+        Step.store(1);
+        while (Step.load() != 2)
+            std::this_thread::yield();
+    });
+    while (Step.load() != 1)
+        std::this_thread::yield();
+    cut::Logger::DeleteLogger("cached");
+    bool Written = CountLines("cached.log", "(MESSAGE): Cached message.", Matching) == 1 && Matching == 1;
+    Step.store(2);
+    Holder.join();
+    if (!Written)
+        return -1;
+    try
+    {
+        cut::Logger::GetLogger("cached");
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
 
 
     return 0;
@@ -10,8 +10,12 @@
  * @date        2023-10-25
  */
 #include <cut/algo/minheap.hpp>
+#include <cut/algo/dheap.hpp>
+#include <cut/algo/radixheap.hpp>
 #include <vector>
+#include <algorithm>
 #include <random>
+#include <cmath>
 #include <iostream>
 
 std::mt19937 Eng(0);
@@ -31,6 +35,26 @@ void Fill(std::vector<double>& Vector, size_t NElems)
         Vector[i] = i;
 }
 
+// Run the same monotone sequence of operations on any heap, returning the extracted keys
+template<typename Heap>
+std::vector<double> MonotoneRun(Heap& H, size_t NElems)
+{
+    std::mt19937 Gen(1);
+    std::uniform_int_distribution<int> Dist(0, 1 << 20);
+    for (size_t i = 0; i < NElems; ++i)
+        H.Push(i, Dist(Gen));
+    std::vector<double> Keys;
+    while (!H.Empty())
+    {
+        double Last = H.ExtractMin().first;
+        Keys.push_back(Last);
+        // Decrease a random element, but never below the last extracted key
+        size_t e = Gen() % NElems;
+        if (H.Contains(e) && H.GetKey(e) > Last)
+            H.DecreaseKey(e, std::floor((H.GetKey(e) - Last) / 2));
+    }
+    return Keys;
+}
 
 int main(int argc, const char* const argv[])
 {
@@ -60,6 +84,8 @@ int main(int argc, const char* const argv[])
     Shuffle(V);
     cut::MinHeap H2(V);
     std::cout << "Done." << std::endl;
+    if (H2.FindMin().first != 0 || V[H2.FindMin().second] != 0)
+        return -1;
     std::cout << "Min key:     " << H2.FindMin().first << std::endl;
     std::cout << "Min element: " << H2.FindMin().second << std::endl;
     std::cout << "Decreasing element 655 to make it the minimum... ";
@@ -92,4 +118,127 @@ int main(int argc, const char* const argv[])
     std::cout << "Done." << std::endl;
     std::cout << "Max key:     " << H3.FindMin().first << std::endl;
     std::cout << "Max element: " << H3.FindMin().second << std::endl;
+    if (H3.FindMinUnchecked() != H3.FindMin() || H3.GetKeyUnchecked(250) != H3.GetKey(250))
+        return -1;
+
+    // Extracting all the elements must return them in order
+    std::cout << std::endl;
+    std::cout << "Extracting all the elements from the min-heap... ";
+    cut::MinHeap H4(V);
+    double Last = -1;
+    while (H4.Size() > 0)
+    {
+        std::pair<double, size_t> Min = H4.ExtractMin();
+        if (Min.first < Last || H4.Contains(Min.second) || V[Min.second] != Min.first)
+            return -1;
+        Last = Min.first;
+    }
+    std::cout << "Done." << std::endl;
+
+    // Reuse the same heap for many queries
+    std::cout << "Pushing and popping on a reused heap... ";
+    cut::MinHeap H5;
+    H5.Reserve(V.size());
+    for (int q = 0; q < 10; ++q)
+    {
+        for (size_t i = q; i < V.size(); i += 3)
+            H5.Push(i, V[i]);
+        if (!H5.Contains(q) || H5.Contains(q + 1) || H5.GetKey(q) != V[q])
+            return -1;
+        H5.DecreaseKey(q, 2048);
+        if (H5.ExtractMin().second != (size_t)q)
+            return -1;
+        H5.Push(q, V[q]);
+        H5.Clear();
+        if (H5.Size() != 0 || H5.Contains(q))
+            return -1;
+    }
+    std::cout << "Done." << std::endl;
+
+    // The d-ary heaps must agree with the binary one
+    std::cout << "Comparing the radix heap with the other heaps... ";
+    cut::RadixHeap<uint32_t> RH;
+    cut::IndexedHeap<uint32_t, uint32_t, 4> IH;
+    cut::MinHeap MH;
+    std::vector<double> RKeys = MonotoneRun(RH, 5000);
+    if (RKeys != MonotoneRun(IH, 5000) || RKeys != MonotoneRun(MH, 5000) || RKeys.size() != 5000)
+        return -1;
+    RH.Clear();
+    if (!RH.Empty() || RH.LowerBound() != 0 || RH.Contains(0))
+        return -1;
+    std::cout << "Done." << std::endl;
+
+    std::cout << "Comparing d-ary heaps with the binary heap... ";
+    static_assert(sizeof(cut::IndexedHeap<float, uint32_t, 8>::Node) == 8, "Nodes of float keys must take 8 bytes.");
+    std::vector<float> FV(V.begin(), V.end());
+    cut::IndexedHeap<float, uint32_t, 8> D8(FV);
+    cut::IndexedHeap<double, size_t, 4, std::greater<double>> D4Max(V);
+    cut::MinHeap HMax(V, true);
+    D8.DecreaseKey(655, 2048);
+    D4Max.IncreaseKey(123, 2048);
+    HMax.IncreaseKey(123, 2048);
+    if (D8.FindMin().second != 655 || D4Max.FindMin() != HMax.FindMin())
+        return -1;
+    Last = -4096;
+    while (!D8.Empty())
+    {
+        std::pair<float, uint32_t> Min = D8.ExtractMin();
+        std::pair<double, size_t> Max = D4Max.ExtractMin();
+        if (Min.first < Last || Max != HMax.ExtractMin())
+            return -1;
+        Last = Min.first;
+    }
+    // The binary and the odd arities sort as well, with the padded root
+    cut::IndexedHeap<double, uint32_t, 2> D2(V);
+    cut::IndexedHeap<double, uint32_t, 3> D3(V);
+    std::vector<double> Sorted(V);
+    std::sort(Sorted.begin(), Sorted.end());
+    for (double Key : Sorted)
+    {
+        if (D2.ExtractMin().first != Key || D3.ExtractMin().first != Key)
+            return -1;
+    }
+    if (!D2.Empty() || !D3.Empty())
+        return -1;
+    std::cout << "Done." << std::endl;
+
+    // Batched updates must match the same updates applied one at a time
+    std::cout << "Setting keys in batches... ";
+    for (bool AsMax : { false, true })
+    {
+        for (size_t NumUpdates : { 10, 50, 800, 3000 })
+        {
+            cut::MinHeap Batch(V, AsMax);
+            cut::MinHeap Single(V, AsMax);
+            std::vector<std::pair<size_t, double>> Updates;
+            std::uniform_int_distribution<int> Dist(0, 4096);
+            for (size_t i = 0; i < NumUpdates; ++i)
+            {
+                size_t e = Eng() % V.size();
+                // Some updates leave the key unchanged, some elements repeat
+                Updates.emplace_back(e, i % 4 == 0 ? Single.GetKey(e) : Dist(Eng));
+                Single.SetKey(Updates.back().first, Updates.back().second);
+            }
+            Batch.SetKeys(Updates.data(), Updates.size());
+            if (Batch.Size() != Single.Size())
+                return -1;
+            for (size_t e = 0; e < V.size(); ++e)
+            {
+                if (Batch.GetKey(e) != Single.GetKey(e))
+                    return -1;
+            }
+            while (!Batch.Empty())
+            {
+                if (Batch.ExtractMin().first != Single.ExtractMin().first)
+                    return -1;
+            }
+        }
+    }
+    cut::MinHeap Unchanged(V);
+    std::vector<std::pair<size_t, double>> Same = { { 3, V[3] }, { 7, V[7] } };
+    Unchanged.SetKeys(cut::Span<std::pair<size_t, double>>(Same.data(), Same.size()));
+    Unchanged.SetKeys(nullptr, 0);
+    if (Unchanged.GetKey(3) != V[3] || Unchanged.FindMin().first != 0)
+        return -1;
+    std::cout << "Done." << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+ * @file        parallel.cpp
+ * 
+ * @brief       Application to test the multithreading primitives.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-11-22
+ */
+#include <cut/parallel/parallel.hpp>
+#include <cut/parallel/multiqueue.hpp>
+#include <cut/algo/adjlist.hpp>
+#include <cut/algo/csr.hpp>
+#include <iostream>
+#include <random>
+#include <numeric>
+
+
+int main(int argc, const char* const argv[])
+{
+    int NThreads = 4;
+    if (argc > 1)
+        NThreads = std::atoi(argv[1]);
+    cut::SetNumThreads(NThreads);
+    std::cout << "Using " << cut::GetNumThreads() << " threads." << std::endl;
+
+    // Parallel loop and prefix sum
+    std::vector<size_t> V(1 << 20);
+    cut::ParallelFor(0, V.size(), [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e; ++i)
+            V[i] = 1;
+    });
+    cut::ParallelPrefixSum(V.data(), V.size());
+    for (size_t i = 0; i < V.size(); ++i)
+    {
+        if (V[i] != i + 1)
+            return -1;
+    }
+    std::cout << "Parallel prefix sum behaving as expected." << std::endl;
+
+    // Exceptions are propagated to the caller
+    try
+    {
+        cut::ParallelFor(0, 1024, [&](size_t b, size_t e)
+        {
+            if (b == 512)
+                throw cut::AssertionError("Block 512 failed.");
+        }, -1, 1);
+        return -1;
+    }
+    catch(const cut::AssertionError& e)
+    {
+        std::cout << "Exception propagated: " << e.what() << std::endl;
+    }
+
+    // Random skewed graph with duplicates
+    std::mt19937 Eng(0);
+    std::uniform_int_distribution<int> Dist(0, 9999);
+    std::vector<std::pair<int, int>> Pairs;
+    for (int i = 0; i < 200000; ++i)
+    {
+        int n = Dist(Eng);
+        Pairs.emplace_back(n % 100 == 0 ? 0 : n, Dist(Eng) % 5000);
+    }
+
+    // Parallel and sequential constructions must agree
+    cut::CSRBuildStats Stats;
+    cut::CompatAdjacencyList Par(Pairs, true, &Stats);
+    cut::SetNumThreads(1);
+    cut::CompatAdjacencyList Seq(Pairs);
+    cut::SetNumThreads(NThreads);
+    if (Par.NumNodes() != Seq.NumNodes() || Par.NumConnections() != Seq.NumConnections())
+        return -1;
+    if (Stats.NumDuplicates != Pairs.size() - Seq.NumConnections())
+        return -1;
+    for (int i = 0; i < Seq.NumNodes(); ++i)
+    {
+        cut::Span<int> P = Par.Neighbors(i);
+        cut::Span<int> S = Seq.Neighbors(i);
+        if (P.Size() != S.Size() || !std::equal(P.begin(), P.end(), S.begin()))
+            return -1;
+    }
+    std::cout << "Parallel construction behaving as expected." << std::endl;
+
+    // Parallel conversions
+    cut::AdjacencyList FAL(Par);
+    cut::CompatAdjacencyList CAL(FAL);
+    cut::CSRAdjacencyList<uint16_t, uint32_t> CSR(FAL);
+    for (int i = 0; i < Seq.NumNodes(); ++i)
+    {
+        cut::Span<int> S = Seq.Neighbors(i);
+        if (!std::equal(S.begin(), S.end(), FAL.Neighbors(i).begin()))
+            return -1;
+        if (!std::equal(S.begin(), S.end(), CAL.Neighbors(i).begin()))
+            return -1;
+        if (!std::equal(S.begin(), S.end(), CSR.Row(i).begin()))
+            return -1;
+    }
+    std::cout << "Parallel conversions behaving as expected." << std::endl;
+
+    // A single heap is an exact priority queue
+    cut::MultiQueue Exact(1, 1);
+    for (size_t i = 0; i < 1000; ++i)
+        Exact.Push(i, (double)((i * 7919) % 1000));
+    std::pair<double, size_t> Min;
+    for (double k = 0; k < 1000; ++k)
+    {
+        if (!Exact.TryExtractApproxMin(Min) || Min.first != k || (Min.second * 7919) % 1000 != k)
+            return -1;
+    }
+    if (!Exact.Empty() || Exact.TryExtractApproxMin(Min))
+        return -1;
+
+    // Concurrent pushes and extractions must return every entry exactly once
+    const size_t NEntries = 1 << 16;
+    cut::MultiQueue MQ;
+    if (MQ.NumQueues() != 2 * (size_t)cut::GetNumThreads())
+        return -1;
+    std::vector<std::atomic<int>> Extracted(NEntries);
+    for (std::atomic<int>& e : Extracted)
+        e.store(0);
+    std::atomic<size_t> Inversions(0);
+    cut::ParallelFor(0, NEntries, [&](size_t b, size_t e)
+    {
+        // Half of the entries are pushed while the queue is being emptied
+        for (size_t i = b; i < e; ++i)
+            MQ.Push(i, (double)(i % 1024));
+        std::pair<double, size_t> M;
+        size_t Last = 0, Inv = 0;
+        for (size_t i = b; i < e; i += 2)
+        {
+            if (!MQ.TryExtractApproxMin(M))
+                break;
+            Extracted[M.second].fetch_add(1);
+            Inv += M.first < Last;
+            Last = (size_t)M.first;
+        }
+        Inversions.fetch_add(Inv);
+    }, -1, 1024);
+    while (MQ.TryExtractApproxMin(Min))
+        Extracted[Min.second].fetch_add(1);
+    for (const std::atomic<int>& e : Extracted)
+    {
+        if (e.load() != 1)
+            return -1;
+    }
+    MQ.DecreaseKey(5, 1.0);
+    MQ.Push(5, 2.0);
+    MQ.Clear();
+    if (MQ.Size() != 0 || MQ.TryExtractApproxMin(Min))
+        return -1;
+    std::cout << "Relaxed priority queue behaving as expected, with " << Inversions.load() << " inversions." << std::endl;
+
+    return 0;
+}
\ No newline at end of file
@@ -10,9 +10,17 @@
  * @date        2023-10-24
  */
 #include <cut/time/time.hpp>
+#include <cut/excepts/excepts.hpp>
 #include <iostream>
 #include <random>
 #include <algorithm>
+#include <thread>
+#include <string>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <cstdio>
 
 
 void busy()
@@ -61,6 +69,157 @@ int main(int argc, const char* const argv[])
     std::cout << "  - microseconds: " << cut::Timer::GetTimer("zero").GetTime(cut::TimerPrecision::MICROSECONDS) << std::endl;
     std::cout << "  - nanoseconds:  " << cut::Timer::GetTimer("zero").GetTime(cut::TimerPrecision::NANOSECONDS) << std::endl;
 
+    // Global timers can be created and looked up from several threads
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        Threads.emplace_back([t]()
+        {
+            std::string Name = "thread" + std::to_string(t);
+            for (int i = 0; i < 100; ++i)
+            {
+                cut::Timer::AttachTimer(Name + "_" + std::to_string(i));
+                cut::Timer::GetTimer(Name + "_" + std::to_string(i)).Pause();
+                cut::Timer::GetTimer("zero").IsPaused();
+            }
+            for (int i = 0; i < 100; ++i)
+                cut::Timer::DeleteTimer(Name + "_" + std::to_string(i));
+        });
+    }
+    for (std::thread& th : Threads)
+        th.join();
+    for (int t = 0; t < 4; ++t)
+        cut::Timer::AttachTimer("thread" + std::to_string(t) + "_0");
+
+    // The cached formatting agrees with the standard one
+    char Buffer[cut::Timestamp::MaxFormatLength];
+    cut::Timestamp Now;
+    size_t Len = Now.Format(Buffer, sizeof(Buffer));
+    if (std::string(Buffer, Len) != Now.ToString())
+        return -1;
+    if (Now.Format(Buffer, sizeof(Buffer), cut::TimerPrecision::MILLISECONDS) != Len + 4 || Buffer[Len] != '.')
+        return -1;
+    if (Now.Format(Buffer, sizeof(Buffer), cut::TimerPrecision::NANOSECONDS) != Len + 10 || std::string(Buffer, Len) != Now.ToString())
+        return -1;
+    std::cout << "Now is " << Buffer << std::endl;
+    try
+    {
+        Now.Format(Buffer, Len, cut::TimerPrecision::SECONDS);
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
+
+    // Percentiles of known samples, within the resolution of the histogram
+    cut::ProfileRegion& Known = cut::ProfileRegion::Get("known");
+    for (uint64_t i = 1; i <= 1000; ++i)
+        Known.Record(i);
+    cut::ProfileStats KS = Known.Stats();
+    double Rate = cut::ProfileClock::NanosecondsPerTick();
+    if (KS.Count != 1000 || KS.Min != Rate || KS.Max != 1000 * Rate || std::abs(KS.Mean - 500.5 * Rate) > 1e-6 * Rate)
+        return -1;
+    if (std::abs(KS.P50 - 500 * Rate) > 0.125 * 500 * Rate || std::abs(KS.P99 - 990 * Rate) > 0.125 * 990 * Rate)
+        return -1;
+    if (KS.P50 > KS.P90 || KS.P90 > KS.P99 || KS.P99 > KS.Max)
+        return -1;
+    if (&cut::ProfileRegion::Get("known") != &Known)
+        return -1;
+    Known.Reset();
+    if (Known.Count() != 0 || Known.Percentile(0.5) != 0.0)
+        return -1;
+#if CUT_CHECKS >= 1
+    try
+    {
+        Known.Percentile(1.5);
+        return -1;
+    }
+    catch(const cut::AssertionError& e) { }
+#endif
+
+    // Scoped regions recorded by several threads
+    const int NSamples = 1000000;
+    Threads.clear();
+    for (int t = 0; t < 4; ++t)
+    {
+        Threads.emplace_back([NSamples]()
+        {
+            for (int i = 0; i < NSamples; ++i)
+            {
+                CUTProfileScope("scoped");
+            }
+        });
+    }
+    for (std::thread& th : Threads)
+        th.join();
+    cut::ProfileStats SS = cut::ProfileRegion::Get("scoped").Stats();
+    if (SS.Count != 4 * NSamples)
+        return -1;
+    cut::Timer Overhead;
+    for (int i = 0; i < NSamples; ++i)
+    {
+        CUTProfileScope("overhead");
+    }
+    Overhead.Pause();
+    std::cout << "Profiling clock: " << (cut::ProfileClock::IsTSC() ? "TSC" : "steady") << std::endl;
+    std::cout << "Cost of a scoped sample: " << Overhead.GetTime(cut::TimerPrecision::NANOSECONDS) / NSamples << " ns." << std::endl;
+    for (const std::pair<std::string, cut::ProfileStats>& R : cut::ProfileRegion::AllStats())
+    {
+        std::cout << R.first << ": " << R.second.Count << " samples, min " << R.second.Min << " ns, p50 " << R.second.P50
+                  << " ns, p99 " << R.second.P99 << " ns, max " << R.second.Max << " ns." << std::endl;
+    }
+
+    // Nested regions traced from several threads
+    cut::Profiler::StartTracing();
+    Threads.clear();
+    for (int t = 0; t < 2; ++t)
+    {
+        Threads.emplace_back([]()
+        {
+            CUTProfileScope("outer");
+            for (int i = 0; i < 3; ++i)
+            {
+                CUTProfileScope("inner");
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        });
+    }
+    for (std::thread& th : Threads)
+        th.join();
+    cut::Profiler::StopTracing();
+    {
+        CUTProfileScope("untraced");
+    }
+    std::vector<cut::ProfileEvent> Events = cut::Profiler::CollectTrace();
+    if (Events.size() != 8)
+        return -1;
+    for (size_t i = 0; i < Events.size(); ++i)
+    {
+        // Each thread has its outer event first, then the inner ones
+        const cut::ProfileEvent& E = Events[i];
+        bool Outer = (i % 4 == 0);
+        if (E.Region->Name() != (Outer ? "outer" : "inner") || E.Depth != (Outer ? 0 : 1))
+            return -1;
+        if (!Outer && (E.Thread != Events[i - i % 4].Thread || E.Begin < Events[i - i % 4].Begin || E.End > Events[i - i % 4].End))
+            return -1;
+    }
+    if (&cut::ProfileRegion::Get("inner") != Events[1].Region)
+        return -1;
+    cut::Profiler::WriteChromeTrace("trace.json");
+    {
+        std::ifstream In("trace.json");
+        std::string Trace((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+        if (Trace.front() != '{' || Trace.find("\"name\":\"inner\",\"cat\":\"cut\",\"ph\":\"X\"") == std::string::npos)
+            return -1;
+    }
+    std::remove("trace.json");
+    std::stringstream Report;
+    cut::Profiler::WriteReport(Report);
+    if (Report.str().find("Call tree") == std::string::npos || Report.str().find("\n  inner ") == std::string::npos)
+        return -1;
+    std::cout << Report.str();
+    cut::Profiler::ClearTrace();
+    if (!cut::Profiler::CollectTrace().empty())
+        return -1;
+
     cut::Timestamp End;
     std::cout << "Program ended at " << End.ToString("%T %F") << std::endl;
 
@@ -0,0 +1,434 @@
+/**
+ * @file        profiler.cpp
+ * 
+ * @brief       Implements the classes cut::ProfileClock, cut::ProfileRegion and cut::Profiler.
+ * 
+ * @author      Filippo Maggioli\n
+ *              (maggioli@di.uniroma1.it, maggioli.filippo@gmail.com)\n
+ *              Sapienza, University of Rome - Department of Computer Science
+ * 
+ * @date        2023-12-06
+ */
+#include <cut/time/profiler.hpp>
+#include <cut/common/registry.hpp>
+#include <cut/excepts/excepts.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <cmath>
+#include <map>
+
+
+
+const size_t cut::ProfileRegion::NumBuckets;
+const size_t cut::Profiler::DefaultMaxEvents;
+std::atomic<bool> cut::Profiler::m_Tracing(false);
+thread_local uint32_t cut::Profiler::m_Depth = 0;
+
+
+namespace
+{
+    // The global regions. A local static, so that regions can be profiled during static initialization
+    cut::Registry<cut::ProfileRegion>& Regions()
+    {
+        static cut::Registry<cut::ProfileRegion> R;
+        return R;
+    }
+
+    // Identifiers of the regions, in order of creation
+    std::atomic<uint32_t> NextRegionId(0);
+
+    // The events of a thread. The lock is only contended while the trace is read
+    struct ThreadTrace
+    {
+        uint32_t Thread;
+        std::mutex Lock;
+        std::vector<cut::ProfileEvent> Events;
+    };
+
+    // The buffers of all the threads, kept after the threads exit
+    struct TraceState
+    {
+        std::mutex Lock;
+        std::vector<std::shared_ptr<ThreadTrace>> Threads;
+        std::atomic<size_t> MaxEvents;
+        std::atomic<size_t> Dropped;
+
+        TraceState() : MaxEvents(cut::Profiler::DefaultMaxEvents), Dropped(0) { }
+    };
+
+    TraceState& Traces()
+    {
+        static TraceState T;
+        return T;
+    }
+
+    ThreadTrace& LocalTrace()
+    {
+        static thread_local std::shared_ptr<ThreadTrace> Local;
+        if (!Local)
+        {
+            Local = std::make_shared<ThreadTrace>();
+            TraceState& T = Traces();
+            std::lock_guard<std::mutex> Guard(T.Lock);
+            Local->Thread = (uint32_t)T.Threads.size();
+            T.Threads.push_back(Local);
+        }
+        return *Local;
+    }
+
+    // Write a string as a JSON literal
+    void WriteJSONString(std::ostream& Out, const std::string& S)
+    {
+        Out << '"';
+        for (char c : S)
+        {
+            switch (c)
+            {
+            case '"':  Out << "\\\""; break;
+            case '\\': Out << "\\\\"; break;
+            case '\n': Out << "\\n"; break;
+            case '\t': Out << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                    Out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+                else
+                    Out << c;
+            }
+        }
+        Out << '"';
+    }
+
+    // A node of the tree of calls
+    struct CallNode
+    {
+        const cut::ProfileRegion* Region;
+        uint64_t Count;
+        uint64_t Total;
+        uint64_t Children;
+        std::map<std::string, size_t> Next;
+    };
+
+    void WriteCallTree(std::ostream& Out, const std::vector<CallNode>& Tree, size_t Node, size_t Level, double Rate)
+    {
+        for (const std::pair<const std::string, size_t>& C : Tree[Node].Next)
+        {
+            const CallNode& N = Tree[C.second];
+            Out << std::string(2 * Level, ' ') << std::left << std::setw(std::max<int>(1, 40 - 2 * (int)Level)) << C.first
+                << std::right << std::setw(12) << N.Count
+                << std::setw(16) << (double)N.Total * Rate * 1e-6
+                << std::setw(16) << (double)(N.Total - N.Children) * Rate * 1e-6 << '\n';
+            WriteCallTree(Out, Tree, C.second, Level + 1, Rate);
+        }
+    }
+
+#if __CUT_HAS_RDTSC
+    // Measure the rate of the time stamp counter against the steady clock
+    double CalibrateTSC()
+    {
+        std::chrono::steady_clock::time_point T0 = std::chrono::steady_clock::now();
+        uint64_t C0 = cut::ProfileClock::Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::chrono::steady_clock::time_point T1 = std::chrono::steady_clock::now();
+        uint64_t C1 = cut::ProfileClock::Now();
+        double Ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(T1 - T0).count();
+        return C1 > C0 ? Ns / (double)(C1 - C0) : 1.0;
+    }
+#endif
+}
+
+
+
+double cut::ProfileClock::NanosecondsPerTick()
+{
+#if __CUT_HAS_RDTSC
+    static const double Rate = CalibrateTSC();
+    return Rate;
+#else
+    return 1.0;
+#endif
+}
+
+bool cut::ProfileClock::IsTSC()
+{
+    return __CUT_HAS_RDTSC != 0;
+}
+
+
+
+
+cut::ProfileRegion::ProfileRegion(const std::string& Name)
+    : m_Name(Name), m_Id(NextRegionId.fetch_add(1))
+{
+    Reset();
+}
+
+const std::string& cut::ProfileRegion::Name() const { return m_Name; }
+uint32_t cut::ProfileRegion::Id() const { return m_Id; }
+
+
+uint64_t cut::ProfileRegion::BucketBegin(size_t B)
+{
+    if (B < 8)
+        return (uint64_t)B;
+    size_t Exp = B / 8 + 2;
+    return (uint64_t)(8 + B % 8) << (Exp - 3);
+}
+
+
+uint64_t cut::ProfileRegion::Count() const
+{
+    return m_Count.load(std::memory_order_relaxed);
+}
+
+
+double cut::ProfileRegion::Percentile(double Q) const
+{
+    CUTAssert(Q >= 0.0 && Q <= 1.0);
+    uint64_t Lo = m_Min.load(std::memory_order_relaxed);
+    uint64_t Hi = m_Max.load(std::memory_order_relaxed);
+
+    // The bucket counts are read once, the total is their sum
+    uint64_t Counts[NumBuckets];
+    uint64_t N = 0;
+    for (size_t b = 0; b < NumBuckets; ++b)
+    {
+        Counts[b] = m_Buckets[b].load(std::memory_order_relaxed);
+        N += Counts[b];
+    }
+    if (N == 0)
+        return 0.0;
+
+    uint64_t Rank = std::max<uint64_t>(1, (uint64_t)std::ceil(Q * (double)N));
+    uint64_t Seen = 0;
+    size_t B = 0;
+    for (; B < NumBuckets - 1; ++B)
+    {
+        Seen += Counts[B];
+        if (Seen >= Rank)
+            break;
+    }
+
+    // The midpoint of the bucket, never outside the observed range
+    uint64_t Begin = BucketBegin(B);
+    uint64_t End = B + 1 < NumBuckets ? BucketBegin(B + 1) : std::numeric_limits<uint64_t>::max();
+    double Value = B < 8 ? (double)Begin : (double)Begin + 0.5 * (double)(End - Begin);
+    Value = std::min(std::max(Value, (double)Lo), (double)Hi);
+    return Value * cut::ProfileClock::NanosecondsPerTick();
+}
+
+
+cut::ProfileStats cut::ProfileRegion::Stats() const
+{
+    cut::ProfileStats S;
+    double Rate = cut::ProfileClock::NanosecondsPerTick();
+    S.Count = Count();
+    if (S.Count == 0)
+    {
+        S.Total = S.Mean = S.Min = S.P50 = S.P90 = S.P99 = S.Max = 0.0;
+        return S;
+    }
+    S.Total = (double)m_Total.load(std::memory_order_relaxed) * Rate;
+    S.Mean = S.Total / (double)S.Count;
+    S.Min = (double)m_Min.load(std::memory_order_relaxed) * Rate;
+    S.Max = (double)m_Max.load(std::memory_order_relaxed) * Rate;
+    S.P50 = Percentile(0.5);
+    S.P90 = Percentile(0.9);
+    S.P99 = Percentile(0.99);
+    return S;
+}
+
+
+void cut::ProfileRegion::Reset()
+{
+    m_Count.store(0, std::memory_order_relaxed);
+    m_Total.store(0, std::memory_order_relaxed);
+    m_Min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_Max.store(0, std::memory_order_relaxed);
+    for (size_t b = 0; b < NumBuckets; ++b)
+        m_Buckets[b].store(0, std::memory_order_relaxed);
+}
+
+
+
+
+cut::ProfileRegion& cut::ProfileRegion::Get(const std::string& Name)
+{
+    return Regions().Acquire(Name, Name);
+}
+
+
+std::vector<std::pair<std::string, cut::ProfileStats>> cut::ProfileRegion::AllStats()
+{
+    std::vector<std::pair<std::string, cut::ProfileStats>> All;
+    Regions().ForEach([&All](const std::string& Name, cut::ProfileRegion& R)
+    {
+        All.emplace_back(Name, R.Stats());
+    });
+    std::sort(All.begin(), All.end(),
+              [](const std::pair<std::string, cut::ProfileStats>& A, const std::pair<std::string, cut::ProfileStats>& B)
+              {
+                  return A.first < B.first;
+              });
+    return All;
+}
+
+
+
+
+void cut::Profiler::Trace(const cut::ProfileRegion& Region, uint64_t Begin, uint64_t End, uint32_t Depth)
+{
+    ThreadTrace& Local = LocalTrace();
+    TraceState& T = Traces();
+    std::lock_guard<std::mutex> Guard(Local.Lock);
+    if (Local.Events.size() >= T.MaxEvents.load(std::memory_order_relaxed))
+    {
+        T.Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    cut::ProfileEvent E = { &Region, Begin, End, Depth, Local.Thread };
+    Local.Events.push_back(E);
+}
+
+
+void cut::Profiler::StartTracing(size_t MaxEventsPerThread)
+{
+    Traces().MaxEvents.store(MaxEventsPerThread);
+    m_Tracing.store(true);
+}
+
+void cut::Profiler::StopTracing() { m_Tracing.store(false); }
+bool cut::Profiler::IsTracing() { return m_Tracing.load(); }
+size_t cut::Profiler::NumDroppedEvents() { return Traces().Dropped.load(); }
+
+void cut::Profiler::ClearTrace()
+{
+    TraceState& T = Traces();
+    std::lock_guard<std::mutex> Guard(T.Lock);
+    for (const std::shared_ptr<ThreadTrace>& TT : T.Threads)
+    {
+        std::lock_guard<std::mutex> ThreadGuard(TT->Lock);
+        TT->Events.clear();
+    }
+    T.Dropped.store(0);
+}
+
+
+std::vector<cut::ProfileEvent> cut::Profiler::CollectTrace()
+{
+    std::vector<cut::ProfileEvent> All;
+    TraceState& T = Traces();
+    std::lock_guard<std::mutex> Guard(T.Lock);
+    for (const std::shared_ptr<ThreadTrace>& TT : T.Threads)
+    {
+        std::lock_guard<std::mutex> ThreadGuard(TT->Lock);
+        size_t First = All.size();
+        All.insert(All.end(), TT->Events.begin(), TT->Events.end());
+        // The events are appended when they end, the enclosing ones go first
+        std::sort(All.begin() + First, All.end(), [](const cut::ProfileEvent& A, const cut::ProfileEvent& B)
+        {
+            return A.Begin < B.Begin || (A.Begin == B.Begin && A.Depth < B.Depth);
+        });
+    }
+    return All;
+}
+
+
+void cut::Profiler::WriteChromeTrace(std::ostream& Out)
+{
+    std::vector<cut::ProfileEvent> Events = CollectTrace();
+    uint64_t Origin = std::numeric_limits<uint64_t>::max();
+    for (const cut::ProfileEvent& E : Events)
+        Origin = std::min(Origin, E.Begin);
+    double Rate = cut::ProfileClock::NanosecondsPerTick() * 1e-3;
+
+    Out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    Out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < Events.size(); ++i)
+    {
+        const cut::ProfileEvent& E = Events[i];
+        Out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+        WriteJSONString(Out, E.Region->Name());
+        Out << ",\"cat\":\"cut\",\"ph\":\"X\",\"pid\":1,\"tid\":" << E.Thread
+            << ",\"ts\":" << (double)(E.Begin - Origin) * Rate
+            << ",\"dur\":" << (double)(E.End - E.Begin) * Rate << '}';
+    }
+    Out << "\n]}\n";
+    Out.unsetf(std::ios::floatfield);
+}
+
+void cut::Profiler::WriteChromeTrace(const std::string& Filename)
+{
+    std::ofstream Out(Filename, std::ios::out);
+    CUTAssert(Out.is_open());
+    WriteChromeTrace(Out);
+}
+
+
+void cut::Profiler::WriteReport(std::ostream& Out)
+{
+    std::ios::fmtflags Flags = Out.flags();
+    std::streamsize Precision = Out.precision();
+    Out << std::fixed << std::setprecision(3);
+
+    Out << std::left << std::setw(40) << "Region" << std::right << std::setw(12) << "Count"
+        << std::setw(16) << "Total (ms)" << std::setw(16) << "Mean (us)" << std::setw(16) << "Min (us)"
+        << std::setw(16) << "P50 (us)" << std::setw(16) << "P99 (us)" << std::setw(16) << "Max (us)" << '\n';
+    for (const std::pair<std::string, cut::ProfileStats>& R : cut::ProfileRegion::AllStats())
+    {
+        const cut::ProfileStats& S = R.second;
+        Out << std::left << std::setw(40) << R.first << std::right << std::setw(12) << S.Count
+            << std::setw(16) << S.Total * 1e-6 << std::setw(16) << S.Mean * 1e-3 << std::setw(16) << S.Min * 1e-3
+            << std::setw(16) << S.P50 * 1e-3 << std::setw(16) << S.P99 * 1e-3 << std::setw(16) << S.Max * 1e-3 << '\n';
+    }
+
+    std::vector<cut::ProfileEvent> Events = CollectTrace();
+    if (!Events.empty())
+    {
+        // Rebuild the nesting of each thread with a stack of the open events
+        std::vector<CallNode> Tree(1);
+        Tree[0].Region = nullptr;
+        Tree[0].Count = Tree[0].Total = Tree[0].Children = 0;
+        std::vector<std::pair<const cut::ProfileEvent*, size_t>> Open;
+        for (size_t i = 0; i < Events.size(); ++i)
+        {
+            const cut::ProfileEvent& E = Events[i];
+            if (i > 0 && Events[i - 1].Thread != E.Thread)
+                Open.clear();
+            while (!Open.empty() && (Open.back().first->End < E.End || Open.back().first->Depth >= E.Depth))
+                Open.pop_back();
+            size_t Parent = Open.empty() ? 0 : Open.back().second;
+
+            std::map<std::string, size_t>::iterator It = Tree[Parent].Next.find(E.Region->Name());
+            size_t Node;
+            if (It == Tree[Parent].Next.end())
+            {
+                Node = Tree.size();
+                Tree[Parent].Next.emplace(E.Region->Name(), Node);
+                CallNode N;
+                N.Region = E.Region;
+                N.Count = N.Total = N.Children = 0;
+                Tree.push_back(N);
+            }
+            else
+                Node = It->second;
+            Tree[Node].Count++;
+            Tree[Node].Total += E.End - E.Begin;
+            Tree[Parent].Children += E.End - E.Begin;
+            Open.emplace_back(&E, Node);
+        }
+
+        Out << '\n' << std::left << std::setw(40) << "Call tree" << std::right << std::setw(12) << "Count"
+            << std::setw(16) << "Total (ms)" << std::setw(16) << "Self (ms)" << '\n';
+        WriteCallTree(Out, Tree, 0, 0, cut::ProfileClock::NanosecondsPerTick());
+        if (NumDroppedEvents() > 0)
+            Out << NumDroppedEvents() << " events dropped.\n";
+    }
+
+    Out.flags(Flags);
+    Out.precision(Precision);
+}
\ No newline at end of file
@@ -14,7 +14,7 @@
 
 
 
-std::unordered_map<std::string, cut::Timer> cut::Timer::m_Timers;
+cut::Registry<cut::Timer> cut::Timer::m_Timers;
 
 
 cut::Timer::Timer(bool StartNow)
@@ -91,7 +91,7 @@ size_t cut::Timer::GetTime(cut::TimerPrecision Precision) const
         End = std::chrono::system_clock::now();
         ET += End - m_Start;;
     }
-    size_t ETcast;
+    size_t ETcast = 0;
     switch (Precision)
     {
     case cut::TimerPrecision::SECONDS:
@@ -129,19 +129,15 @@ double cut::Timer::GetCPUTime() const
 
 void cut::Timer::AttachTimer(const std::string& Name, bool StartNow)
 {
-    CUTAssert(m_Timers.find(Name) == m_Timers.end());
-
-    m_Timers.emplace(Name, StartNow);
+    m_Timers.Attach(Name, StartNow);
 }
 
 cut::Timer& cut::Timer::GetTimer(const std::string& Name)
 {
-    CUTAssert(m_Timers.find(Name) != m_Timers.end());
-    return m_Timers[Name];
+    return m_Timers.Get(Name);
 }
 
 void cut::Timer::DeleteTimer(const std::string& Name)
 {
-    CUTAssert(m_Timers.find(Name) != m_Timers.end());
-    m_Timers.erase(Name);
+    m_Timers.Remove(Name);
 }
\ No newline at end of file
@@ -10,9 +10,31 @@
  * @date        2023-10-24
  */
 #include <cut/time/timestamp.hpp>
+#include <cut/excepts/excepts.hpp>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <cstring>
+#include <cstdint>
+
+
+const size_t cut::Timestamp::MaxFormatLength;
+
+
+namespace
+{
+    // Thread-safe replacement of std::localtime
+    std::tm LocalTime(std::time_t TS)
+    {
+        std::tm Out;
+#if defined(_WIN32)
+        localtime_s(&Out, &TS);
+#else
+        localtime_r(&TS, &Out);
+#endif
+        return Out;
+    }
+}
 
 cut::Timestamp::Timestamp()
 {
@@ -30,8 +52,8 @@ std::string cut::Timestamp::ToString(int UTC, const std::string& Format) const
     TS += UTCShift;
 
     std::stringstream ss;
-    const std::time_t TS_t = std::chrono::system_clock::to_time_t(TS);
-    ss << std::put_time(std::localtime(&TS_t), Format.c_str());
+    const std::tm TS_tm = LocalTime(std::chrono::system_clock::to_time_t(TS));
+    ss << std::put_time(&TS_tm, Format.c_str());
 
     return ss.str();
 }
@@ -39,8 +61,8 @@ std::string cut::Timestamp::ToString(int UTC, const std::string& Format) const
 std::string cut::Timestamp::ToString(const std::string& Format) const
 {
     std::stringstream ss;
-    const std::time_t TS_t = std::chrono::system_clock::to_time_t(m_TS);
-    ss << std::put_time(std::localtime(&TS_t), Format.c_str());
+    const std::tm TS_tm = LocalTime(std::chrono::system_clock::to_time_t(m_TS));
+    ss << std::put_time(&TS_tm, Format.c_str());
 
     return ss.str();
 }
@@ -48,4 +70,59 @@ std::string cut::Timestamp::ToString(const std::string& Format) const
 std::string cut::Timestamp::ToString() const
 {
     return ToString("%F %T");
+}
+
+size_t cut::Timestamp::Format(char* Buffer,
+                              size_t Size,
+                              cut::TimerPrecision Precision) const
+{
+    CUTCheckNull(Buffer);
+    CUTAssert((Precision == cut::TimerPrecision::SECONDS) || 
+              (Precision == cut::TimerPrecision::MILLISECONDS) || 
+              (Precision == cut::TimerPrecision::MICROSECONDS) || 
+              (Precision == cut::TimerPrecision::NANOSECONDS));
+
+    // Split in whole seconds and nanoseconds, rounding towards the past
+    int64_t NS = std::chrono::duration_cast<std::chrono::nanoseconds>(m_TS.time_since_epoch()).count();
+    int64_t Sec = NS / 1000000000;
+    int64_t Frac = NS % 1000000000;
+    if (Frac < 0)
+    {
+        Sec--;
+        Frac += 1000000000;
+    }
+
+    // The date and time are rendered once per second and thread
+    static thread_local int64_t CachedSec = INT64_MIN;
+    static thread_local char Cached[MaxFormatLength];
+    static thread_local size_t CachedLen = 0;
+    if (Sec != CachedSec)
+    {
+        const std::tm TS_tm = LocalTime((std::time_t)Sec);
+        CachedLen = std::strftime(Cached, sizeof(Cached), "%Y-%m-%d %H:%M:%S", &TS_tm);
+        CUTAssert(CachedLen > 0);
+        CachedSec = Sec;
+    }
+
+    static const size_t Digits[] = { 0, 3, 6, 9 };
+    size_t NDigits = Digits[(int)Precision];
+    size_t Len = CachedLen + (NDigits > 0 ? NDigits + 1 : 0);
+    // Never compiled out, an overflow here would corrupt the caller's stack
+    if (Size <= Len)
+        throw cut::AssertionError("The buffer is too small for the timestamp.");
+
+    std::memcpy(Buffer, Cached, CachedLen);
+    if (NDigits > 0)
+    {
+        for (size_t k = NDigits; k < 9; ++k)
+            Frac /= 10;
+        Buffer[CachedLen] = '.';
+        for (size_t k = NDigits; k > 0; --k)
+        {
+            Buffer[CachedLen + k] = (char)('0' + Frac % 10);
+            Frac /= 10;
+        }
+    }
+    Buffer[Len] = '\0';
+    return Len;
 }
\ No newline at end of file